@@ -0,0 +1,85 @@
+#include "ParticleSystem.h"
+#include <chrono>
+#include <iostream>
+
+//Measures how long ParticleSystem::Update and ParticleSystem::GetInstances take for one million particles.
+
+static const unsigned int NUM_PARTICLES{ 1000000 };
+static const unsigned int NUM_UPDATES{ 200 };
+static const float DT{ 1.0f / 60.0f };
+
+//Returns the average time in milliseconds of calling the function the specified number of times.
+template<typename Function>
+static double AverageMilliseconds(unsigned int count, Function function)
+{
+	auto start{ std::chrono::steady_clock::now() };
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		function();
+	}
+
+	auto end{ std::chrono::steady_clock::now() };
+
+	return std::chrono::duration<double, std::milli>(end - start).count() / count;
+}
+
+static void PrintResult(const char* name, double milliseconds, unsigned int numParticles)
+{
+	std::cout << name << ": " << milliseconds << " ms per call, " <<
+		milliseconds * 1000000.0 / numParticles << " ns per particle (" << numParticles << " particles)\n";
+}
+
+int main()
+{
+	PhysicsEngine::ParticleEmitter emitter;
+	emitter.direction = vec3{ 0.0f, 1.0f, 0.0f };
+	emitter.spreadAngle = 30.0f;
+	emitter.minSpeed = 5.0f;
+	emitter.maxSpeed = 10.0f;
+	emitter.color = vec4{ 1.0f, 0.5f, 0.0f, 1.0f };
+
+	//Long lived particles, so the update only measures the integration and the scan for dead particles.
+	{
+		PhysicsEngine::ParticleSystem particleSystem(NUM_PARTICLES);
+		particleSystem.SetGravity(9.81f, vec3{ 0.0f, -1.0f, 0.0f });
+		particleSystem.SetDrag(0.1f, 0.01f);
+
+		emitter.minLifetime = 1000.0f;
+		emitter.maxLifetime = 1000.0f;
+		particleSystem.AddEmitter(emitter);
+		particleSystem.Emit(0, NUM_PARTICLES);
+
+		//warm up
+		particleSystem.Update(DT);
+
+		double update{ AverageMilliseconds(NUM_UPDATES, [&particleSystem]() { particleSystem.Update(DT); }) };
+		PrintResult("Update", update, particleSystem.GetNumberOfParticles());
+
+		double instances{ AverageMilliseconds(NUM_UPDATES, [&particleSystem]() { particleSystem.GetInstances(); }) };
+		PrintResult("GetInstances", instances, particleSystem.GetNumberOfParticles());
+	}
+
+	//Short lived particles with a continuous emitter, so particles die and get emitted every update.
+	{
+		PhysicsEngine::ParticleSystem particleSystem(NUM_PARTICLES);
+		particleSystem.SetGravity(9.81f, vec3{ 0.0f, -1.0f, 0.0f });
+		particleSystem.SetDrag(0.1f, 0.01f);
+
+		emitter.minLifetime = 1.0f;
+		emitter.maxLifetime = 2.0f;
+		emitter.emissionRate = NUM_PARTICLES / 2.0f;
+		particleSystem.AddEmitter(emitter);
+
+		//Fill the system until the number of particles dying and being emitted is about the same.
+		for (unsigned int i = 0; i < 180; ++i)
+		{
+			particleSystem.Update(DT);
+		}
+
+		double update{ AverageMilliseconds(NUM_UPDATES, [&particleSystem]() { particleSystem.Update(DT); }) };
+		PrintResult("Update with emission", update, particleSystem.GetNumberOfParticles());
+	}
+
+	return 0;
+}
@@ -0,0 +1,892 @@
+#include "Checks.h"
+#include "BoundingVolumeArrays.h"
+#include "CompoundShape.h"
+#include "CreateShapes.h"
+#include "LargeWorld.h"
+#include "Random.h"
+#include "SceneQueries.h"
+#include "ShapeAssets.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+static unsigned int gNumChecks{ 0 };
+static unsigned int gNumFailedChecks{ 0 };
+
+const char* Check(bool passed)
+{
+	++gNumChecks;
+	if (!passed)
+		++gNumFailedChecks;
+
+	return passed ? "yes" : "NO";
+}
+
+unsigned int GetNumberOfFailedChecks()
+{
+	return gNumFailedChecks;
+}
+
+unsigned int GetNumberOfChecks()
+{
+	return gNumChecks;
+}
+
+static vec3 RandomDirection(Random& random)
+{
+	vec3 direction{ random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f) };
+
+	return MathEngine::Normalize(MathEngine::Length(direction) > 0.01f ? direction : vec3{ 0.0f, 0.0f, 1.0f });
+}
+
+void CreateQueryScene(QueryTestScene& scene, unsigned int numVolumesPerType, float size, unsigned int seed)
+{
+	Random random{ seed };
+
+	scene.spheres.resize(numVolumesPerType);
+	scene.boxes.resize(numVolumesPerType);
+	scene.vertices.resize(3 * numVolumesPerType);
+	scene.triangles.resize(numVolumesPerType);
+
+	for (unsigned int i = 0; i < numVolumesPerType; ++i)
+	{
+		vec3 center{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		scene.spheres[i] = PhysicsEngine::Sphere{ center, random.Next(0.5f, 2.0f) };
+
+		center = vec3{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		vec3 extents{ random.Next(0.5f, 2.0f), random.Next(0.5f, 2.0f), random.Next(0.5f, 2.0f) };
+		scene.boxes[i] = PhysicsEngine::AABB{ center - extents, center + extents };
+
+		center = vec3{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			scene.vertices[3 * i + j].position = center + vec3{ random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f) };
+		}
+
+		scene.triangles[i] = ShapesEngine::Triangle{ scene.vertices.data(), 3 * i, 3 * i + 1, 3 * i + 2 };
+	}
+
+	scene.scene.spheres = scene.spheres.data();
+	scene.scene.numSpheres = numVolumesPerType;
+	scene.scene.boxes = scene.boxes.data();
+	scene.scene.numBoxes = numVolumesPerType;
+	scene.scene.triangles = scene.triangles.data();
+	scene.scene.numTriangles = numVolumesPerType;
+
+	scene.volumeBVH.BuildQueryVolumeBVH(scene.spheres.data(), numVolumesPerType, scene.boxes.data(), numVolumesPerType);
+	scene.triangleMesh.InitializeTriangleMeshCollider(scene.triangles);
+	scene.scene.volumeBVH = &scene.volumeBVH;
+	scene.scene.triangleMesh = &scene.triangleMesh;
+}
+
+void CreateQueryRays(std::vector<PhysicsEngine::Ray>& rays, unsigned int numRays, float size, unsigned int seed)
+{
+	Random random{ seed };
+
+	rays.resize(numRays);
+	for (auto& i : rays)
+	{
+		i.origin = vec3{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		i.direction = RandomDirection(random);
+		i.maxDistance = 4.0f * size;
+	}
+}
+
+//On a tie the later volume wins, the same as the packets.
+static PhysicsEngine::QueryHit CastRayScalar(const PhysicsEngine::QueryScene& scene, const PhysicsEngine::Ray& ray)
+{
+	PhysicsEngine::QueryHit hit;
+	hit.distance = ray.maxDistance;
+
+	auto test = [&ray, &hit](const auto& volume, PhysicsEngine::QueryVolumeType type, unsigned int index)
+	{
+		float t{ 0.0f };
+		vec3 normal;
+		if (PhysicsEngine::IntersectRay(ray, volume, t, normal) && t <= hit.distance)
+		{
+			hit.type = type;
+			hit.index = index;
+			hit.distance = t;
+			hit.normal = normal;
+		}
+	};
+
+	for (unsigned int i = 0; i < scene.numSpheres; ++i)
+		test(scene.spheres[i], PhysicsEngine::QUERY_SPHERE, i);
+
+	for (unsigned int i = 0; i < scene.numBoxes; ++i)
+		test(scene.boxes[i], PhysicsEngine::QUERY_AABB, i);
+
+	for (unsigned int i = 0; i < scene.numTriangles; ++i)
+		test(scene.triangles[i], PhysicsEngine::QUERY_TRIANGLE, i);
+
+	if (hit.type == PhysicsEngine::QUERY_NONE)
+		hit.distance = 0.0f;
+
+	return hit;
+}
+
+void CastRaysScalar(const PhysicsEngine::QueryScene& scene, const PhysicsEngine::Ray* rays, unsigned int numRays, PhysicsEngine::QueryHit* hits)
+{
+	for (unsigned int i = 0; i < numRays; ++i)
+	{
+		hits[i] = CastRayScalar(scene, rays[i]);
+	}
+}
+
+//Returns the distance from the point to each kind of volume, negative inside a sphere and 0 inside an AABB.
+static float Distance(const vec3& point, const PhysicsEngine::Sphere& sphere)
+{
+	return MathEngine::Length(point - sphere.center) - sphere.radius;
+}
+
+static float Distance(const vec3& point, const PhysicsEngine::AABB& aabb)
+{
+	vec3 closest{ std::clamp(point.x, aabb.min.x, aabb.max.x), std::clamp(point.y, aabb.min.y, aabb.max.y),
+		std::clamp(point.z, aabb.min.z, aabb.max.z) };
+
+	return MathEngine::Length(point - closest);
+}
+
+static float Distance(const vec3& point, const ShapesEngine::Triangle& triangle)
+{
+	return MathEngine::Length(point - PhysicsEngine::ClosestPointOnTriangle(point, triangle));
+}
+
+//Returns the distance from the point to the closest volume of the scene.
+static float Distance(const vec3& point, const PhysicsEngine::QueryScene& scene)
+{
+	float distance{ 1e30f };
+	for (unsigned int i = 0; i < scene.numSpheres; ++i)
+		distance = std::min(distance, Distance(point, scene.spheres[i]));
+
+	for (unsigned int i = 0; i < scene.numBoxes; ++i)
+		distance = std::min(distance, Distance(point, scene.boxes[i]));
+
+	for (unsigned int i = 0; i < scene.numTriangles; ++i)
+		distance = std::min(distance, Distance(point, scene.triangles[i]));
+
+	return distance;
+}
+
+//Compares the packet ray casts with the scalar ones, the sphere casts with the distances to the volumes along the path of the sphere,
+//and the overlaps found on several threads with testing every query against every volume. Then runs the queries again without the
+//hierarchies and compares the hits.
+static void CheckSceneQueries()
+{
+	const float size{ 20.0f };
+	const float tolerance{ 1e-3f };
+
+	QueryTestScene testScene;
+	CreateQueryScene(testScene, 100, size, 5);
+	const PhysicsEngine::QueryScene& scene{ testScene.scene };
+
+	//rays
+	std::vector<PhysicsEngine::Ray> rays;
+	CreateQueryRays(rays, 4096, 1.5f * size, 6);
+
+	std::vector<PhysicsEngine::QueryHit> packetHits(rays.size());
+	std::vector<PhysicsEngine::QueryHit> scalarHits(rays.size());
+	PhysicsEngine::CastRays(scene, rays.data(), (unsigned int)rays.size(), packetHits.data(), 4);
+	CastRaysScalar(scene, rays.data(), (unsigned int)rays.size(), scalarHits.data());
+
+	unsigned int numRayHits{ 0 };
+	bool sameRays{ true };
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		const PhysicsEngine::QueryHit& packet{ packetHits[i] };
+		const PhysicsEngine::QueryHit& scalar{ scalarHits[i] };
+		if ((packet.type == PhysicsEngine::QUERY_NONE) != (scalar.type == PhysicsEngine::QUERY_NONE))
+		{
+			sameRays = false;
+			continue;
+		}
+
+		if (packet.type == PhysicsEngine::QUERY_NONE)
+			continue;
+
+		++numRayHits;
+
+		//The packets compute the distances in a different order, so two volumes at almost the same distance can swap.
+		if (std::fabs(packet.distance - scalar.distance) > tolerance * (1.0f + scalar.distance))
+			sameRays = false;
+		else if ((packet.type != scalar.type || packet.index != scalar.index) && std::fabs(packet.distance - scalar.distance) > tolerance)
+			sameRays = false;
+	}
+
+	//sphere casts
+	Random random{ 7 };
+	std::vector<PhysicsEngine::SphereCast> casts(1024);
+	for (auto& i : casts)
+	{
+		i.origin = vec3{ random.Next(-1.5f * size, 1.5f * size), random.Next(-1.5f * size, 1.5f * size), random.Next(-1.5f * size, 1.5f * size) };
+		i.direction = RandomDirection(random);
+		i.radius = random.Next(0.2f, 1.0f);
+		i.maxDistance = 3.0f * size;
+	}
+
+	std::vector<PhysicsEngine::QueryHit> castHits(casts.size());
+	PhysicsEngine::CastSpheres(scene, casts.data(), (unsigned int)casts.size(), castHits.data(), 4);
+
+	//The sphere has to touch the scene at the hit and be clear of it at every sample before the hit, or along the whole path if it missed.
+	const unsigned int numSamples{ 32 };
+	unsigned int numCastHits{ 0 };
+	bool sameCasts{ true };
+	for (size_t i = 0; i < casts.size(); ++i)
+	{
+		const PhysicsEngine::SphereCast& cast{ casts[i] };
+		const PhysicsEngine::QueryHit& hit{ castHits[i] };
+
+		float end{ cast.maxDistance };
+		if (hit.type != PhysicsEngine::QUERY_NONE)
+		{
+			++numCastHits;
+			end = hit.distance;
+
+			float distance{ Distance(cast.origin + cast.direction * hit.distance, scene) };
+			if (hit.distance > 0.0f ? std::fabs(distance - cast.radius) > tolerance : distance > cast.radius + tolerance)
+				sameCasts = false;
+		}
+
+		for (unsigned int j = 0; j < numSamples && end > 0.0f; ++j)
+		{
+			if (Distance(cast.origin + cast.direction * (end * j / numSamples), scene) < cast.radius - tolerance)
+			{
+				sameCasts = false;
+				break;
+			}
+		}
+	}
+
+	//overlaps
+	std::vector<PhysicsEngine::Sphere> sphereQueries(4096);
+	std::vector<PhysicsEngine::AABB> boxQueries(4096);
+	for (size_t i = 0; i < sphereQueries.size(); ++i)
+	{
+		vec3 center{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		sphereQueries[i] = PhysicsEngine::Sphere{ center, random.Next(0.5f, 3.0f) };
+
+		center = vec3{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		vec3 extents{ random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f) };
+		boxQueries[i] = PhysicsEngine::AABB{ center - extents, center + extents };
+	}
+
+	std::vector<PhysicsEngine::OverlapHit> sphereOverlaps;
+	std::vector<PhysicsEngine::OverlapHit> boxOverlaps;
+	PhysicsEngine::OverlapSpheres(scene, sphereQueries.data(), (unsigned int)sphereQueries.size(), sphereOverlaps, 4);
+	PhysicsEngine::OverlapAABBs(scene, boxQueries.data(), (unsigned int)boxQueries.size(), boxOverlaps, 4);
+
+	//The sphere overlaps are checked against the distances, the AABB overlaps against the single tests.
+	std::vector<PhysicsEngine::OverlapHit> expectedSpheres;
+	std::vector<PhysicsEngine::OverlapHit> expectedBoxes;
+	for (unsigned int i = 0; i < (unsigned int)sphereQueries.size(); ++i)
+	{
+		const PhysicsEngine::Sphere& query{ sphereQueries[i] };
+		for (unsigned int j = 0; j < scene.numSpheres; ++j)
+		{
+			if (Distance(query.center, scene.spheres[j]) <= query.radius)
+				expectedSpheres.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_SPHERE, j });
+		}
+
+		for (unsigned int j = 0; j < scene.numBoxes; ++j)
+		{
+			if (Distance(query.center, scene.boxes[j]) <= query.radius)
+				expectedSpheres.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_AABB, j });
+		}
+
+		for (unsigned int j = 0; j < scene.numTriangles; ++j)
+		{
+			if (Distance(query.center, scene.triangles[j]) <= query.radius)
+				expectedSpheres.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_TRIANGLE, j });
+		}
+
+		for (unsigned int j = 0; j < scene.numSpheres; ++j)
+		{
+			if (PhysicsEngine::TestIntersection(scene.spheres[j], boxQueries[i]))
+				expectedBoxes.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_SPHERE, j });
+		}
+
+		for (unsigned int j = 0; j < scene.numBoxes; ++j)
+		{
+			if (PhysicsEngine::TestIntersection(boxQueries[i], scene.boxes[j]))
+				expectedBoxes.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_AABB, j });
+		}
+
+		for (unsigned int j = 0; j < scene.numTriangles; ++j)
+		{
+			if (PhysicsEngine::TestIntersection(boxQueries[i], scene.triangles[j]))
+				expectedBoxes.push_back(PhysicsEngine::OverlapHit{ i, PhysicsEngine::QUERY_TRIANGLE, j });
+		}
+	}
+
+	auto sameOverlaps = [](const std::vector<PhysicsEngine::OverlapHit>& a, const std::vector<PhysicsEngine::OverlapHit>& b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const PhysicsEngine::OverlapHit& x, const PhysicsEngine::OverlapHit& y)
+			{
+				return x.query == y.query && x.type == y.type && x.index == y.index;
+			});
+	};
+
+	//Without the hierarchies every volume is tested with the same tests, so the hits are the same. Only a ray that starts inside
+	//several volumes can pick another one of them, since they are all at a distance of 0.
+	PhysicsEngine::QueryScene flatScene{ scene };
+	flatScene.volumeBVH = nullptr;
+	flatScene.triangleMesh = nullptr;
+
+	std::vector<PhysicsEngine::QueryHit> flatHits(rays.size());
+	PhysicsEngine::CastRays(flatScene, rays.data(), (unsigned int)rays.size(), flatHits.data(), 4);
+
+	auto sameHit = [](const PhysicsEngine::QueryHit& a, const PhysicsEngine::QueryHit& b)
+	{
+		return a.distance == b.distance && (a.distance == 0.0f || (a.type == b.type && a.index == b.index));
+	};
+
+	bool sameHierarchies{ std::equal(flatHits.begin(), flatHits.end(), packetHits.begin(), sameHit) };
+
+	PhysicsEngine::CastSpheres(flatScene, casts.data(), (unsigned int)casts.size(), flatHits.data(), 4);
+	for (size_t i = 0; i < casts.size() && sameHierarchies; ++i)
+	{
+		sameHierarchies = flatHits[i].distance == castHits[i].distance && flatHits[i].type == castHits[i].type &&
+			flatHits[i].index == castHits[i].index;
+	}
+
+	std::vector<PhysicsEngine::OverlapHit> flatOverlaps;
+	PhysicsEngine::OverlapSpheres(flatScene, sphereQueries.data(), (unsigned int)sphereQueries.size(), flatOverlaps, 4);
+	sameHierarchies = sameHierarchies && sameOverlaps(flatOverlaps, sphereOverlaps);
+	PhysicsEngine::OverlapAABBs(flatScene, boxQueries.data(), (unsigned int)boxQueries.size(), flatOverlaps, 4);
+	sameHierarchies = sameHierarchies && sameOverlaps(flatOverlaps, boxOverlaps);
+
+	std::cout << std::left << std::setw(16) << "scene queries" << std::right <<
+		std::setw(8) << rays.size() << " rays" <<
+		std::setw(8) << numRayHits << " hits" <<
+		std::setw(8) << numCastHits << " cast hits" <<
+		std::setw(8) << sphereOverlaps.size() + boxOverlaps.size() << " overlaps" <<
+		"  packets: " << Check(sameRays) <<
+		"  sphere casts: " << Check(sameCasts) <<
+		"  overlaps: " << Check(sameOverlaps(sphereOverlaps, expectedSpheres) && sameOverlaps(boxOverlaps, expectedBoxes)) <<
+		"  hierarchies: " << Check(sameHierarchies) << "\n";
+}
+
+//Returns true if the triangles of every shape in the library point to the vertices of their shape.
+static bool TrianglesPointToOwnVertices(const PhysicsEngine::ShapeAssetLibrary& library)
+{
+	for (unsigned int i = 0; i < library.GetNumberOfShapes(); ++i)
+	{
+		const PhysicsEngine::ShapeAsset& shape{ library.GetShape(i) };
+		for (const auto& j : shape.triangles)
+		{
+			if (j.vertexList != shape.vertices.data())
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//Moves the shapes of a library to another one, and checks the instances of each shape against the rigid bodies made from them.
+//The model matrix of an instance has to put every vertex where the rigid body puts it, before and after the body moves,
+//and the world bounds of the instance have to contain the vertices.
+static void CheckShapeAssets()
+{
+	PhysicsEngine::ShapeAssetLibrary library;
+	std::vector<ShapesEngine::Vertex> vertices;
+	std::vector<ShapesEngine::Triangle> triangles;
+
+	ShapesEngine::CreateBox(vertices, triangles);
+	library.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_BOX);
+	ShapesEngine::CreateCone(vertices, triangles);
+	library.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_CONE);
+	ShapesEngine::CreatePyramid(vertices, triangles);
+	library.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_PYRAMID);
+
+	PhysicsEngine::ShapeAssetLibrary moved{ std::move(library) };
+	PhysicsEngine::ShapeAssetLibrary assets;
+	assets = std::move(moved);
+	bool movesKeepTriangles{ library.GetNumberOfShapes() == 0 && moved.GetNumberOfShapes() == 0 && assets.GetNumberOfShapes() == 3 &&
+		TrianglesPointToOwnVertices(assets) };
+
+	Random random{ 29 };
+	const float dt{ 1.0f / 60.0f };
+	const float tolerance{ 1e-4f };
+	float maxError{ 0.0f };
+	bool boundsContainVertices{ true };
+
+	std::vector<PhysicsEngine::ShapeInstance> instances(assets.GetNumberOfShapes());
+	for (unsigned int i = 0; i < assets.GetNumberOfShapes(); ++i)
+	{
+		const PhysicsEngine::ShapeAsset& shape{ assets.GetShape(i) };
+
+		PhysicsEngine::ShapeInstance& instance{ instances[i] };
+		instance.shape = i;
+		instance.position = vec3{ random.Next(-50.0f, 50.0f), random.Next(-50.0f, 50.0f), random.Next(-50.0f, 50.0f) };
+		instance.orientation = RandomOrientation(random);
+		instance.scale = vec3{ random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f) };
+
+		PhysicsEngine::RigidBody body;
+		PhysicsEngine::InitializeRigidBody(body, 2.0f, shape, instance);
+		body.SetLinearVelocity(vec3{ random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f) });
+		body.SetAngularVelocity(vec3{ random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f) });
+
+		for (unsigned int step = 0; step <= 30; ++step)
+		{
+			if (step > 0)
+			{
+				body.Integrate(dt);
+				PhysicsEngine::UpdateShapeInstance(instance, shape, body);
+			}
+
+			mat4 model{ PhysicsEngine::ComputeModelMatrix(instance) };
+			mat3 rotation{ MathEngine::QuaternionToRotationMatrixRow3x3(body.GetOrientation()) };
+
+			PhysicsEngine::AABB worldBox;
+			PhysicsEngine::Sphere worldSphere;
+			PhysicsEngine::ComputeWorldAABB(worldBox, shape, instance);
+			PhysicsEngine::ComputeWorldSphere(worldSphere, shape, instance);
+
+			for (const auto& j : shape.vertices)
+			{
+				vec4 transformed{ vec4{ j.position.x, j.position.y, j.position.z, 1.0f } * model };
+				vec3 position{ transformed.x, transformed.y, transformed.z };
+
+				vec3 expected{ body.GetCenterOfMass() + ((j.position - shape.massProperties.centerOfMass) * MathEngine::Scale(instance.scale)) * rotation };
+				float scale{ std::max(1.0f, MathEngine::Length(expected)) };
+				maxError = std::max(maxError, MathEngine::Length(position - expected) / scale);
+
+				vec3 margin{ tolerance * scale, tolerance * scale, tolerance * scale };
+				vec3 belowMin{ worldBox.min - margin - position };
+				vec3 aboveMax{ position - worldBox.max - margin };
+				if (belowMin.x > 0.0f || belowMin.y > 0.0f || belowMin.z > 0.0f || aboveMax.x > 0.0f || aboveMax.y > 0.0f || aboveMax.z > 0.0f)
+					boundsContainVertices = false;
+
+				if (MathEngine::Length(position - worldSphere.center) > worldSphere.radius + tolerance * scale)
+					boundsContainVertices = false;
+			}
+		}
+	}
+
+	std::vector<mat4> models(instances.size());
+	PhysicsEngine::ComputeModelMatrices(instances.data(), (unsigned int)instances.size(), models.data());
+	bool sameModels{ true };
+	for (unsigned int i = 0; i < instances.size(); ++i)
+	{
+		mat4 model{ PhysicsEngine::ComputeModelMatrix(instances[i]) };
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			for (unsigned int column = 0; column < 4; ++column)
+			{
+				if (models[i](row, column) != model(row, column))
+					sameModels = false;
+			}
+		}
+	}
+
+	std::cout << std::left << std::setw(16) << "shape assets" << std::right <<
+		std::setw(8) << assets.GetNumberOfShapes() << " shapes" <<
+		std::setw(12) << std::scientific << std::setprecision(2) << maxError << std::defaultfloat << " max error" <<
+		"  moves: " << Check(movesKeepTriangles) <<
+		"  instances: " << Check(maxError < tolerance) <<
+		"  bounds: " << Check(boundsContainVertices) <<
+		"  model matrices: " << Check(sameModels) << "\n";
+}
+
+//Returns true if the matrices are equal.
+static bool SameMatrix(const mat4& a, const mat4& b)
+{
+	for (unsigned int row = 0; row < 4; ++row)
+	{
+		for (unsigned int column = 0; column < 4; ++column)
+		{
+			if (a(row, column) != b(row, column))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+//Transforms a mix of spheres and AABBs with BoundingVolumeArrays and checks the world volumes and their model matrices against
+//TransformSphere and TransformAABB of each body. The model matrices have to be the ones ComputeSphereModelMatrix and
+//ComputeAABBModelMatrix return for the world volumes, which is what BoundingSphere::UpdateModelMatrix and BoundingBox::UpdateModelMatrix do.
+static void CheckBoundingVolumeArrays()
+{
+	const unsigned int numBodies{ 1001 };
+
+	Random random{ 33 };
+	PhysicsEngine::BoundingVolumeArrays volumes;
+	std::vector<PhysicsEngine::Sphere> localSpheres(numBodies);
+	std::vector<PhysicsEngine::AABB> localBoxes(numBodies);
+	std::vector<mat4> models(numBodies);
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		PhysicsEngine::ShapeInstance instance;
+		instance.position = vec3{ random.Next(-100.0f, 100.0f), random.Next(-100.0f, 100.0f), random.Next(-100.0f, 100.0f) };
+		instance.orientation = RandomOrientation(random);
+		instance.scale = vec3{ random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f) };
+		models[i] = PhysicsEngine::ComputeModelMatrix(instance);
+
+		vec3 center{ random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f) };
+		if (random.Next(0.0f, 1.0f) < 0.5f)
+		{
+			localSpheres[i] = PhysicsEngine::Sphere{ center, random.Next(0.1f, 2.0f) };
+			PhysicsEngine::AddBoundingSphere(volumes, localSpheres[i]);
+		}
+		else
+		{
+			vec3 halfWidths{ random.Next(0.1f, 2.0f), random.Next(0.1f, 2.0f), random.Next(0.1f, 2.0f) };
+			localBoxes[i] = PhysicsEngine::AABB{ center - halfWidths, center + halfWidths };
+			PhysicsEngine::AddBoundingBox(volumes, localBoxes[i]);
+		}
+	}
+
+	std::vector<mat4> volumeModels(numBodies);
+	PhysicsEngine::TransformBoundingVolumes(volumes, models.data());
+	PhysicsEngine::ComputeBoundingVolumeModelMatrices(volumes, volumeModels.data());
+
+	//The AABBs are transformed 4 at a time from their centers and extents, so they can round differently than TransformAABB.
+	const float tolerance{ 1e-5f };
+	float maxBoxError{ 0.0f };
+	bool sameSpheres{ PhysicsEngine::GetNumberOfBoundingVolumes(volumes) == numBodies };
+	bool sameModels{ sameSpheres };
+	for (unsigned int i = 0; i < numBodies && sameSpheres; ++i)
+	{
+		if (PhysicsEngine::GetBoundingVolumeType(volumes, i) == PhysicsEngine::BOUNDING_SPHERE)
+		{
+			PhysicsEngine::Sphere expected;
+			PhysicsEngine::TransformSphere(expected, localSpheres[i], models[i]);
+
+			const PhysicsEngine::Sphere& sphere{ PhysicsEngine::GetWorldSphere(volumes, i) };
+			if (sphere.center.x != expected.center.x || sphere.center.y != expected.center.y || sphere.center.z != expected.center.z ||
+				sphere.radius != expected.radius)
+				sameSpheres = false;
+
+			if (!SameMatrix(volumeModels[i], PhysicsEngine::ComputeSphereModelMatrix(sphere)))
+				sameModels = false;
+		}
+		else
+		{
+			PhysicsEngine::AABB expected;
+			PhysicsEngine::TransformAABB(expected, localBoxes[i], models[i]);
+
+			PhysicsEngine::AABB box{ PhysicsEngine::GetWorldAABB(volumes, i) };
+			float scale{ std::max(1.0f, MathEngine::Length(expected.max - expected.min)) };
+			maxBoxError = std::max(maxBoxError, std::max(MathEngine::Length(box.min - expected.min), MathEngine::Length(box.max - expected.max)) / scale);
+
+			if (!SameMatrix(volumeModels[i], PhysicsEngine::ComputeAABBModelMatrix(box)))
+				sameModels = false;
+		}
+	}
+
+	std::cout << std::left << std::setw(16) << "bounding volumes" << std::right <<
+		std::setw(8) << volumes.worldSpheres.size() << " spheres" <<
+		std::setw(8) << volumes.boxBodies.size() << " boxes" <<
+		std::setw(12) << std::scientific << std::setprecision(2) << maxBoxError << std::defaultfloat << " box error" <<
+		"  spheres: " << Check(sameSpheres) <<
+		"  boxes: " << Check(maxBoxError < tolerance) <<
+		"  model matrices: " << Check(sameModels) << "\n";
+}
+
+//Returns a compound of spheres, boxes and capsules with random sizes, positions, orientations and densities spread over a cube
+//from -size to size.
+static PhysicsEngine::CompoundShape CreateRandomCompound(Random& random, unsigned int numChildren, float size)
+{
+	std::vector<PhysicsEngine::CompoundChild> children(numChildren);
+	for (unsigned int i = 0; i < numChildren; ++i)
+	{
+		PhysicsEngine::CompoundChild& child{ children[i] };
+		if (i % 3 == 0)
+			child.shape = PhysicsEngine::MakeSphereShape(random.Next(0.2f, 1.0f));
+		else if (i % 3 == 1)
+			child.shape = PhysicsEngine::MakeBoxShape(vec3{ random.Next(0.2f, 1.0f), random.Next(0.2f, 1.0f), random.Next(0.2f, 1.0f) });
+		else
+			child.shape = PhysicsEngine::MakeCapsuleShape(random.Next(0.2f, 0.6f), random.Next(0.2f, 1.0f));
+
+		child.position = vec3{ random.Next(-size, size), random.Next(-size, size), random.Next(-size, size) };
+		child.orientation = RandomOrientation(random);
+		child.massDensity = random.Next(0.5f, 4.0f);
+	}
+
+	return PhysicsEngine::CompoundShape{ children };
+}
+
+//Returns the world position and orientation of a child of a compound, the way the compound collision functions find them.
+static void GetChildTransform(const PhysicsEngine::CompoundShape& compound, unsigned int index, const vec3& position,
+	const MathEngine::Quaternion& orientation, vec3& childPosition, MathEngine::Quaternion& childOrientation)
+{
+	const PhysicsEngine::CompoundChild& child{ compound.GetChild(index) };
+	childPosition = child.position * MathEngine::QuaternionToRotationMatrixRow3x3(orientation) + position;
+	childOrientation = orientation * child.orientation;
+}
+
+//Checks the mass properties of a compound of two boxes with different densities against the parallel axis theorem worked out by hand,
+//and checks FindChildren, CollideCompound and CollideCompounds against testing every child or every pair of children.
+static void CheckCompoundShapes()
+{
+	//A 1 x 1 x 1 box with a density of 1 at (-1, 0, 0), and a 2 x 1 x 0.5 box with a density of 3 at (2, 0.5, 0) turned 90 degrees
+	//about the y-axis, so it is 0.5 x 1 x 2 in the coordinates of the compound.
+	std::vector<PhysicsEngine::CompoundChild> boxes(2);
+	boxes[0].shape = PhysicsEngine::MakeBoxShape(vec3{ 0.5f, 0.5f, 0.5f });
+	boxes[0].position = vec3{ -1.0f, 0.0f, 0.0f };
+	boxes[0].massDensity = 1.0f;
+	boxes[1].shape = PhysicsEngine::MakeBoxShape(vec3{ 1.0f, 0.5f, 0.25f });
+	boxes[1].position = vec3{ 2.0f, 0.5f, 0.0f };
+	boxes[1].orientation = MathEngine::RotationQuaternion(90.0f, vec3{ 0.0f, 1.0f, 0.0f });
+	boxes[1].massDensity = 3.0f;
+	PhysicsEngine::CompoundShape twoBoxes{ boxes };
+
+	//The covariance of a box of mass m is m / 12 times the squares of its sizes on the diagonal, and moving it by d adds m * d^T d.
+	const double masses[2]{ 1.0, 3.0 };
+	const double sizes[2][3]{ { 1.0, 1.0, 1.0 }, { 0.5, 1.0, 2.0 } };
+	const double positions[2][3]{ { -1.0, 0.0, 0.0 }, { 2.0, 0.5, 0.0 } };
+	double centerOfMass[3]{};
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			centerOfMass[j] += masses[i] * positions[i][j] / 4.0;
+		}
+	}
+
+	double covariance[3][3]{};
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		for (unsigned int row = 0; row < 3; ++row)
+		{
+			for (unsigned int column = 0; column < 3; ++column)
+			{
+				double d{ (positions[i][row] - centerOfMass[row]) * (positions[i][column] - centerOfMass[column]) };
+				covariance[row][column] += masses[i] * d + ((row == column) ? masses[i] * sizes[i][row] * sizes[i][row] / 12.0 : 0.0);
+			}
+		}
+	}
+
+	const PhysicsEngine::MassProperties& massProperties{ twoBoxes.GetMassProperties() };
+	const vec3& offset{ twoBoxes.GetCenterOfMassOffset() };
+	double massError{ std::fabs(massProperties.mass - 4.0) };
+	massError = std::max(massError, std::fabs(offset.x - centerOfMass[0]));
+	massError = std::max(massError, std::fabs(offset.y - centerOfMass[1]));
+	massError = std::max(massError, std::fabs(offset.z - centerOfMass[2]));
+	for (unsigned int row = 0; row < 3; ++row)
+	{
+		for (unsigned int column = 0; column < 3; ++column)
+		{
+			massError = std::max(massError, std::fabs(massProperties.covariance(row, column) - covariance[row][column]));
+		}
+	}
+
+	Random random{ 44 };
+
+	//FindChildren has to return every child whose bounds overlap the box, and only those.
+	const unsigned int numChildren{ 300 };
+	const unsigned int numQueries{ 2000 };
+	PhysicsEngine::CompoundShape compound{ CreateRandomCompound(random, numChildren, 10.0f) };
+	std::vector<vec3> childMins(numChildren);
+	std::vector<vec3> childMaxs(numChildren);
+	for (unsigned int i = 0; i < numChildren; ++i)
+	{
+		const PhysicsEngine::CompoundChild& child{ compound.GetChild(i) };
+		PhysicsEngine::ComputeShapeBounds(child.shape, child.position, child.orientation, childMins[i], childMaxs[i]);
+	}
+
+	bool sameChildren{ true };
+	unsigned long long numFound{ 0 };
+	std::vector<unsigned int> found;
+	std::vector<unsigned int> expected;
+	for (unsigned int i = 0; i < numQueries; ++i)
+	{
+		vec3 center{ random.Next(-12.0f, 12.0f), random.Next(-12.0f, 12.0f), random.Next(-12.0f, 12.0f) };
+		vec3 halfWidths{ random.Next(0.1f, 3.0f), random.Next(0.1f, 3.0f), random.Next(0.1f, 3.0f) };
+		vec3 min{ center - halfWidths };
+		vec3 max{ center + halfWidths };
+
+		compound.FindChildren(min, max, found);
+		std::sort(found.begin(), found.end());
+
+		expected.clear();
+		for (unsigned int j = 0; j < numChildren; ++j)
+		{
+			if (childMins[j].x <= max.x && childMaxs[j].x >= min.x && childMins[j].y <= max.y && childMaxs[j].y >= min.y &&
+				childMins[j].z <= max.z && childMaxs[j].z >= min.z)
+				expected.push_back(j);
+		}
+
+		sameChildren = sameChildren && found == expected;
+		numFound += found.size();
+	}
+
+	//CollideCompound has to find a contact with every child that intersects the shape, and nothing else.
+	const unsigned int numPlacements{ 500 };
+	PhysicsEngine::CollisionShape shapes[3]{ PhysicsEngine::MakeSphereShape(2.0f), PhysicsEngine::MakeBoxShape(vec3{ 1.5f, 2.0f, 1.0f }),
+		PhysicsEngine::MakeCapsuleShape(1.0f, 2.0f) };
+	vec3 positionA{ random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f) };
+	MathEngine::Quaternion orientationA{ RandomOrientation(random) };
+
+	bool sameShapeContacts{ true };
+	unsigned long long numShapeContacts{ 0 };
+	std::vector<PhysicsEngine::CompoundContact> contacts;
+	for (unsigned int i = 0; i < numPlacements; ++i)
+	{
+		const PhysicsEngine::CollisionShape& b{ shapes[i % 3] };
+		vec3 positionB{ positionA + vec3{ random.Next(-12.0f, 12.0f), random.Next(-12.0f, 12.0f), random.Next(-12.0f, 12.0f) } };
+		MathEngine::Quaternion orientationB{ RandomOrientation(random) };
+
+		contacts.clear();
+		PhysicsEngine::CollideCompound(compound, positionA, orientationA, b, positionB, orientationB, contacts);
+
+		found.clear();
+		for (const auto& j : contacts)
+		{
+			found.push_back(j.childA);
+			sameShapeContacts = sameShapeContacts && j.childB == PhysicsEngine::NO_CHILD;
+		}
+		std::sort(found.begin(), found.end());
+
+		expected.clear();
+		for (unsigned int j = 0; j < numChildren; ++j)
+		{
+			vec3 childPosition;
+			MathEngine::Quaternion childOrientation;
+			GetChildTransform(compound, j, positionA, orientationA, childPosition, childOrientation);
+
+			PhysicsEngine::ContactManifold manifold;
+			if (PhysicsEngine::Collide(compound.GetChild(j).shape, childPosition, childOrientation, b, positionB, orientationB, manifold))
+				expected.push_back(j);
+		}
+
+		sameShapeContacts = sameShapeContacts && found == expected;
+		numShapeContacts += contacts.size();
+	}
+
+	//CollideCompounds has to find a contact for every pair of children that intersect, and nothing else.
+	const unsigned int numSmallChildren{ 40 };
+	PhysicsEngine::CompoundShape compoundA{ CreateRandomCompound(random, numSmallChildren, 4.0f) };
+	PhysicsEngine::CompoundShape compoundB{ CreateRandomCompound(random, numSmallChildren, 4.0f) };
+
+	bool sameCompoundContacts{ true };
+	unsigned long long numCompoundContacts{ 0 };
+	std::vector<std::pair<unsigned int, unsigned int>> foundPairs;
+	std::vector<std::pair<unsigned int, unsigned int>> expectedPairs;
+	for (unsigned int i = 0; i < numPlacements; ++i)
+	{
+		vec3 positionB{ positionA + vec3{ random.Next(-8.0f, 8.0f), random.Next(-8.0f, 8.0f), random.Next(-8.0f, 8.0f) } };
+		MathEngine::Quaternion orientationB{ RandomOrientation(random) };
+
+		contacts.clear();
+		PhysicsEngine::CollideCompounds(compoundA, positionA, orientationA, compoundB, positionB, orientationB, contacts);
+
+		foundPairs.clear();
+		for (const auto& j : contacts)
+		{
+			foundPairs.push_back(std::make_pair(j.childA, j.childB));
+		}
+		std::sort(foundPairs.begin(), foundPairs.end());
+
+		expectedPairs.clear();
+		for (unsigned int j = 0; j < numSmallChildren; ++j)
+		{
+			vec3 childPositionA;
+			MathEngine::Quaternion childOrientationA;
+			GetChildTransform(compoundA, j, positionA, orientationA, childPositionA, childOrientationA);
+
+			for (unsigned int k = 0; k < numSmallChildren; ++k)
+			{
+				vec3 childPositionB;
+				MathEngine::Quaternion childOrientationB;
+				GetChildTransform(compoundB, k, positionB, orientationB, childPositionB, childOrientationB);
+
+				PhysicsEngine::ContactManifold manifold;
+				if (PhysicsEngine::Collide(compoundA.GetChild(j).shape, childPositionA, childOrientationA, compoundB.GetChild(k).shape,
+					childPositionB, childOrientationB, manifold))
+					expectedPairs.push_back(std::make_pair(j, k));
+			}
+		}
+
+		sameCompoundContacts = sameCompoundContacts && foundPairs == expectedPairs;
+		numCompoundContacts += contacts.size();
+	}
+
+	std::cout << std::left << std::setw(16) << "compound shapes" << std::right <<
+		std::setw(12) << std::scientific << std::setprecision(2) << massError << std::defaultfloat << " mass error" <<
+		std::setw(8) << std::fixed << std::setprecision(1) << (double)numFound / numQueries << std::defaultfloat << " of " << numChildren << " children found" <<
+		std::setw(8) << numShapeContacts << " shape contacts" <<
+		std::setw(8) << numCompoundContacts << " compound contacts" <<
+		"  mass: " << Check(massError < 1e-5) <<
+		"  find: " << Check(sameChildren) <<
+		"  shape: " << Check(sameShapeContacts && numShapeContacts > 0) <<
+		"  compounds: " << Check(sameCompoundContacts && numCompoundContacts > 0) << "\n";
+}
+
+//Places shapes whose mesh origin is not their center of mass near an origin far from (0, 0, 0) and checks that the camera relative
+//transforms are the model matrices of the instances with the camera position subtracted.
+static void CheckCameraRelativeTransforms()
+{
+	PhysicsEngine::ShapeAssetLibrary assets;
+	std::vector<ShapesEngine::Vertex> vertices;
+	std::vector<ShapesEngine::Triangle> triangles;
+
+	ShapesEngine::CreateBox(vertices, triangles);
+	assets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_BOX);
+	ShapesEngine::CreateCone(vertices, triangles);
+	assets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_CONE);
+	ShapesEngine::CreatePyramid(vertices, triangles);
+	assets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_PYRAMID);
+
+	PhysicsEngine::FloatingOrigin origin;
+	origin.UpdateOrigin(PhysicsEngine::WorldPosition{ 3000000.0, -20000.0, 1500000.0 });
+
+	const unsigned int numBodies{ 300 };
+	Random random{ 50 };
+	PhysicsEngine::RigidBodyArrays bodies;
+	std::vector<PhysicsEngine::ShapeInstance> instances(numBodies);
+	std::vector<mat4> localModels(numBodies);
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		PhysicsEngine::ShapeInstance& instance{ instances[i] };
+		instance.shape = i % assets.GetNumberOfShapes();
+		instance.position = vec3{ random.Next(-50.0f, 50.0f), random.Next(-50.0f, 50.0f), random.Next(-50.0f, 50.0f) };
+		instance.orientation = RandomOrientation(random);
+		instance.scale = vec3{ random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f), random.Next(0.5f, 3.0f) };
+
+		const PhysicsEngine::ShapeAsset& shape{ assets.GetShape(instance.shape) };
+		PhysicsEngine::RigidBody body;
+		PhysicsEngine::InitializeRigidBody(body, 1.0f, shape, instance);
+		PhysicsEngine::AddRigidBody(bodies, body);
+
+		localModels[i] = PhysicsEngine::ComputeLocalModelMatrix(shape, instance.scale);
+	}
+
+	vec3 camera{ random.Next(-20.0f, 20.0f), random.Next(-20.0f, 20.0f), random.Next(-20.0f, 20.0f) };
+	std::vector<mat4> transforms;
+	origin.ComputeCameraRelativeTransforms(bodies, localModels.data(), origin.ToWorld(camera), transforms);
+
+	float maxError{ 0.0f };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		mat4 expected{ PhysicsEngine::ComputeModelMatrix(instances[i]) };
+		expected.SetRow(3, vec4{ expected(3, 0) - camera.x, expected(3, 1) - camera.y, expected(3, 2) - camera.z, 1.0f });
+
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			for (unsigned int column = 0; column < 4; ++column)
+			{
+				float scale{ std::max(1.0f, std::fabs(expected(row, column))) };
+				maxError = std::max(maxError, std::fabs(transforms[i](row, column) - expected(row, column)) / scale);
+			}
+		}
+	}
+
+	std::cout << std::left << std::setw(16) << "camera relative" << std::right <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(12) << std::scientific << std::setprecision(2) << maxError << std::defaultfloat << " max error" <<
+		"  model matrices: " << Check(maxError < 1e-5f) << "\n";
+}
+
+void RunChecks()
+{
+	CheckSceneQueries();
+	CheckShapeAssets();
+	CheckBoundingVolumeArrays();
+	CheckCompoundShapes();
+	CheckCameraRelativeTransforms();
+}
\ No newline at end of file
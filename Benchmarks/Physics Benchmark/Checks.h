@@ -0,0 +1,44 @@
+#pragma once
+
+#include "SceneQueries.h"
+#include <vector>
+
+//The correctness checks of the physics benchmark.
+//The timed measurements in main.cpp record the checks they make on their own results with Check, and the checks that do not
+//need timing are in Checks.cpp and are run by RunChecks. The benchmark exits with a failure code if any check failed.
+
+//Records the result of a check and returns "yes" if it passed or "NO" if it failed, so the result can be printed.
+const char* Check(bool passed);
+
+//Returns the number of checks that failed.
+unsigned int GetNumberOfFailedChecks();
+
+//Returns the number of checks that were made.
+unsigned int GetNumberOfChecks();
+
+//Runs the checks that do not need timing and prints their results.
+void RunChecks();
+
+//A scene of spheres, AABBs and triangles for the scene queries, with the arrays and hierarchies the QueryScene points to.
+struct QueryTestScene
+{
+	std::vector<PhysicsEngine::Sphere> spheres;
+	std::vector<PhysicsEngine::AABB> boxes;
+	std::vector<ShapesEngine::Vertex> vertices;
+	std::vector<ShapesEngine::Triangle> triangles;
+
+	PhysicsEngine::QueryVolumeBVH volumeBVH;
+	PhysicsEngine::TriangleMeshCollider triangleMesh;
+
+	PhysicsEngine::QueryScene scene;
+};
+
+//Fills the scene with the specified number of spheres, AABBs and triangles each, spread over a cube from -size to size,
+//and builds the hierarchies over them.
+void CreateQueryScene(QueryTestScene& scene, unsigned int numVolumesPerType, float size, unsigned int seed);
+
+//Creates rays that start in a cube from -size to size and go in random directions.
+void CreateQueryRays(std::vector<PhysicsEngine::Ray>& rays, unsigned int numRays, float size, unsigned int seed);
+
+//Finds the closest hit of each ray by testing it against every volume one at a time, without packets.
+void CastRaysScalar(const PhysicsEngine::QueryScene& scene, const PhysicsEngine::Ray* rays, unsigned int numRays, PhysicsEngine::QueryHit* hits);
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "MathEngine.h"
+
+//A xorshift generator, so the scenarios are the same with every standard library.
+struct Random
+{
+	unsigned int state;
+
+	float Next(float min, float max)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return min + (max - min) * ((state >> 8) * (1.0f / 16777216.0f));
+	}
+};
+
+inline MathEngine::Quaternion RandomOrientation(Random& random)
+{
+	return MathEngine::RotationQuaternion(random.Next(0.0f, 360.0f), vec3{ random.Next(-1.0f, 1.0f), random.Next(-1.0f, 1.0f), 1.0f });
+}
\ No newline at end of file
@@ -0,0 +1,1950 @@
+#include "RigidBodyArrays.h"
+#include "ForceGenerators.h"
+#include "PrimitiveMassProperties.h"
+#include "StepProfiler.h"
+#include "WorldSnapshot.h"
+#include "RollbackWorld.h"
+#include "ConvexHull.h"
+#include "TriangleMeshCollider.h"
+#include "Narrowphase.h"
+#include "ContactSolver.h"
+#include "Broadphase.h"
+#include "TriggerSystem.h"
+#include "WorldBatch.h"
+#include "BodyPackets.h"
+#include "AdaptiveStepper.h"
+#include "LargeWorld.h"
+#include "CreateShapes.h"
+#include "Checks.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+//Runs the standard physics scenarios and reports steps per second, nanoseconds per body per step and energy drift.
+//The bodies are RigidBody objects that are loaded into a RigidBodyArrays object, pushed by the force generators and integrated
+//with RigidBody::Integrate each step.
+//In the stacks and pile scenarios the bodies also collide with each other and with a ground plane, so their steps run the broadphase,
+//the narrowphase and the contact solver between the forces and the integration.
+//Every scenario uses a fixed seed so runs are comparable.
+//
+//Usage: PhysicsBenchmark [scale]
+//scale multiplies the number of bodies in every scenario, the default is 1.
+//The benchmark exits with EXIT_FAILURE if any of its checks failed, see Checks.h.
+
+enum Meshes { MESH_BOX = 0, MESH_CONE, MESH_CYLINDER, MESH_SPHERE, MESH_PYRAMID, NUM_MESHES };
+
+//Keeps the compiler from removing work whose result is never used. The old value is read, so the sink is never only written.
+static volatile float gSink{ 0.0f };
+
+static void KeepResult(float value)
+{
+	gSink = gSink + value;
+}
+
+struct Scenario
+{
+	const char* name{ "" };
+
+	std::vector<PhysicsEngine::RigidBody> bodies;
+	PhysicsEngine::RigidBodyArrays arrays;
+	PhysicsEngine::ForceGeneratorRegistry forceGenerators;
+
+	//The uniform gravity acceleration, used for the potential energy.
+	vec3 gravity;
+
+	//The gravitational constant of the mutual gravity between the bodies. If it is 0 there is no mutual gravity.
+	float gravitationalConstant{ 0.0f };
+	float softening{ 0.0f };
+
+	float dt{ 1.0f / 60.0f };
+	unsigned int numSteps{ 0 };
+
+	//The collision shape of each body. If there are no shapes the bodies do not collide.
+	//The convex shapes point to the hulls, so the hulls are reserved up front and never reallocated.
+	std::vector<PhysicsEngine::CollisionShape> shapes;
+	std::vector<PhysicsEngine::ConvexHull> hulls;
+
+	//If true the bodies also collide with a ground plane at y = 0.
+	bool ground{ false };
+
+	PhysicsEngine::Broadphase broadphase;
+	PhysicsEngine::ContactSolver solver;
+	std::vector<unsigned int> groundBodies;
+	std::vector<PhysicsEngine::ContactConstraint> contacts;
+};
+
+//The ground plane is the top face of a large static box.
+static const PhysicsEngine::CollisionShape gGroundShape{ PhysicsEngine::MakeBoxShape(vec3{ 1000.0f, 10.0f, 1000.0f }) };
+static const vec3 gGroundPosition{ 0.0f, -10.0f, 0.0f };
+
+//Returns the exact mass properties of the unit primitive. The meshes are in the same order as the primitive types.
+static const PhysicsEngine::MassProperties& GetMassProperties(Meshes mesh)
+{
+	static PhysicsEngine::MassProperties massProperties[NUM_MESHES];
+	static bool computed{ false };
+
+	if (!computed)
+	{
+		for (unsigned int i = 0; i < NUM_MESHES; ++i)
+		{
+			PhysicsEngine::ComputeMassProperties((PhysicsEngine::PrimitiveType)i, massProperties[i]);
+		}
+
+		computed = true;
+	}
+
+	return massProperties[mesh];
+}
+
+//Adds a body made from the mesh with the specified dimensions. The local origin of the mesh is placed at the position.
+static PhysicsEngine::RigidBody& AddBody(Scenario& scenario, Meshes mesh, float massDensity, const vec3& dimensions,
+	const vec3& position, const MathEngine::Quaternion& orientation)
+{
+	scenario.bodies.emplace_back();
+	PhysicsEngine::RigidBody& body{ scenario.bodies.back() };
+
+	body.InitializeRigidBody(massDensity, orientation, GetMassProperties(mesh), MathEngine::Scale(dimensions));
+	body.SetCenterOfMass(position + body.GetCenterOfMass() * MathEngine::QuaternionToRotationMatrixRow3x3(orientation));
+
+	return body;
+}
+
+//Returns the vertices of the unit mesh. The meshes are created the first time they are used.
+static const std::vector<ShapesEngine::Vertex>& GetMeshVertices(Meshes mesh)
+{
+	static std::vector<ShapesEngine::Vertex> vertices[NUM_MESHES];
+
+	if (vertices[mesh].empty())
+	{
+		std::vector<ShapesEngine::Triangle> triangles;
+
+		switch (mesh)
+		{
+		case MESH_BOX:
+			ShapesEngine::CreateBox(vertices[mesh], triangles);
+			break;
+
+		case MESH_CONE:
+			ShapesEngine::CreateCone(vertices[mesh], triangles);
+			break;
+
+		case MESH_CYLINDER:
+			ShapesEngine::CreateCylinder(vertices[mesh], triangles);
+			break;
+
+		case MESH_SPHERE:
+			ShapesEngine::CreateSphere(vertices[mesh], triangles);
+			break;
+
+		default:
+			ShapesEngine::CreatePyramid(vertices[mesh], triangles);
+			break;
+		}
+	}
+
+	return vertices[mesh];
+}
+
+//Adds the collision shape of the last body added, made from the mesh with the specified dimensions.
+//Boxes, round spheres and round cylinders use their own shape. Every other body uses the convex hull of its scaled mesh,
+//moved so the center of mass is at the origin like the body.
+static void AddCollisionShape(Scenario& scenario, Meshes mesh, const vec3& dimensions)
+{
+	if (mesh == MESH_BOX)
+	{
+		scenario.shapes.push_back(PhysicsEngine::MakeBoxShape(dimensions * 0.5f));
+		return;
+	}
+
+	if (mesh == MESH_SPHERE && dimensions.x == dimensions.y && dimensions.x == dimensions.z)
+	{
+		scenario.shapes.push_back(PhysicsEngine::MakeSphereShape(dimensions.x));
+		return;
+	}
+
+	if (mesh == MESH_CYLINDER && dimensions.x == dimensions.z)
+	{
+		scenario.shapes.push_back(PhysicsEngine::MakeCylinderShape(dimensions.x, 0.5f * dimensions.y));
+		return;
+	}
+
+	const std::vector<ShapesEngine::Vertex>& vertices{ GetMeshVertices(mesh) };
+	vec3 centerOfMass{ GetMassProperties(mesh).centerOfMass * MathEngine::Scale(dimensions) };
+
+	std::vector<vec3> points(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		points[i] = vertices[i].position * MathEngine::Scale(dimensions) - centerOfMass;
+	}
+
+	scenario.hulls.emplace_back();
+	PhysicsEngine::ComputeConvexHull(points.data(), (unsigned int)points.size(), scenario.hulls.back(), 32);
+	scenario.shapes.push_back(PhysicsEngine::MakeConvexShape(scenario.hulls.back()));
+}
+
+//Registers the force generators and copies the bodies into the arrays once all the bodies are added.
+//If the bodies have collision shapes they are also added to the broadphase.
+static void FinishScenario(Scenario& scenario, const vec3& gravity)
+{
+	PhysicsEngine::ReserveBodies(scenario.arrays, (unsigned int)scenario.bodies.size());
+	for (const auto& i : scenario.bodies)
+	{
+		PhysicsEngine::AddRigidBody(scenario.arrays, i);
+	}
+
+	for (size_t i = 0; i < scenario.shapes.size(); ++i)
+	{
+		vec3 min;
+		vec3 max;
+		PhysicsEngine::ComputeShapeBounds(scenario.shapes[i], scenario.bodies[i].GetCenterOfMass(), scenario.bodies[i].GetOrientation(), min, max);
+		scenario.broadphase.AddBody(min, max);
+	}
+
+	scenario.gravity = gravity;
+	if (MathEngine::Length(gravity) > 0.0f)
+	{
+		PhysicsEngine::BodyRange allBodies{ 0, (unsigned int)scenario.bodies.size() };
+		scenario.forceGenerators.RegisterUniformGravity(MathEngine::Length(gravity), gravity, allBodies);
+	}
+}
+
+//Mixed shapes from CreateShapes with random sizes, orientations and spins falling from random heights.
+static void CreateFreeFall(Scenario& scenario, unsigned int numBodies)
+{
+	scenario.name = "free fall";
+	scenario.numSteps = 300;
+
+	Random random{ 1 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		vec3 dimensions{ random.Next(0.5f, 2.0f), random.Next(0.5f, 2.0f), random.Next(0.5f, 2.0f) };
+		vec3 position{ random.Next(-100.0f, 100.0f), random.Next(10.0f, 200.0f), random.Next(-100.0f, 100.0f) };
+
+		PhysicsEngine::RigidBody& body{ AddBody(scenario, (Meshes)(i % NUM_MESHES), random.Next(0.5f, 2.0f), dimensions, position,
+			RandomOrientation(random)) };
+
+		body.SetAngularVelocity(vec3{ random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f), random.Next(-2.0f, 2.0f) });
+	}
+
+	FinishScenario(scenario, vec3{ 0.0f, -9.81f, 0.0f });
+}
+
+//Small spheres in circular orbits around a heavy sphere, with mutual gravity between every pair of bodies.
+static void CreateOrbital(Scenario& scenario, unsigned int numBodies)
+{
+	scenario.name = "orbital n-body";
+	scenario.numSteps = 100;
+	scenario.dt = 0.01f;
+	scenario.gravitationalConstant = 1.0f;
+	scenario.softening = 0.1f;
+
+	Random random{ 2 };
+
+	PhysicsEngine::RigidBody& star{ AddBody(scenario, MESH_SPHERE, 10000.0f, vec3{ 2.0f, 2.0f, 2.0f }, vec3{}, MathEngine::Quaternion{}) };
+	float starMass{ star.GetMass() };
+
+	for (unsigned int i = 1; i < numBodies; ++i)
+	{
+		float radius{ random.Next(20.0f, 200.0f) };
+		float angle{ random.Next(0.0f, PI2) };
+		vec3 position{ radius * std::cos(angle), random.Next(-2.0f, 2.0f), radius * std::sin(angle) };
+
+		PhysicsEngine::RigidBody& body{ AddBody(scenario, MESH_SPHERE, 1.0f, vec3{ 0.2f, 0.2f, 0.2f }, position, MathEngine::Quaternion{}) };
+
+		//v = sqrt(GM / r) for a circular orbit.
+		float speed{ std::sqrt(scenario.gravitationalConstant * starMass / radius) };
+		body.SetLinearMomentum(vec3{ -std::sin(angle), 0.0f, std::cos(angle) } * (speed * body.GetMass()));
+	}
+
+	FinishScenario(scenario, vec3{});
+}
+
+//Columns of boxes resting on top of each other on the ground.
+static void CreateStacks(Scenario& scenario, unsigned int numBodies)
+{
+	scenario.name = "stacks";
+	scenario.numSteps = 300;
+	scenario.ground = true;
+
+	const unsigned int stackHeight{ 10 };
+	unsigned int numStacks{ (numBodies + stackHeight - 1) / stackHeight };
+	unsigned int stacksPerRow{ (unsigned int)std::ceil(std::sqrt((float)numStacks)) };
+
+	Random random{ 3 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		unsigned int stack{ i / stackHeight };
+		vec3 position{ (stack % stacksPerRow) * 3.0f, (i % stackHeight) * 1.0f + 0.5f, (stack / stacksPerRow) * 3.0f };
+
+		//A small random offset and twist per box, like a stack built by hand.
+		position += vec3{ random.Next(-0.05f, 0.05f), 0.0f, random.Next(-0.05f, 0.05f) };
+		MathEngine::Quaternion orientation{ MathEngine::RotationQuaternion(random.Next(-5.0f, 5.0f), vec3{ 0.0f, 1.0f, 0.0f }) };
+
+		AddBody(scenario, MESH_BOX, 1.0f, vec3{ 1.0f, 1.0f, 1.0f }, position, orientation);
+		AddCollisionShape(scenario, MESH_BOX, vec3{ 1.0f, 1.0f, 1.0f });
+	}
+
+	FinishScenario(scenario, vec3{ 0.0f, -9.81f, 0.0f });
+}
+
+//Mixed shapes packed densely in a heap on the ground.
+static void CreatePile(Scenario& scenario, unsigned int numBodies)
+{
+	scenario.name = "pile";
+	scenario.numSteps = 300;
+	scenario.ground = true;
+	scenario.hulls.reserve(numBodies);
+
+	//The heap is a cone of bodies. Its base radius grows with the number of bodies so the density stays the same.
+	float baseRadius{ std::cbrt((float)numBodies) * 1.5f };
+
+	Random random{ 4 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		float height{ random.Next(0.0f, 1.0f) };
+		float radius{ baseRadius * (1.0f - height) * std::sqrt(random.Next(0.0f, 1.0f)) };
+		float angle{ random.Next(0.0f, PI2) };
+		vec3 position{ radius * std::cos(angle), height * baseRadius + 0.5f, radius * std::sin(angle) };
+
+		vec3 dimensions{ random.Next(0.4f, 1.0f), random.Next(0.4f, 1.0f), random.Next(0.4f, 1.0f) };
+		AddBody(scenario, (Meshes)(i % NUM_MESHES), 1.0f, dimensions, position, RandomOrientation(random));
+		AddCollisionShape(scenario, (Meshes)(i % NUM_MESHES), dimensions);
+	}
+
+	FinishScenario(scenario, vec3{ 0.0f, -9.81f, 0.0f });
+}
+
+//Adds the softened gravitational force between every pair of bodies to the net forces.
+static void AddMutualGravity(PhysicsEngine::RigidBodyArrays& arrays, float gravitationalConstant, float softening)
+{
+	unsigned int numBodies{ PhysicsEngine::GetNumberOfBodies(arrays) };
+	float softeningSquared{ softening * softening };
+
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		float x{ arrays.centerOfMassX[i] };
+		float y{ arrays.centerOfMassY[i] };
+		float z{ arrays.centerOfMassZ[i] };
+		float gm{ gravitationalConstant * arrays.mass[i] };
+
+		float fx{ 0.0f };
+		float fy{ 0.0f };
+		float fz{ 0.0f };
+
+		for (unsigned int j = i + 1; j < numBodies; ++j)
+		{
+			float dx{ arrays.centerOfMassX[j] - x };
+			float dy{ arrays.centerOfMassY[j] - y };
+			float dz{ arrays.centerOfMassZ[j] - z };
+
+			float distanceSquared{ dx * dx + dy * dy + dz * dz + softeningSquared };
+			float inverseDistance{ 1.0f / std::sqrt(distanceSquared) };
+			float f{ gm * arrays.mass[j] * inverseDistance * inverseDistance * inverseDistance };
+
+			fx += f * dx;
+			fy += f * dy;
+			fz += f * dz;
+
+			arrays.netForceX[j] -= f * dx;
+			arrays.netForceY[j] -= f * dy;
+			arrays.netForceZ[j] -= f * dz;
+		}
+
+		arrays.netForceX[i] += fx;
+		arrays.netForceY[i] += fy;
+		arrays.netForceZ[i] += fz;
+	}
+}
+
+//Adds a contact constraint for each point of the manifold between bodies a and b.
+static void AddContacts(const PhysicsEngine::ContactManifold& manifold, unsigned int a, unsigned int b,
+	std::vector<PhysicsEngine::ContactConstraint>& contacts)
+{
+	for (unsigned int i = 0; i < manifold.numPoints; ++i)
+	{
+		PhysicsEngine::ContactConstraint contact;
+		contact.bodyA = a;
+		contact.bodyB = b;
+		contact.normal = manifold.normal;
+		contact.point = manifold.points[i];
+		contact.depth = manifold.depths[i];
+		contacts.push_back(contact);
+	}
+}
+
+//Updates the bounds of the bodies, finds their pairs with the broadphase, collides the pairs and the bodies that reach the ground,
+//and solves the contacts. The forces have to be in the arrays, the solver adds the contact impulses to them.
+static void SolveCollisions(Scenario& scenario, PhysicsEngine::StepProfiler& profiler)
+{
+	const PhysicsEngine::RigidBodyArrays& arrays{ scenario.arrays };
+	unsigned int numBodies{ (unsigned int)scenario.shapes.size() };
+
+	profiler.BeginPhase(PhysicsEngine::PHASE_BOUNDING_VOLUMES);
+
+	scenario.groundBodies.clear();
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		vec3 min;
+		vec3 max;
+		PhysicsEngine::ComputeShapeBounds(scenario.shapes[i], PhysicsEngine::GetCenterOfMass(arrays, i), PhysicsEngine::GetOrientation(arrays, i),
+			min, max);
+		scenario.broadphase.SetBounds(i, min, max);
+
+		if (scenario.ground && min.y < 0.0f)
+			scenario.groundBodies.push_back(i);
+	}
+
+	profiler.EndPhase(PhysicsEngine::PHASE_BOUNDING_VOLUMES);
+
+	scenario.broadphase.FindPairs(&profiler);
+
+	profiler.BeginPhase(PhysicsEngine::PHASE_NARROWPHASE);
+
+	scenario.contacts.clear();
+	for (const auto& i : scenario.broadphase.GetPairs())
+	{
+		PhysicsEngine::ContactManifold manifold;
+		if (PhysicsEngine::Collide(scenario.shapes[i.bodyA], PhysicsEngine::GetCenterOfMass(arrays, i.bodyA), PhysicsEngine::GetOrientation(arrays, i.bodyA),
+			scenario.shapes[i.bodyB], PhysicsEngine::GetCenterOfMass(arrays, i.bodyB), PhysicsEngine::GetOrientation(arrays, i.bodyB), manifold))
+		{
+			AddContacts(manifold, i.bodyA, i.bodyB, scenario.contacts);
+		}
+	}
+
+	for (unsigned int i : scenario.groundBodies)
+	{
+		PhysicsEngine::ContactManifold manifold;
+		if (PhysicsEngine::Collide(gGroundShape, gGroundPosition, MathEngine::Quaternion{},
+			scenario.shapes[i], PhysicsEngine::GetCenterOfMass(arrays, i), PhysicsEngine::GetOrientation(arrays, i), manifold))
+		{
+			AddContacts(manifold, PhysicsEngine::INVALID_BODY, i, scenario.contacts);
+		}
+	}
+
+	profiler.AddContacts((unsigned int)scenario.contacts.size());
+	profiler.EndPhase(PhysicsEngine::PHASE_NARROWPHASE);
+
+	scenario.solver.SolveContacts(scenario.arrays, scenario.contacts, scenario.dt, &profiler);
+}
+
+static void Step(Scenario& scenario, PhysicsEngine::StepProfiler& profiler)
+{
+	unsigned int numBodies{ (unsigned int)scenario.bodies.size() };
+
+	profiler.BeginStep();
+	profiler.SetBodyCounts(numBodies, numBodies);
+
+	profiler.BeginPhase(PhysicsEngine::PHASE_FORCES);
+
+	//Copying the bodies into the arrays also clears their force and torque accumulators.
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		PhysicsEngine::LoadRigidBody(scenario.arrays, i, scenario.bodies[i]);
+	}
+
+	scenario.forceGenerators.ApplyForceGenerators(scenario.arrays);
+
+	if (scenario.gravitationalConstant > 0.0f)
+		AddMutualGravity(scenario.arrays, scenario.gravitationalConstant, scenario.softening);
+
+	profiler.EndPhase(PhysicsEngine::PHASE_FORCES);
+
+	if (!scenario.shapes.empty())
+		SolveCollisions(scenario, profiler);
+
+	profiler.BeginPhase(PhysicsEngine::PHASE_INTEGRATION);
+
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		scenario.bodies[i].Integrate(PhysicsEngine::GetNetForce(scenario.arrays, i), PhysicsEngine::GetNetTorque(scenario.arrays, i), scenario.dt);
+	}
+
+	profiler.EndPhase(PhysicsEngine::PHASE_INTEGRATION);
+
+	profiler.EndStep();
+}
+
+//Returns the kinetic energy plus the potential energy of the uniform gravity and of the mutual gravity.
+static double TotalEnergy(const Scenario& scenario)
+{
+	double energy{ 0.0 };
+
+	for (const auto& i : scenario.bodies)
+	{
+		double mass{ i.GetMass() };
+		energy += 0.5 * mass * MathEngine::DotProduct(i.GetLinearVelocity(), i.GetLinearVelocity());
+		energy += 0.5 * MathEngine::DotProduct(i.GetAngularVelocity(), i.GetAngularMomentum());
+		energy -= mass * MathEngine::DotProduct(scenario.gravity, i.GetCenterOfMass());
+	}
+
+	if (scenario.gravitationalConstant > 0.0f)
+	{
+		double softeningSquared{ (double)scenario.softening * scenario.softening };
+
+		for (size_t i = 0; i < scenario.bodies.size(); ++i)
+		{
+			for (size_t j = i + 1; j < scenario.bodies.size(); ++j)
+			{
+				vec3 d{ scenario.bodies[j].GetCenterOfMass() - scenario.bodies[i].GetCenterOfMass() };
+				double distance{ std::sqrt(MathEngine::DotProduct(d, d) + softeningSquared) };
+				energy -= scenario.gravitationalConstant * (double)scenario.bodies[i].GetMass() * scenario.bodies[j].GetMass() / distance;
+			}
+		}
+	}
+
+	return energy;
+}
+
+//Measures how long saving the bodies to a snapshot and restoring new bodies from it takes.
+static void MeasureSnapshot(Scenario& scenario)
+{
+	const unsigned int numRepeats{ 20 };
+	unsigned int numBodies{ (unsigned int)scenario.bodies.size() };
+
+	std::vector<unsigned char> snapshot;
+	PhysicsEngine::RigidBodyArrays restoredArrays;
+	std::vector<PhysicsEngine::RigidBody> restoredBodies(numBodies);
+
+	auto start{ std::chrono::steady_clock::now() };
+
+	for (unsigned int i = 0; i < numRepeats; ++i)
+	{
+		for (unsigned int j = 0; j < numBodies; ++j)
+		{
+			PhysicsEngine::LoadRigidBody(scenario.arrays, j, scenario.bodies[j]);
+		}
+
+		PhysicsEngine::SaveWorldSnapshot(scenario.arrays, snapshot);
+	}
+
+	auto middle{ std::chrono::steady_clock::now() };
+
+	for (unsigned int i = 0; i < numRepeats; ++i)
+	{
+		PhysicsEngine::LoadWorldSnapshot(snapshot, restoredArrays);
+	}
+
+	auto loaded{ std::chrono::steady_clock::now() };
+
+	//Rebuilding RigidBody objects from the arrays is only needed by code that steps RigidBody objects instead of the arrays.
+	for (unsigned int i = 0; i < numRepeats; ++i)
+	{
+		for (unsigned int j = 0; j < numBodies; ++j)
+		{
+			PhysicsEngine::RestoreRigidBody(restoredArrays, j, restoredBodies[j]);
+		}
+	}
+
+	auto end{ std::chrono::steady_clock::now() };
+
+	//The restored bodies have to step exactly like the original bodies.
+	Scenario restored;
+	restored.bodies = restoredBodies;
+	restored.gravity = scenario.gravity;
+	restored.gravitationalConstant = scenario.gravitationalConstant;
+	restored.softening = scenario.softening;
+	restored.dt = scenario.dt;
+	restored.arrays = restoredArrays;
+	restored.forceGenerators = scenario.forceGenerators;
+	restored.shapes = scenario.shapes;
+	restored.ground = scenario.ground;
+	restored.broadphase = scenario.broadphase;
+
+	PhysicsEngine::StepProfiler profiler;
+	Step(scenario, profiler);
+	Step(restored, profiler);
+
+	float maxError{ 0.0f };
+	for (unsigned int j = 0; j < numBodies; ++j)
+	{
+		float error{ MathEngine::Length(scenario.bodies[j].GetCenterOfMass() - restored.bodies[j].GetCenterOfMass()) };
+		if (error > maxError)
+			maxError = error;
+	}
+
+	std::cout << std::left << std::setw(16) << "  snapshot" << std::right << std::fixed <<
+		std::setw(8) << snapshot.size() / 1024 << " KB" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(middle - start).count() / numRepeats << " ms save" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(loaded - middle).count() / numRepeats << " ms restore" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(end - loaded).count() / numRepeats << " ms RigidBody rebuild" <<
+		std::setw(14) << std::scientific << std::setprecision(3) << maxError << " max position error after a step" <<
+		"  exact: " << Check(maxError == 0.0f) << "\n";
+}
+
+static void RunScenario(Scenario& scenario)
+{
+	PhysicsEngine::StepProfiler profiler(scenario.numSteps);
+	unsigned int numBodies{ (unsigned int)scenario.bodies.size() };
+
+	double startEnergy{ TotalEnergy(scenario) };
+
+	auto start{ std::chrono::steady_clock::now() };
+
+	for (unsigned int i = 0; i < scenario.numSteps; ++i)
+	{
+		Step(scenario, profiler);
+	}
+
+	auto end{ std::chrono::steady_clock::now() };
+
+	double seconds{ std::chrono::duration<double>(end - start).count() };
+	double endEnergy{ TotalEnergy(scenario) };
+	double drift{ (endEnergy - startEnergy) / (std::fabs(startEnergy) > 1e-12 ? std::fabs(startEnergy) : 1.0) };
+
+	PhysicsEngine::StepStats average{ profiler.GetAverage() };
+
+	std::cout << std::left << std::setw(16) << scenario.name << std::right <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(6) << scenario.numSteps << " steps" <<
+		std::setw(12) << std::fixed << std::setprecision(1) << scenario.numSteps / seconds << " steps/s" <<
+		std::setw(10) << std::setprecision(1) << seconds * 1e9 / ((double)scenario.numSteps * numBodies) << " ns/body/step" <<
+		std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_FORCES] << " ms forces" <<
+		std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_INTEGRATION] << " ms integration" <<
+		std::setw(14) << std::scientific << std::setprecision(3) << drift << " energy drift\n";
+
+	if (!scenario.shapes.empty())
+	{
+		std::cout << std::left << std::setw(16) << "  collisions" << std::right << std::fixed <<
+			std::setw(8) << average.numPairs << " pairs" <<
+			std::setw(8) << average.numContacts << " contacts" <<
+			std::setw(6) << average.numConstraintBatches << " batches" <<
+			std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_BOUNDING_VOLUMES] << " ms bounds" <<
+			std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_BROADPHASE] << " ms broadphase" <<
+			std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_NARROWPHASE] << " ms narrowphase" <<
+			std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_SOLVE] << " ms solve\n";
+	}
+
+	MeasureSnapshot(scenario);
+}
+
+//Sets the same inputs for a step in two different orders, so the result must not depend on the order.
+static void SetRandomInputs(PhysicsEngine::RollbackWorld& world, unsigned long long step, Random& random, unsigned int numInputs,
+	bool reverse, std::vector<PhysicsEngine::BodyInput>& inputs)
+{
+	unsigned int numBodies{ PhysicsEngine::GetNumberOfBodies(world.GetBodies()) };
+
+	inputs.clear();
+	for (unsigned int i = 0; i < numInputs; ++i)
+	{
+		PhysicsEngine::BodyInput input;
+		input.body = (unsigned int)random.Next(0.0f, (float)numBodies) % numBodies;
+		input.force = vec3{ random.Next(-50.0f, 50.0f), random.Next(0.0f, 100.0f), random.Next(-50.0f, 50.0f) };
+		input.torque = vec3{ random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f), random.Next(-5.0f, 5.0f) };
+		inputs.push_back(input);
+	}
+
+	if (reverse)
+		std::reverse(inputs.begin(), inputs.end());
+
+	world.SetInputs(step, inputs);
+}
+
+//Checks that the rollback world is deterministic and measures rewinding and re-simulating the last 8 steps of 1000 bodies.
+static void RunRollback(float scale)
+{
+	const unsigned int numSteps{ 120 };
+	const unsigned int numResimulatedSteps{ 8 };
+	const unsigned int numInputs{ 16 };
+	const unsigned int numRepeats{ 50 };
+
+	Scenario scenario;
+	CreateFreeFall(scenario, (unsigned int)(1000 * scale));
+	scenario.forceGenerators.RegisterDrag(0.1f, 0.01f, PhysicsEngine::BodyRange{ 0, (unsigned int)scenario.bodies.size() });
+
+	PhysicsEngine::RollbackWorld world;
+	PhysicsEngine::RollbackWorld reference;
+	world.InitializeRollbackWorld(scenario.arrays, scenario.forceGenerators, scenario.dt, numResimulatedSteps, numInputs);
+	reference.InitializeRollbackWorld(scenario.arrays, scenario.forceGenerators, scenario.dt, numResimulatedSteps, numInputs);
+
+	//Both worlds get the same inputs in a different order.
+	Random worldRandom{ 5 };
+	Random referenceRandom{ 5 };
+	std::vector<PhysicsEngine::BodyInput> inputs;
+	inputs.reserve(numInputs);
+
+	for (unsigned int i = 0; i < numSteps; ++i)
+	{
+		SetRandomInputs(world, world.GetCurrentStep(), worldRandom, numInputs, false, inputs);
+		world.Step();
+
+		SetRandomInputs(reference, reference.GetCurrentStep(), referenceRandom, numInputs, true, inputs);
+		reference.Step();
+	}
+
+	bool sameRuns{ PhysicsEngine::HashWorldState(world.GetBodies()) == PhysicsEngine::HashWorldState(reference.GetBodies()) };
+
+	//Re-simulating with unchanged inputs has to end in the same state.
+	unsigned long long firstStep{ world.GetCurrentStep() - numResimulatedSteps };
+	unsigned long long hashBefore{ PhysicsEngine::HashWorldState(world.GetBodies()) };
+
+	unsigned long long allocations{ PhysicsEngine::GetAllocationCount() };
+	auto start{ std::chrono::steady_clock::now() };
+
+	for (unsigned int i = 0; i < numRepeats; ++i)
+	{
+		world.Resimulate(firstStep);
+	}
+
+	auto end{ std::chrono::steady_clock::now() };
+	allocations = PhysicsEngine::GetAllocationCount() - allocations;
+
+	bool sameResimulation{ PhysicsEngine::HashWorldState(world.GetBodies()) == hashBefore };
+
+	//A late input for an old step changes the result, and re-simulating has to match a world that had the input from the start.
+	Random lateRandom{ 6 };
+	SetRandomInputs(world, firstStep, lateRandom, numInputs, false, inputs);
+	world.Resimulate(firstStep);
+
+	lateRandom = Random{ 6 };
+	reference.Rewind(firstStep);
+	SetRandomInputs(reference, firstStep, lateRandom, numInputs, true, inputs);
+	for (unsigned int i = 0; i < numResimulatedSteps; ++i)
+	{
+		reference.Step();
+	}
+
+	unsigned long long hashAfter{ PhysicsEngine::HashWorldState(world.GetBodies()) };
+	bool sameLateInput{ hashAfter != hashBefore && hashAfter == PhysicsEngine::HashWorldState(reference.GetBodies()) };
+
+	std::cout << std::left << std::setw(16) << "rollback" << std::right <<
+		std::setw(8) << PhysicsEngine::GetNumberOfBodies(world.GetBodies()) << " bodies" <<
+		std::setw(6) << numResimulatedSteps << " steps" <<
+		std::setw(10) << std::fixed << std::setprecision(3) <<
+		std::chrono::duration<double, std::milli>(end - start).count() / numRepeats << " ms rewind and re-simulate" <<
+		std::setw(6) << allocations << " allocations" <<
+		"  deterministic: " << Check(sameRuns) <<
+		"  re-simulation: " << Check(sameResimulation) <<
+		"  late input: " << Check(sameLateInput) << "\n";
+}
+
+//Compares finding support points on the render meshes by testing every vertex with hill climbing on their reduced convex hulls.
+static void MeasureConvexHulls()
+{
+	const unsigned int numQueries{ 100000 };
+	const char* names[NUM_MESHES]{ "box", "cone", "cylinder", "sphere", "pyramid" };
+
+	for (unsigned int mesh = 0; mesh < NUM_MESHES; ++mesh)
+	{
+		std::vector<ShapesEngine::Vertex> vertices;
+		std::vector<ShapesEngine::Triangle> triangles;
+
+		switch (mesh)
+		{
+		case MESH_BOX: ShapesEngine::CreateBox(vertices, triangles); break;
+		case MESH_CONE: ShapesEngine::CreateCone(vertices, triangles); break;
+		case MESH_CYLINDER: ShapesEngine::CreateCylinder(vertices, triangles); break;
+		case MESH_SPHERE: ShapesEngine::CreateSphere(vertices, triangles); break;
+		default: ShapesEngine::CreatePyramid(vertices, triangles); break;
+		}
+
+		std::vector<vec3> points;
+		for (const auto& i : vertices)
+		{
+			points.push_back(i.position);
+		}
+
+		PhysicsEngine::ConvexHull hull;
+		auto start{ std::chrono::steady_clock::now() };
+		PhysicsEngine::ComputeConvexHull(points.data(), (unsigned int)points.size(), hull, 32);
+		auto built{ std::chrono::steady_clock::now() };
+
+		//Slowly turning directions, like the support queries of a narrowphase over consecutive steps.
+		std::vector<vec3> directions(numQueries);
+		Random random{ 7 };
+		vec3 direction{ 1.0f, 0.0f, 0.0f };
+		for (auto& i : directions)
+		{
+			direction = MathEngine::Normalize(direction + vec3{ random.Next(-0.1f, 0.1f), random.Next(-0.1f, 0.1f), random.Next(-0.1f, 0.1f) });
+			i = direction;
+		}
+
+		float checksum{ 0.0f };
+
+		auto meshStart{ std::chrono::steady_clock::now() };
+		for (const auto& i : directions)
+		{
+			float maxDistance{ -1e30f };
+			for (const auto& j : points)
+			{
+				float distance{ MathEngine::DotProduct(j, i) };
+				if (distance > maxDistance)
+					maxDistance = distance;
+			}
+
+			checksum += maxDistance;
+		}
+		auto meshEnd{ std::chrono::steady_clock::now() };
+
+		unsigned int vertex{ 0 };
+		for (const auto& i : directions)
+		{
+			vertex = PhysicsEngine::FindSupportVertex(hull, i, vertex);
+			checksum += MathEngine::DotProduct(hull.vertices[vertex], i);
+		}
+		auto hullEnd{ std::chrono::steady_clock::now() };
+
+		std::cout << std::left << std::setw(16) << names[mesh] << std::right << std::fixed <<
+			std::setw(8) << points.size() << " mesh vertices" <<
+			std::setw(6) << hull.vertices.size() << " hull vertices" <<
+			std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(built - start).count() << " ms build" <<
+			std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(meshEnd - meshStart).count() / numQueries << " ns mesh support" <<
+			std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(hullEnd - meshEnd).count() / numQueries << " ns hull support" <<
+			std::setw(10) << std::setprecision(4) << PhysicsEngine::ComputeHullError(hull, points.data(), (unsigned int)points.size()) << " hull error\n";
+
+		//Keeps the compiler from removing the queries.
+		KeepResult(checksum);
+	}
+}
+
+//Builds a collider over a terrain grid with one and with all hardware threads, then times ray casts, sphere and box contacts
+//and loading the saved collider.
+static void MeasureTriangleMesh(float scale)
+{
+	unsigned int gridSize{ (unsigned int)(300 * std::sqrt(scale)) };
+	if (gridSize < 2)
+		gridSize = 2;
+
+	std::vector<vec3> vertices;
+	std::vector<unsigned int> indices;
+	for (unsigned int z = 0; z <= gridSize; ++z)
+	{
+		for (unsigned int x = 0; x <= gridSize; ++x)
+		{
+			vertices.push_back(vec3{ (float)x, 3.0f * std::sin(x * 0.1f) * std::cos(z * 0.13f), (float)z });
+		}
+	}
+
+	for (unsigned int z = 0; z < gridSize; ++z)
+	{
+		for (unsigned int x = 0; x < gridSize; ++x)
+		{
+			unsigned int a{ z * (gridSize + 1) + x };
+			unsigned int c{ a + gridSize + 1 };
+			indices.insert(indices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+		}
+	}
+
+	unsigned int numThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+
+	PhysicsEngine::TriangleMeshCollider serial;
+	auto start{ std::chrono::steady_clock::now() };
+	serial.InitializeTriangleMeshCollider(vertices, indices, 1);
+	auto serialEnd{ std::chrono::steady_clock::now() };
+
+	PhysicsEngine::TriangleMeshCollider collider;
+	collider.InitializeTriangleMeshCollider(vertices, indices, numThreads);
+	auto parallelEnd{ std::chrono::steady_clock::now() };
+
+	const unsigned int numQueries{ 100000 };
+	Random random{ 11 };
+	float size{ (float)gridSize };
+	float checksum{ 0.0f };
+
+	auto rayStart{ std::chrono::steady_clock::now() };
+	unsigned int numHits{ 0 };
+	for (unsigned int i = 0; i < numQueries; ++i)
+	{
+		vec3 origin{ random.Next(0.0f, size), 10.0f, random.Next(0.0f, size) };
+		vec3 direction{ MathEngine::Normalize(vec3{ random.Next(-0.5f, 0.5f), -1.0f, random.Next(-0.5f, 0.5f) }) };
+
+		PhysicsEngine::MeshRayHit hit;
+		if (collider.CastRay(origin, direction, 100.0f, hit))
+		{
+			++numHits;
+			checksum += hit.distance;
+		}
+	}
+	auto rayEnd{ std::chrono::steady_clock::now() };
+
+	std::vector<PhysicsEngine::MeshContact> contacts;
+	unsigned int numSphereContacts{ 0 };
+	for (unsigned int i = 0; i < numQueries; ++i)
+	{
+		contacts.clear();
+		collider.CollideSphere(vec3{ random.Next(0.0f, size), random.Next(-3.0f, 3.0f), random.Next(0.0f, size) }, 0.5f, contacts);
+		numSphereContacts += (unsigned int)contacts.size();
+	}
+	auto sphereEnd{ std::chrono::steady_clock::now() };
+
+	std::vector<ShapesEngine::Vertex> boxVertices;
+	std::vector<ShapesEngine::Triangle> boxTriangles;
+	ShapesEngine::CreateBox(boxVertices, boxTriangles);
+
+	PhysicsEngine::ConvexHull box;
+	PhysicsEngine::ComputeConvexHull(boxVertices, box);
+
+	const unsigned int numBoxQueries{ numQueries / 10 };
+	unsigned int numBoxContacts{ 0 };
+	auto boxStart{ std::chrono::steady_clock::now() };
+	for (unsigned int i = 0; i < numBoxQueries; ++i)
+	{
+		contacts.clear();
+		collider.CollideConvex(box, vec3{ random.Next(0.0f, size), random.Next(-3.0f, 3.0f), random.Next(0.0f, size) },
+			RandomOrientation(random), contacts);
+		numBoxContacts += (unsigned int)contacts.size();
+	}
+	auto boxEnd{ std::chrono::steady_clock::now() };
+
+	std::vector<unsigned char> data;
+	collider.Save(data);
+
+	PhysicsEngine::TriangleMeshCollider loaded;
+	auto loadStart{ std::chrono::steady_clock::now() };
+	bool loadedOk{ loaded.Load(data.data(), data.size()) };
+	auto loadEnd{ std::chrono::steady_clock::now() };
+
+	//Point the last interior node back at the root, as a damaged file could, and check Load rejects the cycle.
+	const std::vector<PhysicsEngine::MeshBVHNode>& nodes{ collider.GetNodes() };
+	std::vector<unsigned char> damaged{ data };
+	for (size_t i = nodes.size(); i-- > 0;)
+	{
+		if (nodes[i].count == 0)
+		{
+			unsigned int root{ 0 };
+			size_t offset{ damaged.size() - (nodes.size() - i) * sizeof(PhysicsEngine::MeshBVHNode) + offsetof(PhysicsEngine::MeshBVHNode, leftOrFirst) };
+			std::memcpy(damaged.data() + offset, &root, sizeof(root));
+			break;
+		}
+	}
+
+	PhysicsEngine::TriangleMeshCollider damagedCollider;
+	bool rejectedCycle{ !damagedCollider.Load(damaged.data(), damaged.size()) };
+
+	std::vector<unsigned char> serialData;
+	serial.Save(serialData);
+
+	std::cout << std::left << std::setw(16) << "triangle mesh" << std::right << std::fixed <<
+		std::setw(8) << collider.GetNumberOfTriangles() << " triangles" <<
+		std::setw(8) << collider.GetNodes().size() << " nodes" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::milli>(serialEnd - start).count() << " ms build" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::milli>(parallelEnd - serialEnd).count() << " ms build on " <<
+		numThreads << " threads" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(loadEnd - loadStart).count() << " ms load" <<
+		"  same: " << Check(serialData == data && loadedOk) <<
+		"  rejects cycle: " << Check(rejectedCycle) << "\n";
+
+	std::cout << std::left << std::setw(16) << "" << std::right <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(rayEnd - rayStart).count() / numQueries << " ns ray" <<
+		std::setw(8) << numHits << " hits" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(sphereEnd - rayEnd).count() / numQueries << " ns sphere" <<
+		std::setw(8) << numSphereContacts << " contacts" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(boxEnd - boxStart).count() / numBoxQueries << " ns box" <<
+		std::setw(8) << numBoxContacts << " contacts\n";
+
+	//Keeps the compiler from removing the queries.
+	KeepResult(checksum);
+}
+
+//Times ray casts against 300 spheres, AABBs and triangles one volume at a time, in packets of 4 against every volume, and in packets
+//of 4 through the hierarchies on one thread, on all the hardware threads, and in batches of 256 rays, which are too small to be split
+//between threads. Then times sphere casts and overlaps through the hierarchies.
+static void MeasureSceneQueries(float scale)
+{
+	const unsigned int smallBatch{ 256 };
+	unsigned int numRays{ (unsigned int)(50000 * scale) };
+	if (numRays < smallBatch)
+		numRays = smallBatch;
+
+	unsigned int numThreads{ std::thread::hardware_concurrency() };
+	if (numThreads == 0)
+		numThreads = 1;
+
+	QueryTestScene testScene;
+	CreateQueryScene(testScene, 100, 20.0f, 8);
+	const PhysicsEngine::QueryScene& scene{ testScene.scene };
+	unsigned int numVolumes{ scene.numSpheres + scene.numBoxes + scene.numTriangles };
+
+	std::vector<PhysicsEngine::Ray> rays;
+	CreateQueryRays(rays, numRays, 30.0f, 9);
+	std::vector<PhysicsEngine::QueryHit> hits(numRays);
+
+	float checksum{ 0.0f };
+	auto sum = [&hits, &checksum]()
+	{
+		for (const auto& i : hits)
+			checksum += i.distance;
+	};
+
+	auto start{ std::chrono::steady_clock::now() };
+	CastRaysScalar(scene, rays.data(), numRays, hits.data());
+	auto scalarEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	PhysicsEngine::QueryScene flatScene{ scene };
+	flatScene.volumeBVH = nullptr;
+	flatScene.triangleMesh = nullptr;
+
+	auto packetStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::CastRays(flatScene, rays.data(), numRays, hits.data());
+	auto packetEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	auto hierarchyStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::CastRays(scene, rays.data(), numRays, hits.data());
+	auto hierarchyEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	auto threadStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::CastRays(scene, rays.data(), numRays, hits.data(), numThreads);
+	auto threadEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	unsigned int numBatches{ numRays / smallBatch };
+	auto batchStart{ std::chrono::steady_clock::now() };
+	for (unsigned int i = 0; i < numBatches; ++i)
+	{
+		PhysicsEngine::CastRays(scene, rays.data() + i * smallBatch, smallBatch, hits.data() + i * smallBatch, numThreads);
+	}
+	auto batchEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	//The sphere casts and overlaps start at the ray origins.
+	unsigned int numCasts{ numRays / 10 };
+	std::vector<PhysicsEngine::SphereCast> casts(numCasts);
+	std::vector<PhysicsEngine::Sphere> spheres(numCasts);
+	for (unsigned int i = 0; i < numCasts; ++i)
+	{
+		casts[i] = PhysicsEngine::SphereCast{ rays[i].origin, rays[i].direction, 0.5f, rays[i].maxDistance };
+		spheres[i] = PhysicsEngine::Sphere{ rays[i].origin, 2.0f };
+	}
+
+	auto flatCastStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::CastSpheres(flatScene, casts.data(), numCasts, hits.data(), numThreads);
+	auto flatCastEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	auto castStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::CastSpheres(scene, casts.data(), numCasts, hits.data(), numThreads);
+	auto castEnd{ std::chrono::steady_clock::now() };
+	sum();
+
+	std::vector<PhysicsEngine::OverlapHit> overlaps;
+	auto flatOverlapStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::OverlapSpheres(flatScene, spheres.data(), numCasts, overlaps, numThreads);
+	auto flatOverlapEnd{ std::chrono::steady_clock::now() };
+
+	auto overlapStart{ std::chrono::steady_clock::now() };
+	PhysicsEngine::OverlapSpheres(scene, spheres.data(), numCasts, overlaps, numThreads);
+	auto overlapEnd{ std::chrono::steady_clock::now() };
+
+	double scalarTime{ std::chrono::duration<double, std::nano>(scalarEnd - start).count() / numRays };
+	double packetTime{ std::chrono::duration<double, std::nano>(packetEnd - packetStart).count() / numRays };
+	double hierarchyTime{ std::chrono::duration<double, std::nano>(hierarchyEnd - hierarchyStart).count() / numRays };
+
+	std::cout << std::left << std::setw(16) << "scene queries" << std::right << std::fixed <<
+		std::setw(8) << numVolumes << " volumes" <<
+		std::setw(10) << std::setprecision(1) << scalarTime << " ns scalar ray" <<
+		std::setw(10) << std::setprecision(1) << packetTime << " ns packet ray" <<
+		std::setw(8) << std::setprecision(1) << scalarTime / packetTime << "x" <<
+		std::setw(10) << std::setprecision(1) << hierarchyTime << " ns hierarchy" <<
+		std::setw(8) << std::setprecision(1) << scalarTime / hierarchyTime << "x" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(threadEnd - threadStart).count() / numRays <<
+		" ns on " << numThreads << " threads" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(batchEnd - batchStart).count() / (numBatches * smallBatch) <<
+		" ns in batches of " << smallBatch << "\n";
+
+	std::cout << std::left << std::setw(16) << "" << std::right <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(flatCastEnd - flatCastStart).count() / numCasts <<
+		" ns sphere cast" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(castEnd - castStart).count() / numCasts <<
+		" ns with hierarchy" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(flatOverlapEnd - flatOverlapStart).count() / numCasts <<
+		" ns sphere overlap" <<
+		std::setw(10) << std::setprecision(1) << std::chrono::duration<double, std::nano>(overlapEnd - overlapStart).count() / numCasts <<
+		" ns with hierarchy" <<
+		std::setw(8) << overlaps.size() << " overlaps\n";
+
+	//Keeps the compiler from removing the queries.
+	KeepResult(checksum);
+}
+
+//Times the dispatch table against CollideGJK for every pair that has its own function, on the same random overlapping poses.
+static void MeasureNarrowphase()
+{
+	const unsigned int numPoses{ 100000 };
+	const PhysicsEngine::CollisionShapeType pairs[6][2]{ { PhysicsEngine::COLLISION_SPHERE, PhysicsEngine::COLLISION_SPHERE },
+		{ PhysicsEngine::COLLISION_SPHERE, PhysicsEngine::COLLISION_BOX }, { PhysicsEngine::COLLISION_BOX, PhysicsEngine::COLLISION_BOX },
+		{ PhysicsEngine::COLLISION_SPHERE, PhysicsEngine::COLLISION_CAPSULE }, { PhysicsEngine::COLLISION_CAPSULE, PhysicsEngine::COLLISION_CAPSULE },
+		{ PhysicsEngine::COLLISION_SPHERE, PhysicsEngine::COLLISION_CYLINDER } };
+	const char* names[PhysicsEngine::NUM_COLLISION_SHAPES]{ "sphere", "box", "capsule", "cylinder", "convex" };
+
+	PhysicsEngine::CollisionShape shapes[PhysicsEngine::NUM_COLLISION_SHAPES]{ PhysicsEngine::MakeSphereShape(0.5f),
+		PhysicsEngine::MakeBoxShape(vec3{ 0.5f, 0.3f, 0.7f }), PhysicsEngine::MakeCapsuleShape(0.3f, 0.5f),
+		PhysicsEngine::MakeCylinderShape(0.4f, 0.6f), PhysicsEngine::MakeSphereShape(0.5f) };
+
+	struct Pose
+	{
+		vec3 positionA;
+		vec3 positionB;
+		MathEngine::Quaternion orientationA;
+		MathEngine::Quaternion orientationB;
+	};
+
+	std::vector<Pose> poses(numPoses);
+	Random random{ 13 };
+	for (auto& i : poses)
+	{
+		i.positionA = vec3{ random.Next(-0.6f, 0.6f), random.Next(-0.6f, 0.6f), random.Next(-0.6f, 0.6f) };
+		i.positionB = vec3{ random.Next(-0.6f, 0.6f), random.Next(-0.6f, 0.6f), random.Next(-0.6f, 0.6f) };
+		i.orientationA = RandomOrientation(random);
+		i.orientationB = RandomOrientation(random);
+	}
+
+	for (const auto& pair : pairs)
+	{
+		const PhysicsEngine::CollisionShape& a{ shapes[pair[0]] };
+		const PhysicsEngine::CollisionShape& b{ shapes[pair[1]] };
+		float checksum{ 0.0f };
+
+		unsigned int numHits{ 0 };
+		unsigned int numPoints{ 0 };
+		auto start{ std::chrono::steady_clock::now() };
+		for (const auto& i : poses)
+		{
+			PhysicsEngine::ContactManifold manifold;
+			if (PhysicsEngine::Collide(a, i.positionA, i.orientationA, b, i.positionB, i.orientationB, manifold))
+			{
+				++numHits;
+				numPoints += manifold.numPoints;
+				checksum += manifold.depths[0];
+			}
+		}
+		auto dispatchEnd{ std::chrono::steady_clock::now() };
+
+		unsigned int numGJKHits{ 0 };
+		for (const auto& i : poses)
+		{
+			PhysicsEngine::ContactManifold manifold;
+			if (PhysicsEngine::CollideGJK(a, i.positionA, i.orientationA, b, i.positionB, i.orientationB, manifold))
+			{
+				++numGJKHits;
+				checksum += manifold.depths[0];
+			}
+		}
+		auto gjkEnd{ std::chrono::steady_clock::now() };
+
+		double dispatchTime{ std::chrono::duration<double, std::nano>(dispatchEnd - start).count() / numPoses };
+		double gjkTime{ std::chrono::duration<double, std::nano>(gjkEnd - dispatchEnd).count() / numPoses };
+
+		std::cout << std::left << std::setw(8) << names[pair[0]] << std::setw(8) << names[pair[1]] << std::right << std::fixed <<
+			std::setw(10) << std::setprecision(1) << dispatchTime << " ns dispatch" <<
+			std::setw(10) << std::setprecision(1) << gjkTime << " ns GJK" <<
+			std::setw(8) << std::setprecision(1) << gjkTime / dispatchTime << "x" <<
+			std::setw(8) << numHits << " hits" <<
+			std::setw(8) << numGJKHits << " GJK hits" <<
+			std::setw(6) << std::setprecision(2) << (numHits > 0 ? (double)numPoints / numHits : 0.0) << " points per hit\n";
+
+		//Keeps the compiler from removing the queries.
+		KeepResult(checksum);
+	}
+}
+
+//Finds the pairs of a field of boxes that drift each step, first with every body on the default layer and then with most of the
+//bodies on a debris layer that does not collide with itself.
+static void MeasureBroadphase(float scale)
+{
+	const unsigned int numSteps{ 60 };
+	const unsigned int debrisLayer{ 0x00000002 };
+
+	unsigned int numBodies{ (unsigned int)(20000 * scale) };
+	if (numBodies < 10)
+		numBodies = 10;
+
+	float side{ 2.5f * std::cbrt((float)numBodies) };
+	std::vector<vec3> positions(numBodies);
+	std::vector<vec3> velocities(numBodies);
+	std::vector<vec3> halfExtents(numBodies);
+	Random random{ 17 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		positions[i] = vec3{ random.Next(0.0f, side), random.Next(0.0f, side), random.Next(0.0f, side) };
+		velocities[i] = vec3{ random.Next(-0.02f, 0.02f), random.Next(-0.02f, 0.02f), random.Next(-0.02f, 0.02f) };
+		halfExtents[i] = vec3{ random.Next(0.2f, 1.0f), random.Next(0.2f, 1.0f), random.Next(0.2f, 1.0f) };
+	}
+
+	const char* names[2]{ "no filtering", "debris filtered" };
+	for (unsigned int run = 0; run < 2; ++run)
+	{
+		PhysicsEngine::Broadphase broadphase;
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			//Three of every four bodies are debris, which only collides with the default layer.
+			PhysicsEngine::CollisionFilter filter;
+			if (run == 1 && i % 4 != 0)
+			{
+				filter.layer = debrisLayer;
+				filter.mask = PhysicsEngine::ALL_COLLISION_LAYERS & ~debrisLayer;
+			}
+
+			broadphase.AddBody(positions[i] - halfExtents[i], positions[i] + halfExtents[i], filter);
+		}
+
+		PhysicsEngine::StepProfiler profiler(numSteps);
+		std::vector<vec3> moved{ positions };
+		for (unsigned int step = 0; step < numSteps; ++step)
+		{
+			profiler.BeginStep();
+			profiler.SetBodyCounts(numBodies, numBodies);
+
+			for (unsigned int i = 0; i < numBodies; ++i)
+			{
+				moved[i] += velocities[i];
+				broadphase.SetBounds(i, moved[i] - halfExtents[i], moved[i] + halfExtents[i]);
+			}
+
+			broadphase.FindPairs(&profiler);
+			profiler.EndStep();
+		}
+
+		PhysicsEngine::StepStats average{ profiler.GetAverage() };
+		std::cout << std::left << std::setw(16) << "broadphase" << std::setw(16) << names[run] << std::right << std::fixed <<
+			std::setw(8) << numBodies << " bodies" <<
+			std::setw(10) << average.numPairs << " pairs" <<
+			std::setw(10) << std::setprecision(3) << average.phaseMilliseconds[PhysicsEngine::PHASE_BROADPHASE] << " ms broadphase\n";
+	}
+}
+
+//Moves bodies through a field of trigger volumes and compares the TriggerSystem with testing every trigger against every body,
+//which is what scanning the overlaps with TestIntersection each frame does.
+static void MeasureTriggers(float scale)
+{
+	const unsigned int numSteps{ 60 };
+
+	unsigned int numBodies{ (unsigned int)(10000 * scale) };
+	unsigned int numTriggers{ (unsigned int)(500 * scale) };
+	if (numBodies < 10)
+		numBodies = 10;
+
+	if (numTriggers < 10)
+		numTriggers = 10;
+
+	float side{ 3.0f * std::cbrt((float)numBodies) };
+	PhysicsEngine::CollisionShape bodyShape{ PhysicsEngine::MakeSphereShape(0.5f) };
+	PhysicsEngine::CollisionShape triggerShape{ PhysicsEngine::MakeBoxShape(vec3{ 2.0f, 2.0f, 2.0f }) };
+
+	std::vector<vec3> bodies(numBodies);
+	std::vector<vec3> velocities(numBodies);
+	std::vector<vec3> triggers(numTriggers);
+	Random random{ 23 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		bodies[i] = vec3{ random.Next(0.0f, side), random.Next(0.0f, side), random.Next(0.0f, side) };
+		velocities[i] = vec3{ random.Next(-0.1f, 0.1f), random.Next(-0.1f, 0.1f), random.Next(-0.1f, 0.1f) };
+	}
+
+	for (auto& i : triggers)
+	{
+		i = vec3{ random.Next(0.0f, side), random.Next(0.0f, side), random.Next(0.0f, side) };
+	}
+
+	PhysicsEngine::TriggerSystem system;
+	for (const auto& i : triggers)
+	{
+		system.AddTrigger(triggerShape, i, MathEngine::Quaternion{});
+	}
+
+	for (const auto& i : bodies)
+	{
+		system.AddBody(bodyShape, i, MathEngine::Quaternion{});
+	}
+
+	system.Update();
+
+	unsigned long long numEvents{ 0 };
+	unsigned int numScanned{ 0 };
+	double systemTime{ 0.0 };
+	double scanTime{ 0.0 };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			bodies[i] += velocities[i];
+		}
+
+		auto start{ std::chrono::steady_clock::now() };
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			system.SetBodyPose(i, bodies[i], MathEngine::Quaternion{});
+		}
+
+		system.Update();
+		numEvents += system.GetEvents().size();
+		auto systemEnd{ std::chrono::steady_clock::now() };
+
+		numScanned = 0;
+		for (const auto& i : triggers)
+		{
+			for (const auto& j : bodies)
+			{
+				PhysicsEngine::ContactManifold manifold;
+				if (PhysicsEngine::CollideSphereBox(bodyShape, j, MathEngine::Quaternion{}, triggerShape, i, MathEngine::Quaternion{}, manifold))
+					++numScanned;
+			}
+		}
+		auto scanEnd{ std::chrono::steady_clock::now() };
+
+		systemTime += std::chrono::duration<double, std::milli>(systemEnd - start).count();
+		scanTime += std::chrono::duration<double, std::milli>(scanEnd - systemEnd).count();
+	}
+
+	std::cout << std::left << std::setw(16) << "triggers" << std::right << std::fixed <<
+		std::setw(8) << numTriggers << " triggers" <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(8) << system.GetNumberOfOverlaps() << " overlaps" <<
+		std::setw(10) << std::setprecision(1) << (double)numEvents / numSteps << " events per step" <<
+		std::setw(10) << std::setprecision(3) << systemTime / numSteps << " ms update" <<
+		std::setw(10) << std::setprecision(3) << scanTime / numSteps << " ms scanning all pairs" <<
+		"  same overlaps: " << Check(numScanned == system.GetNumberOfOverlaps()) << "\n";
+}
+
+//Sweeps the drag coefficient over many copies of the five shapes of the Gravity Simulator, first one world at a time with its own
+//RigidBodyArrays and force generators, then with a WorldBatch on one thread and on every thread.
+static void MeasureWorldBatch(float scale)
+{
+	const unsigned int numSteps{ 600 };
+	const unsigned int bodiesPerWorld{ NUM_MESHES };
+	const float dt{ 1.0f / 60.0f };
+	const vec3 gravity{ 9.81f * MathEngine::Normalize(vec3{ 0.0f, -1.0f, 0.0f }) };
+
+	unsigned int numWorlds{ (unsigned int)(4000 * scale) };
+	if (numWorlds < 10)
+		numWorlds = 10;
+
+	//The same five bodies in every world, each world starts them from a different height and has a different drag.
+	Scenario shapes;
+	Random random{ 29 };
+	for (unsigned int i = 0; i < bodiesPerWorld; ++i)
+	{
+		AddBody(shapes, (Meshes)i, 1.0f, vec3{ 1.0f, 1.0f, 1.0f }, vec3{ -2.0f + 2.0f * i, 0.0f, 0.0f }, RandomOrientation(random));
+	}
+
+	std::vector<float> heights(numWorlds);
+	std::vector<float> drags(numWorlds);
+	for (unsigned int i = 0; i < numWorlds; ++i)
+	{
+		heights[i] = random.Next(0.0f, 50.0f);
+		drags[i] = 20.0f * i / numWorlds;
+	}
+
+	auto getBody = [&](unsigned int world, unsigned int body)
+	{
+		PhysicsEngine::RigidBody rigidBody{ shapes.bodies[body] };
+		rigidBody.SetCenterOfMass(rigidBody.GetCenterOfMass() + vec3{ 0.0f, heights[world], 0.0f });
+		rigidBody.SetAngularVelocity(vec3{ 0.1f * body, 1.0f, 0.0f });
+		return rigidBody;
+	};
+
+	//One world at a time.
+	std::vector<float> finalHeights(numWorlds * bodiesPerWorld);
+	auto start{ std::chrono::steady_clock::now() };
+	for (unsigned int world = 0; world < numWorlds; ++world)
+	{
+		PhysicsEngine::RigidBodyArrays arrays;
+		PhysicsEngine::ForceGeneratorRegistry forceGenerators;
+		for (unsigned int body = 0; body < bodiesPerWorld; ++body)
+		{
+			PhysicsEngine::AddRigidBody(arrays, getBody(world, body));
+		}
+
+		forceGenerators.RegisterUniformGravity(9.81f, vec3{ 0.0f, -1.0f, 0.0f }, PhysicsEngine::BodyRange{ 0, bodiesPerWorld });
+		forceGenerators.RegisterDrag(drags[world], 0.0f, PhysicsEngine::BodyRange{ 0, bodiesPerWorld });
+
+		for (unsigned int step = 0; step < numSteps; ++step)
+		{
+			PhysicsEngine::ResetForcesAndTorques(arrays);
+			forceGenerators.ApplyForceGenerators(arrays);
+			PhysicsEngine::IntegrateRigidBodies(arrays, dt);
+		}
+
+		for (unsigned int body = 0; body < bodiesPerWorld; ++body)
+		{
+			finalHeights[body * numWorlds + world] = arrays.centerOfMassY[body];
+		}
+	}
+	double sequentialTime{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() };
+
+	unsigned int numThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+	double batchTimes[2]{};
+	bool same{ true };
+	unsigned int numSamples{ 0 };
+	for (unsigned int run = 0; run < 2; ++run)
+	{
+		PhysicsEngine::WorldBatch batch(numWorlds, bodiesPerWorld);
+		for (unsigned int world = 0; world < numWorlds; ++world)
+		{
+			for (unsigned int body = 0; body < bodiesPerWorld; ++body)
+			{
+				batch.SetBody(world, body, getBody(world, body));
+			}
+
+			batch.SetGravity(world, gravity);
+			batch.SetDrag(world, drags[world], 0.0f);
+		}
+
+		//The trajectories are streamed out a second at a time.
+		PhysicsEngine::WorldBatchSamples samples;
+		samples.interval = 60;
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned int step = 0; step < numSteps; step += 60)
+		{
+			batch.StepWorlds(60, dt, (run == 0) ? 1 : numThreads, &samples);
+			numSamples += samples.numSamples;
+			PhysicsEngine::ClearSamples(samples);
+		}
+		batchTimes[run] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		for (unsigned int body = 0; body < bodiesPerWorld; ++body)
+		{
+			for (unsigned int world = 0; world < numWorlds; ++world)
+			{
+				same = same && batch.GetCenterOfMass(world, body).y == finalHeights[body * numWorlds + world];
+			}
+		}
+	}
+
+	double bodySteps{ (double)numWorlds * bodiesPerWorld * numSteps };
+	std::cout << std::left << std::setw(16) << "world batch" << std::right << std::fixed <<
+		std::setw(8) << numWorlds << " worlds" <<
+		std::setw(10) << std::setprecision(1) << bodySteps / sequentialTime / 1000.0 << " M body steps/s one world at a time" <<
+		std::setw(10) << std::setprecision(1) << bodySteps / batchTimes[0] / 1000.0 << " M batched" <<
+		std::setw(10) << std::setprecision(1) << bodySteps / batchTimes[1] / 1000.0 << " M batched on " << numThreads << " threads" <<
+		std::setw(6) << numSamples / 2 << " samples" <<
+		"  same: " << Check(same) << "\n";
+}
+
+//Integrates the free fall bodies with IntegrateRigidBodies on the arrays, then in packets, then gathered into packets from
+//scattered handles and scattered back each step, and checks that every path gives the same bits.
+static void MeasureBodyPackets(float scale)
+{
+	const unsigned int numSteps{ 100 };
+	const float dt{ 1.0f / 60.0f };
+
+	Scenario scenario;
+	CreateFreeFall(scenario, (unsigned int)(50000 * scale));
+	unsigned int numBodies{ (unsigned int)scenario.bodies.size() };
+
+	//Each body gets a constant force and torque, the integrators do not clear them.
+	Random random{ 31 };
+	PhysicsEngine::RigidBodyArrays& arrays{ scenario.arrays };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		arrays.netForceX[i] = random.Next(-10.0f, 10.0f);
+		arrays.netForceY[i] = random.Next(-10.0f, 10.0f);
+		arrays.netForceZ[i] = random.Next(-10.0f, 10.0f);
+		arrays.netTorqueX[i] = random.Next(-1.0f, 1.0f);
+		arrays.netTorqueY[i] = random.Next(-1.0f, 1.0f);
+		arrays.netTorqueZ[i] = random.Next(-1.0f, 1.0f);
+	}
+
+	//The handles visit the bodies out of order, like the awake bodies of a scene would.
+	std::vector<unsigned int> handles(numBodies);
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		handles[i] = (unsigned int)(((unsigned long long)i * 7919) % numBodies);
+	}
+
+	PhysicsEngine::RigidBodyArrays scalar{ arrays };
+	auto start{ std::chrono::steady_clock::now() };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		PhysicsEngine::IntegrateRigidBodies(scalar, dt);
+	}
+	auto scalarEnd{ std::chrono::steady_clock::now() };
+
+	PhysicsEngine::BodyPacketArrays packets;
+	PhysicsEngine::GatherBodies(packets, arrays, handles.data(), numBodies);
+	auto packetStart{ std::chrono::steady_clock::now() };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		PhysicsEngine::IntegrateRigidBodies(packets, dt);
+	}
+	auto packetEnd{ std::chrono::steady_clock::now() };
+
+	PhysicsEngine::RigidBodyArrays packed{ arrays };
+	PhysicsEngine::ScatterBodies(packets, packed, handles.data(), numBodies);
+
+	PhysicsEngine::RigidBodyArrays gathered{ arrays };
+	auto gatherStart{ std::chrono::steady_clock::now() };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		PhysicsEngine::GatherBodies(packets, gathered, handles.data(), numBodies);
+		PhysicsEngine::IntegrateRigidBodies(packets, dt);
+		PhysicsEngine::ScatterBodies(packets, gathered, handles.data(), numBodies);
+	}
+	auto gatherEnd{ std::chrono::steady_clock::now() };
+
+	bool same{ packed.centerOfMassX == scalar.centerOfMassX && packed.orientationW == scalar.orientationW &&
+		packed.angularVelocityX == scalar.angularVelocityX && gathered.centerOfMassY == scalar.centerOfMassY &&
+		gathered.orientationZ == scalar.orientationZ && gathered.angularMomentumZ == scalar.angularMomentumZ };
+
+	double bodySteps{ (double)numBodies * numSteps };
+	double scalarTime{ std::chrono::duration<double, std::nano>(scalarEnd - start).count() / bodySteps };
+	double packetTime{ std::chrono::duration<double, std::nano>(packetEnd - packetStart).count() / bodySteps };
+	double gatherTime{ std::chrono::duration<double, std::nano>(gatherEnd - gatherStart).count() / bodySteps };
+
+	std::cout << std::left << std::setw(16) << "body packets" << std::right << std::fixed <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(4) << PhysicsEngine::BODY_PACKET_WIDTH << " wide" <<
+		std::setw(10) << std::setprecision(2) << scalarTime << " ns scalar" <<
+		std::setw(10) << std::setprecision(2) << packetTime << " ns packets" <<
+		std::setw(8) << std::setprecision(1) << scalarTime / packetTime << "x" <<
+		std::setw(10) << std::setprecision(2) << gatherTime << " ns with gather and scatter" <<
+		"  same: " << Check(same) << "\n";
+}
+
+//Steps chains of 4 bodies hanging from anchored springs. One chain in 16 has stiff springs and the rest are soft, so only a few
+//islands need short steps. Compares one step of dt for every body, 8 sub-steps for every body and the adaptive stepper with
+//the largest distance of each from a reference stepped with 64 sub-steps.
+static void MeasureAdaptiveStepping(float scale)
+{
+	const unsigned int numSteps{ 60 };
+	const unsigned int chainLength{ 4 };
+	const float dt{ 1.0f / 60.0f };
+
+	Scenario scenario;
+	unsigned int numChains{ (unsigned int)(2000 * scale) };
+	if (numChains == 0)
+		numChains = 1;
+
+	Random random{ 37 };
+	for (unsigned int i = 0; i < numChains * chainLength; ++i)
+	{
+		vec3 position{ 4.0f * (float)(i / chainLength), -1.0f - (float)(i % chainLength), random.Next(-0.1f, 0.1f) };
+		AddBody(scenario, (Meshes)(i % NUM_MESHES), 1.0f, vec3{ 0.5f, 0.5f, 0.5f }, position, MathEngine::Quaternion{});
+	}
+
+	FinishScenario(scenario, vec3{ 0.0f, -9.81f, 0.0f });
+
+	PhysicsEngine::AdaptiveStepper stepper;
+	for (unsigned int i = 0; i < numChains; ++i)
+	{
+		//The stiffness is scaled by the mass so each link has the same frequency.
+		float frequency{ (i % 16 == 0) ? 60.0f : 2.0f };
+		for (unsigned int j = 0; j < chainLength; ++j)
+		{
+			unsigned int body{ i * chainLength + j };
+			float stiffness{ frequency * frequency * scenario.bodies[body].GetMass() };
+			float damping{ 0.05f * frequency * scenario.bodies[body].GetMass() };
+
+			if (j == 0)
+				scenario.forceGenerators.RegisterAnchoredSpring(body, vec3{}, vec3{ 4.0f * (float)i, 0.0f, 0.0f }, 1.0f, stiffness, damping);
+			else
+				scenario.forceGenerators.RegisterSpring(body - 1, vec3{}, body, vec3{}, 1.0f, stiffness, damping);
+
+			stepper.SetBodySize(body, 0.5f);
+		}
+	}
+
+	const PhysicsEngine::ForceGeneratorRegistry& forceGenerators{ scenario.forceGenerators };
+	auto stepFixed{ [&forceGenerators](PhysicsEngine::RigidBodyArrays& bodies, unsigned int numSubsteps, float stepTime)
+		{
+			for (unsigned int i = 0; i < numSubsteps; ++i)
+			{
+				PhysicsEngine::ResetForcesAndTorques(bodies);
+				forceGenerators.ApplyForceGenerators(bodies);
+				PhysicsEngine::IntegrateRigidBodies(bodies, stepTime / (float)numSubsteps);
+			}
+		} };
+
+	PhysicsEngine::RigidBodyArrays reference{ scenario.arrays };
+	PhysicsEngine::RigidBodyArrays single{ scenario.arrays };
+	PhysicsEngine::RigidBodyArrays fixed{ scenario.arrays };
+	PhysicsEngine::RigidBodyArrays adaptive{ scenario.arrays };
+
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		stepFixed(reference, 64, dt);
+	}
+
+	auto singleStart{ std::chrono::steady_clock::now() };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		stepFixed(single, 1, dt);
+	}
+	auto singleEnd{ std::chrono::steady_clock::now() };
+
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		stepFixed(fixed, stepper.GetSettings().maxSubsteps, dt);
+	}
+	auto fixedEnd{ std::chrono::steady_clock::now() };
+
+	unsigned long long bodySubsteps{ 0 };
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		stepper.Step(adaptive, forceGenerators, dt);
+		bodySubsteps += stepper.GetNumberOfBodySubsteps();
+	}
+	auto adaptiveEnd{ std::chrono::steady_clock::now() };
+
+	auto maxError{ [&reference](const PhysicsEngine::RigidBodyArrays& bodies)
+		{
+			float error{ 0.0f };
+			for (unsigned int i = 0; i < PhysicsEngine::GetNumberOfBodies(bodies); ++i)
+			{
+				vec3 d{ bodies.centerOfMassX[i] - reference.centerOfMassX[i], bodies.centerOfMassY[i] - reference.centerOfMassY[i],
+					bodies.centerOfMassZ[i] - reference.centerOfMassZ[i] };
+
+				//A body that blew up counts as infinitely far away.
+				float distance{ MathEngine::Length(d) };
+				if (std::isnan(distance))
+					return INFINITY;
+
+				error = std::max(error, distance);
+			}
+
+			return error;
+		} };
+
+	unsigned int numBodies{ PhysicsEngine::GetNumberOfBodies(scenario.arrays) };
+	double singleTime{ std::chrono::duration<double, std::milli>(singleEnd - singleStart).count() / numSteps };
+	double fixedTime{ std::chrono::duration<double, std::milli>(fixedEnd - singleEnd).count() / numSteps };
+	double adaptiveTime{ std::chrono::duration<double, std::milli>(adaptiveEnd - fixedEnd).count() / numSteps };
+
+	std::cout << std::left << std::setw(16) << "adaptive steps" << std::right << std::fixed <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(5) << stepper.GetNumberOfIslands() << " islands" <<
+		std::setw(10) << std::setprecision(3) << singleTime << " ms 1 step (error " << std::setprecision(4) << maxError(single) << ")" <<
+		std::setw(10) << std::setprecision(3) << fixedTime << " ms " << stepper.GetSettings().maxSubsteps << " steps (error " <<
+		std::setprecision(4) << maxError(fixed) << ")" <<
+		std::setw(10) << std::setprecision(3) << adaptiveTime << " ms adaptive (error " << std::setprecision(4) << maxError(adaptive) << ", " <<
+		std::setprecision(2) << (double)bodySubsteps / ((double)numBodies * numSteps) << " sub-steps per body)\n";
+}
+
+//Moves a body at 1 unit per second for 10 seconds, 1000 km from the world origin, with plain float positions and with a floating origin,
+//then rebases a scene and compares shifting the bodies and broadphase with rebuilding the broadphase.
+static void MeasureLargeWorld(float scale)
+{
+	const float dt{ 1.0f / 60.0f };
+	const unsigned int numSteps{ 600 };
+	const PhysicsEngine::WorldPosition start{ 1000000.0, 0.0, 0.0 };
+
+	PhysicsEngine::RigidBody body;
+	body.SetLinearVelocity(vec3{ 1.0f, 0.0f, 0.0f });
+	body.SetLinearMomentum(vec3{ 1.0f, 0.0f, 0.0f });
+
+	PhysicsEngine::RigidBodyArrays absolute;
+	PhysicsEngine::AddRigidBody(absolute, body);
+	absolute.centerOfMassX[0] = (float)start.x;
+
+	PhysicsEngine::FloatingOrigin origin;
+	PhysicsEngine::RigidBodyArrays relative;
+	PhysicsEngine::AddRigidBody(relative, body);
+	origin.Rebase(start, relative);
+	origin.SetWorldPosition(relative, 0, start);
+
+	for (unsigned int step = 0; step < numSteps; ++step)
+	{
+		PhysicsEngine::IntegrateRigidBodies(absolute, dt);
+		PhysicsEngine::IntegrateRigidBodies(relative, dt);
+		origin.Rebase(origin.GetWorldPosition(relative, 0), relative);
+	}
+
+	double expected{ start.x + (double)numSteps * dt };
+	double absoluteError{ std::fabs((double)absolute.centerOfMassX[0] - expected) };
+	double relativeError{ std::fabs(origin.GetWorldPosition(relative, 0).x - expected) };
+
+	std::cout << std::left << std::setw(16) << "large world" << std::right << std::scientific << std::setprecision(2) <<
+		"error " << absoluteError << " float positions, " << relativeError << " floating origin\n" << std::fixed;
+
+	//A scene 5 km from the origin that the camera has moved to. The positions are multiples of 1 / 256, so they are shifted exactly
+	//and the pairs after the shift are the same as before it.
+	unsigned int numBodies{ (unsigned int)(20000 * scale) };
+	if (numBodies < 10)
+		numBodies = 10;
+
+	float side{ 2.5f * std::cbrt((float)numBodies) };
+	PhysicsEngine::FloatingOrigin sceneOrigin;
+	PhysicsEngine::RigidBodyArrays bodies;
+	PhysicsEngine::ReserveBodies(bodies, numBodies);
+	PhysicsEngine::Broadphase broadphase;
+	Random random{ 41 };
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		vec3 position{ 5000.0f + std::floor(random.Next(0.0f, side) * 256.0f) / 256.0f, std::floor(random.Next(0.0f, side) * 256.0f) / 256.0f,
+			std::floor(random.Next(0.0f, side) * 256.0f) / 256.0f };
+		PhysicsEngine::AddRigidBody(bodies, body);
+		bodies.centerOfMassX[i] = position.x;
+		bodies.centerOfMassY[i] = position.y;
+		bodies.centerOfMassZ[i] = position.z;
+		broadphase.AddBody(position - vec3{ 0.5f, 0.5f, 0.5f }, position + vec3{ 0.5f, 0.5f, 0.5f });
+	}
+
+	broadphase.FindPairs();
+	unsigned int numPairs{ (unsigned int)broadphase.GetPairs().size() };
+
+	auto rebaseStart{ std::chrono::steady_clock::now() };
+	sceneOrigin.Rebase(PhysicsEngine::WorldPosition{ 5000.0, 0.0, 0.0 }, bodies, nullptr, &broadphase);
+	auto rebaseEnd{ std::chrono::steady_clock::now() };
+	broadphase.FindPairs();
+	auto shiftedEnd{ std::chrono::steady_clock::now() };
+	bool samePairs{ broadphase.GetPairs().size() == numPairs };
+
+	//Rebuilding adds the bodies again and sorts them from scratch.
+	auto rebuildStart{ std::chrono::steady_clock::now() };
+	broadphase.ClearBodies();
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		vec3 position{ bodies.centerOfMassX[i], bodies.centerOfMassY[i], bodies.centerOfMassZ[i] };
+		broadphase.AddBody(position - vec3{ 0.5f, 0.5f, 0.5f }, position + vec3{ 0.5f, 0.5f, 0.5f });
+	}
+	broadphase.FindPairs();
+	auto rebuildEnd{ std::chrono::steady_clock::now() };
+	samePairs = samePairs && broadphase.GetPairs().size() == numPairs;
+
+	std::cout << std::left << std::setw(16) << "rebase" << std::right << std::fixed <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(rebaseEnd - rebaseStart).count() << " ms shift" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(shiftedEnd - rebaseStart).count() << " ms shift and pairs" <<
+		std::setw(10) << std::setprecision(3) << std::chrono::duration<double, std::milli>(rebuildEnd - rebuildStart).count() << " ms rebuild and pairs" <<
+		"  same pairs: " << Check(samePairs) << "\n";
+}
+
+//Finds the contacts between spheres of the same radius and with the ground at y = 0, using a hash grid with cells as big as the spheres.
+static void FindSphereContacts(const PhysicsEngine::RigidBodyArrays& arrays, float radius, std::vector<unsigned int>& cellHeads,
+	std::vector<unsigned int>& cellNext, std::vector<PhysicsEngine::ContactConstraint>& contacts)
+{
+	unsigned int numBodies{ PhysicsEngine::GetNumberOfBodies(arrays) };
+	unsigned int tableSize{ (unsigned int)cellHeads.size() };
+	float cellSize{ 2.0f * radius };
+
+	auto getCell = [&](float x, float y, float z, int dx, int dy, int dz)
+	{
+		unsigned int cx{ (unsigned int)((int)std::floor(x / cellSize) + dx) };
+		unsigned int cy{ (unsigned int)((int)std::floor(y / cellSize) + dy) };
+		unsigned int cz{ (unsigned int)((int)std::floor(z / cellSize) + dz) };
+
+		return (cx * 73856093u ^ cy * 19349663u ^ cz * 83492791u) % tableSize;
+	};
+
+	std::fill(cellHeads.begin(), cellHeads.end(), PhysicsEngine::INVALID_BODY);
+	cellNext.resize(numBodies);
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		unsigned int cell{ getCell(arrays.centerOfMassX[i], arrays.centerOfMassY[i], arrays.centerOfMassZ[i], 0, 0, 0) };
+		cellNext[i] = cellHeads[cell];
+		cellHeads[cell] = i;
+	}
+
+	PhysicsEngine::CollisionShape sphere{ PhysicsEngine::MakeSphereShape(radius) };
+	contacts.clear();
+
+	for (unsigned int i = 0; i < numBodies; ++i)
+	{
+		vec3 position{ arrays.centerOfMassX[i], arrays.centerOfMassY[i], arrays.centerOfMassZ[i] };
+
+		if (position.y < radius)
+		{
+			PhysicsEngine::ContactConstraint contact;
+			contact.bodyB = i;
+			contact.normal = vec3{ 0.0f, 1.0f, 0.0f };
+			contact.point = vec3{ position.x, 0.5f * (position.y - radius), position.z };
+			contact.depth = radius - position.y;
+			contacts.push_back(contact);
+		}
+
+		for (int dx = -1; dx <= 1; ++dx)
+		{
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				for (int dz = -1; dz <= 1; ++dz)
+				{
+					for (unsigned int j = cellHeads[getCell(position.x, position.y, position.z, dx, dy, dz)]; j != PhysicsEngine::INVALID_BODY; j = cellNext[j])
+					{
+						//Each pair once. Cells that hash to the same slot can list a body twice, which the check also skips.
+						if (j <= i)
+							continue;
+
+						vec3 other{ arrays.centerOfMassX[j], arrays.centerOfMassY[j], arrays.centerOfMassZ[j] };
+						if (std::floor(other.x / cellSize) - std::floor(position.x / cellSize) != dx ||
+							std::floor(other.y / cellSize) - std::floor(position.y / cellSize) != dy ||
+							std::floor(other.z / cellSize) - std::floor(position.z / cellSize) != dz)
+							continue;
+
+						PhysicsEngine::ContactManifold manifold;
+						if (PhysicsEngine::CollideSphereSphere(sphere, position, MathEngine::Quaternion{}, sphere, other, MathEngine::Quaternion{}, manifold))
+						{
+							PhysicsEngine::ContactConstraint contact;
+							contact.bodyA = i;
+							contact.bodyB = j;
+							contact.normal = manifold.normal;
+							contact.point = manifold.points[0];
+							contact.depth = manifold.depths[0];
+							contacts.push_back(contact);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+//Settles one big pile of spheres, which is a single island, with the contact solver on one thread and on all hardware threads.
+//The color batches are solved in the same order either way, so both runs must end with the same bodies.
+static void MeasureContactSolver(float scale)
+{
+	const float radius{ 0.5f };
+	const unsigned int numSteps{ 120 };
+	const float dt{ 1.0f / 60.0f };
+
+	unsigned int numBodies{ (unsigned int)(4000 * scale) };
+	if (numBodies < 10)
+		numBodies = 10;
+
+	//A square heap of jittered layers, each a little smaller than the one below.
+	Scenario pile;
+	Random random{ 5 };
+	unsigned int side{ (unsigned int)std::ceil(std::cbrt((float)numBodies) * 1.5f) };
+	for (unsigned int i = 0, layer = 0; i < numBodies; ++layer)
+	{
+		unsigned int layerSide{ (side > layer) ? side - layer : 1 };
+		for (unsigned int j = 0; j < layerSide * layerSide && i < numBodies; ++j, ++i)
+		{
+			vec3 position{ (j % layerSide + 0.5f * layer) * 2.0f * radius + random.Next(-0.05f, 0.05f), (layer * 0.9f + 1.0f) * 2.0f * radius,
+				(j / layerSide + 0.5f * layer) * 2.0f * radius + random.Next(-0.05f, 0.05f) };
+			AddBody(pile, MESH_SPHERE, 1.0f, vec3{ radius, radius, radius }, position, MathEngine::Quaternion{});
+		}
+	}
+
+	FinishScenario(pile, vec3{ 0.0f, -9.81f, 0.0f });
+
+	unsigned int numThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+	PhysicsEngine::RigidBodyArrays results[2];
+	double solveMilliseconds[2]{};
+	PhysicsEngine::StepStats average;
+	unsigned int largestBatch{ 0 };
+
+	for (unsigned int run = 0; run < 2; ++run)
+	{
+		PhysicsEngine::RigidBodyArrays& arrays{ results[run] };
+		arrays = pile.arrays;
+
+		PhysicsEngine::ContactSolver solver(10, (run == 0) ? 1 : numThreads);
+		PhysicsEngine::StepProfiler profiler(numSteps);
+		std::vector<PhysicsEngine::ContactConstraint> contacts;
+		std::vector<unsigned int> cellHeads(2 * numBodies);
+		std::vector<unsigned int> cellNext;
+
+		for (unsigned int step = 0; step < numSteps; ++step)
+		{
+			profiler.BeginStep();
+			profiler.SetBodyCounts(numBodies, numBodies);
+
+			profiler.BeginPhase(PhysicsEngine::PHASE_FORCES);
+			PhysicsEngine::ResetForcesAndTorques(arrays);
+			pile.forceGenerators.ApplyForceGenerators(arrays);
+			profiler.EndPhase(PhysicsEngine::PHASE_FORCES);
+
+			profiler.BeginPhase(PhysicsEngine::PHASE_NARROWPHASE);
+			FindSphereContacts(arrays, radius, cellHeads, cellNext, contacts);
+			profiler.AddContacts((unsigned int)contacts.size());
+			profiler.EndPhase(PhysicsEngine::PHASE_NARROWPHASE);
+
+			solver.SolveContacts(arrays, contacts, dt, &profiler);
+
+			profiler.BeginPhase(PhysicsEngine::PHASE_INTEGRATION);
+			PhysicsEngine::IntegrateRigidBodies(arrays, dt);
+			profiler.EndPhase(PhysicsEngine::PHASE_INTEGRATION);
+
+			profiler.EndStep();
+		}
+
+		average = profiler.GetAverage();
+		solveMilliseconds[run] = average.phaseMilliseconds[PhysicsEngine::PHASE_SOLVE];
+
+		const PhysicsEngine::ConstraintColoring& coloring{ solver.GetColoring() };
+		for (unsigned int i = 0; i < PhysicsEngine::GetNumberOfBatches(coloring); ++i)
+		{
+			largestBatch = std::max(largestBatch, coloring.batchStarts[i + 1] - coloring.batchStarts[i]);
+		}
+	}
+
+	bool same{ results[0].centerOfMassX == results[1].centerOfMassX && results[0].centerOfMassY == results[1].centerOfMassY &&
+		results[0].centerOfMassZ == results[1].centerOfMassZ && results[0].angularMomentumX == results[1].angularMomentumX };
+
+	float lowest{ 1e30f };
+	for (float y : results[0].centerOfMassY)
+	{
+		lowest = std::min(lowest, y);
+	}
+
+	std::cout << std::left << std::setw(16) << "contact solver" << std::right << std::fixed <<
+		std::setw(8) << numBodies << " bodies" <<
+		std::setw(8) << average.numContacts << " contacts" <<
+		std::setw(6) << average.numConstraintBatches << " batches" <<
+		std::setw(8) << largestBatch << " largest batch" <<
+		std::setw(10) << std::setprecision(3) << solveMilliseconds[0] << " ms solve" <<
+		std::setw(10) << std::setprecision(3) << solveMilliseconds[1] << " ms solve on " << numThreads << " threads" <<
+		std::setw(8) << std::setprecision(3) << radius - lowest << " deepest ground contact" <<
+		"  same: " << Check(same) << "\n";
+}
+
+int main(int argc, char** argv)
+{
+	float scale{ 1.0f };
+	if (argc > 1)
+		scale = (float)std::atof(argv[1]);
+
+	if (scale <= 0.0f)
+		scale = 1.0f;
+
+	Scenario freeFall;
+	CreateFreeFall(freeFall, (unsigned int)(10000 * scale));
+	RunScenario(freeFall);
+
+	Scenario orbital;
+	CreateOrbital(orbital, (unsigned int)(2000 * scale));
+	RunScenario(orbital);
+
+	Scenario stacks;
+	CreateStacks(stacks, (unsigned int)(5000 * scale));
+	RunScenario(stacks);
+
+	Scenario pile;
+	CreatePile(pile, (unsigned int)(5000 * scale));
+	RunScenario(pile);
+
+	RunRollback(scale);
+
+	MeasureConvexHulls();
+
+	MeasureTriangleMesh(scale);
+
+	MeasureSceneQueries(scale);
+
+	MeasureBroadphase(scale);
+
+	MeasureTriggers(scale);
+
+	MeasureWorldBatch(scale);
+
+	MeasureBodyPackets(scale);
+
+	MeasureAdaptiveStepping(scale);
+
+	MeasureLargeWorld(scale);
+
+	MeasureNarrowphase();
+
+	MeasureContactSolver(scale);
+
+	RunChecks();
+
+	if (GetNumberOfFailedChecks() > 0)
+	{
+		std::cout << "\n" << GetNumberOfFailedChecks() << " of " << GetNumberOfChecks() << " checks FAILED\n";
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "\nall " << GetNumberOfChecks() << " checks passed\n";
+
+	return 0;
+}
\ No newline at end of file
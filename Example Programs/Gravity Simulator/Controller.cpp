@@ -26,11 +26,13 @@ namespace MVC
 			if (LOWORD(wParam) == WA_INACTIVE)
 			{
 				con->mPauseApplication = true;
+				con->mModel.SetPhysicsPaused(true);
 				RenderingEngine::Stop(con->mRenderTime);
 			}
 			else
 			{
 				con->mPauseApplication = false;
+				con->mModel.SetPhysicsPaused(!con->mPlayAnimaton);
 				RenderingEngine::Start(con->mRenderTime);
 			}
 
@@ -55,6 +57,7 @@ namespace MVC
 			else if (wParam == SIZE_MINIMIZED)
 			{
 				con->mPauseApplication = true;
+				con->mModel.SetPhysicsPaused(true);
 				con->mView.UnMaximizeRenderingWindow();
 				con->mView.UnMinimizeRenderingWindow();
 
@@ -97,6 +100,7 @@ namespace MVC
 		case WM_ENTERSIZEMOVE:
 		{
 			con->mPauseApplication = true;
+			con->mModel.SetPhysicsPaused(true);
 			RenderingEngine::Stop(con->mRenderTime);
 			con->mView.ResizingRenderingWindow();
 			return 0;
@@ -105,6 +109,7 @@ namespace MVC
 		case WM_EXITSIZEMOVE:
 		{
 			con->mPauseApplication = false;
+			con->mModel.SetPhysicsPaused(!con->mPlayAnimaton);
 			RenderingEngine::Start(con->mRenderTime);
 			con->mView.NotResizingRenderingWindow();
 
@@ -212,10 +217,13 @@ namespace MVC
 						SetWindowText((HWND)lParam, L"PAUSE");
 					}
 
+					con->mModel.SetPhysicsPaused(!con->mPlayAnimaton);
+
 					SetFocus(con->mView.GetRenderingWindowHandle());
 				}
 				else if (LOWORD(wParam) == RESET)
 				{
+					con->mModel.SetPhysicsPaused(true);
 					con->mModel.Reset();
 					con->mPlayAnimaton = false;
 					SetWindowText(con->mView.GetPlayPauseButtonWindowHandle(), L"PLAY");
@@ -248,6 +256,9 @@ namespace MVC
 			5.0f, 0.125f);
 
 		SetProperties(mPerspectiveProjection, 1.0f, 1000.0f, 45.0f, (float)mView.GetRenderingWindowWidth() / mView.GetRenderingWindowHeight());
+
+		//Step the physics on its own thread so slow frames do not slow down or drop simulation time.
+		mModel.EnablePhysicsThread(true);
 	}
 
 	void Controller::LoadShaders()
@@ -372,9 +383,15 @@ namespace MVC
 			milliSecondsPerFrameStream << std::setprecision(6) << milliSecondsPerFrame;
 			std::string milliSecondsPerFrameString{ milliSecondsPerFrameStream.str() };
 
+			std::stringstream milliSecondsPerStepStream;
+			milliSecondsPerStepStream << std::setprecision(6) << mModel.GetLastStepStats().totalMilliseconds;
+			std::string milliSecondsPerStepString{ milliSecondsPerStepStream.str() };
+
 			std::wstring fpsWString{ AnsiToWString(fpsString) };
 			std::wstring milliSecondsPerFrameWString{ AnsiToWString(milliSecondsPerFrameString) };
-			std::wstring textStr = L"Gravity Simulator - FPS: " + fpsWString + L"     Frame Time: " + milliSecondsPerFrameWString;
+			std::wstring milliSecondsPerStepWString{ AnsiToWString(milliSecondsPerStepString) };
+			std::wstring textStr = L"Gravity Simulator - FPS: " + fpsWString + L"     Frame Time: " + milliSecondsPerFrameWString +
+				L"     Physics Step Time: " + milliSecondsPerStepWString;
 			SetWindowText(mView.GetRenderingWindowHandle(), textStr.c_str());
 
 			//reset for next average
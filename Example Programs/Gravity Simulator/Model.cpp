@@ -2,21 +2,24 @@
 
 namespace MVC
 {
-	Model::Model() : mSimulationTime{ 0.1f }, mAccumulator{ 0.0f }, mAlpha{ 0.0f }
+	Model::Model() : mSimulationTime{ 0.1f }, mAccumulator{ 0.0f }, mAlpha{ 0.0f },
+		mUsePhysicsThread{ false }, mRunPhysicsThread{ false }, mPhysicsPaused{ true }
 	{
-		for (unsigned int i = 0; i < 5; ++i)
-		{
-			mPreviousRigidShapes.emplace_back();
-			mInterpolatedRigidShapes.emplace_back();
-			mCurrentRigidShapes.emplace_back();
-		}
-
 		CreateBox();
 		CreateCone();
 		CreateCylinder();
 		CreateSphere();
 		CreatePyramid();
 		CreateBoundingVolumes();
+
+		PhysicsEngine::BodyRange allBodies{ 0, PhysicsEngine::GetNumberOfBodies(mBodies) };
+		mForceGenerators.RegisterUniformGravity(9.81f, vec3{ 0.0f, -1.0f, 0.0f }, allBodies);
+		mForceGenerators.RegisterDrag(10.0f, 0.0f, allBodies);
+	}
+
+	Model::~Model()
+	{
+		StopPhysicsThread();
 	}
 
 	void Model::CreateBox()
@@ -35,42 +38,17 @@ namespace MVC
 		float height{ 1.0f };
 		float depth{ 1.0f };
 
-		/*mPreviousRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));*/
+		//The mesh is added to the library once. Its bounding sphere, mass properties and render data are shared by every instance of it.
+		//The instance only stores the transform and the dimensions of the shape as its scale.
+		PhysicsEngine::ShapeHandle handle{ mShapeAssets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_BOX) };
+		const PhysicsEngine::ShapeAsset& shape{ mShapeAssets.GetShape(handle) };
 
-		mPreviousRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		AddShapeInstance(handle, massDensity, PhysicsEngine::ShapeInstance{ handle, position, orientation, vec3{ width, height, depth } });
 
-		mInterpolatedRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_BOX).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Box>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_BOX).SetDrawArguments(
-			RenderingEngine::MakeDrawArguments((unsigned int)triangles.size() * 3, (unsigned int)mIndexList.size(), (int)mVertexList.size(),
-				RIGID_BOX, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-
-		mVertexList.insert(mVertexList.end(), vertices.begin(), vertices.end());
-
-		for (auto& i : triangles)
-		{
-			mIndexList.push_back(i.p0);
-			mIndexList.push_back(i.p1);
-			mIndexList.push_back(i.p2);
-		}
+		mRenderData.at(handle).drawArguments = RenderingEngine::MakeDrawArguments(shape.indexCount, shape.locationOfFirstIndex,
+			shape.indexOfFirstVertex, RIGID_BOX, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		mRenderData.at(handle).color = color;
+		mRenderData.at(handle).boundingVolumeColor = boundingVolumeColor;
 	}
 
 	void Model::CreateCone()
@@ -88,42 +66,15 @@ namespace MVC
 		float radius{ 1.0f };
 		float height{ 1.0f };
 
-		/*mPreviousRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));*/
-
-		mPreviousRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		PhysicsEngine::ShapeHandle handle{ mShapeAssets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_CONE) };
+		const PhysicsEngine::ShapeAsset& shape{ mShapeAssets.GetShape(handle) };
 
-		mInterpolatedRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		AddShapeInstance(handle, massDensity, PhysicsEngine::ShapeInstance{ handle, position, orientation, vec3{ radius, height, radius } });
 
-		mCurrentRigidShapes.at(RIGID_CONE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cone>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_CONE).SetDrawArguments(
-			RenderingEngine::MakeDrawArguments((unsigned int)triangles.size() * 3, (unsigned int)mIndexList.size(), (int)mVertexList.size(),
-				RIGID_CONE, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-
-		mVertexList.insert(mVertexList.end(), vertices.begin(), vertices.end());
-
-		for (auto& i : triangles)
-		{
-			mIndexList.push_back(i.p0);
-			mIndexList.push_back(i.p1);
-			mIndexList.push_back(i.p2);
-		}
+		mRenderData.at(handle).drawArguments = RenderingEngine::MakeDrawArguments(shape.indexCount, shape.locationOfFirstIndex,
+			shape.indexOfFirstVertex, RIGID_CONE, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		mRenderData.at(handle).color = color;
+		mRenderData.at(handle).boundingVolumeColor = boundingVolumeColor;
 	}
 
 	void Model::CreateCylinder()
@@ -141,42 +92,15 @@ namespace MVC
 		float radius{ 1.0f };
 		float height{ 1.0f };
 
-		/*mPreviousRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));*/
-
-		mPreviousRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		PhysicsEngine::ShapeHandle handle{ mShapeAssets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_CYLINDER) };
+		const PhysicsEngine::ShapeAsset& shape{ mShapeAssets.GetShape(handle) };
 
-		mCurrentRigidShapes.at(RIGID_CYLINDER).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Cylinder>(radius, height, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		AddShapeInstance(handle, massDensity, PhysicsEngine::ShapeInstance{ handle, position, orientation, vec3{ radius, height, radius } });
 
-		mInterpolatedRigidShapes.at(RIGID_CYLINDER).SetDrawArguments(
-			RenderingEngine::MakeDrawArguments((unsigned int)triangles.size() * 3, (unsigned int)mIndexList.size(), (int)mVertexList.size(),
-				RIGID_CYLINDER, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-
-		mVertexList.insert(mVertexList.end(), vertices.begin(), vertices.end());
-
-		for (auto& i : triangles)
-		{
-			mIndexList.push_back(i.p0);
-			mIndexList.push_back(i.p1);
-			mIndexList.push_back(i.p2);
-		}
+		mRenderData.at(handle).drawArguments = RenderingEngine::MakeDrawArguments(shape.indexCount, shape.locationOfFirstIndex,
+			shape.indexOfFirstVertex, RIGID_CYLINDER, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		mRenderData.at(handle).color = color;
+		mRenderData.at(handle).boundingVolumeColor = boundingVolumeColor;
 	}
 
 	void Model::CreateSphere()
@@ -191,44 +115,17 @@ namespace MVC
 		RenderingEngine::Color color(0.2f, 0.1f, 1.0f, 1.0f);
 		RenderingEngine::Color boundingVolumeColor(1.0f, 1.0f, 0.0f, 1.0f);
 		float massDensity{ 0.75f };
-		float radius{ 1.0f };;
-
-		/*mPreviousRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));*/
-
-		mPreviousRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_SPHERE).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Sphere>(radius, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		float radius{ 1.0f };
 
-		mInterpolatedRigidShapes.at(RIGID_SPHERE).SetDrawArguments(
-			RenderingEngine::MakeDrawArguments((unsigned int)triangles.size() * 3, (unsigned int)mIndexList.size(), (int)mVertexList.size(),
-				RIGID_SPHERE, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		PhysicsEngine::ShapeHandle handle{ mShapeAssets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_SPHERE) };
+		const PhysicsEngine::ShapeAsset& shape{ mShapeAssets.GetShape(handle) };
 
-		mVertexList.insert(mVertexList.end(), vertices.begin(), vertices.end());
+		AddShapeInstance(handle, massDensity, PhysicsEngine::ShapeInstance{ handle, position, orientation, vec3{ radius, radius, radius } });
 
-		for (auto& i : triangles)
-		{
-			mIndexList.push_back(i.p0);
-			mIndexList.push_back(i.p1);
-			mIndexList.push_back(i.p2);
-		}
+		mRenderData.at(handle).drawArguments = RenderingEngine::MakeDrawArguments(shape.indexCount, shape.locationOfFirstIndex,
+			shape.indexOfFirstVertex, RIGID_SPHERE, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		mRenderData.at(handle).color = color;
+		mRenderData.at(handle).boundingVolumeColor = boundingVolumeColor;
 	}
 
 	void Model::CreatePyramid()
@@ -247,72 +144,87 @@ namespace MVC
 		float height{ 5.0f };
 		float depth{ 1.0f };
 
-		/*mPreviousRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingBox>(vertices, boundingVolumeColor));*/
-
-		mPreviousRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mInterpolatedRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
-
-		mCurrentRigidShapes.at(RIGID_PYRAMID).InitializeRigidShape(massDensity, triangles,
-			std::make_unique<ShapesEngine::Pyramid>(width, height, depth, position, orientation, color),
-			std::make_unique<PhysicsEngine::BoundingSphere>(vertices, boundingVolumeColor));
+		PhysicsEngine::ShapeHandle handle{ mShapeAssets.AddShape(vertices, triangles, PhysicsEngine::PRIMITIVE_PYRAMID) };
+		const PhysicsEngine::ShapeAsset& shape{ mShapeAssets.GetShape(handle) };
 
-		mInterpolatedRigidShapes.at(RIGID_PYRAMID).SetDrawArguments(
-			RenderingEngine::MakeDrawArguments((unsigned int)triangles.size() * 3, (unsigned int)mIndexList.size(), (int)mVertexList.size(),
-				RIGID_PYRAMID, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		AddShapeInstance(handle, massDensity, PhysicsEngine::ShapeInstance{ handle, position, orientation, vec3{ width, height, depth } });
 
-		mVertexList.insert(mVertexList.end(), vertices.begin(), vertices.end());
-
-		for (auto& i : triangles)
-		{
-			mIndexList.push_back(i.p0);
-			mIndexList.push_back(i.p1);
-			mIndexList.push_back(i.p2);
-		}
+		mRenderData.at(handle).drawArguments = RenderingEngine::MakeDrawArguments(shape.indexCount, shape.locationOfFirstIndex,
+			shape.indexOfFirstVertex, RIGID_PYRAMID, L"Object Constant Buffer", 0, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		mRenderData.at(handle).color = color;
+		mRenderData.at(handle).boundingVolumeColor = boundingVolumeColor;
 	}
 
 	void Model::CreateBoundingVolumes()
 	{
-		RenderingEngine::DrawArguments sphereDrawArgs(mInterpolatedRigidShapes.at(RIGID_SPHERE).GetDrawArguments());
-		RenderingEngine::DrawArguments boxDrawArgs(mInterpolatedRigidShapes.at(RIGID_BOX).GetDrawArguments());
+		RenderingEngine::DrawArguments sphereDrawArgs(mRenderData.at(mShapeInstances.at(RIGID_SPHERE).shape).drawArguments);
+		RenderingEngine::DrawArguments boxDrawArgs(mRenderData.at(mShapeInstances.at(RIGID_BOX).shape).drawArguments);
 
-		for (unsigned int i = 0; i < 5; ++i)
+		for (unsigned int i = 0; i < mRenderData.size(); ++i)
 		{
-			/*mInterpolatedRigidShapes.at(i).SetBoundingVolumeDrawArguments(
+			/*mRenderData.at(i).boundingVolumeDrawArguments =
 				RenderingEngine::MakeDrawArguments(boxDrawArgs.indexCount, boxDrawArgs.locationOfFirstIndex, boxDrawArgs.indexOfFirstVertex,
-					i + 5, boxDrawArgs.constantBufferKey, boxDrawArgs.rootParameterIndex, boxDrawArgs.primtive));*/
+					i + 5, boxDrawArgs.constantBufferKey, boxDrawArgs.rootParameterIndex, boxDrawArgs.primtive);*/
 
-			mInterpolatedRigidShapes.at(i).SetBoundingVolumeDrawArguments(
+			mRenderData.at(i).boundingVolumeDrawArguments =
 				RenderingEngine::MakeDrawArguments(sphereDrawArgs.indexCount, sphereDrawArgs.locationOfFirstIndex, sphereDrawArgs.indexOfFirstVertex,
-					i + 5, sphereDrawArgs.constantBufferKey, sphereDrawArgs.rootParameterIndex, sphereDrawArgs.primtive));
+					i + 5, sphereDrawArgs.constantBufferKey, sphereDrawArgs.rootParameterIndex, sphereDrawArgs.primtive);
 		}
 	}
 
+	void Model::AddShapeInstance(PhysicsEngine::ShapeHandle handle, float massDensity, const PhysicsEngine::ShapeInstance& instance)
+	{
+		PhysicsEngine::RigidBody body;
+		PhysicsEngine::InitializeRigidBody(body, massDensity, mShapeAssets.GetShape(handle), instance);
+
+		mShapeInstances.push_back(instance);
+		mMassDensities.push_back(massDensity);
+		if (mRenderData.size() <= handle)
+			mRenderData.resize(handle + 1);
+
+		PhysicsEngine::AddRigidBody(mBodies, body);
+		mPreviousCentersOfMass.push_back(body.GetCenterOfMass());
+		mPreviousOrientations.push_back(body.GetOrientation());
+	}
+
 	void Model::StoreVerticesAndIndices(RenderingEngine::RenderScene* scene)
 	{
-		scene->CreateStaticBuffer(L"Vertex Buffer", mVertexList.data(), (unsigned int)(mVertexList.size() * sizeof(ShapesEngine::Vertex)),
+		const std::vector<ShapesEngine::Vertex>& vertexList{ mShapeAssets.GetVertexList() };
+		const std::vector<unsigned int>& indexList{ mShapeAssets.GetIndexList() };
+
+		scene->CreateStaticBuffer(L"Vertex Buffer", vertexList.data(), (unsigned int)(vertexList.size() * sizeof(ShapesEngine::Vertex)),
 			sizeof(ShapesEngine::Vertex));
 
-		scene->CreateStaticBuffer(L"Index Buffer", mIndexList.data(), (unsigned int)(mIndexList.size() * sizeof(unsigned int)), DXGI_FORMAT_R32_UINT);
+		scene->CreateStaticBuffer(L"Index Buffer", indexList.data(), (unsigned int)(indexList.size() * sizeof(unsigned int)), DXGI_FORMAT_R32_UINT);
 	}
 
 	void Model::Simulate(float renderTime)
 	{
-		static float total{ 0.0f };
+		if (mUsePhysicsThread)
+		{
+			//The physics thread owns the bodies and their previous poses, only the snapshots it publishes are read here.
+			mSnapshots.Update();
+			const PhysicsSnapshot& snapshot{ mSnapshots.GetReadBuffer() };
+
+			//Interpolate from the previous to the current transforms over the step that follows the time of the snapshot.
+			std::chrono::duration<float> elapsed{ std::chrono::steady_clock::now() - snapshot.time };
+			mAlpha = elapsed.count() / mSimulationTime;
+			if (mAlpha < 0.0f)
+				mAlpha = 0.0f;
+			else if (mAlpha > 1.0f)
+				mAlpha = 1.0f;
+
+			for (unsigned int i = 0; i < 5; ++i)
+			{
+				PhysicsEngine::ShapeInstance& instance{ mShapeInstances.at(i) };
+				PhysicsEngine::UpdateShapeInstance(instance, mShapeAssets.GetShape(instance.shape),
+					MathEngine::Lerp(snapshot.previousCenterOfMass[i], snapshot.currentCenterOfMass[i], mAlpha),
+					MathEngine::Slerp(snapshot.previousOrientation[i], snapshot.currentOrientation[i], mAlpha));
+			}
+
+			return;
+		}
+
 		//set the max number of simulation updates in one frame to 25
 		if (renderTime > 0.25f)
 		{
@@ -324,15 +236,7 @@ namespace MVC
 		//simulate until accumulator < simulation time
 		while (mAccumulator >= mSimulationTime)
 		{
-			for (unsigned int i = 0; i < 5; ++i)
-			{
-				vec3 force(NetForce(mCurrentRigidShapes.at(i).GetMass(), mCurrentRigidShapes.at(i).GetLinearVelocity()));
-
-				vec3 torque(NetTorque(force, mCurrentRigidShapes.at(i).GetAngularVelocity(),
-					mCurrentRigidShapes.at(i).GetCenterOfMass(), mCurrentRigidShapes.at(i).GetCenterOfMass() + vec3{ 0.5f, 0.0f, 0.0f }));
-
-				PhysicsEngine::SimulateRigidShape(mPreviousRigidShapes.at(i), mCurrentRigidShapes.at(i), force, torque, mSimulationTime);
-			}
+			Step();
 
 			mAccumulator -= mSimulationTime;
 		}
@@ -341,43 +245,192 @@ namespace MVC
 		mAlpha = mAccumulator / mSimulationTime;
 
 		//Interpolate to avoid stuttering.
+		for (unsigned int i = 0; i < mShapeInstances.size(); ++i)
+		{
+			PhysicsEngine::ShapeInstance& instance{ mShapeInstances.at(i) };
+			PhysicsEngine::UpdateShapeInstance(instance, mShapeAssets.GetShape(instance.shape),
+				MathEngine::Lerp(mPreviousCentersOfMass.at(i), PhysicsEngine::GetCenterOfMass(mBodies, i), mAlpha),
+				MathEngine::Slerp(mPreviousOrientations.at(i), PhysicsEngine::GetOrientation(mBodies, i), mAlpha));
+		}
+	}
+
+	void Model::Step()
+	{
+		PhysicsEngine::BodyRange allBodies{ 0, PhysicsEngine::GetNumberOfBodies(mBodies) };
+
+		mStepProfiler.BeginStep();
+		mStepProfiler.SetBodyCounts(allBodies.count, allBodies.count);
+
+		mStepProfiler.BeginPhase(PhysicsEngine::PHASE_FORCES);
+
+		PhysicsEngine::ResetForcesAndTorques(mBodies, allBodies);
+		mForceGenerators.ApplyForceGenerators(mBodies);
+
+		//The net force of each body acts on a point next to its center of mass, so it also turns the body.
+		for (unsigned int i = allBodies.first; i < allBodies.first + allBodies.count; ++i)
+		{
+			vec3 centerOfMass{ PhysicsEngine::GetCenterOfMass(mBodies, i) };
+			vec3 angularVelocity{ mBodies.angularVelocityX[i], mBodies.angularVelocityY[i], mBodies.angularVelocityZ[i] };
+
+			PhysicsEngine::AddTorque(mBodies, i, NetTorque(PhysicsEngine::GetNetForce(mBodies, i), angularVelocity,
+				centerOfMass, centerOfMass + vec3{ 0.5f, 0.0f, 0.0f }));
+		}
+
+		mStepProfiler.EndPhase(PhysicsEngine::PHASE_FORCES);
+
+		mStepProfiler.BeginPhase(PhysicsEngine::PHASE_INTEGRATION);
+
+		for (unsigned int i = allBodies.first; i < allBodies.first + allBodies.count; ++i)
+		{
+			mPreviousCentersOfMass.at(i) = PhysicsEngine::GetCenterOfMass(mBodies, i);
+			mPreviousOrientations.at(i) = PhysicsEngine::GetOrientation(mBodies, i);
+		}
+
+		PhysicsEngine::IntegrateRigidBodies(mBodies, allBodies, mSimulationTime);
+
+		mStepProfiler.EndPhase(PhysicsEngine::PHASE_INTEGRATION);
+
+		mStepProfiler.EndStep();
+	}
+
+	const PhysicsEngine::StepStats& Model::GetLastStepStats() const
+	{
+		if (mUsePhysicsThread)
+			return mSnapshots.GetReadBuffer().lastStep;
+
+		return mStepProfiler.GetStep(0);
+	}
+
+	void Model::EnablePhysicsThread(bool enable)
+	{
+		if (enable == mUsePhysicsThread)
+			return;
+
+		mUsePhysicsThread = enable;
+
+		if (enable)
+			StartPhysicsThread();
+		else
+		{
+			StopPhysicsThread();
+			mAccumulator = 0.0f;
+		}
+	}
+
+	void Model::SetPhysicsPaused(bool paused)
+	{
+		mPhysicsPaused.store(paused);
+	}
+
+	void Model::StartPhysicsThread()
+	{
+		PublishSnapshot(std::chrono::steady_clock::now());
+
+		mRunPhysicsThread.store(true);
+		mPhysicsThread = std::thread(&Model::PhysicsThread, this);
+	}
+
+	void Model::StopPhysicsThread()
+	{
+		mRunPhysicsThread.store(false);
+
+		if (mPhysicsThread.joinable())
+			mPhysicsThread.join();
+	}
+
+	void Model::PhysicsThread()
+	{
+		std::chrono::steady_clock::duration step{
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(mSimulationTime)) };
+
+		std::chrono::steady_clock::time_point nextStep{ std::chrono::steady_clock::now() + step };
+		bool paused{ false };
+
+		while (mRunPhysicsThread.load())
+		{
+			std::this_thread::sleep_until(nextStep);
+
+			if (mPhysicsPaused.load())
+			{
+				paused = true;
+			}
+			else if (paused)
+			{
+				//The last snapshot is from before the pause, so its interpolation has run to the current transforms.
+				//Publish the current transforms as both ends at the time the steps start again, so the next step interpolates from them.
+				paused = false;
+				for (unsigned int i = 0; i < 5; ++i)
+				{
+					mPreviousCentersOfMass.at(i) = PhysicsEngine::GetCenterOfMass(mBodies, i);
+					mPreviousOrientations.at(i) = PhysicsEngine::GetOrientation(mBodies, i);
+				}
+
+				nextStep = std::chrono::steady_clock::now();
+				PublishSnapshot(nextStep);
+			}
+			else
+			{
+				Step();
+				PublishSnapshot(nextStep);
+			}
+
+			nextStep += step;
+
+			//If the thread fell more than a step behind, start again from now instead of running the missed steps back to back.
+			std::chrono::steady_clock::time_point now{ std::chrono::steady_clock::now() };
+			if (now > nextStep + step)
+				nextStep = now + step;
+		}
+	}
+
+	void Model::PublishSnapshot(std::chrono::steady_clock::time_point time)
+	{
+		PhysicsSnapshot& snapshot{ mSnapshots.GetWriteBuffer() };
+
 		for (unsigned int i = 0; i < 5; ++i)
 		{
-			PhysicsEngine::Interpolate(mPreviousRigidShapes.at(i), mCurrentRigidShapes.at(i), mInterpolatedRigidShapes.at(i), mAlpha);
+			snapshot.previousCenterOfMass[i] = mPreviousCentersOfMass.at(i);
+			snapshot.previousOrientation[i] = mPreviousOrientations.at(i);
+			snapshot.currentCenterOfMass[i] = PhysicsEngine::GetCenterOfMass(mBodies, i);
+			snapshot.currentOrientation[i] = PhysicsEngine::GetOrientation(mBodies, i);
 		}
+
+		snapshot.time = time;
+		snapshot.lastStep = mStepProfiler.GetStep(0);
+
+		mSnapshots.Publish();
 	}
 
 	void Model::UpdateModels(RenderingEngine::RenderScene* scene, const MathEngine::Matrix4x4& viewMatrix, const MathEngine::Matrix4x4& projectionMatrix)
 	{
 		ObjectConstants data;
-		for (auto& i : mInterpolatedRigidShapes)
+		for (const auto& i : mShapeInstances)
 		{
-			i.UpdateModelMatrix();
-			data.MVP = MathEngine::Transpose(i.GetModelMatrix() * viewMatrix * projectionMatrix);
-			data.color = i.GetColor();
-			RenderingEngine::Update(scene, i.GetDrawArguments(), &data, sizeof(ObjectConstants));
-
-			data.MVP = MathEngine::Transpose(i.GetBoundingVolumeModelMatrix() * viewMatrix * projectionMatrix);
-			data.color = i.GetBoundingVolumeColor();
-			RenderingEngine::Update(scene, i.GetBoundingVolumeDrawArguments(), &data, sizeof(ObjectConstants));
+			const ShapeRenderData& renderData{ mRenderData.at(i.shape) };
+
+			data.MVP = MathEngine::Transpose(PhysicsEngine::ComputeModelMatrix(i) * viewMatrix * projectionMatrix);
+			data.color = renderData.color;
+			RenderingEngine::Update(scene, renderData.drawArguments, &data, sizeof(ObjectConstants));
+
+			PhysicsEngine::Sphere worldSphere;
+			PhysicsEngine::ComputeWorldSphere(worldSphere, mShapeAssets.GetShape(i.shape), i);
+
+			data.MVP = MathEngine::Transpose(PhysicsEngine::ComputeSphereModelMatrix(worldSphere) * viewMatrix * projectionMatrix);
+			data.color = renderData.boundingVolumeColor;
+			RenderingEngine::Update(scene, renderData.boundingVolumeDrawArguments, &data, sizeof(ObjectConstants));
 		}
 	}
 
 	void Model::RenderModels(RenderingEngine::RenderScene* scene)
 	{
-		for (const auto& i : mInterpolatedRigidShapes)
+		for (const auto& i : mShapeInstances)
 		{
-			RenderingEngine::Render(scene, i.GetDrawArguments());
+			RenderingEngine::Render(scene, mRenderData.at(i.shape).drawArguments);
 
-			RenderingEngine::Render(scene, i.GetBoundingVolumeDrawArguments());
+			RenderingEngine::Render(scene, mRenderData.at(i.shape).boundingVolumeDrawArguments);
 		}
 	}
 
-	vec3 Model::NetForce(float mass, const vec3& linearVelocity)
-	{
-		return PhysicsEngine::GravitationalForce(mass, 9.81f, vec3{ 0.0f, -1.0f, 0.0f }) + PhysicsEngine::DragForce(10.0f, 0.0f, linearVelocity);
-	}
-
 	vec3 Model::NetTorque(const vec3& force, const vec3& angularVelocity, const vec3& centerOfMass, const vec3& point)
 	{
 		return MathEngine::CrossProduct(point - centerOfMass, force); //PhysicsEngine::DragForce(2.0f, 0.0f, angularVelocity);
@@ -385,28 +438,32 @@ namespace MVC
 
 	void Model::Reset()
 	{
+		//The physics thread uses the bodies, so stop it while they are reset.
+		StopPhysicsThread();
+
 		vec3 position{ -2.0f, 0.0f, 0.0f };
-		for (unsigned int i = 0; i < 5; ++i)
+		for (unsigned int i = 0; i < mShapeInstances.size(); ++i)
 		{
-			mPreviousRigidShapes.at(i).SetPosition(position);
-			mPreviousRigidShapes.at(i).SetOrientation(MathEngine::Quaternion{});
-			mPreviousRigidShapes.at(i).SetLinearMomentum(vec3{ 0.0f, 0.0f, 0.0f });
-			mPreviousRigidShapes.at(i).SetAngularMomentum(vec3{ 0.0f, 0.0f, 0.0f });
-
-			mInterpolatedRigidShapes.at(i).SetPosition(position);
-			mInterpolatedRigidShapes.at(i).SetOrientation(MathEngine::Quaternion{});
-			mInterpolatedRigidShapes.at(i).SetLinearMomentum(vec3{ 0.0f, 0.0f, 0.0f });
-			mInterpolatedRigidShapes.at(i).SetAngularMomentum(vec3{ 0.0f, 0.0f, 0.0f });
-
-			mCurrentRigidShapes.at(i).SetPosition(position);
-			mCurrentRigidShapes.at(i).SetOrientation(MathEngine::Quaternion{});
-			mCurrentRigidShapes.at(i).SetLinearMomentum(vec3{ 0.0f, 0.0f, 0.0f });
-			mCurrentRigidShapes.at(i).SetAngularMomentum(vec3{ 0.0f, 0.0f, 0.0f });
+			PhysicsEngine::ShapeInstance& instance{ mShapeInstances.at(i) };
+			instance.position = position;
+			instance.orientation = MathEngine::Quaternion{};
+
+			//A body initialized from the instance is at rest at the start.
+			PhysicsEngine::RigidBody body;
+			PhysicsEngine::InitializeRigidBody(body, mMassDensities.at(i), mShapeAssets.GetShape(instance.shape), instance);
+
+			PhysicsEngine::LoadRigidBody(mBodies, i, body);
+			mPreviousCentersOfMass.at(i) = body.GetCenterOfMass();
+			mPreviousOrientations.at(i) = body.GetOrientation();
+
 			position += vec3{ 6.0f, 0.0f, 0.0f };
 		}
 
 		mAccumulator = 0.0f;
 		mAlpha = 0.0f;
+
+		if (mUsePhysicsThread)
+			StartPhysicsThread();
 	}
 
 }
\ No newline at end of file
@@ -1,27 +1,53 @@
 #pragma once
 
-#include "Box.h"
-#include "Cone.h"
-#include "Cylinder.h"
-#include "Sphere.h"
-#include "Pyramid.h"
-#include "RigidShape.h"
-#include "BoundingBox.h"
-#include "BoundingSphere.h"
+#include "RenderingEngineUtility.h"
 #include "GameTime.h"
 #include "ForceFunctions.h"
+#include "ForceGenerators.h"
+#include "ShapeAssets.h"
+#include "TripleBuffer.h"
+#include "StepProfiler.h"
 #include "CreateShapes.h"
 #include "Structures.h"
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace MVC
 {
 	enum Shapes { RIGID_BOX = 0, RIGID_CONE, RIGID_CYLINDER, RIGID_SPHERE, RIGID_PYRAMID };
 
+	//The transforms of the shapes before and after the last physics step and the time the step was scheduled for.
+	struct PhysicsSnapshot
+	{
+		vec3 previousCenterOfMass[5];
+		MathEngine::Quaternion previousOrientation[5];
+
+		vec3 currentCenterOfMass[5];
+		MathEngine::Quaternion currentOrientation[5];
+
+		std::chrono::steady_clock::time_point time;
+
+		//A copy of the timings and counts of the last step, so they can be read without reading the profiler of the physics thread.
+		PhysicsEngine::StepStats lastStep;
+	};
+
+	//The data used to draw a shape asset and its bounding sphere. It is stored once per asset, at the index of the asset handle.
+	struct ShapeRenderData
+	{
+		RenderingEngine::DrawArguments drawArguments;
+		RenderingEngine::DrawArguments boundingVolumeDrawArguments;
+
+		RenderingEngine::Color color;
+		RenderingEngine::Color boundingVolumeColor;
+	};
+
 	class Model
 	{
 	public:
 		Model();
+		~Model();
 
 		void StoreVerticesAndIndices(RenderingEngine::RenderScene* scene);
 
@@ -33,6 +59,16 @@ namespace MVC
 
 		void Reset();
 
+		//When enabled the physics steps run on their own thread at a fixed rate and Simulate only interpolates the latest snapshot.
+		void EnablePhysicsThread(bool enable);
+
+		//Pauses or resumes the physics thread.
+		void SetPhysicsPaused(bool paused);
+
+		//The timings and counts of the last physics step. When the physics thread is enabled they are the copy in the last snapshot
+		//read by Simulate, so they can be read while the thread runs.
+		const PhysicsEngine::StepStats& GetLastStepStats() const;
+
 	private:
 		void CreateBox();
 		void CreateCone();
@@ -40,8 +76,15 @@ namespace MVC
 		void CreateSphere();
 		void CreatePyramid();
 		void CreateBoundingVolumes();
+		void AddShapeInstance(PhysicsEngine::ShapeHandle handle, float massDensity, const PhysicsEngine::ShapeInstance& instance);
+
+		void Step();
+
+		void StartPhysicsThread();
+		void StopPhysicsThread();
+		void PhysicsThread();
+		void PublishSnapshot(std::chrono::steady_clock::time_point time);
 
-		vec3 NetForce(float mass, const vec3& linearVelocity);
 		vec3 NetTorque(const vec3& force, const vec3& angularVelocity, const vec3& centerOfMass, const vec3& point);
 
 	private:
@@ -50,11 +93,24 @@ namespace MVC
 		float mAlpha;
 
 
-		std::vector<PhysicsEngine::RigidShape> mPreviousRigidShapes;
-		std::vector<PhysicsEngine::RigidShape> mInterpolatedRigidShapes;
-		std::vector<PhysicsEngine::RigidShape> mCurrentRigidShapes;
+		//The instances hold the interpolated transforms that are drawn, everything else about a shape is in its asset.
+		std::vector<PhysicsEngine::ShapeInstance> mShapeInstances;
+		std::vector<float> mMassDensities;
+		std::vector<ShapeRenderData> mRenderData;
+
+		//The bodies stay in the arrays from one step to the next. Only their poses from before the last step are kept
+		//outside of them, to interpolate from.
+		PhysicsEngine::RigidBodyArrays mBodies;
+		std::vector<vec3> mPreviousCentersOfMass;
+		std::vector<MathEngine::Quaternion> mPreviousOrientations;
+		PhysicsEngine::ForceGeneratorRegistry mForceGenerators;
+		PhysicsEngine::ShapeAssetLibrary mShapeAssets;
+		PhysicsEngine::StepProfiler mStepProfiler;
 
-		std::vector<ShapesEngine::Vertex> mVertexList;
-		std::vector<unsigned int> mIndexList;
+		bool mUsePhysicsThread;
+		std::thread mPhysicsThread;
+		std::atomic<bool> mRunPhysicsThread;
+		std::atomic<bool> mPhysicsPaused;
+		PhysicsEngine::TripleBuffer<PhysicsSnapshot> mSnapshots;
 	};
 }
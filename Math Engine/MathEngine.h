@@ -925,7 +925,7 @@ namespace MathEngine
 	{
 		Matrix2x2 res;
 
-		for (int i = 0; i < 4; ++i)
+		for (int i = 0; i < 2; ++i)
 		{
 			res(i, 0) =
 				(m1(i, 0) * m2(0, 0)) +
@@ -934,14 +934,6 @@ namespace MathEngine
 			res(i, 1) =
 				(m1(i, 0) * m2(0, 1)) +
 				(m1(i, 1) * m2(1, 1));
-
-			res(i, 2) =
-				(m1(i, 0) * m2(0, 2)) +
-				(m1(i, 1) * m2(1, 2));
-
-			res(i, 3) =
-				(m1(i, 0) * m2(0, 3)) +
-				(m1(i, 1) * m2(1, 3));
 		}
 
 		return res;
@@ -1570,7 +1562,7 @@ namespace MathEngine
 	{
 		Matrix3x3 result;
 
-		for (int i = 0; i < 4; ++i)
+		for (int i = 0; i < 3; ++i)
 		{
 			result(i, 0) =
 				(m1(i, 0) * m2(0, 0)) +
@@ -1586,11 +1578,6 @@ namespace MathEngine
 				(m1(i, 0) * m2(0, 2)) +
 				(m1(i, 1) * m2(1, 2)) +
 				(m1(i, 2) * m2(2, 2));
-
-			result(i, 3) =
-				(m1(i, 0) * m2(0, 3)) +
-				(m1(i, 1) * m2(1, 3)) +
-				(m1(i, 2) * m2(2, 3));
 		}
 
 		return result;
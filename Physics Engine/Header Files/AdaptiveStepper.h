@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ContactSolver.h"
+#include "ForceGenerators.h"
+
+namespace PhysicsEngine
+{
+	/**brief The limits an AdaptiveStepper keeps each sub-step of an island under.
+	*
+	* maxTravel is the largest distance a body can move in one sub-step, as a fraction of its size.
+	* maxRotation is the largest angle in radians a body can turn in one sub-step.
+	* maxSpringPhase is the largest fraction of a radian a spring can oscillate through in one sub-step, which is w * dt for a spring
+	* of natural frequency w. It also limits the fraction of the relative velocity the damping of a spring removes in one sub-step.\n
+	* maxSubsteps is the most sub-steps an island can take in one step. It is rounded down to a power of 2.
+	*/
+	struct AdaptiveStepSettings
+	{
+		float maxTravel{ 0.25f };
+		float maxRotation{ 0.25f };
+		float maxSpringPhase{ 0.5f };
+		unsigned int maxSubsteps{ 8 };
+	};
+
+	/** @class AdaptiveStepper ""
+	*	@brief Steps the bodies of a RigidBodyArrays object with a number of sub-steps chosen for each island.
+	*
+	*	An island is a group of bodies that can move and are joined by springs or contacts, bodies with an inverse mass of 0
+	*	do not join islands. Each step the stepper finds the islands and picks the number of sub-steps of each one from
+	*	how far its bodies move relative to their size, how fast they turn and how stiff its springs are. Quiet islands take
+	*	one sub-step of dt and violent ones take up to maxSubsteps shorter ones, so the time is spent where it is needed.\n
+	*
+	*	The sub-step counts are powers of 2, so the step is cut into ticks of dt / N, where N is the largest count of the step.
+	*	An island with n sub-steps is integrated on every (N / n)th tick. The forces of all the bodies are applied on every tick,
+	*	so the generators must not connect bodies of different islands, which is true for all of them.\n
+	*
+	*	If every island takes one sub-step, a step is the same as ResetForcesAndTorques, ApplyForceGenerators, SolveContacts and
+	*	IntegrateRigidBodies with dt.
+	*/
+	class AdaptiveStepper
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a stepper with the default settings.
+		*/
+		AdaptiveStepper();
+
+		/**brief Creates a stepper with the specified settings.
+		*/
+		AdaptiveStepper(const AdaptiveStepSettings& settings);
+
+		/**brief Sets the settings of the stepper.
+		*/
+		void InitializeAdaptiveStepper(const AdaptiveStepSettings& settings);
+
+		/**brief Returns the settings of the stepper.
+		*/
+		const AdaptiveStepSettings& GetSettings() const;
+
+		/**brief Sets the size of the body, for example the radius of its bounding sphere.
+		*
+		* The size of a body is 1 until it is set. A size of 0 turns off the travel limit for the body.
+		*/
+		void SetBodySize(unsigned int body, float size);
+
+		/**brief Returns the size of the body.
+		*/
+		float GetBodySize(unsigned int body) const;
+
+		/**brief Steps all the bodies forward by dt.
+		*
+		* The net forces and net torques are reset and the force generators are applied on every tick.\n
+		* If contacts and solver are not nullptr, the contacts of each island are solved on every sub-step of the island with its
+		* sub-step time. The depth of the contacts is split between the sub-steps, so an island is pushed out of the contacts by
+		* about the same amount no matter how many sub-steps it takes. The contacts are not changed.\n
+		* If the profiler is not nullptr the forces, solve and integration are timed. The profiler's step is not begun or ended.
+		*/
+		void Step(RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float dt,
+			const std::vector<ContactConstraint>* contacts = nullptr, ContactSolver* solver = nullptr, StepProfiler* profiler = nullptr);
+
+		/**brief Returns the number of islands found by the last step.
+		*/
+		unsigned int GetNumberOfIslands() const;
+
+		/**brief Returns the island of the body in the last step, or INVALID_BODY if the body cannot move.
+		*/
+		unsigned int GetIsland(unsigned int body) const;
+
+		/**brief Returns the number of bodies in the island.
+		*/
+		unsigned int GetNumberOfIslandBodies(unsigned int island) const;
+
+		/**brief Returns the bodies in the island, in increasing order.
+		*/
+		const unsigned int* GetIslandBodies(unsigned int island) const;
+
+		/**brief Returns the number of sub-steps the island took in the last step.
+		*/
+		unsigned int GetIslandSubsteps(unsigned int island) const;
+
+		/**brief Returns the number of ticks of the last step, which is the largest number of sub-steps of any island.
+		*/
+		unsigned int GetNumberOfTicks() const;
+
+		/**brief Returns the number of times a body was integrated in the last step.
+		*/
+		unsigned long long GetNumberOfBodySubsteps() const;
+
+	private:
+		unsigned int FindRoot(unsigned int body);
+		void JoinBodies(const RigidBodyArrays& bodies, unsigned int a, unsigned int b);
+		void BuildIslands(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators,
+			const std::vector<ContactConstraint>* contacts);
+		void ChooseSubsteps(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float dt);
+
+		AdaptiveStepSettings mSettings;
+		unsigned int mMaxLevel;
+
+		std::vector<float> mBodySizes;
+
+		//The union-find forest used to find the islands, one element per body.
+		std::vector<unsigned int> mParents;
+
+		//The island of each body and the bodies of each island. The bodies of island i are from mIslandStarts[i] to mIslandStarts[i + 1].
+		std::vector<unsigned int> mBodyIslands;
+		std::vector<unsigned int> mIslandStarts;
+		std::vector<unsigned int> mIslandBodies;
+
+		//The runs of consecutive bodies in each island, so they are integrated with one call.
+		std::vector<unsigned int> mRangeStarts;
+		std::vector<BodyRange> mRanges;
+
+		//The sub-steps of each island is 2 to the power of its level. The islands of each level are from mLevelStarts[l] to mLevelStarts[l + 1].
+		std::vector<unsigned int> mIslandLevels;
+		std::vector<unsigned int> mLevelStarts;
+		std::vector<unsigned int> mLevelIslands;
+
+		//The contacts solved on a tick.
+		std::vector<ContactConstraint> mTickContacts;
+
+		unsigned int mNumTicks;
+		unsigned long long mNumBodySubsteps;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "RigidBodyArrays.h"
+
+//The number of bodies in a BodyPacket. Builds with AVX (/arch:AVX2 or -mavx2) use packets of 8, other builds use packets of 4 with SSE.
+#if defined(__AVX__)
+#define PHYSICS_ENGINE_BODY_PACKET_WIDTH 8
+#else
+#define PHYSICS_ENGINE_BODY_PACKET_WIDTH 4
+#endif
+
+namespace PhysicsEngine
+{
+	/**brief The number of bodies in a BodyPacket.
+	*/
+	const unsigned int BODY_PACKET_WIDTH{ PHYSICS_ENGINE_BODY_PACKET_WIDTH };
+
+	/**brief The state of BODY_PACKET_WIDTH rigid bodies, with each property of all of them in one SIMD register.
+	*
+	* This is the array of structures of arrays (AoSoA) form of a RigidBodyArrays object. All the properties of a few bodies
+	* are next to each other in memory, so integrating a packet touches one contiguous block instead of one cache line
+	* in each of the arrays, and every load and store is aligned.\n
+	* The inverse inertia tensor in body coordinates is symmetric, so only 6 of its elements are stored.
+	*/
+	struct alignas(4 * PHYSICS_ENGINE_BODY_PACKET_WIDTH) BodyPacket
+	{
+		float mass[BODY_PACKET_WIDTH];
+		float inverseMass[BODY_PACKET_WIDTH];
+
+		float centerOfMassX[BODY_PACKET_WIDTH];
+		float centerOfMassY[BODY_PACKET_WIDTH];
+		float centerOfMassZ[BODY_PACKET_WIDTH];
+
+		float orientationW[BODY_PACKET_WIDTH];
+		float orientationX[BODY_PACKET_WIDTH];
+		float orientationY[BODY_PACKET_WIDTH];
+		float orientationZ[BODY_PACKET_WIDTH];
+
+		float linearVelocityX[BODY_PACKET_WIDTH];
+		float linearVelocityY[BODY_PACKET_WIDTH];
+		float linearVelocityZ[BODY_PACKET_WIDTH];
+
+		float linearMomentumX[BODY_PACKET_WIDTH];
+		float linearMomentumY[BODY_PACKET_WIDTH];
+		float linearMomentumZ[BODY_PACKET_WIDTH];
+
+		float angularVelocityX[BODY_PACKET_WIDTH];
+		float angularVelocityY[BODY_PACKET_WIDTH];
+		float angularVelocityZ[BODY_PACKET_WIDTH];
+
+		float angularMomentumX[BODY_PACKET_WIDTH];
+		float angularMomentumY[BODY_PACKET_WIDTH];
+		float angularMomentumZ[BODY_PACKET_WIDTH];
+
+		float inverseBodyInertiaXX[BODY_PACKET_WIDTH];
+		float inverseBodyInertiaYY[BODY_PACKET_WIDTH];
+		float inverseBodyInertiaZZ[BODY_PACKET_WIDTH];
+		float inverseBodyInertiaXY[BODY_PACKET_WIDTH];
+		float inverseBodyInertiaXZ[BODY_PACKET_WIDTH];
+		float inverseBodyInertiaYZ[BODY_PACKET_WIDTH];
+
+		float netForceX[BODY_PACKET_WIDTH];
+		float netForceY[BODY_PACKET_WIDTH];
+		float netForceZ[BODY_PACKET_WIDTH];
+
+		float netTorqueX[BODY_PACKET_WIDTH];
+		float netTorqueY[BODY_PACKET_WIDTH];
+		float netTorqueZ[BODY_PACKET_WIDTH];
+	};
+
+	/**brief Stores the state of many rigid bodies in packets of BODY_PACKET_WIDTH bodies.
+	*
+	* Body i is in lane i % BODY_PACKET_WIDTH of packet i / BODY_PACKET_WIDTH. The lanes after the last body of the last packet
+	* have an inverse mass of 0, so they are never moved.
+	*/
+	struct BodyPacketArrays
+	{
+		std::vector<BodyPacket> packets;
+		unsigned int numBodies{ 0 };
+	};
+
+	/**brief Returns the number of bodies stored in the specified BodyPacketArrays.
+	*/
+	unsigned int GetNumberOfBodies(const BodyPacketArrays& bodies);
+
+	/**brief Sets the number of bodies. The new bodies are at rest at the origin with an inverse mass of 0.
+	*/
+	void ResizeBodies(BodyPacketArrays& bodies, unsigned int numBodies);
+
+	/**brief Copies the state of the specified rigid body into the packets at the specified index.
+	*
+	* The net force and net torque of the body at the index are set to the zero vector.
+	*/
+	void LoadRigidBody(BodyPacketArrays& bodies, unsigned int index, const RigidBody& body);
+
+	/**brief Copies the center of mass, orientation, linear momentum and angular momentum at the specified index into the rigid body.
+	*/
+	void StoreRigidBody(const BodyPacketArrays& bodies, unsigned int index, RigidBody& body);
+
+	/**brief Copies the bodies of the RigidBodyArrays object with the specified indices into the packets, with their net forces and net torques.
+	*
+	* The packets are resized to numHandles bodies and the body handles[i] goes to index i, so bodies that are far apart in the arrays,
+	* for example the awake bodies or the bodies of an island, are packed together.
+	*/
+	void GatherBodies(BodyPacketArrays& packets, const RigidBodyArrays& bodies, const unsigned int* handles, unsigned int numHandles);
+
+	/**brief Copies the state that integration changes back from index i of the packets to the body handles[i] of the RigidBodyArrays object.
+	*
+	* The state is the center of mass, orientation, linear velocity, linear momentum, angular velocity and angular momentum.
+	*/
+	void ScatterBodies(const BodyPacketArrays& packets, RigidBodyArrays& bodies, const unsigned int* handles, unsigned int numHandles);
+
+	/**brief Sets the net force and net torque of all the bodies to the zero vector.
+	*/
+	void ResetForcesAndTorques(BodyPacketArrays& bodies);
+
+	/**brief Adds the force and torque to the net force and net torque of the body at the specified index.
+	*/
+	void AddForceAndTorque(BodyPacketArrays& bodies, unsigned int index, const vec3& force, const vec3& torque);
+
+	/**brief Integrates the bodies of the packet with their net forces and net torques using the time step dt.
+	*
+	* Does the same operations in the same order as RigidBody::Integrate on every lane at once, so it gives the same results as
+	* IntegrateRigidBodies as long as the compiler does not fuse multiplies and adds. Bodies with an inverse mass of 0 are not moved.
+	*/
+	void Integrate(BodyPacket& packet, float dt);
+
+	/**brief Integrates all the bodies with their net forces and net torques using the time step dt, one packet at a time.
+	*/
+	void IntegrateRigidBodies(BodyPacketArrays& bodies, float dt);
+}
\ No newline at end of file
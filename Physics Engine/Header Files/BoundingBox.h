@@ -1,37 +1,10 @@
 #pragma once
 
 #include "BoundingVolume.h"
-#include "Vertex.h"
+#include "BoundingGeometry.h"
 
 namespace PhysicsEngine
 {
-	/**brief Structure for an axis-aligned bounding box.
-	* Uses the min-max representation.
-	*/
-	struct AABB
-	{
-		vec3 min;
-		vec3 max;
-	};
-
-	/**brief Initializes the specified AABB with the specified min and max values;
-	*/
-	void InitializeAABB(AABB& a, vec3 min, vec3 max);
-
-	/**brief Computes the properties of a AABB from the vertices of an object.
-	*/
-	void ComputeAABB(AABB& aabb, const std::vector<ShapesEngine::Vertex>& vertices);
-
-	/**brief Transforms the localAABB to world space by finding the extents and returning the resultant AABB.
-	* The transformation is done using vector-matrix multiplcation. The localAABB is treated as a row vector.
-	*/
-	void TransformAABB(AABB& worldAABB, const AABB& localAABB, const mat4& model);
-
-	/**brief Returns true if the specified AABBs are intersecting, false otherwise.
-	*/
-	bool TestIntersection(const AABB& a, const AABB& b);
-
-
 	/** @class BoundingBox ""
 	*	@brief This class is used to bound an object using an axis-aligned bounding box and also for rendering it.
 	*/
@@ -58,6 +31,18 @@ namespace PhysicsEngine
 		*/
 		void TransformBoundingVolume(const mat4& model) override;
 
+		/**@brief Returns BOUNDING_BOX.
+		*/
+		BoundingVolumeType GetType() const override;
+
+		/**@brief Returns the AABB in local space.
+		*/
+		const AABB& GetLocalAABB() const;
+
+		/**@brief Returns the AABB in world space.
+		*/
+		const AABB& GetWorldAABB() const;
+
 	private:
 		AABB mLocalAABB;
 		AABB mWorldAABB;
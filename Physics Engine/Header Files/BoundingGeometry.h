@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Vertex.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief The types of bounding volumes.
+	*/
+	enum BoundingVolumeType { BOUNDING_SPHERE = 0, BOUNDING_BOX };
+
+	/**brief Structure for an axis-aligned bounding box.
+	* Uses the min-max representation.
+	*/
+	struct AABB
+	{
+		vec3 min;
+		vec3 max;
+	};
+
+	/**brief Initializes the specified AABB with the specified min and max values;
+	*/
+	void InitializeAABB(AABB& a, vec3 min, vec3 max);
+
+	/**brief Computes the properties of a AABB from the vertices of an object.
+	*/
+	void ComputeAABB(AABB& aabb, const std::vector<ShapesEngine::Vertex>& vertices);
+
+	/**brief Transforms the localAABB to world space by finding the extents and returning the resultant AABB.
+	* The transformation is done using vector-matrix multiplcation. The localAABB is treated as a row vector.
+	*/
+	void TransformAABB(AABB& worldAABB, const AABB& localAABB, const mat4& model);
+
+	/**brief Returns true if the specified AABBs are intersecting, false otherwise.
+	*/
+	bool TestIntersection(const AABB& a, const AABB& b);
+
+	/**brief Stores AABBs in structure of arrays (SoA) form so the batch functions can process 4 AABBs at a time.
+	*/
+	struct AABBArrays
+	{
+		std::vector<float> minX;
+		std::vector<float> minY;
+		std::vector<float> minZ;
+
+		std::vector<float> maxX;
+		std::vector<float> maxY;
+		std::vector<float> maxZ;
+	};
+
+	/**brief Returns the number of AABBs stored in the specified AABBArrays.
+	*/
+	unsigned int GetNumberOfAABBs(const AABBArrays& aabbs);
+
+	/**brief Sets the number of AABBs stored in the specified AABBArrays. New AABBs have their min and max set to the zero vector.
+	*/
+	void ResizeAABBs(AABBArrays& aabbs, unsigned int numAABBs);
+
+	/**brief Appends the AABB to the arrays and returns its index.
+	*/
+	unsigned int AddAABB(AABBArrays& aabbs, const AABB& aabb);
+
+	/**brief Stores the AABB at the specified index.
+	*/
+	void SetAABB(AABBArrays& aabbs, unsigned int index, const AABB& aabb);
+
+	/**brief Returns the AABB at the specified index.
+	*/
+	AABB GetAABB(const AABBArrays& aabbs, unsigned int index);
+
+	/**brief Transforms the local AABBs to world space using their model matrices and stores the results in worldAABBs.
+	*
+	* Uses Arvo's method on the center and extents of the AABBs, 4 AABBs at a time. models has to have a matrix for each local AABB.
+	* worldAABBs is resized to the number of local AABBs.
+	*/
+	void TransformAABBs(AABBArrays& worldAABBs, const AABBArrays& localAABBs, const mat4* models);
+
+	/**brief Tests the AABB against all the AABBs in the arrays, 4 at a time, and returns the number of intersections.
+	*
+	* Bit i % 32 of mask[i / 32] is set if the AABB intersects the AABB at index i and cleared otherwise.
+	* mask has to have room for (GetNumberOfAABBs(aabbs) + 31) / 32 elements.
+	*/
+	unsigned int TestIntersection(const AABB& aabb, const AABBArrays& aabbs, unsigned int* mask);
+
+	struct Sphere
+	{
+		vec3 center;
+		float radius{ 1.0f };
+	};
+
+	/**brief Initializes the properties of a sphere.
+	*/
+	void InitalizeSphere(Sphere& sphere, const vec3& center, float radius);
+
+	/**brief Computes the properties of a sphere from the vertices of an object using Ritter's method.
+	*/
+	void ComputeSphere(Sphere& sphere, const std::vector<ShapesEngine::Vertex>& vertices);
+
+	/**brief Computes the minimum sphere that bounds the vertices of an object using Welzl's algorithm with the move-to-front heuristic.
+	*
+	* The sphere is usually 5-20% smaller than the one computed by ComputeSphere. Compute it once per mesh and share it between
+	* the BoundingSpheres of the objects that use the mesh.
+	*/
+	void ComputeMinimumSphere(Sphere& sphere, const std::vector<ShapesEngine::Vertex>& vertices);
+
+	/**brief Transforms the sphere from local space to world space using a row-major transformation matrix.
+	*/
+	void TransformSphere(Sphere& worldSphere, const Sphere& localSphere, const mat4& model);
+
+	/**brief Returns true if the two spheres are intersecting, false otherwise.
+	*/
+	bool TestIntersection(const Sphere& a, const Sphere& b);
+
+	/**brief Returns the model matrix used to render the AABB, a unit cube scaled to the size of the AABB and moved to its center.
+	*/
+	mat4 ComputeAABBModelMatrix(const AABB& aabb);
+
+	/**brief Returns the model matrix used to render the sphere, a unit sphere scaled by the radius and moved to the center.
+	*/
+	mat4 ComputeSphereModelMatrix(const Sphere& sphere);
+}
\ No newline at end of file
@@ -1,34 +1,11 @@
 #pragma once
 
 #include "BoundingVolume.h"
+#include "BoundingGeometry.h"
 #include "Color.h"
-#include "Vertex.h"
-#include <vector>
 
 namespace PhysicsEngine
 {
-	struct Sphere
-	{
-		vec3 center;
-		float radius{ 1.0f };
-	};
-
-	/**brief Initializes the properties of a sphere.
-	*/
-	void InitalizeSphere(Sphere& sphere, const vec3& center, float radius);
-
-	/**brief Computes the properties of a sphere from the vertices of an object using Ritter's method.
-	*/
-	void ComputeSphere(Sphere& sphere, const std::vector<ShapesEngine::Vertex>& vertices);
-
-	/**brief Transforms the sphere from local space to world space using a row-major transformation matrix.
-	*/
-	void TransformSphere(Sphere& worldSphere, const Sphere& localSphere, const mat4& model);
-
-	/**brief Returns true if the two spheres are intersecting, false otherwise.
-	*/
-	bool TestIntersection(const Sphere& a, const Sphere& b);
-
 	/** @class BoundingSphere ""
 	*	@brief This class is used to bound an object using a sphere and also for rendering it.
 	*/
@@ -43,10 +20,22 @@ namespace PhysicsEngine
 		*/
 		BoundingSphere(const std::vector<ShapesEngine::Vertex>& vertices, const RenderingEngine::Color& color);
 
+		/**brief Initializes the properties of the BoundingSphere using a sphere in local space that was already computed.
+		*/
+		BoundingSphere(const Sphere& localSphere, const RenderingEngine::Color& color);
+
 		/**brief Initializes the properties of the BoundingSphere.
 		*/
 		void InitializeBoundingSphere(const std::vector<ShapesEngine::Vertex>& vertices, const RenderingEngine::Color& color);
 
+		/**brief Initializes the properties of the BoundingSphere using a sphere in local space that was already computed.
+		*/
+		void InitializeBoundingSphere(const Sphere& localSphere, const RenderingEngine::Color& color);
+
+		/**@brief Returns the sphere in local space.
+		*/
+		const Sphere& GetLocalSphere() const;
+
 		/**@brief Updates the BoundingSpheres model matrix.
 		*/
 		void UpdateModelMatrix() override;
@@ -55,6 +44,14 @@ namespace PhysicsEngine
 		*/
 		void TransformBoundingVolume(const mat4& model) override;
 
+		/**@brief Returns BOUNDING_SPHERE.
+		*/
+		BoundingVolumeType GetType() const override;
+
+		/**@brief Returns the sphere in world space.
+		*/
+		const Sphere& GetWorldSphere() const;
+
 	private:
 		Sphere mLocalBoundingSphere;
 		Sphere mWorldBoundingSphere;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BoundingGeometry.h"
 #include "Color.h"
 #include "DrawArguments.h"
 #include "RenderingEngineUtility.h"
@@ -18,6 +19,10 @@ namespace PhysicsEngine
 		*/
 		virtual void TransformBoundingVolume(const mat4& model) = 0;
 
+		/**@brief Returns the type of a bounding volume.
+		*/
+		virtual BoundingVolumeType GetType() const = 0;
+
 		/**@brief Returns the color of a bounding volume.
 		*/
 		virtual const RenderingEngine::Color& GetColor() const;
@@ -57,4 +62,12 @@ namespace PhysicsEngine
 	protected:
 		RenderingEngine::RenderObject mRenderObject;
 	};
+
+	struct BoundingVolumeArrays;
+
+	/**brief Adds a body bounded by the local volume of the specified BoundingSphere or BoundingBox to the arrays and returns the index of the body.
+	*
+	* Lets code that uses BoundingSphere and BoundingBox objects move their volumes into a BoundingVolumeArrays object.
+	*/
+	unsigned int AddBoundingVolume(BoundingVolumeArrays& volumes, const BoundingVolumeAbstract& boundingVolume);
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "BoundingGeometry.h"
+
+namespace PhysicsEngine
+{
+	/**brief The type of the bounding volume of a body and the index of the volume in the array of its type.
+	*/
+	struct BoundingVolumeHandle
+	{
+		BoundingVolumeType type{ BOUNDING_SPHERE };
+		unsigned int index{ 0 };
+	};
+
+	/**brief Stores the bounding volumes of many bodies sorted by type.
+	*
+	* The spheres are stored together and the AABBs are stored together, so the update passes run one loop per type
+	* with no virtual calls. Each body has a handle with the type and index of its volume.
+	* sphereBodies and boxBodies store the body each volume belongs to.\n
+	*
+	* boxModels is scratch memory used by TransformBoundingVolumes so it does not allocate after the first call.
+	*/
+	struct BoundingVolumeArrays
+	{
+		std::vector<BoundingVolumeHandle> handles;
+
+		std::vector<Sphere> localSpheres;
+		std::vector<Sphere> worldSpheres;
+		std::vector<unsigned int> sphereBodies;
+
+		AABBArrays localBoxes;
+		AABBArrays worldBoxes;
+		std::vector<unsigned int> boxBodies;
+
+		std::vector<mat4> boxModels;
+	};
+
+	/**brief Returns the number of bodies that have a bounding volume in the arrays.
+	*/
+	unsigned int GetNumberOfBoundingVolumes(const BoundingVolumeArrays& volumes);
+
+	/**brief Adds a body bounded by the sphere in local space and returns the index of the body.
+	*/
+	unsigned int AddBoundingSphere(BoundingVolumeArrays& volumes, const Sphere& localSphere);
+
+	/**brief Adds a body bounded by the AABB in local space and returns the index of the body.
+	*/
+	unsigned int AddBoundingBox(BoundingVolumeArrays& volumes, const AABB& localAABB);
+
+	/**brief Returns the type of the bounding volume of the body at the specified index.
+	*/
+	BoundingVolumeType GetBoundingVolumeType(const BoundingVolumeArrays& volumes, unsigned int body);
+
+	/**brief Returns the sphere in world space of the body at the specified index. The body has to be bounded by a sphere.
+	*/
+	const Sphere& GetWorldSphere(const BoundingVolumeArrays& volumes, unsigned int body);
+
+	/**brief Returns the AABB in world space of the body at the specified index. The body has to be bounded by an AABB.
+	*/
+	AABB GetWorldAABB(const BoundingVolumeArrays& volumes, unsigned int body);
+
+	/**brief Transforms all the bounding volumes from local space to world space.
+	*
+	* models has to have a model matrix for each body. The spheres are transformed in one loop and the AABBs are transformed
+	* 4 at a time with TransformAABBs.
+	*/
+	void TransformBoundingVolumes(BoundingVolumeArrays& volumes, const mat4* models);
+
+	/**brief Computes the model matrix used to render the world space bounding volume of each body and stores it at the index of the body.
+	*
+	* The matrices are the ones ComputeSphereModelMatrix and ComputeAABBModelMatrix return, which BoundingSphere::UpdateModelMatrix
+	* and BoundingBox::UpdateModelMatrix use as well.
+	*/
+	void ComputeBoundingVolumeModelMatrices(const BoundingVolumeArrays& volumes, mat4* models);
+}
\ No newline at end of file
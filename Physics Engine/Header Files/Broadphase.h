@@ -0,0 +1,123 @@
+#pragma once
+
+#include "MathEngine.h"
+#include "StepProfiler.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief The collision layer every body is on by default.
+	*/
+	const unsigned int DEFAULT_COLLISION_LAYER{ 0x00000001 };
+
+	/**brief The collision mask that lets a body collide with every layer.
+	*/
+	const unsigned int ALL_COLLISION_LAYERS{ 0xffffffff };
+
+	/**brief Decides which bodies a body can collide with.
+	*
+	* layer has the bits of the layers the body is on and mask has the bits of the layers it collides with.
+	* Two bodies collide only if each one is on a layer in the mask of the other.\n
+	* Bodies that share a group other than 0 never collide with each other, for example the parts of one ragdoll.
+	* A mask of 0 takes the body out of the pairs completely, which is what trigger volumes want.
+	*/
+	struct CollisionFilter
+	{
+		unsigned int layer{ DEFAULT_COLLISION_LAYER };
+		unsigned int mask{ ALL_COLLISION_LAYERS };
+		unsigned int group{ 0 };
+	};
+
+	/**brief Returns true if bodies with the two filters can collide.
+	*/
+	bool ShouldCollide(const CollisionFilter& a, const CollisionFilter& b);
+
+	/**brief A pair of bodies whose bounds overlap. bodyA is always less than bodyB.
+	*/
+	struct BodyPair
+	{
+		unsigned int bodyA{ 0 };
+		unsigned int bodyB{ 0 };
+	};
+
+	/** @class Broadphase ""
+	*	@brief Finds the pairs of bodies whose axis-aligned bounds overlap with sort and sweep.
+	*
+	*	The bodies are kept sorted by the lower x bound of their boxes. Bodies move a little each step, so the order from the last
+	*	step is almost sorted and an insertion sort puts it back in order in close to linear time.\n
+	*
+	*	The collision filters are checked before a pair is stored, so a pair that cannot collide costs two ANDs and never reaches
+	*	the narrowphase. The layers and masks are stored in their own arrays so the check does not touch the bounds.
+	*/
+	class Broadphase
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a broadphase with no bodies.
+		*/
+		Broadphase();
+
+		/**brief Adds a body with the bounds from min to max and the filter, and returns the index of the body.
+		*/
+		unsigned int AddBody(const vec3& min, const vec3& max, const CollisionFilter& filter = CollisionFilter{});
+
+		/**brief Removes all the bodies and pairs.
+		*/
+		void ClearBodies();
+
+		/**brief Returns the number of bodies.
+		*/
+		unsigned int GetNumberOfBodies() const;
+
+		/**brief Sets the bounds of the body at the specified index. Call it for each body that moved before FindPairs.
+		*/
+		void SetBounds(unsigned int body, const vec3& min, const vec3& max);
+
+		/**brief Moves the origin of the coordinates by shift, which subtracts shift from the bounds of every body.
+		*
+		* Subtracting the same value from every lower x bound cannot change their order, so the bodies stay sorted
+		* and the next FindPairs has nothing to sort.
+		*/
+		void ShiftOrigin(const vec3& shift);
+
+		/**brief Sets the collision filter of the body at the specified index.
+		*/
+		void SetCollisionFilter(unsigned int body, const CollisionFilter& filter);
+
+		/**brief Returns the collision filter of the body at the specified index.
+		*/
+		CollisionFilter GetCollisionFilter(unsigned int body) const;
+
+		/**brief Finds the pairs of bodies whose bounds overlap and whose filters let them collide.
+		*
+		* The pairs are in the order of the sweep, which only depends on the bounds, so the result is the same every time
+		* for the same bounds.\n
+		* If the profiler is not nullptr the search is timed as PHASE_BROADPHASE and the number of pairs is added to the step.
+		*/
+		void FindPairs(StepProfiler* profiler = nullptr);
+
+		/**brief Returns the pairs from the last call to FindPairs.
+		*/
+		const std::vector<BodyPair>& GetPairs() const;
+
+	private:
+		void SortBodies();
+
+		std::vector<float> mMinX;
+		std::vector<float> mMinY;
+		std::vector<float> mMinZ;
+		std::vector<float> mMaxX;
+		std::vector<float> mMaxY;
+		std::vector<float> mMaxZ;
+
+		std::vector<unsigned int> mLayers;
+		std::vector<unsigned int> mMasks;
+		std::vector<unsigned int> mGroups;
+
+		//The bodies sorted by their lower x bound, and the number of bodies that were in the order when it was last sorted.
+		std::vector<unsigned int> mOrder;
+		unsigned int mNumSorted;
+
+		std::vector<BodyPair> mPairs;
+	};
+}
\ No newline at end of file
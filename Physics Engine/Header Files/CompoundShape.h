@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Narrowphase.h"
+#include "PrimitiveMassProperties.h"
+
+namespace PhysicsEngine
+{
+	/**brief A child of a CompoundShape, a shape with a position and orientation relative to the origin of the compound.
+	*
+	* Children can have different mass densities, for example a heavy base on a light frame.
+	*/
+	struct CompoundChild
+	{
+		CollisionShape shape;
+		vec3 position;
+		MathEngine::Quaternion orientation;
+		float massDensity{ 1.0f };
+	};
+
+	/**brief A node of the bounding volume hierarchy over the children of a CompoundShape.
+	*
+	* If count is 0 the node is internal and its children are nodes first and first + 1.
+	* Otherwise it is a leaf with the count children listed at first in the child order of the compound.
+	*/
+	struct CompoundNode
+	{
+		vec3 min;
+		vec3 max;
+		unsigned int first{ 0 };
+		unsigned int count{ 0 };
+	};
+
+	/**brief The child index of a shape that is not a compound.
+	*/
+	const unsigned int NO_CHILD{ 0xffffffff };
+
+	/**brief A contact between a child of compound A and shape B, or a child of B if it is also a compound.
+	*
+	* childB is NO_CHILD when B is not a compound. The normal of the manifold points from A to B.
+	*/
+	struct CompoundContact
+	{
+		unsigned int childA{ 0 };
+		unsigned int childB{ NO_CHILD };
+		ContactManifold manifold;
+	};
+
+	/**brief Computes the mass properties of the shape with a mass density of 1, in the coordinates of the shape.
+	*
+	* Spheres, boxes, cylinders and capsules use the closed forms. Convex shapes are integrated over the triangles of their hull.
+	*/
+	void ComputeMassProperties(const CollisionShape& shape, MassProperties& massProperties);
+
+	/** @class CompoundShape ""
+	*	@brief Several shapes attached to one rigid body.
+	*
+	*	The mass properties of the children are combined with the parallel axis theorem, so one body moves like the whole object.
+	*	The children are moved when the compound is initialized so the center of mass is at the origin of the compound, which
+	*	makes the position of the compound the center of mass of its rigid body.\n
+	*
+	*	A small bounding volume hierarchy over the children lets a collision skip the children outside the region where the bounds
+	*	of the two shapes overlap before any narrowphase work is done.
+	*/
+	class CompoundShape
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a compound with no children.
+		*/
+		CompoundShape();
+
+		/**brief Creates a compound with the children.
+		*/
+		CompoundShape(const std::vector<CompoundChild>& children);
+
+		/**brief Initializes the compound with the children, computes its mass properties and builds its hierarchy.
+		*
+		* The children are moved by the negative of their combined center of mass, which GetCenterOfMassOffset returns.
+		*/
+		void InitializeCompoundShape(const std::vector<CompoundChild>& children);
+
+		/**brief Returns the number of children.
+		*/
+		unsigned int GetNumberOfChildren() const;
+
+		/**brief Returns the child at the specified index, with its position relative to the center of mass.
+		*/
+		const CompoundChild& GetChild(unsigned int index) const;
+
+		/**brief Returns where the center of mass was relative to the origin the children were given in.
+		*
+		* To place the compound so the children are where they were given, put its rigid body at that origin plus the offset
+		* rotated by the orientation of the body.
+		*/
+		const vec3& GetCenterOfMassOffset() const;
+
+		/**brief Returns the combined mass properties of the children with their mass densities, relative to the center of mass.
+		*
+		* The mass densities are already applied, so initialize the rigid body with a mass density of 1 and a scale of identity.
+		*/
+		const MassProperties& GetMassProperties() const;
+
+		/**brief Returns the nodes of the hierarchy. The root is the first node and its bounds are the bounds of the compound.
+		*/
+		const std::vector<CompoundNode>& GetNodes() const;
+
+		/**brief Stores the indices of the children whose bounds overlap the box from min to max in children.
+		*
+		* The box is in the coordinates of the compound.
+		*/
+		void FindChildren(const vec3& min, const vec3& max, std::vector<unsigned int>& children) const;
+
+	private:
+		void BuildNode(unsigned int node, unsigned int first, unsigned int count);
+
+		std::vector<CompoundChild> mChildren;
+		std::vector<vec3> mChildMins;
+		std::vector<vec3> mChildMaxs;
+
+		std::vector<CompoundNode> mNodes;
+		std::vector<unsigned int> mChildOrder;
+
+		vec3 mCenterOfMassOffset;
+		MassProperties mMassProperties;
+	};
+
+	/**brief Computes the axis-aligned box around the compound at the position and orientation.
+	*/
+	void ComputeCompoundBounds(const CompoundShape& compound, const vec3& position, const MathEngine::Quaternion& orientation,
+		vec3& min, vec3& max);
+
+	/**brief Collides compound A with shape B and adds a contact to contacts for each child of A that intersects B.
+	*
+	* Only the children whose bounds overlap the region where the bounds of A and B overlap are passed to the narrowphase.
+	* Returns the number of contacts added.
+	*/
+	unsigned int CollideCompound(const CompoundShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, std::vector<CompoundContact>& contacts);
+
+	/**brief Collides compound A with compound B and adds a contact to contacts for each pair of children that intersect.
+	*
+	* The children of both compounds are culled against the region where the bounds of A and B overlap, and each pair of children
+	* against the region where their own bounds overlap. Returns the number of contacts added.
+	*/
+	unsigned int CollideCompounds(const CompoundShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CompoundShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, std::vector<CompoundContact>& contacts);
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "RigidBodyArrays.h"
+#include "StepProfiler.h"
+
+namespace PhysicsEngine
+{
+	/**brief A contact between two bodies of a RigidBodyArrays object.
+	*
+	* The normal points from body A to body B like the normal of a ContactManifold, and the point and depth are the ones the narrowphase found.
+	* Either body can be INVALID_BODY for static geometry. Bodies with an inverse mass of 0 are also treated as static geometry.\n
+	* The members after friction are filled in by the ContactSolver.
+	*/
+	struct ContactConstraint
+	{
+		unsigned int bodyA{ INVALID_BODY };
+		unsigned int bodyB{ INVALID_BODY };
+		vec3 point;
+		vec3 normal;
+		float depth{ 0.0f };
+		float friction{ 0.5f };
+
+		vec3 rA;
+		vec3 rB;
+		vec3 tangent1;
+		vec3 tangent2;
+		float normalMass{ 0.0f };
+		float tangentMass1{ 0.0f };
+		float tangentMass2{ 0.0f };
+		float bias{ 0.0f };
+		float normalImpulse{ 0.0f };
+		float tangentImpulse1{ 0.0f };
+		float tangentImpulse2{ 0.0f };
+	};
+
+	/**brief The largest number of batches in a ConstraintColoring, including the overflow batch.
+	*/
+	const unsigned int MAX_CONSTRAINT_COLORS{ 64 };
+
+	/**brief The constraints sorted into batches whose constraints do not share a body that can move.
+	*
+	* constraints has the indices of the constraints batch by batch. Batch i is constraints[batchStarts[i]] to constraints[batchStarts[i + 1] - 1],
+	* so batchStarts has one more element than there are batches.\n
+	* If a constraint does not fit in the first MAX_CONSTRAINT_COLORS - 1 colors it goes into an overflow batch, which is always the last batch.
+	* The constraints of the overflow batch can share bodies, so they have to be solved one after the other.
+	*/
+	struct ConstraintColoring
+	{
+		std::vector<unsigned int> constraints;
+		std::vector<unsigned int> batchStarts;
+		bool hasOverflow{ false };
+
+		//The colors each body has been given as bits, and the color of each constraint.
+		//They are kept so coloring again does not allocate.
+		std::vector<unsigned long long> bodyColors;
+		std::vector<unsigned char> constraintColors;
+	};
+
+	/**brief Colors the constraints so no two constraints of the same color share a body that can move, and stores them in batches by color.
+	*
+	* Each constraint, in index order, gets the lowest color neither of its bodies has been given yet, so the coloring is the same every time
+	* for the same constraints. Static bodies are only read by the solver, so any number of constraints of a color can share them.
+	*/
+	void ColorConstraints(const RigidBodyArrays& bodies, const std::vector<ContactConstraint>& constraints, ConstraintColoring& coloring);
+
+	/**brief Returns the number of batches in the coloring.
+	*/
+	unsigned int GetNumberOfBatches(const ConstraintColoring& coloring);
+
+	/** @class ContactSolver ""
+	*	@brief Solves contact constraints with projected Gauss-Seidel, one color batch at a time.
+	*
+	*	The constraints of a batch do not share a body that can move, so they can be solved in any order without write conflicts.
+	*	Each batch is split between the threads, and the threads wait for each other before the next batch.
+	*	The batches are always solved in the same order, so the result does not depend on the number of threads.
+	*/
+	class ContactSolver
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a solver that does 10 iterations on one thread.
+		*/
+		ContactSolver();
+
+		/**brief Creates a solver that does the specified number of iterations on the specified number of threads.
+		*/
+		ContactSolver(unsigned int numIterations, unsigned int numThreads);
+
+		/**brief Sets the number of iterations and threads.
+		*
+		* If numThreads is 0 the number of hardware threads is used. If numIterations is 0 it is set to 1.
+		*/
+		void InitializeContactSolver(unsigned int numIterations, unsigned int numThreads);
+
+		/**brief Returns the number of iterations.
+		*/
+		unsigned int GetNumberOfIterations() const;
+
+		/**brief Returns the number of threads.
+		*/
+		unsigned int GetNumberOfThreads() const;
+
+		/**brief Returns the coloring of the constraints from the last call to SolveContacts.
+		*/
+		const ConstraintColoring& GetColoring() const;
+
+		/**brief Solves the contacts for a step of dt and adds the impulses to the net forces and net torques of the bodies.
+		*
+		* Call it after the forces are applied and before the bodies are integrated. The velocities the contacts see include the net forces,
+		* and the impulses are added as forces of impulse / dt, so IntegrateRigidBodies ends the step with the solved velocities.\n
+		* Penetration is removed by asking each contact to separate at a speed proportional to its depth.\n
+		* If the profiler is not nullptr the solve is timed as PHASE_SOLVE and the number of batches is added to the step.
+		*/
+		void SolveContacts(RigidBodyArrays& bodies, std::vector<ContactConstraint>& contacts, float dt, StepProfiler* profiler = nullptr);
+
+	private:
+		struct SolverBody
+		{
+			vec3 linearVelocity;
+			vec3 angularVelocity;
+			vec3 linearImpulse;
+			vec3 angularImpulse;
+			mat3 inverseInertia;
+			float inverseMass;
+		};
+
+		struct ThreadBarrier;
+
+		static void PrepareContact(ContactConstraint& contact, const RigidBodyArrays& bodies, const SolverBody& a, const SolverBody& b, float dt);
+		static void ApplyImpulse(SolverBody& body, const vec3& r, const vec3& impulse);
+		static void SolveContact(ContactConstraint& contact, SolverBody& a, SolverBody& b);
+		unsigned int GetSolverBody(const RigidBodyArrays& bodies, unsigned int body) const;
+
+		void SolveOnThread(RigidBodyArrays& bodies, std::vector<ContactConstraint>& contacts, float dt, unsigned int thread,
+			unsigned int numThreads, ThreadBarrier& barrier);
+
+		unsigned int mNumIterations;
+		unsigned int mNumThreads;
+
+		//The velocities of the bodies while they are solved. The last solver body is the static body, it never moves.
+		std::vector<SolverBody> mBodies;
+		ConstraintColoring mColoring;
+	};
+}
\ No newline at end of file
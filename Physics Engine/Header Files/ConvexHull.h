@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Vertex.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief A convex polyhedron made of triangles, used as a collision proxy for a render mesh.
+	*
+	* Every 3 indices are a triangle whose vertices are counterclockwise when seen from outside the hull.
+	* The plane of face i is DotProduct(faceNormals[i], p) = faceDistances[i] and its normal points out of the hull.\n
+	*
+	* The neighbors of vertex i are neighbors[neighborOffsets[i]] to neighbors[neighborOffsets[i + 1] - 1], the vertices that share
+	* an edge with it. They are used to find support vertices by hill climbing instead of testing every vertex.
+	* edgeFaces[k] is the face that has the edge going from vertex i to neighbors[k], so the two faces of an edge are the edgeFaces
+	* of its two directions.
+	*/
+	struct ConvexHull
+	{
+		std::vector<vec3> vertices;
+		std::vector<unsigned int> indices;
+
+		std::vector<vec3> faceNormals;
+		std::vector<float> faceDistances;
+
+		std::vector<unsigned int> neighborOffsets;
+		std::vector<unsigned int> neighbors;
+		std::vector<unsigned int> edgeFaces;
+	};
+
+	/**brief Computes the convex hull of the points with the Quickhull algorithm and stores it in hull.
+	*
+	* If maxVertices is greater than 0 the hull stops growing once it has that many vertices, with a minimum of 4.
+	* Each vertex added is the point farthest outside the hull so far, so the reduced hull is the best fit the algorithm can
+	* make with the budget. The reduced hull is inside the exact hull, points that did not make the budget can be outside it.\n
+	*
+	* Points closer to a face than a small tolerance that depends on the size of the points are treated as on the face,
+	* so coplanar and duplicate points do not add vertices.\n
+	* Returns false and clears the hull if all the points lie in a plane or on a line.
+	*/
+	bool ComputeConvexHull(const vec3* points, unsigned int numPoints, ConvexHull& hull, unsigned int maxVertices = 0);
+
+	/**brief Computes the convex hull of the positions of the vertices.
+	*/
+	bool ComputeConvexHull(const std::vector<ShapesEngine::Vertex>& vertices, ConvexHull& hull, unsigned int maxVertices = 0);
+
+	/**brief Returns the index of the vertex of the hull that is farthest in the specified direction.
+	*
+	* Starts at startVertex and moves to a neighbor that is farther in the direction until there is none.
+	* Passing the result of the previous query as startVertex makes queries in similar directions take only a few steps.
+	*/
+	unsigned int FindSupportVertex(const ConvexHull& hull, const vec3& direction, unsigned int startVertex = 0);
+
+	/**brief Returns the vertex of the hull that is farthest in the specified direction.
+	*/
+	vec3 GetSupportPoint(const ConvexHull& hull, const vec3& direction);
+
+	/**brief Returns how far the point that is farthest outside the hull is above the face planes of the hull, or 0 if every point is inside.
+	*
+	* Use it to see how much a hull that was reduced to a vertex budget cuts off the points it was computed from.
+	*/
+	float ComputeHullError(const ConvexHull& hull, const vec3* points, unsigned int numPoints);
+}
\ No newline at end of file
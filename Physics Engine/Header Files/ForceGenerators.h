@@ -0,0 +1,150 @@
+#pragma once
+
+#include "RigidBodyArrays.h"
+
+namespace PhysicsEngine
+{
+	/**brief Applies F = mg to every body in the range, where g is the gravity acceleration vector.
+	*/
+	struct UniformGravityGenerator
+	{
+		vec3 acceleration;
+		BodyRange range;
+	};
+
+	/**brief Applies F = -v(k1|v| + k2|v|^2) to every body in the range, where v is the velocity of the body relative to the wind velocity.
+	*
+	* With a zero wind velocity this is the same drag force as DragForce.
+	*/
+	struct DragGenerator
+	{
+		vec3 windVelocity;
+		float k1{ 0.0f };
+		float k2{ 0.0f };
+		BodyRange range;
+	};
+
+	/**brief Pulls every body in the range towards a point with F = (strength * m / r^2) * U, where r is the distance to the point
+	* and U is the direction to the point.
+	*
+	* The distance is clamped to minDistance so the force stays finite near the point.
+	*/
+	struct PointAttractorGenerator
+	{
+		vec3 point;
+		float strength{ 0.0f };
+		float minDistance{ 0.1f };
+		BodyRange range;
+	};
+
+	/**brief A damped spring between a point on body A and a point on body B, or a fixed anchor if body B is INVALID_BODY.
+	*
+	* The points on the bodies are in body coordinates relative to the center of mass. If body B is INVALID_BODY, localPointB is the anchor
+	* point in world coordinates.\n
+	* Formula used is F = -(k(|d| - restLength) + c(relative velocity . U)) * U, where d is the vector from the point on B to the point on A
+	* and U = d / |d|. The force is applied at the points, so it also produces a torque.
+	*/
+	struct SpringGenerator
+	{
+		unsigned int bodyA{ 0 };
+		unsigned int bodyB{ 0 };
+		vec3 localPointA;
+		vec3 localPointB;
+		float restLength{ 0.0f };
+		float stiffness{ 0.0f };
+		float damping{ 0.0f };
+	};
+
+	/**brief Adds the force due to the gravity generator to the net force of each body in its range.
+	*/
+	void ApplyUniformGravity(RigidBodyArrays& bodies, const UniformGravityGenerator& gravity);
+
+	/**brief Adds the force due to the drag generator to the net force of each body in its range.
+	*/
+	void ApplyDrag(RigidBodyArrays& bodies, const DragGenerator& drag);
+
+	/**brief Adds the force due to the point attractor to the net force of each body in its range.
+	*/
+	void ApplyPointAttractor(RigidBodyArrays& bodies, const PointAttractorGenerator& attractor);
+
+	/**brief Adds the spring force and the torque it produces to the net force and net torque of the bodies it is attached to.
+	*/
+	void ApplySpring(RigidBodyArrays& bodies, const SpringGenerator& spring);
+
+	/** @class ForceGeneratorRegistry ""
+	*	@brief Stores force generators and applies all of them to a RigidBodyArrays object.
+	*
+	*	Generators of the same type are stored together and applied one type at a time, so each body range is processed
+	*	in one pass over the arrays instead of calling a force function per body.
+	*/
+	class ForceGeneratorRegistry
+	{
+	public:
+		/**brief Default constructor.
+		*/
+		ForceGeneratorRegistry();
+
+		/**brief Registers uniform gravity for the specified range of bodies.
+		*
+		* The direction gets normalized.
+		*/
+		void RegisterUniformGravity(float gravityAcceleration, const vec3& direction, const BodyRange& range);
+
+		/**brief Registers drag for the specified range of bodies.
+		*
+		* k1 is the linear drag coefficient and k2 is the quadratic drag coefficient.
+		*/
+		void RegisterDrag(float k1, float k2, const BodyRange& range);
+
+		/**brief Registers a wind field for the specified range of bodies.
+		*
+		* The bodies get dragged towards the wind velocity using the linear and quadratic drag coefficients k1 and k2.
+		*/
+		void RegisterWindField(const vec3& windVelocity, float k1, float k2, const BodyRange& range);
+
+		/**brief Registers a point attractor for the specified range of bodies.
+		*/
+		void RegisterPointAttractor(const vec3& point, float strength, float minDistance, const BodyRange& range);
+
+		/**brief Registers a damped spring between a point on bodyA and a point on bodyB.
+		*
+		* The points are in body coordinates relative to the center of mass.
+		*/
+		void RegisterSpring(unsigned int bodyA, const vec3& localPointA, unsigned int bodyB, const vec3& localPointB,
+			float restLength, float stiffness, float damping);
+
+		/**brief Registers a damped spring between a point on the body and a fixed anchor point in world coordinates.
+		*/
+		void RegisterAnchoredSpring(unsigned int body, const vec3& localPoint, const vec3& anchor,
+			float restLength, float stiffness, float damping);
+
+		/**brief Removes all registered force generators.
+		*/
+		void ClearForceGenerators();
+
+		/**brief Returns the number of registered force generators.
+		*/
+		unsigned int GetNumberOfForceGenerators() const;
+
+		/**brief Returns the registered springs, including the anchored ones.
+		*/
+		const std::vector<SpringGenerator>& GetSpringGenerators() const;
+
+		/**brief Moves the origin of the world coordinates by shift, which subtracts shift from the points of the point attractors
+		* and the anchors of the anchored springs.
+		*/
+		void ShiftOrigin(const vec3& shift);
+
+		/**brief Adds the forces and torques of all the registered generators to the accumulators of the specified bodies.
+		*
+		* The accumulators are not cleared, call ResetForcesAndTorques before this function each step.
+		*/
+		void ApplyForceGenerators(RigidBodyArrays& bodies) const;
+
+	private:
+		std::vector<UniformGravityGenerator> mGravityGenerators;
+		std::vector<DragGenerator> mDragGenerators;
+		std::vector<PointAttractorGenerator> mPointAttractorGenerators;
+		std::vector<SpringGenerator> mSpringGenerators;
+	};
+}
\ No newline at end of file
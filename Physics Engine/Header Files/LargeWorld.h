@@ -0,0 +1,111 @@
+#pragma once
+
+#include "RigidBodyArrays.h"
+#include "ForceGenerators.h"
+#include "Broadphase.h"
+
+namespace PhysicsEngine
+{
+	/**brief A position in world coordinates with double precision.
+	*/
+	struct WorldPosition
+	{
+		double x{ 0.0 };
+		double y{ 0.0 };
+		double z{ 0.0 };
+	};
+
+	/** @class FloatingOrigin ""
+	*	@brief Keeps the float positions of a large world close to 0 by moving the origin they are relative to.
+	*
+	*	The position of a body in the world is the origin, which has double precision, plus the float center of mass in
+	*	the RigidBodyArrays object. A float has about 7 digits, so 10 km from its origin it can only tell positions 1 mm apart.
+	*	When the focus, usually the camera or the player, gets farther than the rebase distance from the origin, the origin
+	*	is moved under it and everything is shifted back by the same amount in one pass over the bodies.\n
+	*
+	*	The origin is always on a grid, and the grid size should be a power of 2, so every shift is exact in float
+	*	and the positions only round once per rebase.\n
+	*
+	*	Rendering should be relative to the camera as well. ComputeCameraRelativeTransforms finds the offset from the camera
+	*	to each body in double precision, so the transforms sent to the renderer are small even when the camera is far from the origin.
+	*/
+	class FloatingOrigin
+	{
+	public:
+		/**brief Default constructor.
+		* Creates an origin at (0, 0, 0) that rebases when the focus is more than 4096 units away, on a grid of 1024 units.
+		*/
+		FloatingOrigin();
+
+		/**brief Creates an origin at (0, 0, 0) with the specified rebase distance and grid size.
+		*/
+		FloatingOrigin(double rebaseDistance, double gridSize);
+
+		/**brief Moves the origin to (0, 0, 0) and sets the rebase distance and grid size.
+		*
+		* If gridSize is not greater than 0 the origin is not snapped to a grid.
+		*/
+		void InitializeFloatingOrigin(double rebaseDistance, double gridSize);
+
+		/**brief Returns the origin in world coordinates.
+		*/
+		const WorldPosition& GetOrigin() const;
+
+		/**brief Returns the amount the origin moved in the last call to UpdateOrigin that moved it.
+		*/
+		const vec3& GetLastShift() const;
+
+		/**brief Returns the number of times the origin has moved.
+		*/
+		unsigned int GetNumberOfRebases() const;
+
+		/**brief Returns the position relative to the origin.
+		*/
+		vec3 ToLocal(const WorldPosition& position) const;
+
+		/**brief Returns the world position of the position relative to the origin.
+		*/
+		WorldPosition ToWorld(const vec3& local) const;
+
+		/**brief Returns the world position of the center of mass of the body.
+		*/
+		WorldPosition GetWorldPosition(const RigidBodyArrays& bodies, unsigned int body) const;
+
+		/**brief Sets the center of mass of the body to the world position.
+		*/
+		void SetWorldPosition(RigidBodyArrays& bodies, unsigned int body, const WorldPosition& position) const;
+
+		/**brief Moves the origin to the grid point nearest to the focus if the focus is farther than the rebase distance from it.
+		*
+		* Returns true if the origin moved. Everything relative to the old origin then has to be shifted by GetLastShift,
+		* for example with the ShiftOrigin functions of the bodies, the force generators and the broadphase.
+		*/
+		bool UpdateOrigin(const WorldPosition& focus);
+
+		/**brief Calls UpdateOrigin and shifts the bodies, and the force generators and broadphase if they are not nullptr.
+		*
+		* Returns true if the origin moved. Each shift is one pass over the data, nothing is rebuilt.
+		*/
+		bool Rebase(const WorldPosition& focus, RigidBodyArrays& bodies, ForceGeneratorRegistry* forceGenerators = nullptr,
+			Broadphase* broadphase = nullptr);
+
+		/**brief Computes the model matrix of each body relative to the camera.
+		*
+		* localModels[i] is the model matrix of the mesh of body i relative to its center of mass, before it is rotated. It scales the mesh
+		* and moves the origin of the mesh to where it is from the center of mass, for example what ComputeLocalModelMatrix returns.\n
+		* transforms[i] is localModels[i], then the rotation of body i, then the offset from the camera to its center of mass, so it is the
+		* model matrix of the body with the camera position subtracted. The offsets are found in double precision before they are rounded
+		* to float, so the renderer gets small and precise numbers wherever the camera is. Render with a view matrix that has the camera at (0, 0, 0).
+		*/
+		void ComputeCameraRelativeTransforms(const RigidBodyArrays& bodies, const mat4* localModels, const WorldPosition& camera,
+			std::vector<mat4>& transforms) const;
+
+	private:
+		WorldPosition mOrigin;
+		double mRebaseDistance;
+		double mGridSize;
+
+		vec3 mLastShift;
+		unsigned int mNumRebases;
+	};
+}
\ No newline at end of file
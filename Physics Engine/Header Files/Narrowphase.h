@@ -0,0 +1,131 @@
+#pragma once
+
+#include "ConvexHull.h"
+
+namespace PhysicsEngine
+{
+	/**brief The types of shapes the narrowphase can collide.
+	*/
+	enum CollisionShapeType { COLLISION_SPHERE = 0, COLLISION_BOX, COLLISION_CAPSULE, COLLISION_CYLINDER, COLLISION_CONVEX, NUM_COLLISION_SHAPES };
+
+	/**brief The shape of a body in body coordinates, centered at the origin of the body.
+	*
+	* A sphere uses the radius. A box uses the half extents.\n
+	* A capsule is a segment from (0, -halfHeight, 0) to (0, halfHeight, 0) grown by the radius.
+	* A cylinder has the radius and goes from y = -halfHeight to y = halfHeight.\n
+	* A convex shape uses the hull, which is not owned by the shape and has to stay alive while the shape is used.
+	*/
+	struct CollisionShape
+	{
+		CollisionShapeType type{ COLLISION_SPHERE };
+		float radius{ 0.5f };
+		float halfHeight{ 0.5f };
+		vec3 halfExtents{ 0.5f, 0.5f, 0.5f };
+		const ConvexHull* hull{ nullptr };
+	};
+
+	/**brief Returns a sphere with the specified radius.
+	*/
+	CollisionShape MakeSphereShape(float radius);
+
+	/**brief Returns a box with the specified half extents.
+	*/
+	CollisionShape MakeBoxShape(const vec3& halfExtents);
+
+	/**brief Returns a capsule with the specified radius whose segment goes from -halfHeight to halfHeight along the y-axis.
+	*/
+	CollisionShape MakeCapsuleShape(float radius, float halfHeight);
+
+	/**brief Returns a cylinder with the specified radius that goes from -halfHeight to halfHeight along the y-axis.
+	*/
+	CollisionShape MakeCylinderShape(float radius, float halfHeight);
+
+	/**brief Returns a convex shape that uses the hull.
+	*/
+	CollisionShape MakeConvexShape(const ConvexHull& hull);
+
+	/**brief Computes the axis-aligned box around the shape at the position and orientation.
+	*/
+	void ComputeShapeBounds(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation, vec3& min, vec3& max);
+
+	/**brief The largest number of points in a contact manifold.
+	*/
+	const unsigned int MAX_MANIFOLD_POINTS{ 4 };
+
+	/**brief The contacts between two shapes A and B.
+	*
+	* The normal points from A to B, so moving B by normal * depths[i] separates the shapes at points[i].
+	* Each point is halfway between the surfaces of the two shapes.
+	*/
+	struct ContactManifold
+	{
+		vec3 normal;
+		vec3 points[MAX_MANIFOLD_POINTS];
+		float depths[MAX_MANIFOLD_POINTS]{};
+		unsigned int numPoints{ 0 };
+	};
+
+	/**brief A function that collides shape A at its position and orientation with shape B at its position and orientation.
+	*
+	* Returns true and stores the contacts in manifold if the shapes intersect, false otherwise.
+	*/
+	typedef bool (*CollideFunction)(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Returns the function the dispatch table uses for the pair of shape types.
+	*
+	* Sphere-sphere, sphere-box, box-box, sphere-capsule, capsule-capsule and sphere-cylinder, in either order, have their own function.
+	* Every other pair uses CollideGJK.
+	*/
+	CollideFunction GetCollideFunction(CollisionShapeType a, CollisionShapeType b);
+
+	/**brief Collides the two shapes with the function for their types from the dispatch table.
+	*/
+	bool Collide(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides two spheres. The manifold has one point.
+	*/
+	bool CollideSphereSphere(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides sphere A with box B. The manifold has one point.
+	*/
+	bool CollideSphereBox(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides two boxes.
+	*
+	* Finds the axis of least penetration with the separating axis test over the 3 face normals of each box and the 9 cross products
+	* of their edges. Face axes are preferred when an edge axis is only slightly better.\n
+	* For a face axis the incident face of the other box is clipped against the sides of the reference face, and up to 4 points
+	* below the reference face are kept. For an edge axis the manifold has the one point between the two closest edges.
+	*/
+	bool CollideBoxBox(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides sphere A with capsule B. The manifold has one point.
+	*/
+	bool CollideSphereCapsule(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides two capsules.
+	*
+	* The manifold has two points when the segments are parallel and overlap, so a capsule lying on another does not roll on one point.
+	*/
+	bool CollideCapsuleCapsule(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides sphere A with cylinder B. The manifold has one point.
+	*/
+	bool CollideSphereCylinder(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+
+	/**brief Collides any two shapes with GJK and EPA. The manifold has one point.
+	*
+	* Spheres and capsules are treated as a point and a segment grown by their radius. If those cores do not overlap, GJK finds their
+	* closest points and the contact is exact. Otherwise EPA finds the axis of least penetration of the full shapes.
+	*/
+	bool CollideGJK(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold);
+}
\ No newline at end of file
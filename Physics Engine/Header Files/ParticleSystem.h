@@ -0,0 +1,183 @@
+#pragma once
+
+#include "MathEngine.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief Describes how an emitter creates particles.
+	*
+	* Particles are emitted from the position in a cone around the direction. The spread angle is the half angle of the cone in degrees.\n
+	* The speed and lifetime of each particle are picked randomly between their min and max values.\n
+	* The emission rate is the number of particles emitted per second during ParticleSystem::Update.
+	*/
+	struct ParticleEmitter
+	{
+		vec3 position;
+		vec3 direction{ 0.0f, 1.0f, 0.0f };
+		float spreadAngle{ 15.0f };
+		float minSpeed{ 1.0f };
+		float maxSpeed{ 1.0f };
+		float minLifetime{ 1.0f };
+		float maxLifetime{ 1.0f };
+		float emissionRate{ 0.0f };
+		vec4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
+	};
+
+	/**brief The data the renderer needs to draw one particle.
+	*
+	* The struct is 32 bytes with no padding so an array of them can be copied straight into an instance buffer.
+	*/
+	struct ParticleInstance
+	{
+		vec3 position;
+		float size{ 1.0f };
+		vec4 color;
+	};
+
+	/**brief Stores the particles in structure of arrays (SoA) form.
+	*
+	* Every array has room for the max number of particles. Only the first numParticles elements are alive.
+	* Dead particles are removed by moving the last alive particle into their slot, so the alive particles are always contiguous.
+	*/
+	struct ParticleArrays
+	{
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+
+		std::vector<float> velocityX;
+		std::vector<float> velocityY;
+		std::vector<float> velocityZ;
+
+		std::vector<float> lifetime;
+
+		std::vector<float> colorR;
+		std::vector<float> colorG;
+		std::vector<float> colorB;
+		std::vector<float> colorA;
+
+		unsigned int numParticles{ 0 };
+	};
+
+	/**brief Integrates the particles in the range [first, first + count) using semi-implicit Euler method and decreases their lifetimes by dt.
+	*
+	* The forces on each particle are gravity and drag using the same formulas as GravitationalForce and DragForce.\n
+	* gravity is the gravity acceleration vector and k1 and k2 are the drag coefficients. Processes 4 particles at a time.\n
+	* Returns true if the lifetime of any of the particles in the range is <= 0 after the update.
+	*/
+	bool IntegrateParticles(ParticleArrays& particles, unsigned int first, unsigned int count, const vec3& gravity,
+		float k1, float k2, float inverseMass, float dt);
+
+	/**brief Removes the particles whose lifetime is <= 0 by swapping the last alive particle into their slot.
+	*/
+	void RemoveDeadParticles(ParticleArrays& particles);
+
+	/** @class ParticleSystem ""
+	*	@brief A lightweight particle system for effects that do not need rigid bodies.
+	*
+	*	All the particles share the same mass, size, gravity and drag. Each particle has a position, velocity, remaining lifetime and color.
+	*/
+	class ParticleSystem
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a particle system that can hold 0 particles. Call InitializeParticleSystem to initialize it.
+		*/
+		ParticleSystem();
+
+		/**brief Creates a particle system that can hold the specified max number of particles.
+		*/
+		ParticleSystem(unsigned int maxParticles);
+
+		/**brief Initializes the particle system so it can hold the specified max number of particles.
+		*
+		* All the memory the particle system needs is allocated here, so Update and GetInstances never allocate.
+		*/
+		void InitializeParticleSystem(unsigned int maxParticles);
+
+		/**brief Adds an emitter to the particle system and returns its index.
+		*/
+		unsigned int AddEmitter(const ParticleEmitter& emitter);
+
+		/**brief Returns the emitter at the specified index.
+		*/
+		ParticleEmitter& GetEmitter(unsigned int index);
+
+		/**brief Returns the number of emitters.
+		*/
+		unsigned int GetNumberOfEmitters() const;
+
+		/**brief Sets the gravity acting on the particles.
+		*
+		* The direction gets normalized.
+		*/
+		void SetGravity(float gravityAcceleration, const vec3& direction);
+
+		/**brief Sets the drag coefficients for the drag acting on the particles.
+		*/
+		void SetDrag(float k1, float k2);
+
+		/**brief Sets the mass of each particle.
+		*
+		* If the mass is <= 0, the mass is set to 1.
+		*/
+		void SetParticleMass(float mass);
+
+		/**brief Sets the size of each particle used in the instances.
+		*/
+		void SetParticleSize(float size);
+
+		/**brief Emits the specified number of particles from the emitter at the specified index.
+		*
+		* Particles that do not fit are not emitted.
+		*/
+		void Emit(unsigned int emitterIndex, unsigned int count);
+
+		/**brief Integrates the particles, removes the dead particles and emits new particles from the emitters.
+		*/
+		void Update(float dt);
+
+		/**brief Removes all the particles.
+		*/
+		void Clear();
+
+		/**brief Returns the number of alive particles.
+		*/
+		unsigned int GetNumberOfParticles() const;
+
+		/**brief Returns the max number of particles.
+		*/
+		unsigned int GetMaxParticles() const;
+
+		/**brief Returns the particles.
+		*/
+		const ParticleArrays& GetParticles() const;
+
+		/**brief Writes the alive particles as instances and returns them.
+		*
+		* Only the first GetNumberOfParticles() instances are valid.
+		*/
+		const std::vector<ParticleInstance>& GetInstances();
+
+	private:
+		//Returns a random float between min and max.
+		float RandomFloat(float min, float max);
+
+	private:
+		ParticleArrays mParticles;
+		std::vector<ParticleInstance> mInstances;
+
+		std::vector<ParticleEmitter> mEmitters;
+		std::vector<float> mEmissionAccumulators;
+
+		vec3 mGravity;
+		float mK1;
+		float mK2;
+		float mInverseMass;
+		float mParticleSize;
+
+		unsigned int mMaxParticles;
+		unsigned int mRandomState;
+	};
+}
\ No newline at end of file
@@ -5,6 +5,19 @@
 
 namespace PhysicsEngine
 {
+	/**brief The mass properties of a solid polyhedron with a mass density of 1.
+	*
+	* The covariance is the second moment of the volume relative to the center of mass, the integral of (p - cm)^T(p - cm).\n
+	* Unlike the inertia tensor it transforms directly under a linear map, so the mass properties of a scaled polyhedron
+	* can be computed from the unscaled ones without integrating over the triangles again.
+	*/
+	struct MassProperties
+	{
+		double mass{ 0.0 };
+		vec3 centerOfMass;
+		mat3 covariance;
+	};
+
 	/**brief These are the expressions used in computing the mass properties.
 	*/
 	void SubExpressions(double w0, double w1, double w2, double& f1, double& f2, double& f3, double& g0, double& g1, double& g2);
@@ -28,4 +41,18 @@ namespace PhysicsEngine
 	*/
 	void ComputeMassProperties(const std::vector<ShapesEngine::Triangle>& triangles, double& mass, vec3& cm,
 		mat3& bodyInertia, const mat3& scale);
+
+	/**brief Computes the mass properties of a solid polyhedron with a mass density of 1 from the triangles that make up the polyhedron.
+	*/
+	void ComputeMassProperties(const std::vector<ShapesEngine::Triangle>& triangles, MassProperties& massProperties);
+
+	/**brief Computes the mass, center of mass and inertia tensor relative to the center of mass of the polyhedron scaled by the specified matrix.
+	*
+	* The values are computed from the mass properties of the unscaled polyhedron, so the cost does not depend on the number of triangles.\n
+	* Formulas used are m' = m|det(S)|, cm' = cm * S and C' = |det(S)| * S^T * C * S, where C is the covariance.
+	* The inertia tensor is trace(C')I - C'.\n
+	*
+	* Assumes the mass density is 1, so if it is not you need to multiple the mass and body intertia by the mass density to get the correct values.
+	*/
+	void ScaleMassProperties(const MassProperties& massProperties, const mat3& scale, double& mass, vec3& cm, mat3& bodyInertia);
 }
\ No newline at end of file
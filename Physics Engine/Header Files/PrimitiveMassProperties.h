@@ -0,0 +1,31 @@
+#pragma once
+
+#include "PolyhedralMassProperties.h"
+
+namespace PhysicsEngine
+{
+	/**brief The shapes whose mass properties have a closed form.
+	*
+	* PRIMITIVE_NONE is any other shape, its mass properties have to be computed from its triangles.
+	*/
+	enum PrimitiveType { PRIMITIVE_BOX = 0, PRIMITIVE_CONE, PRIMITIVE_CYLINDER, PRIMITIVE_SPHERE, PRIMITIVE_PYRAMID, PRIMITIVE_NONE };
+
+	/**brief Computes the exact mass properties of the solid unit primitive with a mass density of 1.
+	*
+	* The unit primitives are the ones made by the CreateShapes functions: a box with sides of 1, a sphere with a radius of 1,
+	* a cylinder and a cone with a radius of 1 and a height of 1, and a pyramid with a base of 1 by 1 and a height of 1.
+	* The cylinder, cone and pyramid go from y = -0.5 to y = 0.5 and the cone and pyramid point up.\n
+	*
+	* The values are the same as integrating over the triangles of a perfectly tessellated mesh, so scaling them by the dimensions
+	* of a shape with ScaleMassProperties gives the exact mass properties of the shape without any triangles.\n
+	* If the type is PRIMITIVE_NONE the mass properties are set to 0.
+	*/
+	void ComputeMassProperties(PrimitiveType type, MassProperties& massProperties);
+
+	/**brief Computes the exact mass properties of a solid capsule with a mass density of 1.
+	*
+	* The capsule is the segment from (0, -halfHeight, 0) to (0, halfHeight, 0) grown by the radius, like a capsule collision shape.
+	* It does not scale like the unit primitives, since its caps stay round when the capsule gets longer.
+	*/
+	void ComputeCapsuleMassProperties(float radius, float halfHeight, MassProperties& massProperties);
+}
\ No newline at end of file
@@ -29,6 +29,14 @@ namespace PhysicsEngine
 		void InitializeRigidBody(float massDensity, const MathEngine::Quaternion& initialOrientation, 
 			const std::vector<ShapesEngine::Triangle>& triangles, const mat3& scale);
 
+		/**brief Initializes the properties of a rigid body using the mass properties of the unscaled polyhedron.
+		*
+		* Same as the function above, but the center of mass and inertia tensors are computed from the mass properties with ScaleMassProperties,
+		* so the cost does not depend on the number of triangles. Use it with the mass properties of a ShapeAsset when many rigid bodies use the same mesh.
+		*/
+		void InitializeRigidBody(float massDensity, const MathEngine::Quaternion& initialOrientation,
+			const MassProperties& massProperties, const mat3& scale);
+
 		/**brief Returns the mass of the rigid body.
 		*/
 		float GetMass() const;
@@ -104,6 +112,12 @@ namespace PhysicsEngine
 		*/
 		void SetBodyInertiaTensor(const mat3& bodyInertia);
 
+		/**brief Sets the inverse body inertia tensor to the specified matrix and the body inertia tensor to its inverse.
+		*
+		* Use it to copy the inverse tensor of another body exactly, inverting the body inertia tensor again can round differently.
+		*/
+		void SetInverseBodyInertiaTensor(const mat3& inverseBodyInertia);
+
 		/**brief Sets the angular velocity of the rigid body to the specified vector.
 		*/
 		void SetAngularVelocity(const vec3& angularVelocity);
@@ -116,6 +130,12 @@ namespace PhysicsEngine
 		*/
 		void SetOrientation(const MathEngine::Quaternion& orientation);
 
+		/**brief Sets the orientation of the rigid body to the specified quaternion, which has to be normalized already.
+		*
+		* Unlike SetOrientation the quaternion is not normalized again, so an orientation copied from another body does not change.
+		*/
+		void SetUnitOrientation(const MathEngine::Quaternion& orientation);
+
 		/**brief Sets the net force of a rigid body to the zero vector.
 		*/
 		void ResetForce();
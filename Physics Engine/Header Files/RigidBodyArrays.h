@@ -0,0 +1,153 @@
+#pragma once
+
+#include "RigidBody.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief A contiguous range of bodies in a RigidBodyArrays object.
+	*/
+	struct BodyRange
+	{
+		unsigned int first{ 0 };
+		unsigned int count{ 0 };
+	};
+
+	/**brief An index that does not refer to any body.
+	*/
+	const unsigned int INVALID_BODY{ 0xffffffff };
+
+	/**brief Stores the state of many rigid bodies in structure of arrays (SoA) form.
+	*
+	* Each component of each property is stored in its own array so passes over a range of bodies only touch the data they need
+	* and can process several bodies at a time.\n
+	*
+	* The net force and net torque arrays are accumulators. They are cleared with ResetForcesAndTorques and filled by the force generators.
+	*/
+	struct RigidBodyArrays
+	{
+		std::vector<float> mass;
+		std::vector<float> inverseMass;
+
+		std::vector<float> centerOfMassX;
+		std::vector<float> centerOfMassY;
+		std::vector<float> centerOfMassZ;
+
+		std::vector<float> orientationW;
+		std::vector<float> orientationX;
+		std::vector<float> orientationY;
+		std::vector<float> orientationZ;
+
+		std::vector<float> linearVelocityX;
+		std::vector<float> linearVelocityY;
+		std::vector<float> linearVelocityZ;
+
+		std::vector<float> linearMomentumX;
+		std::vector<float> linearMomentumY;
+		std::vector<float> linearMomentumZ;
+
+		std::vector<float> angularVelocityX;
+		std::vector<float> angularVelocityY;
+		std::vector<float> angularVelocityZ;
+
+		std::vector<float> angularMomentumX;
+		std::vector<float> angularMomentumY;
+		std::vector<float> angularMomentumZ;
+
+		//The inverse inertia tensor in body coordinates is symmetric, so only 6 of its elements are stored.
+		std::vector<float> inverseBodyInertiaXX;
+		std::vector<float> inverseBodyInertiaYY;
+		std::vector<float> inverseBodyInertiaZZ;
+		std::vector<float> inverseBodyInertiaXY;
+		std::vector<float> inverseBodyInertiaXZ;
+		std::vector<float> inverseBodyInertiaYZ;
+
+		std::vector<float> netForceX;
+		std::vector<float> netForceY;
+		std::vector<float> netForceZ;
+
+		std::vector<float> netTorqueX;
+		std::vector<float> netTorqueY;
+		std::vector<float> netTorqueZ;
+	};
+
+	/**brief Returns the number of bodies stored in the specified RigidBodyArrays.
+	*/
+	unsigned int GetNumberOfBodies(const RigidBodyArrays& bodies);
+
+	/**brief Reserves memory for the specified number of bodies in each array.
+	*/
+	void ReserveBodies(RigidBodyArrays& bodies, unsigned int numBodies);
+
+	/**brief Removes all bodies from the specified RigidBodyArrays.
+	*/
+	void ClearBodies(RigidBodyArrays& bodies);
+
+	/**brief Appends the state of the specified rigid body to the arrays and returns its index.
+	*/
+	unsigned int AddRigidBody(RigidBodyArrays& bodies, const RigidBody& body);
+
+	/**brief Copies the state of the specified rigid body into the arrays at the specified index.
+	*
+	* The net force and net torque of the body at the index are set to the zero vector.
+	*/
+	void LoadRigidBody(RigidBodyArrays& bodies, unsigned int index, const RigidBody& body);
+
+	/**brief Copies the center of mass, orientation, linear momentum and angular momentum at the specified index into the rigid body.
+	*/
+	void StoreRigidBody(const RigidBodyArrays& bodies, unsigned int index, RigidBody& body);
+
+	/**brief Copies the mass, inertia tensor and state at the specified index into the rigid body.
+	*
+	* Unlike StoreRigidBody, the rigid body does not have to be initialized from the same shape, so this can restore a body from scratch.
+	*/
+	void RestoreRigidBody(const RigidBodyArrays& bodies, unsigned int index, RigidBody& body);
+
+	/**brief Returns the center of mass of the body at the specified index.
+	*/
+	vec3 GetCenterOfMass(const RigidBodyArrays& bodies, unsigned int index);
+
+	/**brief Returns the orientation of the body at the specified index.
+	*/
+	MathEngine::Quaternion GetOrientation(const RigidBodyArrays& bodies, unsigned int index);
+
+	/**brief Adds the specified torque to the net torque of the body at the specified index.
+	*/
+	void AddTorque(RigidBodyArrays& bodies, unsigned int index, const vec3& torque);
+
+	/**brief Returns the net force accumulated for the body at the specified index.
+	*/
+	vec3 GetNetForce(const RigidBodyArrays& bodies, unsigned int index);
+
+	/**brief Returns the net torque accumulated for the body at the specified index.
+	*/
+	vec3 GetNetTorque(const RigidBodyArrays& bodies, unsigned int index);
+
+	/**brief Sets the net force and net torque of the bodies in the specified range to the zero vector.
+	*
+	* The part of the range past the last body is ignored.
+	*/
+	void ResetForcesAndTorques(RigidBodyArrays& bodies, const BodyRange& range);
+
+	/**brief Sets the net force and net torque of all the bodies to the zero vector.
+	*/
+	void ResetForcesAndTorques(RigidBodyArrays& bodies);
+
+	/**brief Moves the origin of the coordinates of the bodies by shift, which subtracts shift from every center of mass.
+	*
+	* The velocities and orientations do not depend on the origin, so they are not changed.
+	*/
+	void ShiftOrigin(RigidBodyArrays& bodies, const vec3& shift);
+
+	/**brief Integrates the bodies in the specified range with their net forces and net torques using the time step dt.
+	*
+	* Does the same operations in the same order as RigidBody::Integrate, so it gives the same results without copying
+	* the bodies into RigidBody objects. Bodies with an inverse mass of 0 are not moved.\n
+	* The bodies are integrated one after the other in index order and nothing is allocated.
+	*/
+	void IntegrateRigidBodies(RigidBodyArrays& bodies, const BodyRange& range, float dt);
+
+	/**brief Integrates all the bodies with their net forces and net torques using the time step dt.
+	*/
+	void IntegrateRigidBodies(RigidBodyArrays& bodies, float dt);
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RigidBody.h"
+#include "PrimitiveMassProperties.h"
 #include "ThreeDimensionalShape.h"
 #include "BoundingVolume.h"
 #include <memory>
@@ -21,15 +22,47 @@ namespace PhysicsEngine
 			std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
 			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
 
+		/**brief Creates a RigidShape object using the mass properties of the unscaled shape.
+		*/
+		RigidShape(float massDensity, const MassProperties& massProperties,
+			std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
+
+		/**brief Creates a RigidShape object using the exact mass properties of the type of the shape.
+		*/
+		RigidShape(float massDensity, std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
+
 		/**brief Initializes a RigidShape object.
 		*/
 		void InitializeRigidShape(float massDensity,const std::vector<ShapesEngine::Triangle>& triangles,
 			std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
 			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
 
+		/**brief Initializes a RigidShape object using the mass properties of the unscaled shape.
+		*
+		* The mass properties are scaled by the dimensions of the shape, so the triangles of the shape are not needed.
+		*/
+		void InitializeRigidShape(float massDensity, const MassProperties& massProperties,
+			std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
+
+		/**brief Initializes a RigidShape object using the exact mass properties of the type of the shape.
+		*
+		* Box, Cone, Cylinder, Sphere and Pyramid shapes use the closed form mass properties of the primitive scaled by the dimensions
+		* of the shape, so no triangles are integrated.\n
+		* Any other shape gets infinite mass, use one of the other functions with the triangles of the shape instead.
+		*/
+		void InitializeRigidShape(float massDensity, std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+			std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume);
+
 		//-------------------------------------------------------------------------------------------------------------------------------------------------------
 		//Rigid Body Delegates
 
+		/**brief Returns the rigid body of the RigidShape.
+		*/
+		const RigidBody& GetRigidBody() const;
+
 		/**brief Returns the mass of the RigidShape.
 		*/
 		float GetMass() const;
@@ -205,6 +238,10 @@ namespace PhysicsEngine
 	*/
 	void SimulateRigidShape(RigidShape& previousRigidShape, RigidShape& currentRigidShape, const vec3& netForce, const vec3& netTorque, float simulationTime);
 
+	/**brief Returns the primitive type of the shape, or PRIMITIVE_NONE if it is not one of the primitive shapes.
+	*/
+	PrimitiveType GetPrimitiveType(const ShapesEngine::ThreeDimensionalShapeAbstract& shape);
+
 	/**brief Interpolates the center of mass and orientation between r1 and r2 and stores the interpolated rigid shape in r3.
 	*/
 	void Interpolate(const RigidShape& r1, const RigidShape& r2, RigidShape& r3, float t);
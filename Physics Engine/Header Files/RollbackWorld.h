@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ForceGenerators.h"
+#include "WorldSnapshot.h"
+
+namespace PhysicsEngine
+{
+	/**brief A force and torque applied to one body for one step, for example from player input.
+	*/
+	struct BodyInput
+	{
+		unsigned int body{ 0 };
+		vec3 force;
+		vec3 torque;
+	};
+
+	/** @class RollbackWorld ""
+	*	@brief Steps a RigidBodyArrays object deterministically with a fixed time step and keeps the last N steps so it can rewind and
+	*	re-simulate them.
+	*
+	*	A step clears the accumulators, applies the force generators in the order they were registered, adds the inputs of the step
+	*	sorted by body and integrates the bodies in index order with IntegrateRigidBodies. The same bodies, generators and inputs
+	*	always give bit-identical results, no matter how many threads the program uses or in which order the inputs were set.\n
+	*
+	*	Before each step the state of the bodies is saved into a ring buffer of snapshots. Rewind goes back to the start of a saved step,
+	*	and Resimulate rewinds and steps forward again to the current step, using inputs that may have been changed with SetInputs
+	*	in the meantime.\n
+	*
+	*	Memory for the snapshots and inputs is allocated by InitializeRollbackWorld, so Step, Rewind and Resimulate do not allocate
+	*	as long as the number of inputs per step stays within the maximum.
+	*/
+	class RollbackWorld
+	{
+	public:
+		/**brief Default constructor.
+		* Creates an empty world with a time step of 1/60 seconds that keeps 1 step.
+		*/
+		RollbackWorld();
+
+		/**brief Initializes the world with a copy of the bodies and force generators.
+		*
+		* historySize is the number of steps that can be rewound and maxInputsPerStep is the number of inputs that can be set per step
+		* without allocating. The current step is set to 0.
+		*/
+		void InitializeRollbackWorld(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float timeStep,
+			unsigned int historySize, unsigned int maxInputsPerStep);
+
+		/**brief Returns the bodies of the world.
+		*/
+		const RigidBodyArrays& GetBodies() const;
+
+		/**brief Returns the number of the next step to be simulated. It is also the number of steps simulated since the world was initialized.
+		*/
+		unsigned long long GetCurrentStep() const;
+
+		/**brief Returns the fixed time step.
+		*/
+		float GetTimeStep() const;
+
+		/**brief Returns the number of steps that can be rewound.
+		*/
+		unsigned int GetHistorySize() const;
+
+		/**brief Returns the oldest step that Rewind can go back to.
+		*/
+		unsigned long long GetOldestStep() const;
+
+		/**brief Sets the inputs of the specified step, replacing the inputs that were set before.
+		*
+		* The step has to be the current step, a future step within the history size, or a past step that can still be rewound to.
+		* Returns false if it is not, or if an input refers to a body that does not exist.\n
+		* The inputs are sorted by body and then by force and torque, so the order they are passed in does not change the result.
+		*/
+		bool SetInputs(unsigned long long step, const BodyInput* inputs, unsigned int numInputs);
+
+		/**brief Sets the inputs of the specified step, replacing the inputs that were set before.
+		*/
+		bool SetInputs(unsigned long long step, const std::vector<BodyInput>& inputs);
+
+		/**brief Simulates the current step and moves on to the next step.
+		*/
+		void Step();
+
+		/**brief Restores the bodies to their state at the start of the specified step and makes it the current step.
+		*
+		* Returns false and does nothing if the step is not between GetOldestStep() and GetCurrentStep().
+		*/
+		bool Rewind(unsigned long long step);
+
+		/**brief Rewinds to the specified step and simulates again up to the step that was current before the call.
+		*
+		* Returns false and does nothing if the step cannot be rewound to.
+		*/
+		bool Resimulate(unsigned long long step);
+
+	private:
+		RigidBodyArrays mBodies;
+		ForceGeneratorRegistry mForceGenerators;
+		float mTimeStep;
+		unsigned long long mCurrentStep;
+
+		//Ring buffers indexed by step % their size.
+		//mStates holds the state at the start of the step and mInputs the inputs of the step. mInputs is twice as long as mStates so
+		//inputs can be set for future steps without overwriting the inputs of the steps that can still be re-simulated.
+		//mStateSteps and mInputSteps hold the step each slot belongs to, so stale slots are never used.
+		std::vector<std::vector<unsigned char>> mStates;
+		std::vector<unsigned long long> mStateSteps;
+		std::vector<std::vector<BodyInput>> mInputs;
+		std::vector<unsigned long long> mInputSteps;
+		unsigned int mMaxInputsPerStep;
+
+		unsigned long long mOldestStep;
+	};
+}
\ No newline at end of file
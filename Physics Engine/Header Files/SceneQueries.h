@@ -0,0 +1,208 @@
+#pragma once
+
+#include "BoundingGeometry.h"
+#include "Triangle.h"
+#include "TriangleMeshCollider.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief The types of volumes a scene query can hit.
+	*/
+	enum QueryVolumeType { QUERY_SPHERE = 0, QUERY_AABB, QUERY_TRIANGLE, QUERY_NONE };
+
+	/**brief A ray starting at the origin and going in the direction. The direction has to be normalized.
+	*
+	* Hits farther than maxDistance from the origin are ignored.
+	*/
+	struct Ray
+	{
+		vec3 origin;
+		vec3 direction{ 0.0f, 0.0f, 1.0f };
+		float maxDistance{ 1e30f };
+	};
+
+	/**brief A sphere with the specified radius moving from the origin in the direction. The direction has to be normalized.
+	*
+	* Hits farther than maxDistance from the origin are ignored.
+	*/
+	struct SphereCast
+	{
+		vec3 origin;
+		vec3 direction{ 0.0f, 0.0f, 1.0f };
+		float radius{ 1.0f };
+		float maxDistance{ 1e30f };
+	};
+
+	/**brief The closest hit of a ray or sphere cast.
+	*
+	* If nothing was hit the type is QUERY_NONE. The index is the index of the volume in its array in the QueryScene.\n
+	* The distance is how far the ray or sphere moved along its direction before the hit. The point is the point of contact on the volume
+	* and the normal is the normal of the volume at that point.\n
+	* If the ray or sphere starts inside a volume, the distance is 0 and the normal is the opposite of the direction.
+	*/
+	struct QueryHit
+	{
+		QueryVolumeType type{ QUERY_NONE };
+		unsigned int index{ 0 };
+		float distance{ 0.0f };
+		vec3 point;
+		vec3 normal;
+	};
+
+	/**brief An overlap between the query at the query index and the volume of the specified type at the index.
+	*/
+	struct OverlapHit
+	{
+		unsigned int query{ 0 };
+		QueryVolumeType type{ QUERY_SPHERE };
+		unsigned int index{ 0 };
+	};
+
+	/** @class QueryVolumeBVH ""
+	*	@brief A bounding volume hierarchy over the spheres and AABBs of a QueryScene, built with the surface area heuristic
+	*	like the hierarchy of a TriangleMeshCollider.
+	*
+	*	The volumes are numbered with the spheres first and the AABBs after them. Build the hierarchy again after the volumes move.
+	*/
+	class QueryVolumeBVH
+	{
+	public:
+		/**brief Default constructor.
+		* Creates an empty hierarchy.
+		*/
+		QueryVolumeBVH();
+
+		/**brief Builds the hierarchy over the spheres and AABBs.
+		*
+		* The hierarchy is built with up to numThreads threads. If numThreads is 0 the number of hardware threads is used.
+		*/
+		void BuildQueryVolumeBVH(const Sphere* spheres, unsigned int numSpheres, const AABB* boxes, unsigned int numBoxes,
+			unsigned int numThreads = 0);
+
+		/**brief Returns the nodes of the hierarchy. The root is the first node.
+		*/
+		const std::vector<MeshBVHNode>& GetNodes() const;
+
+		/**brief Returns the number of the volume in each slot of the leaves.
+		*
+		* A leaf with count volumes starting at leftOrFirst holds the volumes in the slots from leftOrFirst to leftOrFirst + count - 1.
+		*/
+		const std::vector<unsigned int>& GetVolumes() const;
+
+	private:
+		std::vector<MeshBVHNode> mNodes;
+		std::vector<unsigned int> mVolumes;
+	};
+
+	/**brief The volumes the scene queries are tested against.
+	*
+	* The arrays are not owned by the QueryScene and have to stay alive while the queries run.
+	* The vertices of the triangles have to be in world space.\n
+	* Without hierarchies every query is tested against every volume. If volumeBVH is set it has to be built from the spheres and
+	* AABBs of the scene, and if triangleMesh is set it has to be initialized with the triangles of the scene in the same order.
+	* The queries then only test the volumes in the nodes of the hierarchies they reach.
+	*/
+	struct QueryScene
+	{
+		const Sphere* spheres{ nullptr };
+		unsigned int numSpheres{ 0 };
+
+		const AABB* boxes{ nullptr };
+		unsigned int numBoxes{ 0 };
+
+		const ShapesEngine::Triangle* triangles{ nullptr };
+		unsigned int numTriangles{ 0 };
+
+		const QueryVolumeBVH* volumeBVH{ nullptr };
+		const TriangleMeshCollider* triangleMesh{ nullptr };
+	};
+
+	/**brief Returns true if the ray hits the sphere, false otherwise.
+	*
+	* If it does, t is the distance to the hit and normal is the normal of the sphere at the hit.
+	*/
+	bool IntersectRay(const Ray& ray, const Sphere& sphere, float& t, vec3& normal);
+
+	/**brief Returns true if the ray hits the AABB, false otherwise.
+	*
+	* If it does, t is the distance to the hit and normal is the normal of the face of the AABB that was hit.
+	*/
+	bool IntersectRay(const Ray& ray, const AABB& aabb, float& t, vec3& normal);
+
+	/**brief Returns true if the ray hits the triangle from either side, false otherwise.
+	*
+	* If it does, t is the distance to the hit and normal is the normal of the triangle facing the ray.
+	*/
+	bool IntersectRay(const Ray& ray, const ShapesEngine::Triangle& triangle, float& t, vec3& normal);
+
+	/**brief Returns true if the moving sphere hits the sphere, false otherwise.
+	*
+	* If it does, t is the distance the moving sphere moved before the hit and normal is the normal of the sphere at the point of contact.
+	*/
+	bool IntersectSphereCast(const SphereCast& cast, const Sphere& sphere, float& t, vec3& normal);
+
+	/**brief Returns true if the moving sphere hits the AABB, false otherwise.
+	*
+	* If it does, t is the distance the moving sphere moved before the hit and normal is the normal of the AABB at the point of contact.
+	*/
+	bool IntersectSphereCast(const SphereCast& cast, const AABB& aabb, float& t, vec3& normal);
+
+	/**brief Returns true if the moving sphere hits the triangle, false otherwise.
+	*
+	* If it does, t is the distance the moving sphere moved before the hit and normal points from the point of contact to the center of the sphere.
+	*/
+	bool IntersectSphereCast(const SphereCast& cast, const ShapesEngine::Triangle& triangle, float& t, vec3& normal);
+
+	/**brief Returns the point on the triangle closest to the specified point.
+	*/
+	vec3 ClosestPointOnTriangle(const vec3& point, const ShapesEngine::Triangle& triangle);
+
+	/**brief Returns true if the sphere and AABB are intersecting, false otherwise.
+	*/
+	bool TestIntersection(const Sphere& sphere, const AABB& aabb);
+
+	/**brief Returns true if the sphere and triangle are intersecting, false otherwise.
+	*/
+	bool TestIntersection(const Sphere& sphere, const ShapesEngine::Triangle& triangle);
+
+	/**brief Returns true if the AABB and triangle are intersecting, false otherwise.
+	*
+	* Uses the separating axis test with the 13 axes of the AABB and triangle.
+	*/
+	bool TestIntersection(const AABB& aabb, const ShapesEngine::Triangle& triangle);
+
+	/**brief Finds the closest hit of each ray and stores it at the same index in hits.
+	*
+	* The rays are traced in packets of 4, so each node and volume is loaded once and tested against 4 rays at a time.
+	* A node of a hierarchy is skipped when none of the 4 rays reach it before their closest hits so far.\n
+	* The rays are split between up to the specified number of threads. The calling thread is one of the threads.
+	* Batches too small to be worth starting threads for are run on the calling thread.
+	*/
+	void CastRays(const QueryScene& scene, const Ray* rays, unsigned int numRays, QueryHit* hits, unsigned int numThreads = 1);
+
+	/**brief Finds the closest hit of each sphere cast and stores it at the same index in hits.
+	*
+	* The sphere casts are split between up to the specified number of threads. The calling thread is one of the threads.
+	* Batches too small to be worth starting threads for are run on the calling thread.
+	*/
+	void CastSpheres(const QueryScene& scene, const SphereCast* casts, unsigned int numCasts, QueryHit* hits, unsigned int numThreads = 1);
+
+	/**brief Finds all the volumes each sphere overlaps.
+	*
+	* The hits vector is cleared and then filled with the overlaps sorted by the index of the query.\n
+	* The queries are split between up to the specified number of threads. The calling thread is one of the threads.
+	* Batches too small to be worth starting threads for are run on the calling thread.
+	*/
+	void OverlapSpheres(const QueryScene& scene, const Sphere* queries, unsigned int numQueries, std::vector<OverlapHit>& hits,
+		unsigned int numThreads = 1);
+
+	/**brief Finds all the volumes each AABB overlaps.
+	*
+	* The hits vector is cleared and then filled with the overlaps sorted by the index of the query.\n
+	* The queries are split between up to the specified number of threads. The calling thread is one of the threads.
+	* Batches too small to be worth starting threads for are run on the calling thread.
+	*/
+	void OverlapAABBs(const QueryScene& scene, const AABB* queries, unsigned int numQueries, std::vector<OverlapHit>& hits,
+		unsigned int numThreads = 1);
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "BoundingGeometry.h"
+#include "ConvexHull.h"
+#include "PrimitiveMassProperties.h"
+#include "RigidBody.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief A handle to a shape in a ShapeAssetLibrary. It is the index of the shape in the library.
+	*/
+	typedef unsigned int ShapeHandle;
+
+	/**brief A handle that does not refer to any shape.
+	*/
+	const ShapeHandle INVALID_SHAPE{ 0xffffffff };
+
+	/**brief The largest number of vertices in the convex hull of a shape asset.
+	*/
+	const unsigned int MAX_HULL_VERTICES{ 32 };
+
+	/**brief The data of a mesh that is shared by every instance of the mesh.
+	*
+	* The triangles point to the vertices of the asset. The local bounds, hull and mass properties are for the unscaled mesh.\n
+	* The hull is the convex hull of the vertices reduced to at most MAX_HULL_VERTICES vertices, used for collision instead of the triangles.\n
+	* indexCount, locationOfFirstIndex and indexOfFirstVertex are the location of the mesh in the vertex and index lists of the library,
+	* so every instance of the mesh can be drawn with the same draw arguments.
+	*/
+	struct ShapeAsset
+	{
+		std::vector<ShapesEngine::Vertex> vertices;
+		std::vector<ShapesEngine::Triangle> triangles;
+
+		AABB localBox;
+		Sphere localSphere;
+		ConvexHull hull;
+		MassProperties massProperties;
+
+		unsigned int indexCount{ 0 };
+		unsigned int locationOfFirstIndex{ 0 };
+		int indexOfFirstVertex{ 0 };
+	};
+
+	/**brief The data of one instance of a shape.
+	*
+	* Only the transform is stored per instance, everything else is in the ShapeAsset the handle refers to.
+	* The struct is 44 bytes and does not allocate.
+	*/
+	struct ShapeInstance
+	{
+		ShapeHandle shape{ INVALID_SHAPE };
+		vec3 position;
+		MathEngine::Quaternion orientation;
+		vec3 scale{ 1.0f, 1.0f, 1.0f };
+	};
+
+	/** @class ShapeAssetLibrary ""
+	*	@brief Stores immutable shape assets that are shared by any number of shape instances.
+	*
+	*	The library also stores the vertices and indices of all its shapes in one vertex list and one index list,
+	*	so they can be copied into a single vertex buffer and index buffer.\n
+	*	The triangles of the assets point to the vertices of their asset, so the library cannot be copied.
+	*	Moving it points the triangles at the vertices of the moved assets.
+	*/
+	class ShapeAssetLibrary
+	{
+	public:
+		/**brief Default constructor.
+		*/
+		ShapeAssetLibrary();
+
+		ShapeAssetLibrary(const ShapeAssetLibrary&) = delete;
+		ShapeAssetLibrary& operator=(const ShapeAssetLibrary&) = delete;
+
+		/**brief Move constructor.
+		*/
+		ShapeAssetLibrary(ShapeAssetLibrary&& library) noexcept;
+
+		/**brief Move assignment operator.
+		*/
+		ShapeAssetLibrary& operator=(ShapeAssetLibrary&& library) noexcept;
+
+		/**brief Adds a shape made up of the specified vertices and triangles to the library and returns its handle.
+		*
+		* The local AABB, minimum bounding sphere, convex hull and mass properties of the shape are computed here, once per shape.\n
+		* If the shape is the unit mesh of a primitive, pass its type so the exact mass properties of the primitive are used instead of
+		* integrating over the triangles.
+		*/
+		ShapeHandle AddShape(const std::vector<ShapesEngine::Vertex>& vertices, const std::vector<ShapesEngine::Triangle>& triangles,
+			PrimitiveType primitive = PRIMITIVE_NONE);
+
+		/**brief Returns the shape with the specified handle.
+		*/
+		const ShapeAsset& GetShape(ShapeHandle handle) const;
+
+		/**brief Returns the number of shapes in the library.
+		*/
+		unsigned int GetNumberOfShapes() const;
+
+		/**brief Returns the vertices of all the shapes in the library.
+		*/
+		const std::vector<ShapesEngine::Vertex>& GetVertexList() const;
+
+		/**brief Returns the indices of all the shapes in the library.
+		*
+		* The indices of each shape are relative to the first vertex of the shape.
+		*/
+		const std::vector<unsigned int>& GetIndexList() const;
+
+		/**brief Removes all the shapes from the library.
+		*/
+		void Clear();
+
+	private:
+		void PointTrianglesAtVertices();
+
+		std::vector<ShapeAsset> mShapes;
+
+		std::vector<ShapesEngine::Vertex> mVertexList;
+		std::vector<unsigned int> mIndexList;
+	};
+
+	/**brief Returns the model matrix of the shape instance.
+	*/
+	mat4 ComputeModelMatrix(const ShapeInstance& instance);
+
+	/**brief Returns the model matrix of the shape scaled by scale relative to its center of mass, before it is rotated.
+	*
+	* It is the model matrix of an instance with the scale of the instance, less its rotation and the position of its center of mass.
+	* Pass it to FloatingOrigin::ComputeCameraRelativeTransforms.
+	*/
+	mat4 ComputeLocalModelMatrix(const ShapeAsset& shape, const vec3& scale);
+
+	/**brief Computes the model matrix of each instance and stores it at the same index in models.
+	*
+	* Replaces calling the virtual UpdateModelMatrix of each shape. Every shape type uses the same scale, rotate and translate matrix.
+	*/
+	void ComputeModelMatrices(const ShapeInstance* instances, unsigned int numInstances, mat4* models);
+
+	/**brief Transforms the local AABB of the shape to the transform of the instance and stores it in worldAABB.
+	*/
+	void ComputeWorldAABB(AABB& worldAABB, const ShapeAsset& shape, const ShapeInstance& instance);
+
+	/**brief Transforms the local bounding sphere of the shape to the transform of the instance and stores it in worldSphere.
+	*/
+	void ComputeWorldSphere(Sphere& worldSphere, const ShapeAsset& shape, const ShapeInstance& instance);
+
+	/**brief Initializes the rigid body to the specified density and the mass properties of the shape scaled by the scale of the instance.
+	*
+	* The orientation of the rigid body is the orientation of the instance and its center of mass is placed in the world using
+	* the position of the instance.
+	*/
+	void InitializeRigidBody(RigidBody& rigidBody, float massDensity, const ShapeAsset& shape, const ShapeInstance& instance);
+
+	/**brief Sets the position and orientation of the instance to the position and orientation of the rigid body.
+	*
+	* The rigid body has to have been initialized from the same shape and instance scale.
+	*/
+	void UpdateShapeInstance(ShapeInstance& instance, const ShapeAsset& shape, const RigidBody& rigidBody);
+
+	/**brief Sets the position and orientation of the instance to the specified center of mass and orientation of a rigid body.
+	*
+	* Use it for poses that are not stored in a RigidBody, such as poses read from RigidBodyArrays or interpolated between two steps.
+	*/
+	void UpdateShapeInstance(ShapeInstance& instance, const ShapeAsset& shape, const vec3& centerOfMass,
+		const MathEngine::Quaternion& orientation);
+}
\ No newline at end of file
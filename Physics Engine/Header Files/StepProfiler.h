@@ -0,0 +1,166 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief The phases of a physics step that are timed by a StepProfiler.
+	*/
+	enum StepPhase { PHASE_FORCES = 0, PHASE_INTEGRATION, PHASE_BOUNDING_VOLUMES, PHASE_BROADPHASE, PHASE_NARROWPHASE, PHASE_SOLVE, NUM_STEP_PHASES };
+
+	/**brief Returns the name of the phase, for example "forces".
+	*/
+	const char* GetStepPhaseName(StepPhase phase);
+
+	/**brief The timings and counts recorded for one physics step.
+	*
+	* The times are in milliseconds. The total is the time from BeginStep to EndStep, so it also has the time not spent in any phase.\n
+	* numAllocations is the number of heap allocations made during the step. It is only counted if the engine is built with
+	* PHYSICS_ENGINE_COUNT_ALLOCATIONS defined, otherwise it is 0.
+	*/
+	struct StepStats
+	{
+		unsigned long long step{ 0 };
+
+		double phaseMilliseconds[NUM_STEP_PHASES]{};
+		double totalMilliseconds{ 0.0 };
+
+		unsigned int numBodies{ 0 };
+		unsigned int numAwakeBodies{ 0 };
+		unsigned int numPairs{ 0 };
+		unsigned int numContacts{ 0 };
+		unsigned int numConstraintBatches{ 0 };
+		unsigned long long numAllocations{ 0 };
+	};
+
+	/**brief Returns the number of heap allocations made by the program so far.
+	*
+	* Always returns 0 unless the engine is built with PHYSICS_ENGINE_COUNT_ALLOCATIONS defined, which replaces the global operator new
+	* with one that counts its calls.
+	*/
+	unsigned long long GetAllocationCount();
+
+	/** @class StepProfiler ""
+	*	@brief Records the time spent in each phase of a physics step and the counts of the step for the last N steps.
+	*
+	*	Call BeginStep at the start of a step and EndStep at the end. In between, time each phase with BeginPhase and EndPhase
+	*	or a ProfileScope, and report the counts with the Set and Add functions.
+	*	A phase can be timed more than once per step, the times are added together.
+	*/
+	class StepProfiler
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a profiler that keeps the last 120 steps.
+		*/
+		StepProfiler();
+
+		/**brief Creates a profiler that keeps the specified number of steps.
+		*/
+		StepProfiler(unsigned int historySize);
+
+		/**brief Initializes the profiler so it keeps the specified number of steps and clears the recorded steps.
+		*
+		* If the history size is 0 it is set to 1.
+		*/
+		void InitializeStepProfiler(unsigned int historySize);
+
+		/**brief Starts recording a new step.
+		*/
+		void BeginStep();
+
+		/**brief Finishes recording the current step and adds it to the history.
+		*
+		* If the history is full the oldest step is overwritten.
+		*/
+		void EndStep();
+
+		/**brief Starts timing the specified phase.
+		*/
+		void BeginPhase(StepPhase phase);
+
+		/**brief Stops timing the specified phase and adds the time to the phase in the current step.
+		*/
+		void EndPhase(StepPhase phase);
+
+		/**brief Sets the number of bodies and awake bodies of the current step.
+		*/
+		void SetBodyCounts(unsigned int numBodies, unsigned int numAwakeBodies);
+
+		/**brief Adds to the number of pairs found by the broadphase in the current step.
+		*/
+		void AddPairs(unsigned int numPairs);
+
+		/**brief Adds to the number of contacts found by the narrowphase in the current step.
+		*/
+		void AddContacts(unsigned int numContacts);
+
+		/**brief Adds to the number of constraint color batches the solver used in the current step.
+		*/
+		void AddConstraintBatches(unsigned int numBatches);
+
+		/**brief Returns the number of steps in the history.
+		*/
+		unsigned int GetNumberOfSteps() const;
+
+		/**brief Returns a recorded step. Index 0 is the most recent step and GetNumberOfSteps() - 1 is the oldest.
+		*/
+		const StepStats& GetStep(unsigned int index) const;
+
+		/**brief Copies the last count steps into steps, oldest first.
+		*
+		* If fewer steps were recorded, all the recorded steps are copied.
+		*/
+		void GetLastSteps(unsigned int count, std::vector<StepStats>& steps) const;
+
+		/**brief Returns the average of the steps in the history. The step number of the average is the number of steps averaged.
+		*/
+		StepStats GetAverage() const;
+
+		/**brief Removes all the steps from the history.
+		*/
+		void Clear();
+
+		/**brief Writes the steps in the history to the stream as CSV, oldest first, with a header row.
+		*/
+		void WriteCSV(std::ostream& stream) const;
+
+		/**brief Writes the steps in the history to the stream as a JSON array of objects, oldest first.
+		*/
+		void WriteJSON(std::ostream& stream) const;
+
+	private:
+		std::vector<StepStats> mHistory;
+		unsigned int mNextStep;
+		unsigned int mNumSteps;
+		unsigned long long mStepCount;
+
+		StepStats mCurrentStep;
+		std::chrono::steady_clock::time_point mStepStart;
+		std::chrono::steady_clock::time_point mPhaseStart[NUM_STEP_PHASES];
+		unsigned long long mAllocationsAtStepStart;
+	};
+
+	/** @class ProfileScope ""
+	*	@brief Times a phase from its construction to its destruction.
+	*
+	*	If the profiler is nullptr nothing is timed, so profiling can be turned off by passing nullptr.
+	*/
+	class ProfileScope
+	{
+	public:
+		/**brief Starts timing the phase.
+		*/
+		ProfileScope(StepProfiler* profiler, StepPhase phase);
+
+		/**brief Stops timing the phase.
+		*/
+		~ProfileScope();
+
+	private:
+		StepProfiler* mProfiler;
+		StepPhase mPhase;
+	};
+}
\ No newline at end of file
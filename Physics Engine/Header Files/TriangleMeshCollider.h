@@ -0,0 +1,175 @@
+#pragma once
+
+#include "ConvexHull.h"
+#include "Triangle.h"
+#include <string>
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief A node of the bounding volume hierarchy of a TriangleMeshCollider. The node is 32 bytes.
+	*
+	* If count is 0 the node is an interior node and its children are the nodes at leftOrFirst and leftOrFirst + 1.
+	* Otherwise the node is a leaf with count triangles starting at triangle leftOrFirst.
+	*/
+	struct MeshBVHNode
+	{
+		float min[3];
+		unsigned int leftOrFirst;
+		float max[3];
+		unsigned int count;
+	};
+
+	/**brief Every node of a hierarchy built by BuildMeshBVH is less than this many levels below the root, so a traversal stack
+	* of this size never fills up.
+	*/
+	const unsigned int MAX_MESH_BVH_DEPTH{ 128 };
+
+	/**brief Builds a bounding volume hierarchy with the surface area heuristic over the boxes from mins[i] to maxs[i], the same way
+	* a TriangleMeshCollider builds the hierarchy over its triangles.
+	*
+	* The leaves index into order, which is filled with the indices of the boxes in the order of the leaves.
+	* The hierarchy is built with up to numThreads threads. If numThreads is 0 the number of hardware threads is used.
+	*/
+	void BuildMeshBVH(const std::vector<vec3>& mins, const std::vector<vec3>& maxs, std::vector<MeshBVHNode>& nodes,
+		std::vector<unsigned int>& order, unsigned int numThreads = 0);
+
+	/**brief The closest hit of a ray against a triangle mesh.
+	*
+	* The triangle is the index of the triangle in the lists the collider was initialized with.
+	* The normal is the normal of the triangle, facing the origin of the ray.
+	*/
+	struct MeshRayHit
+	{
+		unsigned int triangle{ 0 };
+		float distance{ 0.0f };
+		vec3 point;
+		vec3 normal;
+	};
+
+	/**brief A contact between a triangle of a mesh and another shape.
+	*
+	* The normal points from the mesh towards the other shape, so moving the shape by normal * depth separates them.
+	* The point is on the surface of the other shape.
+	*/
+	struct MeshContact
+	{
+		unsigned int triangle{ 0 };
+		vec3 point;
+		vec3 normal;
+		float depth{ 0.0f };
+	};
+
+	/** @class TriangleMeshCollider ""
+	*	@brief Static geometry made of any number of triangles in world coordinates, for example the mesh of a level.
+	*
+	*	The triangles are stored in a bounding volume hierarchy built with the surface area heuristic, so queries only test the
+	*	triangles near them. Only the positions of the vertices are stored.\n
+	*
+	*	The collider can be saved to a file and loaded back without building the hierarchy again.
+	*/
+	class TriangleMeshCollider
+	{
+	public:
+		/**brief Default constructor.
+		* Creates an empty collider.
+		*/
+		TriangleMeshCollider();
+
+		/**brief Initializes the collider with the triangles in the index list. Every 3 indices are a triangle.
+		*
+		* The hierarchy is built with up to numThreads threads. If numThreads is 0 the number of hardware threads is used.
+		* The collider is the same for any number of threads.
+		*/
+		void InitializeTriangleMeshCollider(const std::vector<vec3>& vertices, const std::vector<unsigned int>& indices, unsigned int numThreads = 0);
+
+		/**brief Initializes the collider with the triangles in the index list, using the positions of the vertices.
+		*/
+		void InitializeTriangleMeshCollider(const std::vector<ShapesEngine::Vertex>& vertices, const std::vector<unsigned int>& indices,
+			unsigned int numThreads = 0);
+
+		/**brief Initializes the collider with the triangles.
+		*/
+		void InitializeTriangleMeshCollider(const std::vector<ShapesEngine::Triangle>& triangles, unsigned int numThreads = 0);
+
+		/**brief Returns the number of triangles in the collider.
+		*/
+		unsigned int GetNumberOfTriangles() const;
+
+		/**brief Returns the nodes of the bounding volume hierarchy. The root is the first node.
+		*/
+		const std::vector<MeshBVHNode>& GetNodes() const;
+
+		/**brief Returns the positions of the vertices.
+		*/
+		const std::vector<vec3>& GetVertices() const;
+
+		/**brief Returns 3 indices per triangle in the order of the leaves of the hierarchy.
+		*
+		* A leaf with count triangles starting at triangle first uses the indices from 3 * first to 3 * (first + count) - 1.
+		*/
+		const std::vector<unsigned int>& GetIndices() const;
+
+		/**brief Returns the index of each triangle of the leaves in the lists the collider was initialized with.
+		*/
+		const std::vector<unsigned int>& GetTriangleIds() const;
+
+		/**brief Stores the indices of the triangles whose bounds overlap the box from min to max in triangles.
+		*
+		* The indices are the indices of the triangles in the lists the collider was initialized with.
+		*/
+		void FindTriangles(const vec3& min, const vec3& max, std::vector<unsigned int>& triangles) const;
+
+		/**brief Returns true if the ray hits a triangle within maxDistance and stores the closest hit in hit.
+		*
+		* The direction has to be normalized. Triangles are hit from both sides.
+		*/
+		bool CastRay(const vec3& origin, const vec3& direction, float maxDistance, MeshRayHit& hit) const;
+
+		/**brief Adds a contact to contacts for each triangle the sphere intersects.
+		*
+		* The point of each contact is the point on the sphere deepest in the triangle.
+		*/
+		void CollideSphere(const vec3& center, float radius, std::vector<MeshContact>& contacts) const;
+
+		/**brief Adds contacts to contacts for each triangle the convex hull intersects.
+		*
+		* The hull is in body coordinates and is placed in the world with the position and orientation.
+		* Each triangle is tested with the separating axis test over the triangle normal, the face normals of the hull and the
+		* cross products of their edges. If the hull rests on the face of a triangle, the contacts are the vertices of the hull
+		* that are below the triangle, otherwise the contact is the deepest vertex of the hull along the axis of least penetration.
+		*/
+		void CollideConvex(const ConvexHull& hull, const vec3& position, const MathEngine::Quaternion& orientation,
+			std::vector<MeshContact>& contacts) const;
+
+		/**brief Writes the collider into data, including the hierarchy, so it can be loaded without building it again.
+		*/
+		void Save(std::vector<unsigned char>& data) const;
+
+		/**brief Replaces the collider with the collider in data.
+		*
+		* Returns false and leaves the collider unchanged if the data is not a valid collider or was written by a newer version.
+		*/
+		bool Load(const unsigned char* data, size_t size);
+
+		/**brief Writes the collider to the specified file. Returns false if the file could not be written.
+		*/
+		bool SaveToFile(const std::string& filename) const;
+
+		/**brief Replaces the collider with the collider in the specified file. Returns false if the file could not be read or is not valid.
+		*/
+		bool LoadFromFile(const std::string& filename);
+
+	private:
+		void BuildHierarchy(unsigned int numThreads);
+
+		//The positions of the vertices, and 3 indices per triangle in the order of the leaves of the hierarchy.
+		std::vector<vec3> mVertices;
+		std::vector<unsigned int> mIndices;
+
+		//The index of each triangle in the lists the collider was initialized with.
+		std::vector<unsigned int> mTriangleIds;
+
+		std::vector<MeshBVHNode> mNodes;
+	};
+}
\ No newline at end of file
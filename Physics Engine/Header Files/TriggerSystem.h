@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "Narrowphase.h"
+
+namespace PhysicsEngine
+{
+	/**brief The layer the TriggerSystem puts its triggers on. Bodies on this layer are not tested against triggers.
+	*/
+	const unsigned int TRIGGER_COLLISION_LAYER{ 0x80000000 };
+
+	/**brief The kinds of trigger events.
+	*
+	* TRIGGER_ENTER is reported on the first step a body overlaps a trigger and TRIGGER_EXIT on the first step it does not.
+	* TRIGGER_STAY is reported on the steps in between, but only for triggers that ask for it.
+	*/
+	enum TriggerEventType { TRIGGER_ENTER = 0, TRIGGER_STAY, TRIGGER_EXIT };
+
+	/**brief A change in the overlap of a trigger and a body.
+	*/
+	struct TriggerEvent
+	{
+		TriggerEventType type{ TRIGGER_ENTER };
+		unsigned int trigger{ 0 };
+		unsigned int body{ 0 };
+	};
+
+	/** @class TriggerSystem ""
+	*	@brief Non-solid trigger volumes that report when bodies start and stop overlapping them.
+	*
+	*	The triggers and bodies are put in a Broadphase with filters that only let a trigger pair with a body, and the pairs it finds
+	*	are tested exactly with the narrowphase. The overlaps from the last step are kept in a hashed pair cache, so only the changes
+	*	are reported and game code never has to go over all the overlaps.\n
+	*
+	*	After each Update the events are in one contiguous buffer. The enter and stay events come first in the order of the
+	*	broadphase, then the exit events.
+	*/
+	class TriggerSystem
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a system with no triggers and no bodies.
+		*/
+		TriggerSystem();
+
+		/**brief Adds a trigger with the shape at the position and orientation, and returns the index of the trigger.
+		*
+		* The trigger reports the bodies on the layers in mask. If reportStay is true it also reports a TRIGGER_STAY event for each
+		* body inside it every step.
+		*/
+		unsigned int AddTrigger(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation,
+			unsigned int mask = ALL_COLLISION_LAYERS, bool reportStay = false);
+
+		/**brief Adds a body with the shape at the position and orientation on the layers in layer, and returns the index of the body.
+		*/
+		unsigned int AddBody(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation,
+			unsigned int layer = DEFAULT_COLLISION_LAYER);
+
+		/**brief Removes all the triggers, bodies, overlaps and events.
+		*/
+		void Clear();
+
+		/**brief Returns the number of triggers.
+		*/
+		unsigned int GetNumberOfTriggers() const;
+
+		/**brief Returns the number of bodies.
+		*/
+		unsigned int GetNumberOfBodies() const;
+
+		/**brief Moves the trigger at the specified index.
+		*/
+		void SetTriggerPose(unsigned int trigger, const vec3& position, const MathEngine::Quaternion& orientation);
+
+		/**brief Moves the body at the specified index.
+		*/
+		void SetBodyPose(unsigned int body, const vec3& position, const MathEngine::Quaternion& orientation);
+
+		/**brief Moves the origin of the coordinates by shift, which subtracts shift from the position of every trigger and body.
+		*
+		* The overlaps are kept, so moving the origin does not cause any events.
+		*/
+		void ShiftOrigin(const vec3& shift);
+
+		/**brief Finds the overlaps of the triggers and bodies at their current poses and stores the events since the last Update.
+		*/
+		void Update();
+
+		/**brief Returns the events from the last call to Update.
+		*/
+		const std::vector<TriggerEvent>& GetEvents() const;
+
+		/**brief Returns the number of bodies that overlapped a trigger at the last call to Update, counting a body once per trigger.
+		*/
+		unsigned int GetNumberOfOverlaps() const;
+
+		/**brief Returns true if the body overlapped the trigger at the last call to Update.
+		*/
+		bool IsOverlapping(unsigned int trigger, unsigned int body) const;
+
+	private:
+		//A volume in the broadphase. index is the index of the trigger or body it belongs to.
+		struct Volume
+		{
+			CollisionShape shape;
+			vec3 position;
+			MathEngine::Quaternion orientation;
+			unsigned int index;
+			bool isTrigger;
+		};
+
+		//An overlap in the pair cache and the last update it was found in.
+		struct Overlap
+		{
+			unsigned long long key;
+			unsigned long long update;
+		};
+
+		static unsigned long long MakeKey(unsigned int trigger, unsigned int body);
+		unsigned int FindSlot(unsigned long long key) const;
+		void InsertOverlap(unsigned long long key);
+		void RemoveOverlap(unsigned int overlap);
+		void GrowTable();
+		void UpdateBounds(unsigned int volume);
+
+		Broadphase mBroadphase;
+		std::vector<Volume> mVolumes;
+		std::vector<unsigned int> mTriggerVolumes;
+		std::vector<unsigned int> mBodyVolumes;
+		std::vector<bool> mReportStay;
+
+		//The overlaps are stored together so finding the ones that ended goes over the overlaps and not the hash table.
+		//The table is open addressing with linear probing and stores the index of each overlap in the slot of its key.
+		std::vector<Overlap> mOverlaps;
+		std::vector<unsigned long long> mTableKeys;
+		std::vector<unsigned int> mTableOverlaps;
+		unsigned long long mUpdate;
+
+		std::vector<TriggerEvent> mEvents;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+
+namespace PhysicsEngine
+{
+	/** @class TripleBuffer ""
+	*	@brief Passes data from one writer thread to one reader thread without locks.
+	*
+	*	There are three buffers. The writer fills the back buffer and publishes it, the reader reads the front buffer,
+	*	and the middle buffer holds the last published data. Publishing and reading only swap indices, so neither side
+	*	ever waits for the other and the reader always gets the newest complete data.\n
+	*	Only one thread can call GetWriteBuffer and Publish, and only one thread can call Update and GetReadBuffer.
+	*/
+	template<typename T>
+	class TripleBuffer
+	{
+	public:
+		/**brief Default constructor.
+		*/
+		TripleBuffer() : mMiddle{ 1 }, mFront{ 0 }, mBack{ 2 }
+		{}
+
+		/**brief Returns the buffer the writer fills before calling Publish.
+		*
+		* The buffer still has the data that was in it the last time it was the back buffer, not the last published data.
+		*/
+		T& GetWriteBuffer()
+		{
+			return mBuffers[mBack];
+		}
+
+		/**brief Makes the back buffer the newest data for the reader.
+		*/
+		void Publish()
+		{
+			mBack = mMiddle.exchange(mBack | FRESH, std::memory_order_acq_rel) & INDEX;
+		}
+
+		/**brief Makes the newest published data the read buffer.
+		*
+		* Returns true if there was new data since the last call, false otherwise. If there was no new data the read buffer does not change.
+		*/
+		bool Update()
+		{
+			if ((mMiddle.load(std::memory_order_relaxed) & FRESH) == 0)
+				return false;
+
+			mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & INDEX;
+
+			return true;
+		}
+
+		/**brief Returns the buffer the reader reads.
+		*/
+		const T& GetReadBuffer() const
+		{
+			return mBuffers[mFront];
+		}
+
+	private:
+		//The middle index is stored with a flag that is set when the middle buffer has data the reader has not seen.
+		static const unsigned int INDEX{ 3 };
+		static const unsigned int FRESH{ 4 };
+
+		T mBuffers[3];
+
+		std::atomic<unsigned int> mMiddle;
+		unsigned int mFront;
+		unsigned int mBack;
+	};
+}
\ No newline at end of file
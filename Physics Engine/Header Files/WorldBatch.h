@@ -0,0 +1,139 @@
+#pragma once
+
+#include "BodyPackets.h"
+
+namespace PhysicsEngine
+{
+	/**brief The centers of mass of every body of every world of a WorldBatch, recorded every interval steps.
+	*
+	* The samples are in structure of arrays form. The center of mass of body b of world w in sample s is at index
+	* (s * bodiesPerWorld + b) * numWorlds + w, so the worlds of a sample are next to each other like the worlds of the batch.\n
+	* StepWorlds adds to the samples, so clear them between calls to stream the results out in pieces.
+	*/
+	struct WorldBatchSamples
+	{
+		unsigned int interval{ 1 };
+		unsigned int numSamples{ 0 };
+
+		std::vector<float> centerOfMassX;
+		std::vector<float> centerOfMassY;
+		std::vector<float> centerOfMassZ;
+	};
+
+	/**brief Removes the samples but keeps the interval and the memory.
+	*/
+	void ClearSamples(WorldBatchSamples& samples);
+
+	/** @class WorldBatch ""
+	*	@brief Steps many small independent worlds with the same number of bodies together, for example for parameter sweeps.
+	*
+	*	Each world has its own gravity and drag, applied with the same formulas as the force generators, and its bodies are
+	*	integrated with the BodyPacket Integrate function, so a world of the batch steps exactly like a RigidBodyArrays object with
+	*	a UniformGravityGenerator and a DragGenerator.\n
+	*
+	*	The bodies are in BodyPacket objects with one world per lane. Packet (w / BODY_PACKET_WIDTH) * bodiesPerWorld + b holds body b of
+	*	BODY_PACKET_WIDTH worlds starting at world w, so the packets of a group of worlds are next to each other. The forces of a packet are
+	*	computed one world per SIMD lane and the packet is integrated right after, so every step reads and writes each packet once.\n
+	*
+	*	The worlds do not interact, so each thread gets its own worlds and takes a tile of them through every step before it
+	*	moves on to the next tile. The tiles are small enough to stay in the cache for the whole call.
+	*/
+	class WorldBatch
+	{
+	public:
+		/**brief Default constructor.
+		* Creates a batch with no worlds.
+		*/
+		WorldBatch();
+
+		/**brief Creates a batch with the specified number of worlds that each have the specified number of bodies.
+		*/
+		WorldBatch(unsigned int numWorlds, unsigned int bodiesPerWorld);
+
+		/**brief Initializes the batch with the specified number of worlds that each have the specified number of bodies.
+		*
+		* The bodies are at rest at the origin with a mass of 1, and the worlds have no gravity and no drag.
+		*/
+		void InitializeWorldBatch(unsigned int numWorlds, unsigned int bodiesPerWorld);
+
+		/**brief Returns the number of worlds.
+		*/
+		unsigned int GetNumberOfWorlds() const;
+
+		/**brief Returns the number of bodies in each world.
+		*/
+		unsigned int GetBodiesPerWorld() const;
+
+		/**brief Returns the number of steps taken since the batch was initialized.
+		*/
+		unsigned long long GetNumberOfSteps() const;
+
+		/**brief Returns the index of the body of the world in the packets returned by GetBodies.
+		*/
+		unsigned int GetBodyIndex(unsigned int world, unsigned int body) const;
+
+		/**brief Returns the bodies of all the worlds.
+		*
+		* The lanes past the last world have an inverse mass of 0.
+		*/
+		const BodyPacketArrays& GetBodies() const;
+
+		/**brief Copies the state of the rigid body into the body of the world.
+		*/
+		void SetBody(unsigned int world, unsigned int body, const RigidBody& rigidBody);
+
+		/**brief Copies the center of mass, orientation, linear momentum and angular momentum of the body of the world into the rigid body.
+		*/
+		void StoreBody(unsigned int world, unsigned int body, RigidBody& rigidBody) const;
+
+		/**brief Returns the center of mass of the body of the world.
+		*/
+		vec3 GetCenterOfMass(unsigned int world, unsigned int body) const;
+
+		/**brief Sets the gravity acceleration vector of the world.
+		*/
+		void SetGravity(unsigned int world, const vec3& acceleration);
+
+		/**brief Sets the linear and quadratic drag coefficients of the world.
+		*/
+		void SetDrag(unsigned int world, float k1, float k2);
+
+		/**brief Sets where the net force of the body of the world is applied, relative to its center of mass in world coordinates.
+		*
+		* The force then also produces the torque offset x force. The default offset is the zero vector, which produces no torque.
+		*/
+		void SetForceOffset(unsigned int world, unsigned int body, const vec3& offset);
+
+		/**brief Takes the specified number of steps of dt in every world.
+		*
+		* If numThreads is 0 the number of hardware threads is used.\n
+		* If samples is not nullptr the centers of mass are added to it after every step whose number is a multiple of its interval,
+		* counting the steps since the batch was initialized. The samples are allocated before the threads start.
+		*/
+		void StepWorlds(unsigned int numSteps, float dt, unsigned int numThreads = 1, WorldBatchSamples* samples = nullptr);
+
+	private:
+		void StepTile(unsigned int firstWorld, unsigned int numWorlds, unsigned int numSteps, float dt, WorldBatchSamples* samples,
+			unsigned int firstSample);
+		void StepThread(unsigned int firstWorld, unsigned int numWorlds, unsigned int numSteps, float dt, WorldBatchSamples* samples,
+			unsigned int firstSample);
+
+		unsigned int mNumWorlds;
+		unsigned int mBodiesPerWorld;
+		unsigned long long mNumSteps;
+
+		BodyPacketArrays mBodies;
+
+		//The force offsets of the bodies, in the same order as the bodies.
+		std::vector<float> mForceOffsetX;
+		std::vector<float> mForceOffsetY;
+		std::vector<float> mForceOffsetZ;
+
+		//The parameters of the worlds, one element per world and per lane past the last world.
+		std::vector<float> mGravityX;
+		std::vector<float> mGravityY;
+		std::vector<float> mGravityZ;
+		std::vector<float> mDragK1;
+		std::vector<float> mDragK2;
+	};
+}
\ No newline at end of file
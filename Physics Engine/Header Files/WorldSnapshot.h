@@ -0,0 +1,66 @@
+#pragma once
+
+#include "RigidBodyArrays.h"
+#include <vector>
+
+namespace PhysicsEngine
+{
+	/**brief The version of the snapshots written by SaveWorldSnapshot.
+	*
+	* Increase it whenever the layout of a section changes.
+	*/
+	const unsigned int WORLD_SNAPSHOT_VERSION{ 1 };
+
+	/**brief The types of data sections in a snapshot.
+	*/
+	enum WorldSnapshotSectionType { SNAPSHOT_BODIES = 1 };
+
+	/**brief The start of every snapshot.
+	*
+	* The magic number is the characters "PEWS". The sections follow the header one after the other.
+	*/
+	struct WorldSnapshotHeader
+	{
+		unsigned int magic{ 0x53574550 };
+		unsigned int version{ WORLD_SNAPSHOT_VERSION };
+		unsigned int numBodies{ 0 };
+		unsigned int numSections{ 0 };
+	};
+
+	/**brief The start of each section in a snapshot. byteSize is the size of the data of the section after this struct.
+	*
+	* Sections of unknown types are skipped when a snapshot is loaded, so new sections can be added without breaking older readers.
+	*/
+	struct WorldSnapshotSection
+	{
+		unsigned int type{ 0 };
+		unsigned int byteSize{ 0 };
+	};
+
+	/**brief Writes the complete state of the bodies into the snapshot.
+	*
+	* The snapshot is a binary blob in the byte order of the machine. The SNAPSHOT_BODIES section starts with the number of arrays
+	* followed by each array of the RigidBodyArrays, in the order they are declared, stored one after the other.
+	* This covers the mass, inverse mass, inverse body inertia, transform, velocities, momenta and force accumulators of every body.\n
+	* The snapshot is resized to fit, so saving into the same vector again does not allocate.
+	*/
+	void SaveWorldSnapshot(const RigidBodyArrays& bodies, std::vector<unsigned char>& snapshot);
+
+	/**brief Replaces the bodies with the bodies in the snapshot.
+	*
+	* Each array is copied with one memcpy. Arrays that are missing from the snapshot are filled with zeros.\n
+	* Returns false and leaves the bodies unchanged if the snapshot is not a valid snapshot or was written by a newer version.
+	*/
+	bool LoadWorldSnapshot(const unsigned char* snapshot, size_t size, RigidBodyArrays& bodies);
+
+	/**brief Replaces the bodies with the bodies in the snapshot.
+	*/
+	bool LoadWorldSnapshot(const std::vector<unsigned char>& snapshot, RigidBodyArrays& bodies);
+
+	/**brief Returns a hash of the state of every body, computed from the bits of the floats in the same arrays a snapshot stores.
+	*
+	* Two worlds with the same hash have, with near certainty, bit-identical bodies. Use it to check that two runs or two machines
+	* stayed in sync.
+	*/
+	unsigned long long HashWorldState(const RigidBodyArrays& bodies);
+}
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "AdaptiveStepper.h"
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	//The most sub-steps a step can be cut into is 2 to the power of this.
+	static const unsigned int MAX_LEVEL{ 16 };
+
+	//Returns the smallest level whose number of sub-steps is at least the specified number, up to the max level.
+	static unsigned int GetLevel(float substeps, unsigned int maxLevel)
+	{
+		unsigned int level{ 0 };
+		while (level < maxLevel && (float)(1u << level) < substeps)
+		{
+			++level;
+		}
+
+		return level;
+	}
+
+	AdaptiveStepper::AdaptiveStepper() : mMaxLevel{ 0 }, mNumTicks{ 0 }, mNumBodySubsteps{ 0 }
+	{
+		InitializeAdaptiveStepper(AdaptiveStepSettings{});
+	}
+
+	AdaptiveStepper::AdaptiveStepper(const AdaptiveStepSettings& settings) : mMaxLevel{ 0 }, mNumTicks{ 0 }, mNumBodySubsteps{ 0 }
+	{
+		InitializeAdaptiveStepper(settings);
+	}
+
+	void AdaptiveStepper::InitializeAdaptiveStepper(const AdaptiveStepSettings& settings)
+	{
+		mSettings = settings;
+
+		mMaxLevel = 0;
+		while (mMaxLevel < MAX_LEVEL && (2u << mMaxLevel) <= settings.maxSubsteps)
+		{
+			++mMaxLevel;
+		}
+
+		mSettings.maxSubsteps = 1u << mMaxLevel;
+	}
+
+	const AdaptiveStepSettings& AdaptiveStepper::GetSettings() const
+	{
+		return mSettings;
+	}
+
+	void AdaptiveStepper::SetBodySize(unsigned int body, float size)
+	{
+		if (body >= (unsigned int)mBodySizes.size())
+			mBodySizes.resize((size_t)body + 1, 1.0f);
+
+		mBodySizes[body] = (size < 0.0f) ? 0.0f : size;
+	}
+
+	float AdaptiveStepper::GetBodySize(unsigned int body) const
+	{
+		return (body < (unsigned int)mBodySizes.size()) ? mBodySizes[body] : 1.0f;
+	}
+
+	unsigned int AdaptiveStepper::FindRoot(unsigned int body)
+	{
+		//Path halving, every other body on the path is pointed at its grandparent.
+		while (mParents[body] != body)
+		{
+			mParents[body] = mParents[mParents[body]];
+			body = mParents[body];
+		}
+
+		return body;
+	}
+
+	void AdaptiveStepper::JoinBodies(const RigidBodyArrays& bodies, unsigned int a, unsigned int b)
+	{
+		unsigned int numBodies{ (unsigned int)mParents.size() };
+		if (a >= numBodies || b >= numBodies || bodies.inverseMass[a] == 0.0f || bodies.inverseMass[b] == 0.0f)
+			return;
+
+		unsigned int rootA{ FindRoot(a) };
+		unsigned int rootB{ FindRoot(b) };
+
+		//The root of an island is its first body, so the islands are numbered in the order of their first bodies.
+		if (rootA < rootB)
+			mParents[rootB] = rootA;
+		else
+			mParents[rootA] = rootB;
+	}
+
+	void AdaptiveStepper::BuildIslands(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators,
+		const std::vector<ContactConstraint>* contacts)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+
+		mParents.resize(numBodies);
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			mParents[i] = i;
+		}
+
+		for (const auto& i : forceGenerators.GetSpringGenerators())
+		{
+			JoinBodies(bodies, i.bodyA, i.bodyB);
+		}
+
+		if (contacts != nullptr)
+		{
+			for (const auto& i : *contacts)
+			{
+				JoinBodies(bodies, i.bodyA, i.bodyB);
+			}
+		}
+
+		unsigned int numIslands{ 0 };
+		mBodyIslands.assign(numBodies, INVALID_BODY);
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			if (bodies.inverseMass[i] == 0.0f)
+				continue;
+
+			unsigned int root{ FindRoot(i) };
+			if (root == i)
+				mBodyIslands[i] = numIslands++;
+			else
+				mBodyIslands[i] = mBodyIslands[root];
+		}
+
+		mIslandStarts.assign((size_t)numIslands + 1, 0);
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			if (mBodyIslands[i] != INVALID_BODY)
+				++mIslandStarts[mBodyIslands[i] + 1];
+		}
+
+		for (unsigned int i = 0; i < numIslands; ++i)
+		{
+			mIslandStarts[i + 1] += mIslandStarts[i];
+		}
+
+		//Filling the islands in body order leaves the bodies of each island sorted.
+		mIslandBodies.resize(mIslandStarts[numIslands]);
+		mRangeStarts.assign(mIslandStarts.begin(), mIslandStarts.end() - 1);
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			if (mBodyIslands[i] != INVALID_BODY)
+				mIslandBodies[mRangeStarts[mBodyIslands[i]]++] = i;
+		}
+
+		mRangeStarts.assign((size_t)numIslands + 1, 0);
+		mRanges.clear();
+		for (unsigned int i = 0; i < numIslands; ++i)
+		{
+			for (unsigned int j = mIslandStarts[i]; j < mIslandStarts[i + 1]; ++j)
+			{
+				unsigned int body{ mIslandBodies[j] };
+				if (j != mIslandStarts[i] && mRanges.back().first + mRanges.back().count == body)
+					++mRanges.back().count;
+				else
+					mRanges.push_back(BodyRange{ body, 1 });
+			}
+
+			mRangeStarts[i + 1] = (unsigned int)mRanges.size();
+		}
+	}
+
+	void AdaptiveStepper::ChooseSubsteps(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float dt)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		unsigned int numIslands{ GetNumberOfIslands() };
+
+		mIslandLevels.assign(numIslands, 0);
+
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			unsigned int island{ mBodyIslands[i] };
+			if (island == INVALID_BODY)
+				continue;
+
+			//The speed at the end of the step is at most the speed now plus the change the net force makes.
+			float speed{ MathEngine::Length(vec3{ bodies.linearVelocityX[i], bodies.linearVelocityY[i], bodies.linearVelocityZ[i] }) +
+				MathEngine::Length(vec3{ bodies.netForceX[i], bodies.netForceY[i], bodies.netForceZ[i] }) * bodies.inverseMass[i] * dt };
+			float angularSpeed{ MathEngine::Length(vec3{ bodies.angularVelocityX[i], bodies.angularVelocityY[i], bodies.angularVelocityZ[i] }) };
+
+			float size{ GetBodySize(i) };
+			float travelSubsteps{ (size > 0.0f) ? speed * dt / (size * mSettings.maxTravel) : 0.0f };
+			float rotationSubsteps{ angularSpeed * dt / mSettings.maxRotation };
+
+			unsigned int level{ GetLevel((travelSubsteps > rotationSubsteps) ? travelSubsteps : rotationSubsteps, mMaxLevel) };
+			if (level > mIslandLevels[island])
+				mIslandLevels[island] = level;
+		}
+
+		for (const auto& i : forceGenerators.GetSpringGenerators())
+		{
+			bool movesA{ i.bodyA < numBodies && mBodyIslands[i.bodyA] != INVALID_BODY };
+			bool movesB{ i.bodyB < numBodies && mBodyIslands[i.bodyB] != INVALID_BODY };
+			if (!movesA && !movesB)
+				continue;
+
+			//The translational frequency and damping rate of the spring, w = sqrt(k / m) and c / m with the reduced mass of the two bodies.
+			float inverseMass{ ((movesA) ? bodies.inverseMass[i.bodyA] : 0.0f) + ((movesB) ? bodies.inverseMass[i.bodyB] : 0.0f) };
+			float frequency{ std::sqrt(i.stiffness * inverseMass) };
+			float dampingRate{ i.damping * inverseMass };
+
+			float substeps{ ((frequency > dampingRate) ? frequency : dampingRate) * dt / mSettings.maxSpringPhase };
+
+			unsigned int island{ (movesA) ? mBodyIslands[i.bodyA] : mBodyIslands[i.bodyB] };
+			unsigned int level{ GetLevel(substeps, mMaxLevel) };
+			if (level > mIslandLevels[island])
+				mIslandLevels[island] = level;
+		}
+
+		mLevelStarts.assign((size_t)mMaxLevel + 2, 0);
+		unsigned int topLevel{ 0 };
+		for (unsigned int i = 0; i < numIslands; ++i)
+		{
+			++mLevelStarts[mIslandLevels[i] + 1];
+			if (mIslandLevels[i] > topLevel)
+				topLevel = mIslandLevels[i];
+		}
+
+		for (unsigned int i = 0; i <= mMaxLevel; ++i)
+		{
+			mLevelStarts[i + 1] += mLevelStarts[i];
+		}
+
+		unsigned int levelNext[MAX_LEVEL + 1];
+		for (unsigned int i = 0; i <= mMaxLevel; ++i)
+		{
+			levelNext[i] = mLevelStarts[i];
+		}
+
+		mLevelIslands.resize(numIslands);
+		for (unsigned int i = 0; i < numIslands; ++i)
+		{
+			mLevelIslands[levelNext[mIslandLevels[i]]++] = i;
+		}
+
+		mNumTicks = 1u << topLevel;
+	}
+
+	void AdaptiveStepper::Step(RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float dt,
+		const std::vector<ContactConstraint>* contacts, ContactSolver* solver, StepProfiler* profiler)
+	{
+		mNumTicks = 0;
+		mNumBodySubsteps = 0;
+
+		if (dt <= 0.0f)
+			return;
+
+		BuildIslands(bodies, forceGenerators, contacts);
+
+		{
+			ProfileScope scope{ profiler, PHASE_FORCES };
+			ResetForcesAndTorques(bodies);
+			forceGenerators.ApplyForceGenerators(bodies);
+		}
+
+		//The forces of the first tick are known, so the sub-steps account for how much they speed the bodies up.
+		ChooseSubsteps(bodies, forceGenerators, dt);
+
+		bool solveContacts{ contacts != nullptr && solver != nullptr };
+
+		for (unsigned int tick = 0; tick < mNumTicks; ++tick)
+		{
+			if (tick != 0)
+			{
+				ProfileScope scope{ profiler, PHASE_FORCES };
+				ResetForcesAndTorques(bodies);
+				forceGenerators.ApplyForceGenerators(bodies);
+			}
+
+			for (unsigned int level = 0; level <= mMaxLevel; ++level)
+			{
+				unsigned int firstIsland{ mLevelStarts[level] };
+				unsigned int lastIsland{ mLevelStarts[level + 1] };
+
+				//The islands of a level take a sub-step every (ticks / sub-steps) ticks.
+				unsigned int numSubsteps{ 1u << level };
+				if (firstIsland == lastIsland || numSubsteps > mNumTicks || tick % (mNumTicks / numSubsteps) != 0)
+					continue;
+
+				float substepTime{ dt / (float)numSubsteps };
+
+				if (solveContacts)
+				{
+					//The contacts keep their order, so with one sub-step they are solved exactly like a call to SolveContacts.
+					mTickContacts.clear();
+					for (const auto& i : *contacts)
+					{
+						unsigned int body{ (i.bodyA < (unsigned int)mBodyIslands.size() && mBodyIslands[i.bodyA] != INVALID_BODY) ? i.bodyA : i.bodyB };
+						if (body >= (unsigned int)mBodyIslands.size() || mBodyIslands[body] == INVALID_BODY ||
+							mIslandLevels[mBodyIslands[body]] != level)
+							continue;
+
+						mTickContacts.push_back(i);
+						mTickContacts.back().depth = i.depth / (float)numSubsteps;
+					}
+
+					if (!mTickContacts.empty())
+						solver->SolveContacts(bodies, mTickContacts, substepTime, profiler);
+				}
+
+				ProfileScope scope{ profiler, PHASE_INTEGRATION };
+				for (unsigned int i = firstIsland; i < lastIsland; ++i)
+				{
+					unsigned int island{ mLevelIslands[i] };
+					for (unsigned int j = mRangeStarts[island]; j < mRangeStarts[island + 1]; ++j)
+					{
+						IntegrateRigidBodies(bodies, mRanges[j], substepTime);
+					}
+
+					mNumBodySubsteps += mIslandStarts[island + 1] - mIslandStarts[island];
+				}
+			}
+		}
+	}
+
+	unsigned int AdaptiveStepper::GetNumberOfIslands() const
+	{
+		return (mIslandStarts.empty()) ? 0 : (unsigned int)mIslandStarts.size() - 1;
+	}
+
+	unsigned int AdaptiveStepper::GetIsland(unsigned int body) const
+	{
+		return (body < (unsigned int)mBodyIslands.size()) ? mBodyIslands[body] : INVALID_BODY;
+	}
+
+	unsigned int AdaptiveStepper::GetNumberOfIslandBodies(unsigned int island) const
+	{
+		return mIslandStarts[island + 1] - mIslandStarts[island];
+	}
+
+	const unsigned int* AdaptiveStepper::GetIslandBodies(unsigned int island) const
+	{
+		return mIslandBodies.data() + mIslandStarts[island];
+	}
+
+	unsigned int AdaptiveStepper::GetIslandSubsteps(unsigned int island) const
+	{
+		return 1u << mIslandLevels[island];
+	}
+
+	unsigned int AdaptiveStepper::GetNumberOfTicks() const
+	{
+		return mNumTicks;
+	}
+
+	unsigned long long AdaptiveStepper::GetNumberOfBodySubsteps() const
+	{
+		return mNumBodySubsteps;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,442 @@
+#include "BodyPackets.h"
+
+#if PHYSICS_ENGINE_BODY_PACKET_WIDTH == 8
+#include <immintrin.h>
+#else
+#include <xmmintrin.h>
+#endif
+
+namespace PhysicsEngine
+{
+	//The SIMD operations the integration kernel uses, on registers of BODY_PACKET_WIDTH floats.
+#if PHYSICS_ENGINE_BODY_PACKET_WIDTH == 8
+	typedef __m256 Lanes;
+
+	static inline Lanes Load(const float* p) { return _mm256_load_ps(p); }
+	static inline void Store(float* p, Lanes a) { _mm256_store_ps(p, a); }
+	static inline Lanes Set(float a) { return _mm256_set1_ps(a); }
+	static inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+	static inline Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+	static inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+	static inline Lanes Div(Lanes a, Lanes b) { return _mm256_div_ps(a, b); }
+	static inline Lanes Sqrt(Lanes a) { return _mm256_sqrt_ps(a); }
+	static inline Lanes Abs(Lanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static inline Lanes Less(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static inline Lanes Greater(Lanes a, Lanes b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static inline Lanes And(Lanes a, Lanes b) { return _mm256_and_ps(a, b); }
+	static inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b, a, mask); }
+#else
+	typedef __m128 Lanes;
+
+	static inline Lanes Load(const float* p) { return _mm_load_ps(p); }
+	static inline void Store(float* p, Lanes a) { _mm_store_ps(p, a); }
+	static inline Lanes Set(float a) { return _mm_set1_ps(a); }
+	static inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+	static inline Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+	static inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+	static inline Lanes Div(Lanes a, Lanes b) { return _mm_div_ps(a, b); }
+	static inline Lanes Sqrt(Lanes a) { return _mm_sqrt_ps(a); }
+	static inline Lanes Abs(Lanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static inline Lanes Less(Lanes a, Lanes b) { return _mm_cmplt_ps(a, b); }
+	static inline Lanes Greater(Lanes a, Lanes b) { return _mm_cmpgt_ps(a, b); }
+	static inline Lanes And(Lanes a, Lanes b) { return _mm_and_ps(a, b); }
+	static inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#endif
+
+	//Sets the lane of the packet to a body at rest at the origin with an inverse mass of 0.
+	static void ClearLane(BodyPacket& packet, unsigned int lane)
+	{
+		packet.mass[lane] = 0.0f;
+		packet.inverseMass[lane] = 0.0f;
+
+		packet.centerOfMassX[lane] = 0.0f;
+		packet.centerOfMassY[lane] = 0.0f;
+		packet.centerOfMassZ[lane] = 0.0f;
+
+		packet.orientationW[lane] = 1.0f;
+		packet.orientationX[lane] = 0.0f;
+		packet.orientationY[lane] = 0.0f;
+		packet.orientationZ[lane] = 0.0f;
+
+		packet.linearVelocityX[lane] = 0.0f;
+		packet.linearVelocityY[lane] = 0.0f;
+		packet.linearVelocityZ[lane] = 0.0f;
+
+		packet.linearMomentumX[lane] = 0.0f;
+		packet.linearMomentumY[lane] = 0.0f;
+		packet.linearMomentumZ[lane] = 0.0f;
+
+		packet.angularVelocityX[lane] = 0.0f;
+		packet.angularVelocityY[lane] = 0.0f;
+		packet.angularVelocityZ[lane] = 0.0f;
+
+		packet.angularMomentumX[lane] = 0.0f;
+		packet.angularMomentumY[lane] = 0.0f;
+		packet.angularMomentumZ[lane] = 0.0f;
+
+		packet.inverseBodyInertiaXX[lane] = 0.0f;
+		packet.inverseBodyInertiaYY[lane] = 0.0f;
+		packet.inverseBodyInertiaZZ[lane] = 0.0f;
+		packet.inverseBodyInertiaXY[lane] = 0.0f;
+		packet.inverseBodyInertiaXZ[lane] = 0.0f;
+		packet.inverseBodyInertiaYZ[lane] = 0.0f;
+
+		packet.netForceX[lane] = 0.0f;
+		packet.netForceY[lane] = 0.0f;
+		packet.netForceZ[lane] = 0.0f;
+
+		packet.netTorqueX[lane] = 0.0f;
+		packet.netTorqueY[lane] = 0.0f;
+		packet.netTorqueZ[lane] = 0.0f;
+	}
+
+	unsigned int GetNumberOfBodies(const BodyPacketArrays& bodies)
+	{
+		return bodies.numBodies;
+	}
+
+	void ResizeBodies(BodyPacketArrays& bodies, unsigned int numBodies)
+	{
+		unsigned int numPackets{ (numBodies + BODY_PACKET_WIDTH - 1) / BODY_PACKET_WIDTH };
+		unsigned int oldBodies{ bodies.numBodies };
+
+		bodies.packets.resize(numPackets);
+		bodies.numBodies = numBodies;
+
+		//Clear the new bodies, and the lanes past the last body if the packets shrank.
+		unsigned int first{ (oldBodies < numBodies) ? oldBodies : numBodies };
+		for (unsigned int i = first; i < numPackets * BODY_PACKET_WIDTH; ++i)
+		{
+			ClearLane(bodies.packets[i / BODY_PACKET_WIDTH], i % BODY_PACKET_WIDTH);
+		}
+	}
+
+	void LoadRigidBody(BodyPacketArrays& bodies, unsigned int index, const RigidBody& body)
+	{
+		BodyPacket& packet{ bodies.packets[index / BODY_PACKET_WIDTH] };
+		unsigned int lane{ index % BODY_PACKET_WIDTH };
+
+		packet.mass[lane] = body.GetMass();
+		packet.inverseMass[lane] = body.GetInverseMass();
+
+		const vec3& centerOfMass{ body.GetCenterOfMass() };
+		packet.centerOfMassX[lane] = centerOfMass.x;
+		packet.centerOfMassY[lane] = centerOfMass.y;
+		packet.centerOfMassZ[lane] = centerOfMass.z;
+
+		const MathEngine::Quaternion& orientation{ body.GetOrientation() };
+		packet.orientationW[lane] = orientation.scalar;
+		packet.orientationX[lane] = orientation.vector.x;
+		packet.orientationY[lane] = orientation.vector.y;
+		packet.orientationZ[lane] = orientation.vector.z;
+
+		const vec3& linearVelocity{ body.GetLinearVelocity() };
+		packet.linearVelocityX[lane] = linearVelocity.x;
+		packet.linearVelocityY[lane] = linearVelocity.y;
+		packet.linearVelocityZ[lane] = linearVelocity.z;
+
+		const vec3& linearMomentum{ body.GetLinearMomentum() };
+		packet.linearMomentumX[lane] = linearMomentum.x;
+		packet.linearMomentumY[lane] = linearMomentum.y;
+		packet.linearMomentumZ[lane] = linearMomentum.z;
+
+		const vec3& angularVelocity{ body.GetAngularVelocity() };
+		packet.angularVelocityX[lane] = angularVelocity.x;
+		packet.angularVelocityY[lane] = angularVelocity.y;
+		packet.angularVelocityZ[lane] = angularVelocity.z;
+
+		const vec3& angularMomentum{ body.GetAngularMomentum() };
+		packet.angularMomentumX[lane] = angularMomentum.x;
+		packet.angularMomentumY[lane] = angularMomentum.y;
+		packet.angularMomentumZ[lane] = angularMomentum.z;
+
+		const mat3& inverseBodyInertia{ body.GetInverseBodyInertiaTensor() };
+		packet.inverseBodyInertiaXX[lane] = inverseBodyInertia(0, 0);
+		packet.inverseBodyInertiaYY[lane] = inverseBodyInertia(1, 1);
+		packet.inverseBodyInertiaZZ[lane] = inverseBodyInertia(2, 2);
+		packet.inverseBodyInertiaXY[lane] = inverseBodyInertia(0, 1);
+		packet.inverseBodyInertiaXZ[lane] = inverseBodyInertia(0, 2);
+		packet.inverseBodyInertiaYZ[lane] = inverseBodyInertia(1, 2);
+
+		packet.netForceX[lane] = 0.0f;
+		packet.netForceY[lane] = 0.0f;
+		packet.netForceZ[lane] = 0.0f;
+
+		packet.netTorqueX[lane] = 0.0f;
+		packet.netTorqueY[lane] = 0.0f;
+		packet.netTorqueZ[lane] = 0.0f;
+	}
+
+	void StoreRigidBody(const BodyPacketArrays& bodies, unsigned int index, RigidBody& body)
+	{
+		const BodyPacket& packet{ bodies.packets[index / BODY_PACKET_WIDTH] };
+		unsigned int lane{ index % BODY_PACKET_WIDTH };
+
+		body.SetCenterOfMass(vec3{ packet.centerOfMassX[lane], packet.centerOfMassY[lane], packet.centerOfMassZ[lane] });
+
+		//The orientation has to be set first since the angular velocity is computed from the world inertia tensor.
+		body.SetOrientation(MathEngine::Quaternion{ packet.orientationW[lane],
+			vec3{ packet.orientationX[lane], packet.orientationY[lane], packet.orientationZ[lane] } });
+
+		body.SetLinearMomentum(vec3{ packet.linearMomentumX[lane], packet.linearMomentumY[lane], packet.linearMomentumZ[lane] });
+		body.SetAngularMomentum(vec3{ packet.angularMomentumX[lane], packet.angularMomentumY[lane], packet.angularMomentumZ[lane] });
+	}
+
+	void GatherBodies(BodyPacketArrays& packets, const RigidBodyArrays& bodies, const unsigned int* handles, unsigned int numHandles)
+	{
+		ResizeBodies(packets, numHandles);
+
+		for (unsigned int i = 0; i < numHandles; ++i)
+		{
+			BodyPacket& packet{ packets.packets[i / BODY_PACKET_WIDTH] };
+			unsigned int lane{ i % BODY_PACKET_WIDTH };
+			unsigned int j{ handles[i] };
+
+			packet.mass[lane] = bodies.mass[j];
+			packet.inverseMass[lane] = bodies.inverseMass[j];
+
+			packet.centerOfMassX[lane] = bodies.centerOfMassX[j];
+			packet.centerOfMassY[lane] = bodies.centerOfMassY[j];
+			packet.centerOfMassZ[lane] = bodies.centerOfMassZ[j];
+
+			packet.orientationW[lane] = bodies.orientationW[j];
+			packet.orientationX[lane] = bodies.orientationX[j];
+			packet.orientationY[lane] = bodies.orientationY[j];
+			packet.orientationZ[lane] = bodies.orientationZ[j];
+
+			packet.linearVelocityX[lane] = bodies.linearVelocityX[j];
+			packet.linearVelocityY[lane] = bodies.linearVelocityY[j];
+			packet.linearVelocityZ[lane] = bodies.linearVelocityZ[j];
+
+			packet.linearMomentumX[lane] = bodies.linearMomentumX[j];
+			packet.linearMomentumY[lane] = bodies.linearMomentumY[j];
+			packet.linearMomentumZ[lane] = bodies.linearMomentumZ[j];
+
+			packet.angularVelocityX[lane] = bodies.angularVelocityX[j];
+			packet.angularVelocityY[lane] = bodies.angularVelocityY[j];
+			packet.angularVelocityZ[lane] = bodies.angularVelocityZ[j];
+
+			packet.angularMomentumX[lane] = bodies.angularMomentumX[j];
+			packet.angularMomentumY[lane] = bodies.angularMomentumY[j];
+			packet.angularMomentumZ[lane] = bodies.angularMomentumZ[j];
+
+			packet.inverseBodyInertiaXX[lane] = bodies.inverseBodyInertiaXX[j];
+			packet.inverseBodyInertiaYY[lane] = bodies.inverseBodyInertiaYY[j];
+			packet.inverseBodyInertiaZZ[lane] = bodies.inverseBodyInertiaZZ[j];
+			packet.inverseBodyInertiaXY[lane] = bodies.inverseBodyInertiaXY[j];
+			packet.inverseBodyInertiaXZ[lane] = bodies.inverseBodyInertiaXZ[j];
+			packet.inverseBodyInertiaYZ[lane] = bodies.inverseBodyInertiaYZ[j];
+
+			packet.netForceX[lane] = bodies.netForceX[j];
+			packet.netForceY[lane] = bodies.netForceY[j];
+			packet.netForceZ[lane] = bodies.netForceZ[j];
+
+			packet.netTorqueX[lane] = bodies.netTorqueX[j];
+			packet.netTorqueY[lane] = bodies.netTorqueY[j];
+			packet.netTorqueZ[lane] = bodies.netTorqueZ[j];
+		}
+	}
+
+	void ScatterBodies(const BodyPacketArrays& packets, RigidBodyArrays& bodies, const unsigned int* handles, unsigned int numHandles)
+	{
+		for (unsigned int i = 0; i < numHandles; ++i)
+		{
+			const BodyPacket& packet{ packets.packets[i / BODY_PACKET_WIDTH] };
+			unsigned int lane{ i % BODY_PACKET_WIDTH };
+			unsigned int j{ handles[i] };
+
+			bodies.centerOfMassX[j] = packet.centerOfMassX[lane];
+			bodies.centerOfMassY[j] = packet.centerOfMassY[lane];
+			bodies.centerOfMassZ[j] = packet.centerOfMassZ[lane];
+
+			bodies.orientationW[j] = packet.orientationW[lane];
+			bodies.orientationX[j] = packet.orientationX[lane];
+			bodies.orientationY[j] = packet.orientationY[lane];
+			bodies.orientationZ[j] = packet.orientationZ[lane];
+
+			bodies.linearVelocityX[j] = packet.linearVelocityX[lane];
+			bodies.linearVelocityY[j] = packet.linearVelocityY[lane];
+			bodies.linearVelocityZ[j] = packet.linearVelocityZ[lane];
+
+			bodies.linearMomentumX[j] = packet.linearMomentumX[lane];
+			bodies.linearMomentumY[j] = packet.linearMomentumY[lane];
+			bodies.linearMomentumZ[j] = packet.linearMomentumZ[lane];
+
+			bodies.angularVelocityX[j] = packet.angularVelocityX[lane];
+			bodies.angularVelocityY[j] = packet.angularVelocityY[lane];
+			bodies.angularVelocityZ[j] = packet.angularVelocityZ[lane];
+
+			bodies.angularMomentumX[j] = packet.angularMomentumX[lane];
+			bodies.angularMomentumY[j] = packet.angularMomentumY[lane];
+			bodies.angularMomentumZ[j] = packet.angularMomentumZ[lane];
+		}
+	}
+
+	void ResetForcesAndTorques(BodyPacketArrays& bodies)
+	{
+		for (auto& i : bodies.packets)
+		{
+			for (unsigned int lane = 0; lane < BODY_PACKET_WIDTH; ++lane)
+			{
+				i.netForceX[lane] = 0.0f;
+				i.netForceY[lane] = 0.0f;
+				i.netForceZ[lane] = 0.0f;
+
+				i.netTorqueX[lane] = 0.0f;
+				i.netTorqueY[lane] = 0.0f;
+				i.netTorqueZ[lane] = 0.0f;
+			}
+		}
+	}
+
+	void AddForceAndTorque(BodyPacketArrays& bodies, unsigned int index, const vec3& force, const vec3& torque)
+	{
+		BodyPacket& packet{ bodies.packets[index / BODY_PACKET_WIDTH] };
+		unsigned int lane{ index % BODY_PACKET_WIDTH };
+
+		packet.netForceX[lane] += force.x;
+		packet.netForceY[lane] += force.y;
+		packet.netForceZ[lane] += force.z;
+
+		packet.netTorqueX[lane] += torque.x;
+		packet.netTorqueY[lane] += torque.y;
+		packet.netTorqueZ[lane] += torque.z;
+	}
+
+	void Integrate(BodyPacket& packet, float dt)
+	{
+		//Every product and sum is done in the same order as the Matrix3x3 and Quaternion operators RigidBody::Integrate uses,
+		//so each lane gets the same bits as the scalar path.
+		Lanes zero{ Set(0.0f) };
+		Lanes one{ Set(1.0f) };
+		Lanes two{ Set(2.0f) };
+		Lanes half{ Set(0.5f) };
+		Lanes sdt{ Set(dt) };
+
+		//If inverse mass equals to 0 that means the rigid body has infinite mass and cannot be moved.
+		Lanes inverseMass{ Load(packet.inverseMass) };
+		Lanes movable{ Greater(inverseMass, zero) };
+
+		//L += F * dt, v = L / m, x += v * dt
+		Lanes px{ Add(Load(packet.linearMomentumX), Mul(Load(packet.netForceX), sdt)) };
+		Lanes py{ Add(Load(packet.linearMomentumY), Mul(Load(packet.netForceY), sdt)) };
+		Lanes pz{ Add(Load(packet.linearMomentumZ), Mul(Load(packet.netForceZ), sdt)) };
+
+		Lanes vx{ Mul(px, inverseMass) };
+		Lanes vy{ Mul(py, inverseMass) };
+		Lanes vz{ Mul(pz, inverseMass) };
+
+		Lanes cx{ Add(Load(packet.centerOfMassX), Mul(vx, sdt)) };
+		Lanes cy{ Add(Load(packet.centerOfMassY), Mul(vy, sdt)) };
+		Lanes cz{ Add(Load(packet.centerOfMassZ), Mul(vz, sdt)) };
+
+		Lanes lx{ Add(Load(packet.angularMomentumX), Mul(Load(packet.netTorqueX), sdt)) };
+		Lanes ly{ Add(Load(packet.angularMomentumY), Mul(Load(packet.netTorqueY), sdt)) };
+		Lanes lz{ Add(Load(packet.angularMomentumZ), Mul(Load(packet.netTorqueZ), sdt)) };
+
+		Lanes qw{ Load(packet.orientationW) };
+		Lanes qx{ Load(packet.orientationX) };
+		Lanes qy{ Load(packet.orientationY) };
+		Lanes qz{ Load(packet.orientationZ) };
+
+		//The row-major rotation matrix of the orientation, QuaternionToRotationMatrixRow3x3.
+		Lanes r00{ Sub(Sub(one, Mul(Mul(two, qy), qy)), Mul(Mul(two, qz), qz)) };
+		Lanes r01{ Add(Mul(Mul(two, qx), qy), Mul(Mul(two, qw), qz)) };
+		Lanes r02{ Sub(Mul(Mul(two, qx), qz), Mul(Mul(two, qw), qy)) };
+		Lanes r10{ Sub(Mul(Mul(two, qx), qy), Mul(Mul(two, qw), qz)) };
+		Lanes r11{ Sub(Sub(one, Mul(Mul(two, qx), qx)), Mul(Mul(two, qz), qz)) };
+		Lanes r12{ Add(Mul(Mul(two, qy), qz), Mul(Mul(two, qw), qx)) };
+		Lanes r20{ Add(Mul(Mul(two, qx), qz), Mul(Mul(two, qw), qy)) };
+		Lanes r21{ Sub(Mul(Mul(two, qy), qz), Mul(Mul(two, qw), qx)) };
+		Lanes r22{ Sub(Sub(one, Mul(Mul(two, qx), qx)), Mul(Mul(two, qy), qy)) };
+
+		Lanes ixx{ Load(packet.inverseBodyInertiaXX) };
+		Lanes iyy{ Load(packet.inverseBodyInertiaYY) };
+		Lanes izz{ Load(packet.inverseBodyInertiaZZ) };
+		Lanes ixy{ Load(packet.inverseBodyInertiaXY) };
+		Lanes ixz{ Load(packet.inverseBodyInertiaXZ) };
+		Lanes iyz{ Load(packet.inverseBodyInertiaYZ) };
+
+		//A = R * inverse body inertia
+		Lanes a00{ Add(Add(Mul(r00, ixx), Mul(r01, ixy)), Mul(r02, ixz)) };
+		Lanes a01{ Add(Add(Mul(r00, ixy), Mul(r01, iyy)), Mul(r02, iyz)) };
+		Lanes a02{ Add(Add(Mul(r00, ixz), Mul(r01, iyz)), Mul(r02, izz)) };
+		Lanes a10{ Add(Add(Mul(r10, ixx), Mul(r11, ixy)), Mul(r12, ixz)) };
+		Lanes a11{ Add(Add(Mul(r10, ixy), Mul(r11, iyy)), Mul(r12, iyz)) };
+		Lanes a12{ Add(Add(Mul(r10, ixz), Mul(r11, iyz)), Mul(r12, izz)) };
+		Lanes a20{ Add(Add(Mul(r20, ixx), Mul(r21, ixy)), Mul(r22, ixz)) };
+		Lanes a21{ Add(Add(Mul(r20, ixy), Mul(r21, iyy)), Mul(r22, iyz)) };
+		Lanes a22{ Add(Add(Mul(r20, ixz), Mul(r21, iyz)), Mul(r22, izz)) };
+
+		//inverse world inertia = A * transpose(R), element (i, j) is row i of A dotted with row j of R.
+		Lanes w00{ Add(Add(Mul(a00, r00), Mul(a01, r01)), Mul(a02, r02)) };
+		Lanes w01{ Add(Add(Mul(a00, r10), Mul(a01, r11)), Mul(a02, r12)) };
+		Lanes w02{ Add(Add(Mul(a00, r20), Mul(a01, r21)), Mul(a02, r22)) };
+		Lanes w10{ Add(Add(Mul(a10, r00), Mul(a11, r01)), Mul(a12, r02)) };
+		Lanes w11{ Add(Add(Mul(a10, r10), Mul(a11, r11)), Mul(a12, r12)) };
+		Lanes w12{ Add(Add(Mul(a10, r20), Mul(a11, r21)), Mul(a12, r22)) };
+		Lanes w20{ Add(Add(Mul(a20, r00), Mul(a21, r01)), Mul(a22, r02)) };
+		Lanes w21{ Add(Add(Mul(a20, r10), Mul(a21, r11)), Mul(a22, r12)) };
+		Lanes w22{ Add(Add(Mul(a20, r20), Mul(a21, r21)), Mul(a22, r22)) };
+
+		//w = L * inverse world inertia
+		Lanes wx{ Add(Add(Mul(lx, w00), Mul(ly, w10)), Mul(lz, w20)) };
+		Lanes wy{ Add(Add(Mul(lx, w01), Mul(ly, w11)), Mul(lz, w21)) };
+		Lanes wz{ Add(Add(Mul(lx, w02), Mul(ly, w12)), Mul(lz, w22)) };
+
+		//dq/dt = [0, w] * q * 0.5. The products with the 0 scalar are kept so signed zeros match the scalar path.
+		Lanes dw{ Sub(Mul(zero, qw), Add(Add(Mul(wx, qx), Mul(wy, qy)), Mul(wz, qz))) };
+		Lanes dx{ Add(Add(Mul(zero, qx), Mul(qw, wx)), Sub(Mul(wy, qz), Mul(wz, qy))) };
+		Lanes dy{ Add(Add(Mul(zero, qy), Mul(qw, wy)), Sub(Mul(wz, qx), Mul(wx, qz))) };
+		Lanes dz{ Add(Add(Mul(zero, qz), Mul(qw, wz)), Sub(Mul(wx, qy), Mul(wy, qx))) };
+
+		Lanes nw{ Add(qw, Mul(Mul(dw, half), sdt)) };
+		Lanes nx{ Add(qx, Mul(Mul(dx, half), sdt)) };
+		Lanes ny{ Add(qy, Mul(Mul(dy, half), sdt)) };
+		Lanes nz{ Add(qz, Mul(Mul(dz, half), sdt)) };
+
+		//Normalize leaves a quaternion whose components are all smaller than EPSILON as it is.
+		Lanes epsilon{ Set(EPSILON) };
+		Lanes isZero{ And(And(Less(Abs(nw), epsilon), Less(Abs(nx), epsilon)), And(Less(Abs(ny), epsilon), Less(Abs(nz), epsilon))) };
+		Lanes inverseLength{ Div(one, Sqrt(Add(Add(Add(Mul(nw, nw), Mul(nx, nx)), Mul(ny, ny)), Mul(nz, nz)))) };
+		Lanes scale{ Select(isZero, one, inverseLength) };
+
+		nw = Mul(nw, scale);
+		nx = Mul(nx, scale);
+		ny = Mul(ny, scale);
+		nz = Mul(nz, scale);
+
+		Store(packet.linearMomentumX, Select(movable, px, Load(packet.linearMomentumX)));
+		Store(packet.linearMomentumY, Select(movable, py, Load(packet.linearMomentumY)));
+		Store(packet.linearMomentumZ, Select(movable, pz, Load(packet.linearMomentumZ)));
+
+		Store(packet.linearVelocityX, Select(movable, vx, Load(packet.linearVelocityX)));
+		Store(packet.linearVelocityY, Select(movable, vy, Load(packet.linearVelocityY)));
+		Store(packet.linearVelocityZ, Select(movable, vz, Load(packet.linearVelocityZ)));
+
+		Store(packet.centerOfMassX, Select(movable, cx, Load(packet.centerOfMassX)));
+		Store(packet.centerOfMassY, Select(movable, cy, Load(packet.centerOfMassY)));
+		Store(packet.centerOfMassZ, Select(movable, cz, Load(packet.centerOfMassZ)));
+
+		Store(packet.angularMomentumX, Select(movable, lx, Load(packet.angularMomentumX)));
+		Store(packet.angularMomentumY, Select(movable, ly, Load(packet.angularMomentumY)));
+		Store(packet.angularMomentumZ, Select(movable, lz, Load(packet.angularMomentumZ)));
+
+		Store(packet.angularVelocityX, Select(movable, wx, Load(packet.angularVelocityX)));
+		Store(packet.angularVelocityY, Select(movable, wy, Load(packet.angularVelocityY)));
+		Store(packet.angularVelocityZ, Select(movable, wz, Load(packet.angularVelocityZ)));
+
+		Store(packet.orientationW, Select(movable, nw, qw));
+		Store(packet.orientationX, Select(movable, nx, qx));
+		Store(packet.orientationY, Select(movable, ny, qy));
+		Store(packet.orientationZ, Select(movable, nz, qz));
+	}
+
+	void IntegrateRigidBodies(BodyPacketArrays& bodies, float dt)
+	{
+		for (auto& i : bodies.packets)
+		{
+			Integrate(i, dt);
+		}
+	}
+}
\ No newline at end of file
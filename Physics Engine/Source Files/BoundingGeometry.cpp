@@ -0,0 +1,580 @@
+#include "BoundingGeometry.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace PhysicsEngine
+{
+	void InitializeAABB(AABB& a, vec3 min, vec3 max)
+	{
+		a.min = min;
+		a.max = max;
+	}
+
+	void ComputeAABB(AABB& aabb, const std::vector<ShapesEngine::Vertex>& vertices)
+	{
+		vec3 minP(vertices.at(0).position);
+		vec3 maxP(vertices.at(0).position);
+
+		//find the min and max x,y and z values.
+		for (const auto& i : vertices)
+		{
+			if (i.position.x < minP.x)
+				minP.x = i.position.x;
+
+			if (i.position.x > maxP.x)
+				maxP.x = i.position.x;
+
+			if (i.position.y < minP.y)
+				minP.y = i.position.y;
+
+			if (i.position.y > maxP.y)
+				maxP.y = i.position.y;
+
+			if (i.position.z < minP.z)
+				minP.z = i.position.z;
+
+			if (i.position.z > maxP.z)
+				maxP.z = i.position.z;
+		}
+
+		aabb.min = minP;
+		aabb.max = maxP;
+	}
+
+	void TransformAABB(AABB& worldAABB, const AABB& localAABB, const mat4& model)
+	{
+		worldAABB.min = vec3{};
+		worldAABB.max = vec3{};
+
+		float a{ 0.0f };
+		float b{ 0.0f };
+
+		//xmin, xmax
+		a = localAABB.min.x * model(0, 0);
+		b = localAABB.max.x * model(0, 0);
+		worldAABB.min.x += a < b ? a : b;
+		worldAABB.max.x += a < b ? b : a;
+
+		a = localAABB.min.y * model(1, 0);
+		b = localAABB.max.y * model(1, 0);
+		worldAABB.min.x += a < b ? a : b;
+		worldAABB.max.x += a < b ? b : a;
+
+		a = localAABB.min.z * model(2, 0);
+		b = localAABB.max.z * model(2, 0);
+		worldAABB.min.x += a < b ? a : b;
+		worldAABB.max.x += a < b ? b : a;
+
+		worldAABB.min.x += model(3, 0);
+		worldAABB.max.x += model(3, 0);
+
+		//ymin, ymax
+		a = localAABB.min.x * model(0, 1);
+		b = localAABB.max.x * model(0, 1);
+		worldAABB.min.y += a < b ? a : b;
+		worldAABB.max.y += a < b ? b : a;
+
+		a = localAABB.min.y * model(1, 1);
+		b = localAABB.max.y * model(1, 1);
+		worldAABB.min.y += a < b ? a : b;
+		worldAABB.max.y += a < b ? b : a;
+
+		a = localAABB.min.z * model(2, 1);
+		b = localAABB.max.z * model(2, 1);
+		worldAABB.min.y += a < b ? a : b;
+		worldAABB.max.y += a < b ? b : a;
+
+		worldAABB.min.y += model(3, 1);
+		worldAABB.max.y += model(3, 1);
+
+		//zmin, zmax
+		a = localAABB.min.x * model(0, 2);
+		b = localAABB.max.x * model(0, 2);
+		worldAABB.min.z += a < b ? a : b;
+		worldAABB.max.z += a < b ? b : a;
+
+		a = localAABB.min.y * model(1, 2);
+		b = localAABB.max.y * model(1, 2);
+		worldAABB.min.z += a < b ? a : b;
+		worldAABB.max.z += a < b ? b : a;
+
+		a = localAABB.min.z * model(2, 2);
+		b = localAABB.max.z * model(2, 2);
+		worldAABB.min.z += a < b ? a : b;
+		worldAABB.max.z += a < b ? b : a;
+
+		worldAABB.min.z += model(3, 2);
+		worldAABB.max.z += model(3, 2);
+	}
+
+	bool TestIntersection(const AABB& a, const AABB& b)
+	{
+		//Two AABBs intersect if and only if they are intersecting on all three axes.
+		//Return false if they are not intersecting on one axis.
+
+		//x-axis test
+		if (a.max.x < b.min.x || a.min.x > b.max.x)
+			return false;
+
+		//y-axis test
+		if (a.max.y < b.min.y || a.min.y > b.max.y)
+			return false;
+
+		//z-axis test
+		if (a.max.z < b.min.z || a.min.z > b.max.z)
+			return false;
+
+		//They intersect on all axes.
+		return true;
+	}
+
+	unsigned int GetNumberOfAABBs(const AABBArrays& aabbs)
+	{
+		return (unsigned int)aabbs.minX.size();
+	}
+
+	void ResizeAABBs(AABBArrays& aabbs, unsigned int numAABBs)
+	{
+		aabbs.minX.resize(numAABBs);
+		aabbs.minY.resize(numAABBs);
+		aabbs.minZ.resize(numAABBs);
+		aabbs.maxX.resize(numAABBs);
+		aabbs.maxY.resize(numAABBs);
+		aabbs.maxZ.resize(numAABBs);
+	}
+
+	unsigned int AddAABB(AABBArrays& aabbs, const AABB& aabb)
+	{
+		unsigned int index{ GetNumberOfAABBs(aabbs) };
+
+		ResizeAABBs(aabbs, index + 1);
+		SetAABB(aabbs, index, aabb);
+
+		return index;
+	}
+
+	void SetAABB(AABBArrays& aabbs, unsigned int index, const AABB& aabb)
+	{
+		aabbs.minX[index] = aabb.min.x;
+		aabbs.minY[index] = aabb.min.y;
+		aabbs.minZ[index] = aabb.min.z;
+		aabbs.maxX[index] = aabb.max.x;
+		aabbs.maxY[index] = aabb.max.y;
+		aabbs.maxZ[index] = aabb.max.z;
+	}
+
+	AABB GetAABB(const AABBArrays& aabbs, unsigned int index)
+	{
+		return AABB{ vec3{ aabbs.minX[index], aabbs.minY[index], aabbs.minZ[index] },
+			vec3{ aabbs.maxX[index], aabbs.maxY[index], aabbs.maxZ[index] } };
+	}
+
+	void TransformAABBs(AABBArrays& worldAABBs, const AABBArrays& localAABBs, const mat4* models)
+	{
+		unsigned int numAABBs{ GetNumberOfAABBs(localAABBs) };
+		ResizeAABBs(worldAABBs, numAABBs);
+
+		__m128 half{ _mm_set1_ps(0.5f) };
+		__m128 absMask{ _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)) };
+
+		unsigned int i{ 0 };
+		for (; i + 4 <= numAABBs; i += 4)
+		{
+			//Transpose the first 3 columns of the 4 model matrices so m[row][col] holds that entry of each matrix.
+			__m128 m[4][3];
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				__m128 a{ _mm_loadu_ps(models[i].Data() + row * 4) };
+				__m128 b{ _mm_loadu_ps(models[i + 1].Data() + row * 4) };
+				__m128 c{ _mm_loadu_ps(models[i + 2].Data() + row * 4) };
+				__m128 d{ _mm_loadu_ps(models[i + 3].Data() + row * 4) };
+				_MM_TRANSPOSE4_PS(a, b, c, d);
+
+				m[row][0] = a;
+				m[row][1] = b;
+				m[row][2] = c;
+			}
+
+			__m128 minX{ _mm_loadu_ps(localAABBs.minX.data() + i) };
+			__m128 minY{ _mm_loadu_ps(localAABBs.minY.data() + i) };
+			__m128 minZ{ _mm_loadu_ps(localAABBs.minZ.data() + i) };
+			__m128 maxX{ _mm_loadu_ps(localAABBs.maxX.data() + i) };
+			__m128 maxY{ _mm_loadu_ps(localAABBs.maxY.data() + i) };
+			__m128 maxZ{ _mm_loadu_ps(localAABBs.maxZ.data() + i) };
+
+			//center and extents of the local AABBs
+			__m128 cx{ _mm_mul_ps(_mm_add_ps(minX, maxX), half) };
+			__m128 cy{ _mm_mul_ps(_mm_add_ps(minY, maxY), half) };
+			__m128 cz{ _mm_mul_ps(_mm_add_ps(minZ, maxZ), half) };
+			__m128 ex{ _mm_mul_ps(_mm_sub_ps(maxX, minX), half) };
+			__m128 ey{ _mm_mul_ps(_mm_sub_ps(maxY, minY), half) };
+			__m128 ez{ _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half) };
+
+			float* worldMin[3]{ worldAABBs.minX.data() + i, worldAABBs.minY.data() + i, worldAABBs.minZ.data() + i };
+			float* worldMax[3]{ worldAABBs.maxX.data() + i, worldAABBs.maxY.data() + i, worldAABBs.maxZ.data() + i };
+
+			for (unsigned int col = 0; col < 3; ++col)
+			{
+				//The center is transformed by the matrix and the extents by the absolute value of the matrix.
+				__m128 center{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, m[0][col]), _mm_mul_ps(cy, m[1][col])),
+					_mm_add_ps(_mm_mul_ps(cz, m[2][col]), m[3][col])) };
+
+				__m128 extent{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_and_ps(m[0][col], absMask)), _mm_mul_ps(ey, _mm_and_ps(m[1][col], absMask))),
+					_mm_mul_ps(ez, _mm_and_ps(m[2][col], absMask))) };
+
+				_mm_storeu_ps(worldMin[col], _mm_sub_ps(center, extent));
+				_mm_storeu_ps(worldMax[col], _mm_add_ps(center, extent));
+			}
+		}
+
+		//remaining AABBs
+		for (; i < numAABBs; ++i)
+		{
+			AABB worldAABB;
+			TransformAABB(worldAABB, GetAABB(localAABBs, i), models[i]);
+			SetAABB(worldAABBs, i, worldAABB);
+		}
+	}
+
+	unsigned int TestIntersection(const AABB& aabb, const AABBArrays& aabbs, unsigned int* mask)
+	{
+		//number of bits set in a 4 bit value
+		static const unsigned int bitCount[16]{ 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+		unsigned int numAABBs{ GetNumberOfAABBs(aabbs) };
+		unsigned int numIntersections{ 0 };
+
+		for (unsigned int i = 0; i < (numAABBs + 31) / 32; ++i)
+		{
+			mask[i] = 0;
+		}
+
+		__m128 minX{ _mm_set1_ps(aabb.min.x) };
+		__m128 minY{ _mm_set1_ps(aabb.min.y) };
+		__m128 minZ{ _mm_set1_ps(aabb.min.z) };
+		__m128 maxX{ _mm_set1_ps(aabb.max.x) };
+		__m128 maxY{ _mm_set1_ps(aabb.max.y) };
+		__m128 maxZ{ _mm_set1_ps(aabb.max.z) };
+
+		unsigned int i{ 0 };
+		for (; i + 4 <= numAABBs; i += 4)
+		{
+			//Two AABBs intersect if they are intersecting on all three axes.
+			__m128 x{ _mm_and_ps(_mm_cmple_ps(minX, _mm_loadu_ps(aabbs.maxX.data() + i)), _mm_cmpge_ps(maxX, _mm_loadu_ps(aabbs.minX.data() + i))) };
+			__m128 y{ _mm_and_ps(_mm_cmple_ps(minY, _mm_loadu_ps(aabbs.maxY.data() + i)), _mm_cmpge_ps(maxY, _mm_loadu_ps(aabbs.minY.data() + i))) };
+			__m128 z{ _mm_and_ps(_mm_cmple_ps(minZ, _mm_loadu_ps(aabbs.maxZ.data() + i)), _mm_cmpge_ps(maxZ, _mm_loadu_ps(aabbs.minZ.data() + i))) };
+
+			unsigned int bits{ (unsigned int)_mm_movemask_ps(_mm_and_ps(_mm_and_ps(x, y), z)) };
+
+			//i is a multiple of 4, so the 4 bits never cross into the next element of the mask.
+			mask[i / 32] |= bits << (i % 32);
+			numIntersections += bitCount[bits];
+		}
+
+		//remaining AABBs
+		for (; i < numAABBs; ++i)
+		{
+			if (TestIntersection(aabb, GetAABB(aabbs, i)))
+			{
+				mask[i / 32] |= 1u << (i % 32);
+				++numIntersections;
+			}
+		}
+
+		return numIntersections;
+	}
+
+	void InitalizeSphere(Sphere& sphere, const vec3& center, float radius)
+	{
+		sphere.center = center;
+		sphere.radius = (radius <= 0.0) ? 1.0f : radius;
+	}
+
+	void ComputeSphere(Sphere& sphere, const std::vector<ShapesEngine::Vertex>& vertices)
+	{
+		vec3 minP(vertices.at(0).position);
+		vec3 maxP(vertices.at(0).position);
+
+		//find the min and max x, y and z values.
+		for (const auto& i : vertices)
+		{
+			if (i.position.x < minP.x)
+				minP.x = i.position.x;
+
+			if (i.position.x > maxP.x)
+				maxP.x = i.position.x;
+
+			if (i.position.y < minP.y)
+				minP.y = i.position.y;
+
+			if (i.position.y > maxP.y)
+				maxP.y = i.position.y;
+
+			if (i.position.z < minP.z)
+				minP.z = i.position.z;
+
+			if (i.position.z > maxP.z)
+				maxP.z = i.position.z;
+		}
+
+		//Compute the distances between each interval
+		float distanceX{ maxP.x - minP.x };
+
+		float distanceY{ maxP.y - minP.y };
+
+		float distanceZ{ maxP.z - minP.z };
+
+		//The max distance is the diameter of the sphere
+		float diameter{ distanceX };
+
+		if (distanceY > diameter)
+			diameter = distanceY;
+
+		if (distanceZ > diameter)
+			diameter = distanceZ;
+
+		//Compute the properties for the initial sphere.
+		sphere.center = (maxP + minP) * 0.5f; //midpoint between the min and max points
+		sphere.radius = diameter / 2.0f; //radius = diameter / 2
+
+		//Check if the sphere bounds all points of the object. If a point is outside the sphere create a new sphere that bounds the old sphere and the point.
+		for (const auto& i : vertices)
+		{
+			//vector from the center of the sphere to the point
+			vec3 distanceVector(i.position - sphere.center);
+
+			//sqaured distance of the vector from the center of the sphere to the point
+			float distance{ MathEngine::DotProduct(distanceVector, distanceVector) };
+
+			//The point is outside the sphere if the squared distance between spheres center and the point is greater than the squared radius of the sphere.
+			if (distance > sphere.radius * sphere.radius)
+			{
+				//Update sphere to bound the the old sphere and point.
+
+				//Compute non-sqaured distance
+				distance = sqrt(distance);
+
+				//direction the spheres center is going to move in.
+				vec3 direction(MathEngine::Normalize(distanceVector));
+
+				//Adding the old radius to the distance from the center of the sphere to the point gives you the new diameter of the sphere.
+				//Divide by 2 to get the new radius.
+				float newRadius{ (sphere.radius + distance) * 0.5f };
+
+				//The distance on how much to move the center of the sphere to its new center is new radius - old radius
+				float k{ newRadius - sphere.radius };
+
+				sphere.radius = newRadius;
+				sphere.center += direction * k;
+			}
+		}
+	}
+
+	//Returns true if the point is inside the sphere. A small tolerance is used so points on the surface count as inside.
+	static bool ContainsPoint(const Sphere& sphere, const vec3& point)
+	{
+		if (sphere.radius < 0.0f)
+			return false;
+
+		vec3 distanceVector(point - sphere.center);
+
+		return MathEngine::DotProduct(distanceVector, distanceVector) <= sphere.radius * sphere.radius * 1.00001f + EPSILON;
+	}
+
+	//Returns the sphere with the segment ab as its diameter.
+	static Sphere SphereFromPoints(const vec3& a, const vec3& b)
+	{
+		return Sphere{ (a + b) * 0.5f, MathEngine::Length(b - a) * 0.5f };
+	}
+
+	//Returns the smallest sphere that has the 3 points on its surface, which is the sphere through the circumcircle of the triangle abc.
+	static Sphere SphereFromPoints(const vec3& a, const vec3& b, const vec3& c)
+	{
+		vec3 ab(b - a);
+		vec3 ac(c - a);
+		vec3 n(MathEngine::CrossProduct(ab, ac));
+
+		float denominator{ 2.0f * MathEngine::DotProduct(n, n) };
+
+		//The points are collinear, so the sphere is made from the 2 points that are the farthest apart.
+		if (denominator < EPSILON * EPSILON)
+		{
+			Sphere sphere{ SphereFromPoints(a, b) };
+			Sphere other{ SphereFromPoints(a, c) };
+
+			if (other.radius > sphere.radius)
+				sphere = other;
+
+			other = SphereFromPoints(b, c);
+			if (other.radius > sphere.radius)
+				sphere = other;
+
+			return sphere;
+		}
+
+		vec3 offset((MathEngine::CrossProduct(n, ab) * MathEngine::DotProduct(ac, ac) +
+			MathEngine::CrossProduct(ac, n) * MathEngine::DotProduct(ab, ab)) * (1.0f / denominator));
+
+		return Sphere{ a + offset, MathEngine::Length(offset) };
+	}
+
+	//Returns the sphere that has the 4 points on its surface.
+	static Sphere SphereFromPoints(const vec3& a, const vec3& b, const vec3& c, const vec3& d)
+	{
+		vec3 ab(b - a);
+		vec3 ac(c - a);
+		vec3 ad(d - a);
+
+		float determinant{ 2.0f * MathEngine::DotProduct(ab, MathEngine::CrossProduct(ac, ad)) };
+
+		//The points are coplanar, so use the smallest sphere through 3 of the points that also bounds the 4th point.
+		if (std::abs(determinant) < EPSILON)
+		{
+			const vec3* points[]{ &a, &b, &c, &d };
+			Sphere sphere{ vec3{}, -1.0f };
+
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				Sphere other{ SphereFromPoints(*points[(i + 1) % 4], *points[(i + 2) % 4], *points[(i + 3) % 4]) };
+
+				if (ContainsPoint(other, *points[i]) && (sphere.radius < 0.0f || other.radius < sphere.radius))
+					sphere = other;
+			}
+
+			return sphere;
+		}
+
+		//Solve 2(p - a) . x = |p - a|^2 for p = b, c and d, where x is the center relative to a.
+		vec3 offset((MathEngine::CrossProduct(ac, ad) * MathEngine::DotProduct(ab, ab) +
+			MathEngine::CrossProduct(ad, ab) * MathEngine::DotProduct(ac, ac) +
+			MathEngine::CrossProduct(ab, ac) * MathEngine::DotProduct(ad, ad)) * (1.0f / determinant));
+
+		return Sphere{ a + offset, MathEngine::Length(offset) };
+	}
+
+	//Returns the smallest sphere that has the boundary points on its surface.
+	//With no boundary points the radius is negative so the sphere contains no points.
+	static Sphere SphereFromBoundary(const vec3* boundary, unsigned int numBoundary)
+	{
+		switch (numBoundary)
+		{
+		case 1:
+			return Sphere{ boundary[0], 0.0f };
+
+		case 2:
+			return SphereFromPoints(boundary[0], boundary[1]);
+
+		case 3:
+			return SphereFromPoints(boundary[0], boundary[1], boundary[2]);
+
+		case 4:
+			return SphereFromPoints(boundary[0], boundary[1], boundary[2], boundary[3]);
+
+		default:
+			return Sphere{ vec3{}, -1.0f };
+		}
+	}
+
+	//Returns the minimum sphere that bounds the first end points and has the boundary points on its surface.
+	//Points that end up outside the sphere are moved to the front of the list, so they get tested first in the next iterations.
+	//The recursion is at most 4 levels deep since a sphere is defined by at most 4 points.
+	static Sphere MinimumSphere(std::vector<vec3>& points, unsigned int end, vec3* boundary, unsigned int numBoundary)
+	{
+		Sphere sphere{ SphereFromBoundary(boundary, numBoundary) };
+
+		if (numBoundary == 4)
+			return sphere;
+
+		for (unsigned int i = 0; i < end; ++i)
+		{
+			if (!ContainsPoint(sphere, points[i]))
+			{
+				boundary[numBoundary] = points[i];
+				sphere = MinimumSphere(points, i, boundary, numBoundary + 1);
+
+				//move to front
+				std::rotate(points.begin(), points.begin() + i, points.begin() + i + 1);
+			}
+		}
+
+		return sphere;
+	}
+
+	void ComputeMinimumSphere(Sphere& sphere, const std::vector<ShapesEngine::Vertex>& vertices)
+	{
+		std::vector<vec3> points;
+		points.reserve(vertices.size());
+
+		for (const auto& i : vertices)
+		{
+			points.push_back(i.position);
+		}
+
+		vec3 boundary[4];
+		sphere = MinimumSphere(points, (unsigned int)points.size(), boundary, 0);
+
+		//Grow the sphere so it bounds the points that are only inside because of the tolerance.
+		float radiusSquared{ sphere.radius * sphere.radius };
+		for (const auto& i : points)
+		{
+			vec3 distanceVector(i - sphere.center);
+			float distance{ MathEngine::DotProduct(distanceVector, distanceVector) };
+
+			if (distance > radiusSquared)
+				radiusSquared = distance;
+		}
+
+		sphere.radius = std::sqrt(radiusSquared);
+	}
+
+	void TransformSphere(Sphere& worldSphere, const Sphere& localSphere, const mat4& model)
+	{
+		//The center is a point, so it gets scaled, rotated and translated. The last row of the model matrix has the translation.
+		vec4 center{ vec4{ localSphere.center.x, localSphere.center.y, localSphere.center.z, 1.0f } * model };
+		worldSphere.center = vec3{ center.x, center.y, center.z };
+
+		//The first 3 rows and columns of a model matrix is rotation and scale.
+		//The rotation matrix is orthonormal which means its rows have a magnitdue of 1.
+		//To retrieve the scale factors, get the magnitdue of the rows.
+		float scaleX{ MathEngine::Length(vec3{ model(0, 0), model(0, 1), model(0, 2) }) };
+		float scaleY{ MathEngine::Length(vec3{ model(1, 0), model(1, 1), model(1, 2) }) };
+		float scaleZ{ MathEngine::Length(vec3{ model(2, 0), model(2, 1), model(2, 2) }) };
+
+		float maxScale{ scaleX };
+		if (scaleY > maxScale)
+			maxScale = scaleY;
+		if (scaleZ > maxScale)
+			maxScale = scaleZ;
+
+		worldSphere.radius = localSphere.radius * maxScale;
+	}
+
+	bool TestIntersection(const Sphere& a, const Sphere& b)
+	{
+		vec3 distanceVector{ a.center - b.center };
+
+		//compute the square of the distance between the centers
+		float distance{ MathEngine::DotProduct(distanceVector, distanceVector) };
+
+		float radiusSum{ a.radius + b.radius };
+
+		//Two spheres intersect if the squared distance between their centers <= the squared sum of their radii
+		return distance <= radiusSum * radiusSum;
+	}
+
+	mat4 ComputeAABBModelMatrix(const AABB& aabb)
+	{
+		vec3 scale{ aabb.max - aabb.min };
+		vec3 translate{ (aabb.min + aabb.max) * 0.5f };
+
+		return MathEngine::Scale4x4(scale) * MathEngine::Translate(translate);
+	}
+
+	mat4 ComputeSphereModelMatrix(const Sphere& sphere)
+	{
+		vec3 scale{ sphere.radius, sphere.radius, sphere.radius };
+
+		return MathEngine::Scale4x4(scale) * MathEngine::Translate(sphere.center);
+	}
+}
\ No newline at end of file
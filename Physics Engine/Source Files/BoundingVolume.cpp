@@ -1,4 +1,7 @@
 #include "BoundingVolume.h"
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "BoundingVolumeArrays.h"
 
 namespace PhysicsEngine
 {
@@ -46,4 +49,12 @@ namespace PhysicsEngine
 	{
 		mRenderObject.drawArguments = drawArgs;
 	}
+
+	unsigned int AddBoundingVolume(BoundingVolumeArrays& volumes, const BoundingVolumeAbstract& boundingVolume)
+	{
+		if (boundingVolume.GetType() == BOUNDING_BOX)
+			return AddBoundingBox(volumes, ((const BoundingBox&)boundingVolume).GetLocalAABB());
+
+		return AddBoundingSphere(volumes, ((const BoundingSphere&)boundingVolume).GetLocalSphere());
+	}
 }
\ No newline at end of file
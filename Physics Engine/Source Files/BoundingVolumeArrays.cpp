@@ -0,0 +1,81 @@
+#include "BoundingVolumeArrays.h"
+
+namespace PhysicsEngine
+{
+	unsigned int GetNumberOfBoundingVolumes(const BoundingVolumeArrays& volumes)
+	{
+		return (unsigned int)volumes.handles.size();
+	}
+
+	unsigned int AddBoundingSphere(BoundingVolumeArrays& volumes, const Sphere& localSphere)
+	{
+		unsigned int body{ (unsigned int)volumes.handles.size() };
+
+		volumes.handles.push_back(BoundingVolumeHandle{ BOUNDING_SPHERE, (unsigned int)volumes.localSpheres.size() });
+		volumes.localSpheres.push_back(localSphere);
+		volumes.worldSpheres.push_back(localSphere);
+		volumes.sphereBodies.push_back(body);
+
+		return body;
+	}
+
+	unsigned int AddBoundingBox(BoundingVolumeArrays& volumes, const AABB& localAABB)
+	{
+		unsigned int body{ (unsigned int)volumes.handles.size() };
+
+		volumes.handles.push_back(BoundingVolumeHandle{ BOUNDING_BOX, AddAABB(volumes.localBoxes, localAABB) });
+		AddAABB(volumes.worldBoxes, localAABB);
+		volumes.boxBodies.push_back(body);
+
+		return body;
+	}
+
+	BoundingVolumeType GetBoundingVolumeType(const BoundingVolumeArrays& volumes, unsigned int body)
+	{
+		return volumes.handles[body].type;
+	}
+
+	const Sphere& GetWorldSphere(const BoundingVolumeArrays& volumes, unsigned int body)
+	{
+		return volumes.worldSpheres[volumes.handles[body].index];
+	}
+
+	AABB GetWorldAABB(const BoundingVolumeArrays& volumes, unsigned int body)
+	{
+		return GetAABB(volumes.worldBoxes, volumes.handles[body].index);
+	}
+
+	void TransformBoundingVolumes(BoundingVolumeArrays& volumes, const mat4* models)
+	{
+		unsigned int numSpheres{ (unsigned int)volumes.localSpheres.size() };
+		for (unsigned int i = 0; i < numSpheres; ++i)
+		{
+			TransformSphere(volumes.worldSpheres[i], volumes.localSpheres[i], models[volumes.sphereBodies[i]]);
+		}
+
+		//TransformAABBs needs the matrices in the same order as the AABBs, so gather them first.
+		unsigned int numBoxes{ (unsigned int)volumes.boxBodies.size() };
+		volumes.boxModels.resize(numBoxes);
+		for (unsigned int i = 0; i < numBoxes; ++i)
+		{
+			volumes.boxModels[i] = models[volumes.boxBodies[i]];
+		}
+
+		TransformAABBs(volumes.worldBoxes, volumes.localBoxes, volumes.boxModels.data());
+	}
+
+	void ComputeBoundingVolumeModelMatrices(const BoundingVolumeArrays& volumes, mat4* models)
+	{
+		unsigned int numSpheres{ (unsigned int)volumes.worldSpheres.size() };
+		for (unsigned int i = 0; i < numSpheres; ++i)
+		{
+			models[volumes.sphereBodies[i]] = ComputeSphereModelMatrix(volumes.worldSpheres[i]);
+		}
+
+		unsigned int numBoxes{ (unsigned int)volumes.boxBodies.size() };
+		for (unsigned int i = 0; i < numBoxes; ++i)
+		{
+			models[volumes.boxBodies[i]] = ComputeAABBModelMatrix(GetAABB(volumes.worldBoxes, i));
+		}
+	}
+}
\ No newline at end of file
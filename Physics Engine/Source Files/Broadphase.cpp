@@ -0,0 +1,179 @@
+#include "Broadphase.h"
+#include <algorithm>
+
+namespace PhysicsEngine
+{
+	bool ShouldCollide(const CollisionFilter& a, const CollisionFilter& b)
+	{
+		if ((a.layer & b.mask) == 0 || (b.layer & a.mask) == 0)
+			return false;
+
+		return a.group == 0 || a.group != b.group;
+	}
+
+	Broadphase::Broadphase() : mNumSorted{ 0 }
+	{}
+
+	unsigned int Broadphase::AddBody(const vec3& min, const vec3& max, const CollisionFilter& filter)
+	{
+		mMinX.push_back(min.x);
+		mMinY.push_back(min.y);
+		mMinZ.push_back(min.z);
+		mMaxX.push_back(max.x);
+		mMaxY.push_back(max.y);
+		mMaxZ.push_back(max.z);
+
+		mLayers.push_back(filter.layer);
+		mMasks.push_back(filter.mask);
+		mGroups.push_back(filter.group);
+
+		return (unsigned int)mMinX.size() - 1;
+	}
+
+	void Broadphase::ClearBodies()
+	{
+		mMinX.clear();
+		mMinY.clear();
+		mMinZ.clear();
+		mMaxX.clear();
+		mMaxY.clear();
+		mMaxZ.clear();
+
+		mLayers.clear();
+		mMasks.clear();
+		mGroups.clear();
+
+		mOrder.clear();
+		mNumSorted = 0;
+
+		mPairs.clear();
+	}
+
+	unsigned int Broadphase::GetNumberOfBodies() const
+	{
+		return (unsigned int)mMinX.size();
+	}
+
+	void Broadphase::SetBounds(unsigned int body, const vec3& min, const vec3& max)
+	{
+		mMinX[body] = min.x;
+		mMinY[body] = min.y;
+		mMinZ[body] = min.z;
+		mMaxX[body] = max.x;
+		mMaxY[body] = max.y;
+		mMaxZ[body] = max.z;
+	}
+
+	void Broadphase::ShiftOrigin(const vec3& shift)
+	{
+		unsigned int numBodies{ GetNumberOfBodies() };
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			mMinX[i] -= shift.x;
+			mMaxX[i] -= shift.x;
+		}
+
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			mMinY[i] -= shift.y;
+			mMaxY[i] -= shift.y;
+		}
+
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			mMinZ[i] -= shift.z;
+			mMaxZ[i] -= shift.z;
+		}
+	}
+
+	void Broadphase::SetCollisionFilter(unsigned int body, const CollisionFilter& filter)
+	{
+		mLayers[body] = filter.layer;
+		mMasks[body] = filter.mask;
+		mGroups[body] = filter.group;
+	}
+
+	CollisionFilter Broadphase::GetCollisionFilter(unsigned int body) const
+	{
+		return CollisionFilter{ mLayers[body], mMasks[body], mGroups[body] };
+	}
+
+	void Broadphase::SortBodies()
+	{
+		unsigned int numBodies{ GetNumberOfBodies() };
+
+		//Ties are broken by index so the order does not depend on the order from the last step.
+		auto less = [this](unsigned int a, unsigned int b) { return mMinX[a] < mMinX[b] || (mMinX[a] == mMinX[b] && a < b); };
+
+		if (mNumSorted != numBodies)
+		{
+			mOrder.resize(numBodies);
+			for (unsigned int i = 0; i < numBodies; ++i)
+			{
+				mOrder[i] = i;
+			}
+
+			std::sort(mOrder.begin(), mOrder.end(), less);
+			mNumSorted = numBodies;
+			return;
+		}
+
+		for (unsigned int i = 1; i < numBodies; ++i)
+		{
+			unsigned int body{ mOrder[i] };
+			unsigned int j{ i };
+			while (j > 0 && less(body, mOrder[j - 1]))
+			{
+				mOrder[j] = mOrder[j - 1];
+				--j;
+			}
+
+			mOrder[j] = body;
+		}
+	}
+
+	void Broadphase::FindPairs(StepProfiler* profiler)
+	{
+		ProfileScope scope{ profiler, PHASE_BROADPHASE };
+
+		mPairs.clear();
+		SortBodies();
+
+		unsigned int numBodies{ GetNumberOfBodies() };
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			unsigned int a{ mOrder[i] };
+			unsigned int layer{ mLayers[a] };
+			unsigned int mask{ mMasks[a] };
+			unsigned int group{ mGroups[a] };
+
+			if (mask == 0)
+				continue;
+
+			float maxX{ mMaxX[a] };
+			for (unsigned int j = i + 1; j < numBodies; ++j)
+			{
+				unsigned int b{ mOrder[j] };
+				if (mMinX[b] > maxX)
+					break;
+
+				//The filters are cheaper than the bounds, so they are checked first.
+				if ((layer & mMasks[b]) == 0 || (mLayers[b] & mask) == 0 || (group != 0 && group == mGroups[b]))
+					continue;
+
+				if (mMinY[b] > mMaxY[a] || mMaxY[b] < mMinY[a] || mMinZ[b] > mMaxZ[a] || mMaxZ[b] < mMinZ[a])
+					continue;
+
+				mPairs.push_back((a < b) ? BodyPair{ a, b } : BodyPair{ b, a });
+			}
+		}
+
+		if (profiler != nullptr)
+			profiler->AddPairs((unsigned int)mPairs.size());
+	}
+
+	const std::vector<BodyPair>& Broadphase::GetPairs() const
+	{
+		return mPairs;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,451 @@
+#include "CompoundShape.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	//Leaves hold at most this many children.
+	static const unsigned int MAX_LEAF_CHILDREN{ 2 };
+
+	//The size of the traversal stack. A median split hierarchy over millions of children is still far less deep.
+	static const unsigned int MAX_COMPOUND_DEPTH{ 64 };
+
+	void ComputeMassProperties(const CollisionShape& shape, MassProperties& massProperties)
+	{
+		switch (shape.type)
+		{
+		case COLLISION_SPHERE:
+			ComputeMassProperties(PRIMITIVE_SPHERE, massProperties);
+			break;
+
+		case COLLISION_BOX:
+			ComputeMassProperties(PRIMITIVE_BOX, massProperties);
+			break;
+
+		case COLLISION_CYLINDER:
+			ComputeMassProperties(PRIMITIVE_CYLINDER, massProperties);
+			break;
+
+		case COLLISION_CAPSULE:
+			ComputeCapsuleMassProperties(shape.radius, shape.halfHeight, massProperties);
+			return;
+
+		default:
+		{
+			massProperties = MassProperties{};
+			if (shape.hull == nullptr || shape.hull->vertices.empty())
+				return;
+
+			std::vector<ShapesEngine::Vertex> vertices(shape.hull->vertices.size());
+			for (size_t i = 0; i < vertices.size(); ++i)
+			{
+				vertices[i].position = shape.hull->vertices[i];
+			}
+
+			std::vector<ShapesEngine::Triangle> triangles;
+			for (size_t i = 0; i + 2 < shape.hull->indices.size(); i += 3)
+			{
+				triangles.push_back(ShapesEngine::Triangle{ vertices.data(), shape.hull->indices[i], shape.hull->indices[i + 1],
+					shape.hull->indices[i + 2] });
+			}
+
+			ComputeMassProperties(triangles, massProperties);
+			return;
+		}
+		}
+
+		//The unit primitives are scaled to the size of the shape. The unit cylinder has a radius of 1 and a height of 1.
+		vec3 size;
+		if (shape.type == COLLISION_SPHERE)
+			size = vec3{ shape.radius, shape.radius, shape.radius };
+		else if (shape.type == COLLISION_BOX)
+			size = shape.halfExtents * 2.0f;
+		else
+			size = vec3{ shape.radius, 2.0f * shape.halfHeight, shape.radius };
+
+		mat3 scale{ MathEngine::Scale(size) };
+		double determinant{ std::fabs((double)size.x * size.y * size.z) };
+
+		massProperties.mass *= determinant;
+		massProperties.centerOfMass = massProperties.centerOfMass * scale;
+		massProperties.covariance = (float)determinant * (MathEngine::Transpose(scale) * massProperties.covariance * scale);
+	}
+
+	//Returns the box around the box from min to max after it is moved from the coordinates of a shape into world coordinates.
+	static void TransformBoxToWorld(const vec3& min, const vec3& max, const vec3& position, const mat3& rotation, vec3& worldMin, vec3& worldMax)
+	{
+		vec3 center{ (min + max) * 0.5f };
+		vec3 extents{ (max - min) * 0.5f };
+
+		vec3 worldCenter{ center * rotation + position };
+		vec3 worldExtents;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			vec3 axis{ rotation.GetRow(i) };
+			float e{ (i == 0) ? extents.x : ((i == 1) ? extents.y : extents.z) };
+			worldExtents += vec3{ std::fabs(axis.x), std::fabs(axis.y), std::fabs(axis.z) } * e;
+		}
+
+		worldMin = worldCenter - worldExtents;
+		worldMax = worldCenter + worldExtents;
+	}
+
+	//Returns the box around the world box from min to max in the coordinates of a shape at the position with the rotation.
+	static void TransformBoxToLocal(const vec3& min, const vec3& max, const vec3& position, const mat3& rotation, vec3& localMin, vec3& localMax)
+	{
+		vec3 center{ (min + max) * 0.5f };
+		vec3 extents{ (max - min) * 0.5f };
+
+		//Multiplying a column vector by the rotation goes from world to local coordinates.
+		vec3 localCenter{ rotation * (center - position) };
+		vec3 localExtents;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			vec3 axis{ rotation.GetCol(i) };
+			float e{ (i == 0) ? extents.x : ((i == 1) ? extents.y : extents.z) };
+			localExtents += vec3{ std::fabs(axis.x), std::fabs(axis.y), std::fabs(axis.z) } * e;
+		}
+
+		localMin = localCenter - localExtents;
+		localMax = localCenter + localExtents;
+	}
+
+	static bool Overlap(const vec3& minA, const vec3& maxA, const vec3& minB, const vec3& maxB)
+	{
+		return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+	}
+
+	//Stores the overlap of the two boxes in min and max. Returns false if they do not overlap.
+	static bool Intersect(const vec3& minA, const vec3& maxA, const vec3& minB, const vec3& maxB, vec3& min, vec3& max)
+	{
+		if (!Overlap(minA, maxA, minB, maxB))
+			return false;
+
+		min = vec3{ std::fmax(minA.x, minB.x), std::fmax(minA.y, minB.y), std::fmax(minA.z, minB.z) };
+		max = vec3{ std::fmin(maxA.x, maxB.x), std::fmin(maxA.y, maxB.y), std::fmin(maxA.z, maxB.z) };
+
+		return true;
+	}
+
+	CompoundShape::CompoundShape()
+	{}
+
+	CompoundShape::CompoundShape(const std::vector<CompoundChild>& children)
+	{
+		InitializeCompoundShape(children);
+	}
+
+	void CompoundShape::InitializeCompoundShape(const std::vector<CompoundChild>& children)
+	{
+		mChildren = children;
+		mMassProperties = MassProperties{};
+		mCenterOfMassOffset = vec3{};
+		mNodes.clear();
+		mChildOrder.clear();
+		mChildMins.clear();
+		mChildMaxs.clear();
+
+		unsigned int numChildren{ (unsigned int)mChildren.size() };
+
+		//The mass properties of each child with its density, rotated into the coordinates of the compound.
+		std::vector<MassProperties> childMassProperties(numChildren);
+		double mass{ 0.0 };
+		vec3 firstMoment;
+
+		for (unsigned int i = 0; i < numChildren; ++i)
+		{
+			const CompoundChild& child{ mChildren[i] };
+			MassProperties& properties{ childMassProperties[i] };
+			ComputeMassProperties(child.shape, properties);
+
+			float density{ (child.massDensity > 0.0f) ? child.massDensity : 0.0f };
+			mat3 rotation{ QuaternionToRotationMatrixRow3x3(child.orientation) };
+
+			properties.mass *= density;
+			properties.centerOfMass = properties.centerOfMass * rotation + child.position;
+			properties.covariance = density * (MathEngine::Transpose(rotation) * properties.covariance * rotation);
+
+			mass += properties.mass;
+			firstMoment += properties.centerOfMass * (float)properties.mass;
+		}
+
+		if (mass > 0.0)
+			mCenterOfMassOffset = firstMoment * (float)(1.0 / mass);
+
+		//Parallel axis theorem: C = sum of Ci + mi * di^T di, where di is the offset of the center of mass of child i.
+		mat3 covariance{ mat3() * 0.0f };
+		for (const auto& i : childMassProperties)
+		{
+			vec3 d{ i.centerOfMass - mCenterOfMassOffset };
+			float m{ (float)i.mass };
+
+			covariance = covariance + i.covariance + mat3(vec3{ d.x * d.x, d.x * d.y, d.x * d.z } * m,
+				vec3{ d.y * d.x, d.y * d.y, d.y * d.z } * m, vec3{ d.z * d.x, d.z * d.y, d.z * d.z } * m);
+		}
+
+		mMassProperties.mass = mass;
+		mMassProperties.centerOfMass = vec3{};
+		mMassProperties.covariance = covariance;
+
+		//Move the children so the center of mass is at the origin.
+		for (auto& i : mChildren)
+		{
+			i.position = i.position - mCenterOfMassOffset;
+		}
+
+		if (numChildren == 0)
+			return;
+
+		mChildMins.resize(numChildren);
+		mChildMaxs.resize(numChildren);
+		mChildOrder.resize(numChildren);
+		for (unsigned int i = 0; i < numChildren; ++i)
+		{
+			ComputeShapeBounds(mChildren[i].shape, mChildren[i].position, mChildren[i].orientation, mChildMins[i], mChildMaxs[i]);
+			mChildOrder[i] = i;
+		}
+
+		mNodes.reserve(2 * numChildren);
+		mNodes.emplace_back();
+		BuildNode(0, 0, numChildren);
+	}
+
+	void CompoundShape::BuildNode(unsigned int node, unsigned int first, unsigned int count)
+	{
+		vec3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+		vec3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		vec3 centerMin{ FLT_MAX, FLT_MAX, FLT_MAX };
+		vec3 centerMax{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (unsigned int i = first; i < first + count; ++i)
+		{
+			const vec3& childMin{ mChildMins[mChildOrder[i]] };
+			const vec3& childMax{ mChildMaxs[mChildOrder[i]] };
+			vec3 center{ (childMin + childMax) * 0.5f };
+
+			min = vec3{ std::fmin(min.x, childMin.x), std::fmin(min.y, childMin.y), std::fmin(min.z, childMin.z) };
+			max = vec3{ std::fmax(max.x, childMax.x), std::fmax(max.y, childMax.y), std::fmax(max.z, childMax.z) };
+			centerMin = vec3{ std::fmin(centerMin.x, center.x), std::fmin(centerMin.y, center.y), std::fmin(centerMin.z, center.z) };
+			centerMax = vec3{ std::fmax(centerMax.x, center.x), std::fmax(centerMax.y, center.y), std::fmax(centerMax.z, center.z) };
+		}
+
+		mNodes[node].min = min;
+		mNodes[node].max = max;
+
+		if (count <= MAX_LEAF_CHILDREN)
+		{
+			mNodes[node].first = first;
+			mNodes[node].count = count;
+			return;
+		}
+
+		//Split the children in half at the median of their centers along the axis the centers spread the most on.
+		vec3 spread{ centerMax - centerMin };
+		unsigned int axis{ (spread.x >= spread.y && spread.x >= spread.z) ? 0u : ((spread.y >= spread.z) ? 1u : 2u) };
+
+		auto getCenter = [&](unsigned int child)
+		{
+			vec3 center{ mChildMins[child] + mChildMaxs[child] };
+			return (axis == 0) ? center.x : ((axis == 1) ? center.y : center.z);
+		};
+
+		unsigned int half{ count / 2 };
+		std::nth_element(mChildOrder.begin() + first, mChildOrder.begin() + first + half, mChildOrder.begin() + first + count,
+			[&](unsigned int a, unsigned int b) { return getCenter(a) < getCenter(b) || (getCenter(a) == getCenter(b) && a < b); });
+
+		unsigned int left{ (unsigned int)mNodes.size() };
+		mNodes.emplace_back();
+		mNodes.emplace_back();
+
+		mNodes[node].first = left;
+		mNodes[node].count = 0;
+
+		BuildNode(left, first, half);
+		BuildNode(left + 1, first + half, count - half);
+	}
+
+	unsigned int CompoundShape::GetNumberOfChildren() const
+	{
+		return (unsigned int)mChildren.size();
+	}
+
+	const CompoundChild& CompoundShape::GetChild(unsigned int index) const
+	{
+		return mChildren[index];
+	}
+
+	const vec3& CompoundShape::GetCenterOfMassOffset() const
+	{
+		return mCenterOfMassOffset;
+	}
+
+	const MassProperties& CompoundShape::GetMassProperties() const
+	{
+		return mMassProperties;
+	}
+
+	const std::vector<CompoundNode>& CompoundShape::GetNodes() const
+	{
+		return mNodes;
+	}
+
+	void CompoundShape::FindChildren(const vec3& min, const vec3& max, std::vector<unsigned int>& children) const
+	{
+		children.clear();
+
+		if (mNodes.empty())
+			return;
+
+		unsigned int stack[MAX_COMPOUND_DEPTH];
+		unsigned int stackSize{ 0 };
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const CompoundNode& node{ mNodes[stack[--stackSize]] };
+			if (!Overlap(node.min, node.max, min, max))
+				continue;
+
+			if (node.count == 0)
+			{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+				continue;
+			}
+
+			for (unsigned int i = node.first; i < node.first + node.count; ++i)
+			{
+				unsigned int child{ mChildOrder[i] };
+				if (Overlap(mChildMins[child], mChildMaxs[child], min, max))
+					children.push_back(child);
+			}
+		}
+	}
+
+	void ComputeCompoundBounds(const CompoundShape& compound, const vec3& position, const MathEngine::Quaternion& orientation,
+		vec3& min, vec3& max)
+	{
+		const std::vector<CompoundNode>& nodes{ compound.GetNodes() };
+		if (nodes.empty())
+		{
+			min = position;
+			max = position;
+			return;
+		}
+
+		TransformBoxToWorld(nodes[0].min, nodes[0].max, position, QuaternionToRotationMatrixRow3x3(orientation), min, max);
+	}
+
+	//Collides the children of the compound that overlap the world region with the other shape and adds a contact for each one that
+	//intersects it. The compound is A if compoundIsA is true, otherwise the other shape is A. Returns the number of contacts added.
+	static unsigned int CollideChildren(const CompoundShape& compound, const vec3& position, const MathEngine::Quaternion& orientation,
+		const vec3& regionMin, const vec3& regionMax, const CollisionShape& other, const vec3& otherPosition,
+		const MathEngine::Quaternion& otherOrientation, unsigned int otherChild, bool compoundIsA, std::vector<unsigned int>& children,
+		std::vector<CompoundContact>& contacts)
+	{
+		mat3 rotation{ QuaternionToRotationMatrixRow3x3(orientation) };
+
+		vec3 localMin;
+		vec3 localMax;
+		TransformBoxToLocal(regionMin, regionMax, position, rotation, localMin, localMax);
+		compound.FindChildren(localMin, localMax, children);
+
+		unsigned int numContacts{ 0 };
+		for (const auto& i : children)
+		{
+			const CompoundChild& child{ compound.GetChild(i) };
+			vec3 childPosition{ child.position * rotation + position };
+			MathEngine::Quaternion childOrientation{ orientation * child.orientation };
+
+			CompoundContact contact;
+			bool hit{ false };
+			if (compoundIsA)
+			{
+				contact.childA = i;
+				contact.childB = otherChild;
+				hit = Collide(child.shape, childPosition, childOrientation, other, otherPosition, otherOrientation, contact.manifold);
+			}
+			else
+			{
+				contact.childA = otherChild;
+				contact.childB = i;
+				hit = Collide(other, otherPosition, otherOrientation, child.shape, childPosition, childOrientation, contact.manifold);
+			}
+
+			if (hit)
+			{
+				contacts.push_back(contact);
+				++numContacts;
+			}
+		}
+
+		return numContacts;
+	}
+
+	unsigned int CollideCompound(const CompoundShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, std::vector<CompoundContact>& contacts)
+	{
+		vec3 minA;
+		vec3 maxA;
+		vec3 minB;
+		vec3 maxB;
+		ComputeCompoundBounds(a, positionA, orientationA, minA, maxA);
+		ComputeShapeBounds(b, positionB, orientationB, minB, maxB);
+
+		vec3 regionMin;
+		vec3 regionMax;
+		if (a.GetNumberOfChildren() == 0 || !Intersect(minA, maxA, minB, maxB, regionMin, regionMax))
+			return 0;
+
+		std::vector<unsigned int> children;
+		return CollideChildren(a, positionA, orientationA, regionMin, regionMax, b, positionB, orientationB, NO_CHILD, true, children, contacts);
+	}
+
+	unsigned int CollideCompounds(const CompoundShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CompoundShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, std::vector<CompoundContact>& contacts)
+	{
+		vec3 minA;
+		vec3 maxA;
+		vec3 minB;
+		vec3 maxB;
+		ComputeCompoundBounds(a, positionA, orientationA, minA, maxA);
+		ComputeCompoundBounds(b, positionB, orientationB, minB, maxB);
+
+		vec3 regionMin;
+		vec3 regionMax;
+		if (a.GetNumberOfChildren() == 0 || b.GetNumberOfChildren() == 0 || !Intersect(minA, maxA, minB, maxB, regionMin, regionMax))
+			return 0;
+
+		mat3 rotationA{ QuaternionToRotationMatrixRow3x3(orientationA) };
+
+		std::vector<unsigned int> childrenA;
+		std::vector<unsigned int> childrenB;
+		vec3 localMin;
+		vec3 localMax;
+		TransformBoxToLocal(regionMin, regionMax, positionA, rotationA, localMin, localMax);
+		a.FindChildren(localMin, localMax, childrenA);
+
+		unsigned int numContacts{ 0 };
+		for (const auto& i : childrenA)
+		{
+			const CompoundChild& child{ a.GetChild(i) };
+			vec3 childPosition{ child.position * rotationA + positionA };
+			MathEngine::Quaternion childOrientation{ orientationA * child.orientation };
+
+			//Only the part of B that overlaps this child of A and the overlap of the two compounds can touch it.
+			vec3 childMin;
+			vec3 childMax;
+			vec3 childRegionMin;
+			vec3 childRegionMax;
+			ComputeShapeBounds(child.shape, childPosition, childOrientation, childMin, childMax);
+			if (!Intersect(childMin, childMax, regionMin, regionMax, childRegionMin, childRegionMax))
+				continue;
+
+			numContacts += CollideChildren(b, positionB, orientationB, childRegionMin, childRegionMax, child.shape, childPosition,
+				childOrientation, i, false, childrenB, contacts);
+		}
+
+		return numContacts;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "ContactSolver.h"
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace PhysicsEngine
+{
+	//The fraction of the depth of a contact removed each step, and the depth that is allowed so resting contacts do not jitter.
+	static const float BAUMGARTE_FACTOR{ 0.2f };
+	static const float PENETRATION_SLOP{ 0.005f };
+
+	//The last color is the overflow batch.
+	static const unsigned int OVERFLOW_COLOR{ MAX_CONSTRAINT_COLORS - 1 };
+
+	//Returns the index of the body if it can move, INVALID_BODY otherwise.
+	static unsigned int GetDynamicBody(const RigidBodyArrays& bodies, unsigned int body)
+	{
+		if (body >= GetNumberOfBodies(bodies) || bodies.inverseMass[body] <= 0.0f)
+			return INVALID_BODY;
+
+		return body;
+	}
+
+	void ColorConstraints(const RigidBodyArrays& bodies, const std::vector<ContactConstraint>& constraints, ConstraintColoring& coloring)
+	{
+		unsigned int numConstraints{ (unsigned int)constraints.size() };
+
+		coloring.bodyColors.assign(GetNumberOfBodies(bodies), 0);
+		coloring.constraintColors.resize(numConstraints);
+
+		unsigned int counts[MAX_CONSTRAINT_COLORS]{};
+
+		for (unsigned int i = 0; i < numConstraints; ++i)
+		{
+			unsigned int a{ GetDynamicBody(bodies, constraints[i].bodyA) };
+			unsigned int b{ GetDynamicBody(bodies, constraints[i].bodyB) };
+
+			unsigned long long used{ 0 };
+			if (a != INVALID_BODY)
+				used |= coloring.bodyColors[a];
+			if (b != INVALID_BODY)
+				used |= coloring.bodyColors[b];
+
+			unsigned int color{ OVERFLOW_COLOR };
+			for (unsigned int j = 0; j < OVERFLOW_COLOR; ++j)
+			{
+				if ((used & (1ull << j)) == 0)
+				{
+					color = j;
+					break;
+				}
+			}
+
+			if (color != OVERFLOW_COLOR)
+			{
+				if (a != INVALID_BODY)
+					coloring.bodyColors[a] |= 1ull << color;
+				if (b != INVALID_BODY)
+					coloring.bodyColors[b] |= 1ull << color;
+			}
+
+			coloring.constraintColors[i] = (unsigned char)color;
+			++counts[color];
+		}
+
+		//The colors are given lowest first, so the used colors before the overflow color are 0 to numColors - 1.
+		unsigned int numColors{ 0 };
+		while (numColors < OVERFLOW_COLOR && counts[numColors] > 0)
+		{
+			++numColors;
+		}
+
+		coloring.hasOverflow = counts[OVERFLOW_COLOR] > 0;
+
+		//Where each color starts in the constraints, with the overflow batch right after the last color.
+		unsigned int starts[MAX_CONSTRAINT_COLORS]{};
+		coloring.batchStarts.clear();
+		unsigned int start{ 0 };
+		for (unsigned int i = 0; i < numColors; ++i)
+		{
+			coloring.batchStarts.push_back(start);
+			starts[i] = start;
+			start += counts[i];
+		}
+
+		if (coloring.hasOverflow)
+		{
+			coloring.batchStarts.push_back(start);
+			starts[OVERFLOW_COLOR] = start;
+		}
+
+		coloring.batchStarts.push_back(numConstraints);
+
+		//The constraints of a batch stay in index order.
+		coloring.constraints.resize(numConstraints);
+		for (unsigned int i = 0; i < numConstraints; ++i)
+		{
+			coloring.constraints[starts[coloring.constraintColors[i]]++] = i;
+		}
+	}
+
+	unsigned int GetNumberOfBatches(const ConstraintColoring& coloring)
+	{
+		return coloring.batchStarts.empty() ? 0 : (unsigned int)coloring.batchStarts.size() - 1;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------------------------------------
+
+	//Blocks each thread that calls Wait until all the threads have called it.
+	struct ContactSolver::ThreadBarrier
+	{
+		std::mutex mutex;
+		std::condition_variable condition;
+		unsigned int numThreads{ 1 };
+		unsigned int numWaiting{ 0 };
+		unsigned int generation{ 0 };
+
+		void Wait()
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			unsigned int currentGeneration{ generation };
+
+			if (++numWaiting == numThreads)
+			{
+				numWaiting = 0;
+				++generation;
+				condition.notify_all();
+				return;
+			}
+
+			condition.wait(lock, [&] { return generation != currentGeneration; });
+		}
+	};
+
+	//Returns a unit vector perpendicular to the unit vector v.
+	static vec3 Perpendicular(const vec3& v)
+	{
+		vec3 axis{ (std::fabs(v.x) < 0.57735f) ? vec3{ 1.0f, 0.0f, 0.0f } : vec3{ 0.0f, 1.0f, 0.0f } };
+
+		return MathEngine::Normalize(MathEngine::CrossProduct(v, axis));
+	}
+
+	//Returns the first index of the part of count items the thread works on.
+	static unsigned int GetThreadStart(unsigned int count, unsigned int thread, unsigned int numThreads)
+	{
+		return (unsigned int)((unsigned long long)count * thread / numThreads);
+	}
+
+	ContactSolver::ContactSolver() : mNumIterations{ 10 }, mNumThreads{ 1 }
+	{}
+
+	ContactSolver::ContactSolver(unsigned int numIterations, unsigned int numThreads) : mNumIterations{ 10 }, mNumThreads{ 1 }
+	{
+		InitializeContactSolver(numIterations, numThreads);
+	}
+
+	void ContactSolver::InitializeContactSolver(unsigned int numIterations, unsigned int numThreads)
+	{
+		mNumIterations = (numIterations == 0) ? 1 : numIterations;
+
+		if (numThreads == 0)
+			numThreads = std::thread::hardware_concurrency();
+
+		mNumThreads = (numThreads == 0) ? 1 : numThreads;
+	}
+
+	unsigned int ContactSolver::GetNumberOfIterations() const
+	{
+		return mNumIterations;
+	}
+
+	unsigned int ContactSolver::GetNumberOfThreads() const
+	{
+		return mNumThreads;
+	}
+
+	const ConstraintColoring& ContactSolver::GetColoring() const
+	{
+		return mColoring;
+	}
+
+	unsigned int ContactSolver::GetSolverBody(const RigidBodyArrays& bodies, unsigned int body) const
+	{
+		unsigned int dynamicBody{ GetDynamicBody(bodies, body) };
+
+		return (dynamicBody == INVALID_BODY) ? (unsigned int)mBodies.size() - 1 : dynamicBody;
+	}
+
+	void ContactSolver::PrepareContact(ContactConstraint& contact, const RigidBodyArrays& bodies, const SolverBody& a, const SolverBody& b, float dt)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+
+		//The static body does not rotate, so its lever arm is never used.
+		contact.rA = vec3{};
+		contact.rB = vec3{};
+		if (contact.bodyA < numBodies)
+			contact.rA = contact.point - vec3{ bodies.centerOfMassX[contact.bodyA], bodies.centerOfMassY[contact.bodyA], bodies.centerOfMassZ[contact.bodyA] };
+		if (contact.bodyB < numBodies)
+			contact.rB = contact.point - vec3{ bodies.centerOfMassX[contact.bodyB], bodies.centerOfMassY[contact.bodyB], bodies.centerOfMassZ[contact.bodyB] };
+
+		contact.tangent1 = Perpendicular(contact.normal);
+		contact.tangent2 = MathEngine::CrossProduct(contact.normal, contact.tangent1);
+
+		//The effective mass along a direction d is 1 / (1/mA + 1/mB + (rA x d) IA^-1 . (rA x d) + (rB x d) IB^-1 . (rB x d)).
+		const vec3* directions[3]{ &contact.normal, &contact.tangent1, &contact.tangent2 };
+		float* masses[3]{ &contact.normalMass, &contact.tangentMass1, &contact.tangentMass2 };
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			vec3 rnA{ MathEngine::CrossProduct(contact.rA, *directions[i]) };
+			vec3 rnB{ MathEngine::CrossProduct(contact.rB, *directions[i]) };
+
+			float k{ a.inverseMass + b.inverseMass + MathEngine::DotProduct(rnA * a.inverseInertia, rnA) +
+				MathEngine::DotProduct(rnB * b.inverseInertia, rnB) };
+
+			*masses[i] = (k > 0.0f) ? 1.0f / k : 0.0f;
+		}
+
+		float depth{ contact.depth - PENETRATION_SLOP };
+		contact.bias = (depth > 0.0f) ? BAUMGARTE_FACTOR * depth / dt : 0.0f;
+
+		contact.normalImpulse = 0.0f;
+		contact.tangentImpulse1 = 0.0f;
+		contact.tangentImpulse2 = 0.0f;
+	}
+
+	void ContactSolver::ApplyImpulse(SolverBody& body, const vec3& r, const vec3& impulse)
+	{
+		//The static body is shared by every thread, so it is never written.
+		if (body.inverseMass <= 0.0f)
+			return;
+
+		vec3 angularImpulse{ MathEngine::CrossProduct(r, impulse) };
+
+		body.linearVelocity += impulse * body.inverseMass;
+		body.angularVelocity += angularImpulse * body.inverseInertia;
+		body.linearImpulse += impulse;
+		body.angularImpulse += angularImpulse;
+	}
+
+	void ContactSolver::SolveContact(ContactConstraint& contact, SolverBody& a, SolverBody& b)
+	{
+		//Friction first, limited by the normal impulse of the last iteration.
+		float maxFriction{ contact.friction * contact.normalImpulse };
+		const vec3* tangents[2]{ &contact.tangent1, &contact.tangent2 };
+		float* tangentImpulses[2]{ &contact.tangentImpulse1, &contact.tangentImpulse2 };
+		float tangentMasses[2]{ contact.tangentMass1, contact.tangentMass2 };
+
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			vec3 relativeVelocity{ b.linearVelocity + MathEngine::CrossProduct(b.angularVelocity, contact.rB) -
+				a.linearVelocity - MathEngine::CrossProduct(a.angularVelocity, contact.rA) };
+
+			float impulse{ -MathEngine::DotProduct(relativeVelocity, *tangents[i]) * tangentMasses[i] };
+			float oldImpulse{ *tangentImpulses[i] };
+			float newImpulse{ oldImpulse + impulse };
+			newImpulse = (newImpulse < -maxFriction) ? -maxFriction : ((newImpulse > maxFriction) ? maxFriction : newImpulse);
+			*tangentImpulses[i] = newImpulse;
+
+			vec3 p{ *tangents[i] * (newImpulse - oldImpulse) };
+			ApplyImpulse(a, contact.rA, -p);
+			ApplyImpulse(b, contact.rB, p);
+		}
+
+		//The normal impulse pushes B along the normal and A against it, and is never negative so the contact only pushes.
+		vec3 relativeVelocity{ b.linearVelocity + MathEngine::CrossProduct(b.angularVelocity, contact.rB) -
+			a.linearVelocity - MathEngine::CrossProduct(a.angularVelocity, contact.rA) };
+
+		float impulse{ (contact.bias - MathEngine::DotProduct(relativeVelocity, contact.normal)) * contact.normalMass };
+		float oldImpulse{ contact.normalImpulse };
+		float newImpulse{ (oldImpulse + impulse > 0.0f) ? oldImpulse + impulse : 0.0f };
+		contact.normalImpulse = newImpulse;
+
+		vec3 p{ contact.normal * (newImpulse - oldImpulse) };
+		ApplyImpulse(a, contact.rA, -p);
+		ApplyImpulse(b, contact.rB, p);
+	}
+
+	void ContactSolver::SolveOnThread(RigidBodyArrays& bodies, std::vector<ContactConstraint>& contacts, float dt, unsigned int thread,
+		unsigned int numThreads, ThreadBarrier& barrier)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		unsigned int numContacts{ (unsigned int)contacts.size() };
+
+		//The velocities at the end of the step without the contacts.
+		for (unsigned int i = GetThreadStart(numBodies, thread, numThreads); i < GetThreadStart(numBodies, thread + 1, numThreads); ++i)
+		{
+			//Static bodies use the static solver body.
+			if (bodies.inverseMass[i] <= 0.0f)
+				continue;
+
+			SolverBody& body{ mBodies[i] };
+			body.linearImpulse = vec3{};
+			body.angularImpulse = vec3{};
+
+			body.inverseMass = bodies.inverseMass[i];
+
+			vec3 linearMomentum{ bodies.linearMomentumX[i], bodies.linearMomentumY[i], bodies.linearMomentumZ[i] };
+			linearMomentum += vec3{ bodies.netForceX[i], bodies.netForceY[i], bodies.netForceZ[i] } * dt;
+			body.linearVelocity = linearMomentum * body.inverseMass;
+
+			vec3 angularMomentum{ bodies.angularMomentumX[i], bodies.angularMomentumY[i], bodies.angularMomentumZ[i] };
+			angularMomentum += vec3{ bodies.netTorqueX[i], bodies.netTorqueY[i], bodies.netTorqueZ[i] } * dt;
+
+			MathEngine::Quaternion orientation{ bodies.orientationW[i],
+				vec3{ bodies.orientationX[i], bodies.orientationY[i], bodies.orientationZ[i] } };
+
+			float xy{ bodies.inverseBodyInertiaXY[i] };
+			float xz{ bodies.inverseBodyInertiaXZ[i] };
+			float yz{ bodies.inverseBodyInertiaYZ[i] };
+			mat3 inverseBodyInertia(vec3{ bodies.inverseBodyInertiaXX[i], xy, xz },
+				vec3{ xy, bodies.inverseBodyInertiaYY[i], yz },
+				vec3{ xz, yz, bodies.inverseBodyInertiaZZ[i] });
+
+			//The same world inverse inertia tensor IntegrateRigidBodies uses, so the angular velocities match.
+			mat3 rOrientation(QuaternionToRotationMatrixRow3x3(orientation));
+			body.inverseInertia = rOrientation * inverseBodyInertia * Transpose(rOrientation);
+			body.angularVelocity = angularMomentum * body.inverseInertia;
+		}
+
+		barrier.Wait();
+
+		for (unsigned int i = GetThreadStart(numContacts, thread, numThreads); i < GetThreadStart(numContacts, thread + 1, numThreads); ++i)
+		{
+			ContactConstraint& contact{ contacts[i] };
+			PrepareContact(contact, bodies, mBodies[GetSolverBody(bodies, contact.bodyA)], mBodies[GetSolverBody(bodies, contact.bodyB)], dt);
+		}
+
+		barrier.Wait();
+
+		unsigned int numBatches{ GetNumberOfBatches(mColoring) };
+		for (unsigned int iteration = 0; iteration < mNumIterations; ++iteration)
+		{
+			for (unsigned int batch = 0; batch < numBatches; ++batch)
+			{
+				unsigned int first{ mColoring.batchStarts[batch] };
+				unsigned int count{ mColoring.batchStarts[batch + 1] - first };
+
+				//The constraints of the overflow batch can share bodies, so one thread solves all of them.
+				unsigned int start{ first + GetThreadStart(count, thread, numThreads) };
+				unsigned int end{ first + GetThreadStart(count, thread + 1, numThreads) };
+				if (mColoring.hasOverflow && batch == numBatches - 1)
+				{
+					start = (thread == 0) ? first : first + count;
+					end = first + count;
+				}
+
+				for (unsigned int i = start; i < end; ++i)
+				{
+					ContactConstraint& contact{ contacts[mColoring.constraints[i]] };
+					SolveContact(contact, mBodies[GetSolverBody(bodies, contact.bodyA)], mBodies[GetSolverBody(bodies, contact.bodyB)]);
+				}
+
+				barrier.Wait();
+			}
+		}
+
+		//Add the impulses as forces over the step.
+		float inverseDt{ 1.0f / dt };
+		for (unsigned int i = GetThreadStart(numBodies, thread, numThreads); i < GetThreadStart(numBodies, thread + 1, numThreads); ++i)
+		{
+			if (bodies.inverseMass[i] <= 0.0f)
+				continue;
+
+			const SolverBody& body{ mBodies[i] };
+
+			bodies.netForceX[i] += body.linearImpulse.x * inverseDt;
+			bodies.netForceY[i] += body.linearImpulse.y * inverseDt;
+			bodies.netForceZ[i] += body.linearImpulse.z * inverseDt;
+
+			bodies.netTorqueX[i] += body.angularImpulse.x * inverseDt;
+			bodies.netTorqueY[i] += body.angularImpulse.y * inverseDt;
+			bodies.netTorqueZ[i] += body.angularImpulse.z * inverseDt;
+		}
+	}
+
+	void ContactSolver::SolveContacts(RigidBodyArrays& bodies, std::vector<ContactConstraint>& contacts, float dt, StepProfiler* profiler)
+	{
+		ProfileScope scope{ profiler, PHASE_SOLVE };
+
+		ColorConstraints(bodies, contacts, mColoring);
+
+		if (profiler != nullptr)
+			profiler->AddConstraintBatches(GetNumberOfBatches(mColoring));
+
+		if (contacts.empty() || dt <= 0.0f)
+			return;
+
+		//The static body has no velocity and infinite mass and inertia.
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		mBodies.resize(numBodies + 1);
+		SolverBody& staticBody{ mBodies[numBodies] };
+		staticBody.linearVelocity = vec3{};
+		staticBody.angularVelocity = vec3{};
+		staticBody.linearImpulse = vec3{};
+		staticBody.angularImpulse = vec3{};
+		staticBody.inverseInertia = mat3() * 0.0f;
+		staticBody.inverseMass = 0.0f;
+
+		//Small problems are not worth waking threads for.
+		unsigned int numThreads{ mNumThreads };
+		if (contacts.size() < 256 * (size_t)numThreads)
+			numThreads = 1;
+
+		ThreadBarrier barrier;
+		barrier.numThreads = numThreads;
+
+		std::vector<std::thread> threads;
+		for (unsigned int i = 1; i < numThreads; ++i)
+		{
+			threads.emplace_back(&ContactSolver::SolveOnThread, this, std::ref(bodies), std::ref(contacts), dt, i, numThreads, std::ref(barrier));
+		}
+
+		SolveOnThread(bodies, contacts, dt, 0, numThreads, barrier);
+
+		for (auto& i : threads)
+		{
+			i.join();
+		}
+	}
+}
\ No newline at end of file
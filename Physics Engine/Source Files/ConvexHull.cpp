@@ -0,0 +1,511 @@
+#include "ConvexHull.h"
+#include <cfloat>
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	//A triangle of a hull that is being built.
+	//Edge i goes from vertices[i] to vertices[(i + 1) % 3] and adjacent[i] is the face on the other side of the edge.
+	//The outside points are the points above the face that have not been added to the hull yet.
+	struct HullFace
+	{
+		unsigned int vertices[3]{};
+		unsigned int adjacent[3]{};
+		vec3 normal;
+		float distance{ 0.0f };
+
+		std::vector<unsigned int> outside;
+		unsigned int farthest{ 0 };
+		float farthestDistance{ 0.0f };
+
+		bool removed{ false };
+		bool visited{ false };
+	};
+
+	//An edge between the faces that can see the eye point and the faces that cannot.
+	//The face is the face that cannot see the eye point and edge is the index of the edge in that face.
+	struct HorizonEdge
+	{
+		unsigned int a{ 0 };
+		unsigned int b{ 0 };
+		unsigned int face{ 0 };
+		unsigned int edge{ 0 };
+	};
+
+	struct HullBuilder
+	{
+		const vec3* points{ nullptr };
+		unsigned int numPoints{ 0 };
+		float tolerance{ 0.0f };
+
+		std::vector<HullFace> faces;
+
+		//The number of faces that use each point. Points with a count greater than 0 are vertices of the hull.
+		std::vector<unsigned int> faceCounts;
+		unsigned int numHullVertices{ 0 };
+	};
+
+	static float GetComponent(const vec3& v, unsigned int i)
+	{
+		return (i == 0) ? v.x : ((i == 1) ? v.y : v.z);
+	}
+
+	static float DistanceAbove(const HullFace& face, const vec3& point)
+	{
+		return MathEngine::DotProduct(face.normal, point) - face.distance;
+	}
+
+	//Returns the index of the edge of the face that goes from u to v, or 3 if the face does not have the edge.
+	static unsigned int FindEdge(const HullFace& face, unsigned int u, unsigned int v)
+	{
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			if (face.vertices[i] == u && face.vertices[(i + 1) % 3] == v)
+				return i;
+		}
+
+		return 3;
+	}
+
+	static unsigned int AddFace(HullBuilder& builder, unsigned int a, unsigned int b, unsigned int c)
+	{
+		HullFace face;
+		face.vertices[0] = a;
+		face.vertices[1] = b;
+		face.vertices[2] = c;
+
+		const vec3& p0{ builder.points[a] };
+		vec3 normal{ MathEngine::CrossProduct(builder.points[b] - p0, builder.points[c] - p0) };
+		float length{ MathEngine::Length(normal) };
+
+		face.normal = (length > 0.0f) ? normal * (1.0f / length) : normal;
+		face.distance = MathEngine::DotProduct(face.normal, p0);
+
+		for (auto i : face.vertices)
+		{
+			if (builder.faceCounts[i]++ == 0)
+				++builder.numHullVertices;
+		}
+
+		builder.faces.push_back(face);
+
+		return (unsigned int)builder.faces.size() - 1;
+	}
+
+	static void RemoveFace(HullBuilder& builder, unsigned int faceIndex)
+	{
+		HullFace& face{ builder.faces[faceIndex] };
+		face.removed = true;
+
+		for (auto i : face.vertices)
+		{
+			if (--builder.faceCounts[i] == 0)
+				--builder.numHullVertices;
+		}
+	}
+
+	//Adds the point to the outside set of the first face in [firstFace, endFace) it is above.
+	//Points that are not above any of the faces are inside the hull and are dropped.
+	static void AssignPoint(HullBuilder& builder, unsigned int point, unsigned int firstFace, unsigned int endFace)
+	{
+		for (unsigned int i = firstFace; i < endFace; ++i)
+		{
+			HullFace& face{ builder.faces[i] };
+			if (face.removed)
+				continue;
+
+			float distance{ DistanceAbove(face, builder.points[point]) };
+			if (distance > builder.tolerance)
+			{
+				if (face.outside.empty() || distance > face.farthestDistance)
+				{
+					face.farthest = point;
+					face.farthestDistance = distance;
+				}
+
+				face.outside.push_back(point);
+				return;
+			}
+		}
+	}
+
+	//Finds the faces that can see the eye point, starting from a face that can, and the horizon around them.
+	//Entering a face through an edge and going around its other edges in order gives the horizon edges in counterclockwise order.
+	static void ComputeHorizon(HullBuilder& builder, unsigned int faceIndex, unsigned int enteredEdge, const vec3& eye,
+		std::vector<HorizonEdge>& horizon, std::vector<unsigned int>& visibleFaces)
+	{
+		builder.faces[faceIndex].visited = true;
+		visibleFaces.push_back(faceIndex);
+
+		unsigned int firstEdge{ (enteredEdge == 3) ? 0u : enteredEdge + 1 };
+		unsigned int numEdges{ (enteredEdge == 3) ? 3u : 2u };
+
+		for (unsigned int i = 0; i < numEdges; ++i)
+		{
+			unsigned int edge{ (firstEdge + i) % 3 };
+			unsigned int u{ builder.faces[faceIndex].vertices[edge] };
+			unsigned int v{ builder.faces[faceIndex].vertices[(edge + 1) % 3] };
+			unsigned int neighbor{ builder.faces[faceIndex].adjacent[edge] };
+
+			if (builder.faces[neighbor].visited)
+				continue;
+
+			unsigned int neighborEdge{ FindEdge(builder.faces[neighbor], v, u) };
+
+			if (DistanceAbove(builder.faces[neighbor], eye) > builder.tolerance)
+				ComputeHorizon(builder, neighbor, neighborEdge, eye, horizon, visibleFaces);
+			else
+				horizon.push_back(HorizonEdge{ u, v, neighbor, neighborEdge });
+		}
+	}
+
+	//Finds 4 points that make a tetrahedron with a volume and adds its faces.
+	//Returns false if the points lie in a plane or on a line.
+	static bool CreateInitialHull(HullBuilder& builder)
+	{
+		const vec3* points{ builder.points };
+
+		//the points with the smallest and largest x, y and z
+		unsigned int extremes[6]{};
+		for (unsigned int i = 1; i < builder.numPoints; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				float value{ GetComponent(points[i], j) };
+
+				if (value < GetComponent(points[extremes[2 * j]], j))
+					extremes[2 * j] = i;
+
+				if (value > GetComponent(points[extremes[2 * j + 1]], j))
+					extremes[2 * j + 1] = i;
+			}
+		}
+
+		//the two extreme points farthest apart
+		unsigned int i0{ 0 };
+		unsigned int i1{ 0 };
+		float maxDistance{ 0.0f };
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			for (unsigned int j = i + 1; j < 6; ++j)
+			{
+				vec3 d{ points[extremes[j]] - points[extremes[i]] };
+				float distance{ MathEngine::DotProduct(d, d) };
+				if (distance > maxDistance)
+				{
+					maxDistance = distance;
+					i0 = extremes[i];
+					i1 = extremes[j];
+				}
+			}
+		}
+
+		if (std::sqrt(maxDistance) <= builder.tolerance)
+			return false;
+
+		//the point farthest from the line through them
+		vec3 lineDirection{ MathEngine::Normalize(points[i1] - points[i0]) };
+		unsigned int i2{ 0 };
+		maxDistance = 0.0f;
+		for (unsigned int i = 0; i < builder.numPoints; ++i)
+		{
+			vec3 c{ MathEngine::CrossProduct(points[i] - points[i0], lineDirection) };
+			float distance{ MathEngine::DotProduct(c, c) };
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				i2 = i;
+			}
+		}
+
+		if (std::sqrt(maxDistance) <= builder.tolerance)
+			return false;
+
+		//the point farthest from the plane through the three points
+		vec3 planeNormal{ MathEngine::Normalize(MathEngine::CrossProduct(points[i1] - points[i0], points[i2] - points[i0])) };
+		unsigned int i3{ 0 };
+		maxDistance = 0.0f;
+		for (unsigned int i = 0; i < builder.numPoints; ++i)
+		{
+			float distance{ std::fabs(MathEngine::DotProduct(planeNormal, points[i] - points[i0])) };
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				i3 = i;
+			}
+		}
+
+		if (maxDistance <= builder.tolerance)
+			return false;
+
+		//The base triangle has to face away from the fourth point.
+		if (MathEngine::DotProduct(planeNormal, points[i3] - points[i0]) > 0.0f)
+		{
+			unsigned int temp{ i1 };
+			i1 = i2;
+			i2 = temp;
+		}
+
+		AddFace(builder, i0, i1, i2);
+		AddFace(builder, i1, i0, i3);
+		AddFace(builder, i2, i1, i3);
+		AddFace(builder, i0, i2, i3);
+
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			HullFace& face{ builder.faces[i] };
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				unsigned int u{ face.vertices[j] };
+				unsigned int v{ face.vertices[(j + 1) % 3] };
+
+				for (unsigned int k = 0; k < 4; ++k)
+				{
+					if (k != i && FindEdge(builder.faces[k], v, u) != 3)
+						face.adjacent[j] = k;
+				}
+			}
+		}
+
+		for (unsigned int i = 0; i < builder.numPoints; ++i)
+		{
+			if (i != i0 && i != i1 && i != i2 && i != i3)
+				AssignPoint(builder, i, 0, 4);
+		}
+
+		return true;
+	}
+
+	//Copies the faces that were not removed into the hull, numbering the vertices in the order they are first used,
+	//and builds the vertex adjacency.
+	static void StoreHull(const HullBuilder& builder, ConvexHull& hull)
+	{
+		std::vector<unsigned int> hullIndex(builder.numPoints, 0xffffffff);
+
+		for (const auto& i : builder.faces)
+		{
+			if (i.removed)
+				continue;
+
+			for (auto j : i.vertices)
+			{
+				if (hullIndex[j] == 0xffffffff)
+				{
+					hullIndex[j] = (unsigned int)hull.vertices.size();
+					hull.vertices.push_back(builder.points[j]);
+				}
+
+				hull.indices.push_back(hullIndex[j]);
+			}
+
+			hull.faceNormals.push_back(i.normal);
+			hull.faceDistances.push_back(i.distance);
+		}
+
+		//Every edge is used by two faces, once in each direction, so adding the end of each directed edge to the list of its start
+		//adds each neighbor exactly once.
+		unsigned int numVertices{ (unsigned int)hull.vertices.size() };
+		hull.neighborOffsets.assign(numVertices + 1, 0);
+
+		for (auto i : hull.indices)
+		{
+			++hull.neighborOffsets[i + 1];
+		}
+
+		for (unsigned int i = 0; i < numVertices; ++i)
+		{
+			hull.neighborOffsets[i + 1] += hull.neighborOffsets[i];
+		}
+
+		std::vector<unsigned int> next(hull.neighborOffsets.begin(), hull.neighborOffsets.end() - 1);
+		hull.neighbors.resize(hull.indices.size());
+		hull.edgeFaces.resize(hull.indices.size());
+
+		for (size_t i = 0; i < hull.indices.size(); i += 3)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				unsigned int u{ hull.indices[i + j] };
+				unsigned int v{ hull.indices[i + (j + 1) % 3] };
+				hull.edgeFaces[next[u]] = (unsigned int)(i / 3);
+				hull.neighbors[next[u]++] = v;
+			}
+		}
+	}
+
+	bool ComputeConvexHull(const vec3* points, unsigned int numPoints, ConvexHull& hull, unsigned int maxVertices)
+	{
+		hull = ConvexHull{};
+
+		if (points == nullptr || numPoints < 4)
+			return false;
+
+		if (maxVertices > 0 && maxVertices < 4)
+			maxVertices = 4;
+
+		HullBuilder builder;
+		builder.points = points;
+		builder.numPoints = numPoints;
+		builder.faceCounts.assign(numPoints, 0);
+
+		//The tolerance grows with the size of the points, since the rounding errors of the plane distances do.
+		float maxX{ 0.0f };
+		float maxY{ 0.0f };
+		float maxZ{ 0.0f };
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			maxX = std::fmax(maxX, std::fabs(points[i].x));
+			maxY = std::fmax(maxY, std::fabs(points[i].y));
+			maxZ = std::fmax(maxZ, std::fabs(points[i].z));
+		}
+		builder.tolerance = 3.0f * FLT_EPSILON * (maxX + maxY + maxZ);
+
+		if (!CreateInitialHull(builder))
+			return false;
+
+		std::vector<HorizonEdge> horizon;
+		std::vector<unsigned int> visibleFaces;
+		std::vector<unsigned int> orphans;
+
+		while (maxVertices == 0 || builder.numHullVertices < maxVertices)
+		{
+			//Add the point that is farthest outside the hull, so a hull that stops at a vertex budget gets the most important points.
+			unsigned int eyeFace{ 0xffffffff };
+			float maxDistance{ 0.0f };
+			for (unsigned int i = 0; i < (unsigned int)builder.faces.size(); ++i)
+			{
+				const HullFace& face{ builder.faces[i] };
+				if (!face.removed && !face.outside.empty() && face.farthestDistance > maxDistance)
+				{
+					maxDistance = face.farthestDistance;
+					eyeFace = i;
+				}
+			}
+
+			if (eyeFace == 0xffffffff)
+				break;
+
+			unsigned int eye{ builder.faces[eyeFace].farthest };
+			const vec3& eyePoint{ points[eye] };
+
+			horizon.clear();
+			visibleFaces.clear();
+			ComputeHorizon(builder, eyeFace, 3, eyePoint, horizon, visibleFaces);
+
+			//The points outside the faces that are replaced have to be assigned to the new faces.
+			orphans.clear();
+			for (auto i : visibleFaces)
+			{
+				for (auto j : builder.faces[i].outside)
+				{
+					if (j != eye)
+						orphans.push_back(j);
+				}
+
+				builder.faces[i].outside.clear();
+				RemoveFace(builder, i);
+			}
+
+			//Connect each horizon edge to the eye point. The horizon edges go around the eye point in order,
+			//so each new face is next to the new faces before and after it.
+			unsigned int firstNewFace{ (unsigned int)builder.faces.size() };
+			unsigned int numNewFaces{ (unsigned int)horizon.size() };
+
+			for (const auto& i : horizon)
+			{
+				unsigned int face{ AddFace(builder, i.a, i.b, eye) };
+				builder.faces[face].adjacent[0] = i.face;
+				builder.faces[i.face].adjacent[i.edge] = face;
+			}
+
+			for (unsigned int i = 0; i < numNewFaces; ++i)
+			{
+				HullFace& face{ builder.faces[firstNewFace + i] };
+				face.adjacent[1] = firstNewFace + (i + 1) % numNewFaces;
+				face.adjacent[2] = firstNewFace + (i + numNewFaces - 1) % numNewFaces;
+			}
+
+			for (auto i : orphans)
+			{
+				AssignPoint(builder, i, firstNewFace, firstNewFace + numNewFaces);
+			}
+		}
+
+		StoreHull(builder, hull);
+
+		return true;
+	}
+
+	bool ComputeConvexHull(const std::vector<ShapesEngine::Vertex>& vertices, ConvexHull& hull, unsigned int maxVertices)
+	{
+		std::vector<vec3> points(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			points[i] = vertices[i].position;
+		}
+
+		return ComputeConvexHull(points.data(), (unsigned int)points.size(), hull, maxVertices);
+	}
+
+	unsigned int FindSupportVertex(const ConvexHull& hull, const vec3& direction, unsigned int startVertex)
+	{
+		if (hull.vertices.empty())
+			return 0;
+
+		unsigned int current{ (startVertex < hull.vertices.size()) ? startVertex : 0 };
+		float currentDistance{ MathEngine::DotProduct(hull.vertices[current], direction) };
+
+		//On a convex polyhedron a vertex that has no neighbor farther in the direction is the farthest vertex.
+		while (true)
+		{
+			unsigned int best{ current };
+
+			for (unsigned int i = hull.neighborOffsets[current]; i < hull.neighborOffsets[current + 1]; ++i)
+			{
+				unsigned int neighbor{ hull.neighbors[i] };
+				float distance{ MathEngine::DotProduct(hull.vertices[neighbor], direction) };
+
+				if (distance > currentDistance)
+				{
+					currentDistance = distance;
+					best = neighbor;
+				}
+			}
+
+			if (best == current)
+				return current;
+
+			current = best;
+		}
+	}
+
+	vec3 GetSupportPoint(const ConvexHull& hull, const vec3& direction)
+	{
+		if (hull.vertices.empty())
+			return vec3{};
+
+		return hull.vertices[FindSupportVertex(hull, direction, 0)];
+	}
+
+	float ComputeHullError(const ConvexHull& hull, const vec3* points, unsigned int numPoints)
+	{
+		float maxError{ 0.0f };
+
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			//The distance above the highest face plane is how far the point is outside the hull along that face normal.
+			float error{ -FLT_MAX };
+			for (size_t j = 0; j < hull.faceNormals.size(); ++j)
+			{
+				float distance{ MathEngine::DotProduct(hull.faceNormals[j], points[i]) - hull.faceDistances[j] };
+				if (distance > error)
+					error = distance;
+			}
+
+			if (error > maxError)
+				maxError = error;
+		}
+
+		return maxError;
+	}
+}
\ No newline at end of file
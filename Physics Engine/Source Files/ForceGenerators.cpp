@@ -0,0 +1,310 @@
+#include "ForceGenerators.h"
+#include <xmmintrin.h>
+
+//Keep the compiler from fusing multiplies and adds into FMA instructions, so the deterministic step applies the forces the same way in every build.
+#if defined(_MSC_VER)
+#pragma fp_contract (off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+namespace PhysicsEngine
+{
+	//Returns the index one past the last body of the range, clamped to the number of bodies.
+	static unsigned int RangeEnd(const RigidBodyArrays& bodies, const BodyRange& range)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		unsigned int end{ range.first + range.count };
+
+		return (end > numBodies) ? numBodies : end;
+	}
+
+	void ApplyUniformGravity(RigidBodyArrays& bodies, const UniformGravityGenerator& gravity)
+	{
+		unsigned int i{ gravity.range.first };
+		unsigned int end{ RangeEnd(bodies, gravity.range) };
+
+		const float* mass{ bodies.mass.data() };
+		float* forceX{ bodies.netForceX.data() };
+		float* forceY{ bodies.netForceY.data() };
+		float* forceZ{ bodies.netForceZ.data() };
+
+		//F = mg, 4 bodies at a time.
+		__m128 gx{ _mm_set1_ps(gravity.acceleration.x) };
+		__m128 gy{ _mm_set1_ps(gravity.acceleration.y) };
+		__m128 gz{ _mm_set1_ps(gravity.acceleration.z) };
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 m{ _mm_loadu_ps(mass + i) };
+
+			_mm_storeu_ps(forceX + i, _mm_add_ps(_mm_loadu_ps(forceX + i), _mm_mul_ps(m, gx)));
+			_mm_storeu_ps(forceY + i, _mm_add_ps(_mm_loadu_ps(forceY + i), _mm_mul_ps(m, gy)));
+			_mm_storeu_ps(forceZ + i, _mm_add_ps(_mm_loadu_ps(forceZ + i), _mm_mul_ps(m, gz)));
+		}
+
+		//remaining bodies
+		for (; i < end; ++i)
+		{
+			forceX[i] += mass[i] * gravity.acceleration.x;
+			forceY[i] += mass[i] * gravity.acceleration.y;
+			forceZ[i] += mass[i] * gravity.acceleration.z;
+		}
+	}
+
+	void ApplyDrag(RigidBodyArrays& bodies, const DragGenerator& drag)
+	{
+		unsigned int i{ drag.range.first };
+		unsigned int end{ RangeEnd(bodies, drag.range) };
+
+		const float* velocityX{ bodies.linearVelocityX.data() };
+		const float* velocityY{ bodies.linearVelocityY.data() };
+		const float* velocityZ{ bodies.linearVelocityZ.data() };
+		float* forceX{ bodies.netForceX.data() };
+		float* forceY{ bodies.netForceY.data() };
+		float* forceZ{ bodies.netForceZ.data() };
+
+		//F = -(v / |v|)(k1|v| + k2|v|^2) = -v(k1 + k2|v|), so no normalization is needed.
+		__m128 wx{ _mm_set1_ps(drag.windVelocity.x) };
+		__m128 wy{ _mm_set1_ps(drag.windVelocity.y) };
+		__m128 wz{ _mm_set1_ps(drag.windVelocity.z) };
+		__m128 k1{ _mm_set1_ps(drag.k1) };
+		__m128 k2{ _mm_set1_ps(drag.k2) };
+
+		for (; i + 4 <= end; i += 4)
+		{
+			//velocity relative to the wind
+			__m128 vx{ _mm_sub_ps(_mm_loadu_ps(velocityX + i), wx) };
+			__m128 vy{ _mm_sub_ps(_mm_loadu_ps(velocityY + i), wy) };
+			__m128 vz{ _mm_sub_ps(_mm_loadu_ps(velocityZ + i), wz) };
+
+			__m128 speed{ _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz))) };
+			__m128 k{ _mm_add_ps(k1, _mm_mul_ps(k2, speed)) };
+
+			_mm_storeu_ps(forceX + i, _mm_sub_ps(_mm_loadu_ps(forceX + i), _mm_mul_ps(vx, k)));
+			_mm_storeu_ps(forceY + i, _mm_sub_ps(_mm_loadu_ps(forceY + i), _mm_mul_ps(vy, k)));
+			_mm_storeu_ps(forceZ + i, _mm_sub_ps(_mm_loadu_ps(forceZ + i), _mm_mul_ps(vz, k)));
+		}
+
+		//remaining bodies
+		for (; i < end; ++i)
+		{
+			vec3 v{ velocityX[i] - drag.windVelocity.x, velocityY[i] - drag.windVelocity.y, velocityZ[i] - drag.windVelocity.z };
+			float k{ drag.k1 + drag.k2 * MathEngine::Length(v) };
+
+			forceX[i] -= v.x * k;
+			forceY[i] -= v.y * k;
+			forceZ[i] -= v.z * k;
+		}
+	}
+
+	void ApplyPointAttractor(RigidBodyArrays& bodies, const PointAttractorGenerator& attractor)
+	{
+		unsigned int i{ attractor.range.first };
+		unsigned int end{ RangeEnd(bodies, attractor.range) };
+
+		const float* mass{ bodies.mass.data() };
+		const float* positionX{ bodies.centerOfMassX.data() };
+		const float* positionY{ bodies.centerOfMassY.data() };
+		const float* positionZ{ bodies.centerOfMassZ.data() };
+		float* forceX{ bodies.netForceX.data() };
+		float* forceY{ bodies.netForceY.data() };
+		float* forceZ{ bodies.netForceZ.data() };
+
+		float minDistanceSquared{ attractor.minDistance * attractor.minDistance };
+
+		//F = (strength * m / r^2) * (d / r) = (strength * m / r^3) * d, where d is the vector from the body to the point.
+		__m128 px{ _mm_set1_ps(attractor.point.x) };
+		__m128 py{ _mm_set1_ps(attractor.point.y) };
+		__m128 pz{ _mm_set1_ps(attractor.point.z) };
+		__m128 strength{ _mm_set1_ps(attractor.strength) };
+		__m128 minR2{ _mm_set1_ps(minDistanceSquared) };
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 dx{ _mm_sub_ps(px, _mm_loadu_ps(positionX + i)) };
+			__m128 dy{ _mm_sub_ps(py, _mm_loadu_ps(positionY + i)) };
+			__m128 dz{ _mm_sub_ps(pz, _mm_loadu_ps(positionZ + i)) };
+
+			__m128 r2{ _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)), minR2) };
+			__m128 r3{ _mm_mul_ps(r2, _mm_sqrt_ps(r2)) };
+			__m128 k{ _mm_div_ps(_mm_mul_ps(strength, _mm_loadu_ps(mass + i)), r3) };
+
+			_mm_storeu_ps(forceX + i, _mm_add_ps(_mm_loadu_ps(forceX + i), _mm_mul_ps(dx, k)));
+			_mm_storeu_ps(forceY + i, _mm_add_ps(_mm_loadu_ps(forceY + i), _mm_mul_ps(dy, k)));
+			_mm_storeu_ps(forceZ + i, _mm_add_ps(_mm_loadu_ps(forceZ + i), _mm_mul_ps(dz, k)));
+		}
+
+		//remaining bodies
+		for (; i < end; ++i)
+		{
+			vec3 d{ attractor.point.x - positionX[i], attractor.point.y - positionY[i], attractor.point.z - positionZ[i] };
+
+			float r2{ MathEngine::DotProduct(d, d) };
+			if (r2 < minDistanceSquared)
+				r2 = minDistanceSquared;
+
+			float k{ attractor.strength * mass[i] / (r2 * std::sqrt(r2)) };
+
+			forceX[i] += d.x * k;
+			forceY[i] += d.y * k;
+			forceZ[i] += d.z * k;
+		}
+	}
+
+	void ApplySpring(RigidBodyArrays& bodies, const SpringGenerator& spring)
+	{
+		unsigned int a{ spring.bodyA };
+		unsigned int b{ spring.bodyB };
+
+		//world space offsets of the attachment points from the centers of mass
+		MathEngine::Quaternion orientationA{ bodies.orientationW[a], vec3{ bodies.orientationX[a], bodies.orientationY[a], bodies.orientationZ[a] } };
+		vec3 rA{ MathEngine::Rotate(orientationA, spring.localPointA) };
+		vec3 pointA{ vec3{ bodies.centerOfMassX[a], bodies.centerOfMassY[a], bodies.centerOfMassZ[a] } + rA };
+
+		//velocity of a point on a rigid body = v + w x r
+		vec3 velocityA{ vec3{ bodies.linearVelocityX[a], bodies.linearVelocityY[a], bodies.linearVelocityZ[a] } +
+			MathEngine::CrossProduct(vec3{ bodies.angularVelocityX[a], bodies.angularVelocityY[a], bodies.angularVelocityZ[a] }, rA) };
+
+		vec3 rB;
+		vec3 pointB{ spring.localPointB };
+		vec3 velocityB;
+
+		if (b != INVALID_BODY)
+		{
+			MathEngine::Quaternion orientationB{ bodies.orientationW[b], vec3{ bodies.orientationX[b], bodies.orientationY[b], bodies.orientationZ[b] } };
+			rB = MathEngine::Rotate(orientationB, spring.localPointB);
+			pointB = vec3{ bodies.centerOfMassX[b], bodies.centerOfMassY[b], bodies.centerOfMassZ[b] } + rB;
+
+			velocityB = vec3{ bodies.linearVelocityX[b], bodies.linearVelocityY[b], bodies.linearVelocityZ[b] } +
+				MathEngine::CrossProduct(vec3{ bodies.angularVelocityX[b], bodies.angularVelocityY[b], bodies.angularVelocityZ[b] }, rB);
+		}
+
+		vec3 d{ pointA - pointB };
+		float length{ MathEngine::Length(d) };
+
+		//The direction of the force is undefined when the points are on top of each other.
+		if (length < EPSILON)
+			return;
+
+		vec3 direction{ d * (1.0f / length) };
+
+		float magnitude{ spring.stiffness * (length - spring.restLength) +
+			spring.damping * MathEngine::DotProduct(velocityA - velocityB, direction) };
+
+		vec3 force{ -magnitude * direction };
+
+		//torque = r x F
+		vec3 torqueA{ MathEngine::CrossProduct(rA, force) };
+		bodies.netForceX[a] += force.x;
+		bodies.netForceY[a] += force.y;
+		bodies.netForceZ[a] += force.z;
+		bodies.netTorqueX[a] += torqueA.x;
+		bodies.netTorqueY[a] += torqueA.y;
+		bodies.netTorqueZ[a] += torqueA.z;
+
+		if (b != INVALID_BODY)
+		{
+			vec3 torqueB{ MathEngine::CrossProduct(rB, -force) };
+			bodies.netForceX[b] -= force.x;
+			bodies.netForceY[b] -= force.y;
+			bodies.netForceZ[b] -= force.z;
+			bodies.netTorqueX[b] += torqueB.x;
+			bodies.netTorqueY[b] += torqueB.y;
+			bodies.netTorqueZ[b] += torqueB.z;
+		}
+	}
+
+
+
+	ForceGeneratorRegistry::ForceGeneratorRegistry()
+	{}
+
+	void ForceGeneratorRegistry::RegisterUniformGravity(float gravityAcceleration, const vec3& direction, const BodyRange& range)
+	{
+		mGravityGenerators.push_back(UniformGravityGenerator{ gravityAcceleration * MathEngine::Normalize(direction), range });
+	}
+
+	void ForceGeneratorRegistry::RegisterDrag(float k1, float k2, const BodyRange& range)
+	{
+		mDragGenerators.push_back(DragGenerator{ vec3{ 0.0f, 0.0f, 0.0f }, k1, k2, range });
+	}
+
+	void ForceGeneratorRegistry::RegisterWindField(const vec3& windVelocity, float k1, float k2, const BodyRange& range)
+	{
+		mDragGenerators.push_back(DragGenerator{ windVelocity, k1, k2, range });
+	}
+
+	void ForceGeneratorRegistry::RegisterPointAttractor(const vec3& point, float strength, float minDistance, const BodyRange& range)
+	{
+		mPointAttractorGenerators.push_back(PointAttractorGenerator{ point, strength, (minDistance <= 0.0f) ? EPSILON : minDistance, range });
+	}
+
+	void ForceGeneratorRegistry::RegisterSpring(unsigned int bodyA, const vec3& localPointA, unsigned int bodyB, const vec3& localPointB,
+		float restLength, float stiffness, float damping)
+	{
+		mSpringGenerators.push_back(SpringGenerator{ bodyA, bodyB, localPointA, localPointB, restLength, stiffness, damping });
+	}
+
+	void ForceGeneratorRegistry::RegisterAnchoredSpring(unsigned int body, const vec3& localPoint, const vec3& anchor,
+		float restLength, float stiffness, float damping)
+	{
+		mSpringGenerators.push_back(SpringGenerator{ body, INVALID_BODY, localPoint, anchor, restLength, stiffness, damping });
+	}
+
+	void ForceGeneratorRegistry::ClearForceGenerators()
+	{
+		mGravityGenerators.clear();
+		mDragGenerators.clear();
+		mPointAttractorGenerators.clear();
+		mSpringGenerators.clear();
+	}
+
+	unsigned int ForceGeneratorRegistry::GetNumberOfForceGenerators() const
+	{
+		return (unsigned int)(mGravityGenerators.size() + mDragGenerators.size() + mPointAttractorGenerators.size() + mSpringGenerators.size());
+	}
+
+	const std::vector<SpringGenerator>& ForceGeneratorRegistry::GetSpringGenerators() const
+	{
+		return mSpringGenerators;
+	}
+
+	void ForceGeneratorRegistry::ShiftOrigin(const vec3& shift)
+	{
+		for (auto& i : mPointAttractorGenerators)
+		{
+			i.point -= shift;
+		}
+
+		//The points on the bodies are in body coordinates, only the anchors are in world coordinates.
+		for (auto& i : mSpringGenerators)
+		{
+			if (i.bodyB == INVALID_BODY)
+				i.localPointB -= shift;
+		}
+	}
+
+	void ForceGeneratorRegistry::ApplyForceGenerators(RigidBodyArrays& bodies) const
+	{
+		for (const auto& i : mGravityGenerators)
+		{
+			ApplyUniformGravity(bodies, i);
+		}
+
+		for (const auto& i : mDragGenerators)
+		{
+			ApplyDrag(bodies, i);
+		}
+
+		for (const auto& i : mPointAttractorGenerators)
+		{
+			ApplyPointAttractor(bodies, i);
+		}
+
+		for (const auto& i : mSpringGenerators)
+		{
+			ApplySpring(bodies, i);
+		}
+	}
+}
\ No newline at end of file
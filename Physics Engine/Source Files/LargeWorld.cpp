@@ -0,0 +1,128 @@
+#include "LargeWorld.h"
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	//Returns the multiple of the grid size nearest to x, or x if there is no grid.
+	static double SnapToGrid(double x, double gridSize)
+	{
+		return (gridSize > 0.0) ? std::floor(x / gridSize + 0.5) * gridSize : x;
+	}
+
+	FloatingOrigin::FloatingOrigin() : mRebaseDistance{ 4096.0 }, mGridSize{ 1024.0 }, mNumRebases{ 0 }
+	{}
+
+	FloatingOrigin::FloatingOrigin(double rebaseDistance, double gridSize) : mRebaseDistance{ 4096.0 }, mGridSize{ 1024.0 }, mNumRebases{ 0 }
+	{
+		InitializeFloatingOrigin(rebaseDistance, gridSize);
+	}
+
+	void FloatingOrigin::InitializeFloatingOrigin(double rebaseDistance, double gridSize)
+	{
+		mOrigin = WorldPosition{};
+		mRebaseDistance = rebaseDistance;
+		mGridSize = gridSize;
+		mLastShift = vec3{};
+		mNumRebases = 0;
+	}
+
+	const WorldPosition& FloatingOrigin::GetOrigin() const
+	{
+		return mOrigin;
+	}
+
+	const vec3& FloatingOrigin::GetLastShift() const
+	{
+		return mLastShift;
+	}
+
+	unsigned int FloatingOrigin::GetNumberOfRebases() const
+	{
+		return mNumRebases;
+	}
+
+	vec3 FloatingOrigin::ToLocal(const WorldPosition& position) const
+	{
+		return vec3{ (float)(position.x - mOrigin.x), (float)(position.y - mOrigin.y), (float)(position.z - mOrigin.z) };
+	}
+
+	WorldPosition FloatingOrigin::ToWorld(const vec3& local) const
+	{
+		return WorldPosition{ mOrigin.x + local.x, mOrigin.y + local.y, mOrigin.z + local.z };
+	}
+
+	WorldPosition FloatingOrigin::GetWorldPosition(const RigidBodyArrays& bodies, unsigned int body) const
+	{
+		return ToWorld(vec3{ bodies.centerOfMassX[body], bodies.centerOfMassY[body], bodies.centerOfMassZ[body] });
+	}
+
+	void FloatingOrigin::SetWorldPosition(RigidBodyArrays& bodies, unsigned int body, const WorldPosition& position) const
+	{
+		vec3 local{ ToLocal(position) };
+		bodies.centerOfMassX[body] = local.x;
+		bodies.centerOfMassY[body] = local.y;
+		bodies.centerOfMassZ[body] = local.z;
+	}
+
+	bool FloatingOrigin::UpdateOrigin(const WorldPosition& focus)
+	{
+		double x{ focus.x - mOrigin.x };
+		double y{ focus.y - mOrigin.y };
+		double z{ focus.z - mOrigin.z };
+		if (x * x + y * y + z * z <= mRebaseDistance * mRebaseDistance)
+			return false;
+
+		WorldPosition origin{ SnapToGrid(focus.x, mGridSize), SnapToGrid(focus.y, mGridSize), SnapToGrid(focus.z, mGridSize) };
+
+		mLastShift = vec3{ (float)(origin.x - mOrigin.x), (float)(origin.y - mOrigin.y), (float)(origin.z - mOrigin.z) };
+
+		//The origin moves by the float shift, so it stays in step with the positions that are shifted by it.
+		mOrigin.x += mLastShift.x;
+		mOrigin.y += mLastShift.y;
+		mOrigin.z += mLastShift.z;
+		++mNumRebases;
+
+		return true;
+	}
+
+	bool FloatingOrigin::Rebase(const WorldPosition& focus, RigidBodyArrays& bodies, ForceGeneratorRegistry* forceGenerators,
+		Broadphase* broadphase)
+	{
+		if (!UpdateOrigin(focus))
+			return false;
+
+		ShiftOrigin(bodies, mLastShift);
+
+		if (forceGenerators != nullptr)
+			forceGenerators->ShiftOrigin(mLastShift);
+
+		if (broadphase != nullptr)
+			broadphase->ShiftOrigin(mLastShift);
+
+		return true;
+	}
+
+	void FloatingOrigin::ComputeCameraRelativeTransforms(const RigidBodyArrays& bodies, const mat4* localModels, const WorldPosition& camera,
+		std::vector<mat4>& transforms) const
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		transforms.resize(numBodies);
+
+		//The offset from the camera to the origin, which can be large, is only ever added in double precision.
+		double originX{ mOrigin.x - camera.x };
+		double originY{ mOrigin.y - camera.y };
+		double originZ{ mOrigin.z - camera.z };
+
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			MathEngine::Quaternion orientation{ bodies.orientationW[i], vec3{ bodies.orientationX[i], bodies.orientationY[i], bodies.orientationZ[i] } };
+
+			//The local model matrix only holds small numbers, so it is rotated in float and its translation, the offset of the mesh
+			//from the center of mass, is added to the offset from the camera in double.
+			mat4& transform{ transforms[i] };
+			transform = localModels[i] * MathEngine::QuaternionToRotationMatrixRow4x4(orientation);
+			transform.SetRow(3, vec4{ (float)(originX + bodies.centerOfMassX[i] + transform(3, 0)),
+				(float)(originY + bodies.centerOfMassY[i] + transform(3, 1)), (float)(originZ + bodies.centerOfMassZ[i] + transform(3, 2)), 1.0f });
+		}
+	}
+}
\ No newline at end of file
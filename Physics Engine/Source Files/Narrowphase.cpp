@@ -0,0 +1,1404 @@
+#include "Narrowphase.h"
+#include <cfloat>
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	//The GJK and EPA loops stop after this many iterations even if they have not converged.
+	static const unsigned int MAX_GJK_ITERATIONS{ 64 };
+	static const unsigned int MAX_EPA_ITERATIONS{ 64 };
+	static const unsigned int MAX_EPA_VERTICES{ MAX_EPA_ITERATIONS + 4 };
+	static const unsigned int MAX_EPA_FACES{ 2 * MAX_EPA_VERTICES };
+
+	//A point of the Minkowski difference A - B and the points of A and B it came from.
+	struct SupportPoint
+	{
+		vec3 w;
+		vec3 a;
+		vec3 b;
+	};
+
+	//A shape placed in the world. If core is true, spheres and capsules are shrunk to their point and segment.
+	struct ShapeProxy
+	{
+		const CollisionShape* shape;
+		vec3 position;
+		mat3 rotation;
+		bool core;
+	};
+
+	CollisionShape MakeSphereShape(float radius)
+	{
+		CollisionShape shape;
+		shape.type = COLLISION_SPHERE;
+		shape.radius = radius;
+		shape.halfHeight = 0.0f;
+
+		return shape;
+	}
+
+	CollisionShape MakeBoxShape(const vec3& halfExtents)
+	{
+		CollisionShape shape;
+		shape.type = COLLISION_BOX;
+		shape.halfExtents = halfExtents;
+
+		return shape;
+	}
+
+	CollisionShape MakeCapsuleShape(float radius, float halfHeight)
+	{
+		CollisionShape shape;
+		shape.type = COLLISION_CAPSULE;
+		shape.radius = radius;
+		shape.halfHeight = halfHeight;
+
+		return shape;
+	}
+
+	CollisionShape MakeCylinderShape(float radius, float halfHeight)
+	{
+		CollisionShape shape;
+		shape.type = COLLISION_CYLINDER;
+		shape.radius = radius;
+		shape.halfHeight = halfHeight;
+
+		return shape;
+	}
+
+	CollisionShape MakeConvexShape(const ConvexHull& hull)
+	{
+		CollisionShape shape;
+		shape.type = COLLISION_CONVEX;
+		shape.hull = &hull;
+
+		return shape;
+	}
+
+	void ComputeShapeBounds(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation, vec3& min, vec3& max)
+	{
+		mat3 rotation{ QuaternionToRotationMatrixRow3x3(orientation) };
+
+		//The rows of the rotation are the axes of the shape in world coordinates.
+		vec3 extents;
+		switch (shape.type)
+		{
+		case COLLISION_SPHERE:
+			extents = vec3{ shape.radius, shape.radius, shape.radius };
+			break;
+
+		case COLLISION_BOX:
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				vec3 axis{ rotation.GetRow(i) };
+				float h{ (i == 0) ? shape.halfExtents.x : ((i == 1) ? shape.halfExtents.y : shape.halfExtents.z) };
+				extents += vec3{ std::fabs(axis.x), std::fabs(axis.y), std::fabs(axis.z) } * h;
+			}
+			break;
+
+		case COLLISION_CAPSULE:
+		{
+			vec3 axis{ rotation.GetRow(1) * shape.halfHeight };
+			extents = vec3{ std::fabs(axis.x), std::fabs(axis.y), std::fabs(axis.z) } + vec3{ shape.radius, shape.radius, shape.radius };
+			break;
+		}
+
+		case COLLISION_CYLINDER:
+		{
+			//A disk of radius r with unit normal u reaches r * sqrt(1 - u_j^2) along axis j.
+			vec3 u{ rotation.GetRow(1) };
+			extents = vec3{ std::fabs(u.x) * shape.halfHeight + shape.radius * std::sqrt(std::fmax(0.0f, 1.0f - u.x * u.x)),
+				std::fabs(u.y) * shape.halfHeight + shape.radius * std::sqrt(std::fmax(0.0f, 1.0f - u.y * u.y)),
+				std::fabs(u.z) * shape.halfHeight + shape.radius * std::sqrt(std::fmax(0.0f, 1.0f - u.z * u.z)) };
+			break;
+		}
+
+		default:
+			if (shape.hull == nullptr || shape.hull->vertices.empty())
+			{
+				min = position;
+				max = position;
+				return;
+			}
+
+			min = vec3{ FLT_MAX, FLT_MAX, FLT_MAX };
+			max = vec3{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (const auto& i : shape.hull->vertices)
+			{
+				vec3 p{ i * rotation + position };
+				min = vec3{ std::fmin(min.x, p.x), std::fmin(min.y, p.y), std::fmin(min.z, p.z) };
+				max = vec3{ std::fmax(max.x, p.x), std::fmax(max.y, p.y), std::fmax(max.z, p.z) };
+			}
+			return;
+		}
+
+		min = position - extents;
+		max = position + extents;
+	}
+
+	static float GetComponent(const vec3& v, unsigned int i)
+	{
+		return (i == 0) ? v.x : ((i == 1) ? v.y : v.z);
+	}
+
+	//Returns a unit vector perpendicular to the unit vector v.
+	static vec3 Perpendicular(const vec3& v)
+	{
+		vec3 axis{ (std::fabs(v.x) < 0.57735f) ? vec3{ 1.0f, 0.0f, 0.0f } : vec3{ 0.0f, 1.0f, 0.0f } };
+
+		return MathEngine::Normalize(MathEngine::CrossProduct(v, axis));
+	}
+
+	static void SetSinglePoint(ContactManifold& manifold, const vec3& normal, const vec3& point, float depth)
+	{
+		manifold.normal = normal;
+		manifold.points[0] = point;
+		manifold.depths[0] = depth;
+		manifold.numPoints = 1;
+	}
+
+	//Returns the point on the segment from p to q closest to the point.
+	static vec3 ClosestPointOnSegment(const vec3& point, const vec3& p, const vec3& q)
+	{
+		vec3 d{ q - p };
+		float lengthSquared{ MathEngine::DotProduct(d, d) };
+		if (lengthSquared <= FLT_MIN)
+			return p;
+
+		float t{ MathEngine::DotProduct(point - p, d) / lengthSquared };
+		t = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+
+		return p + d * t;
+	}
+
+	//Finds the closest points c1 on segment p1-q1 and c2 on segment p2-q2.
+	static void ClosestPointsBetweenSegments(const vec3& p1, const vec3& q1, const vec3& p2, const vec3& q2, vec3& c1, vec3& c2)
+	{
+		vec3 d1{ q1 - p1 };
+		vec3 d2{ q2 - p2 };
+		vec3 r{ p1 - p2 };
+
+		float a{ MathEngine::DotProduct(d1, d1) };
+		float e{ MathEngine::DotProduct(d2, d2) };
+		float f{ MathEngine::DotProduct(d2, r) };
+
+		float s{ 0.0f };
+		float t{ 0.0f };
+
+		if (a <= FLT_MIN && e <= FLT_MIN)
+		{
+			c1 = p1;
+			c2 = p2;
+			return;
+		}
+
+		if (a <= FLT_MIN)
+		{
+			t = f / e;
+			t = (t < 0.0f) ? 0.0f : ((t > 1.0f) ? 1.0f : t);
+		}
+		else
+		{
+			float c{ MathEngine::DotProduct(d1, r) };
+
+			if (e <= FLT_MIN)
+			{
+				s = -c / a;
+				s = (s < 0.0f) ? 0.0f : ((s > 1.0f) ? 1.0f : s);
+			}
+			else
+			{
+				float b{ MathEngine::DotProduct(d1, d2) };
+				float denominator{ a * e - b * b };
+
+				//If the segments are parallel any s works, pick 0.
+				if (denominator > FLT_MIN)
+				{
+					s = (b * f - c * e) / denominator;
+					s = (s < 0.0f) ? 0.0f : ((s > 1.0f) ? 1.0f : s);
+				}
+
+				t = (b * s + f) / e;
+
+				if (t < 0.0f)
+				{
+					t = 0.0f;
+					s = -c / a;
+					s = (s < 0.0f) ? 0.0f : ((s > 1.0f) ? 1.0f : s);
+				}
+				else if (t > 1.0f)
+				{
+					t = 1.0f;
+					s = (b - c) / a;
+					s = (s < 0.0f) ? 0.0f : ((s > 1.0f) ? 1.0f : s);
+				}
+			}
+		}
+
+		c1 = p1 + d1 * s;
+		c2 = p2 + d2 * t;
+	}
+
+	//Sets the manifold for two spheres, or for the closest points of two cores grown by their radii.
+	//The normal points from centerA to centerB.
+	static bool CollideSpheres(const vec3& centerA, float radiusA, const vec3& centerB, float radiusB, const vec3& fallbackNormal,
+		ContactManifold& manifold)
+	{
+		vec3 d{ centerB - centerA };
+		float distanceSquared{ MathEngine::DotProduct(d, d) };
+		float radii{ radiusA + radiusB };
+
+		if (distanceSquared > radii * radii)
+			return false;
+
+		float distance{ std::sqrt(distanceSquared) };
+		vec3 normal{ (distance > 1e-6f) ? d * (1.0f / distance) : fallbackNormal };
+
+		//Halfway between the deepest points of the spheres.
+		vec3 point{ ((centerA + normal * radiusA) + (centerB - normal * radiusB)) * 0.5f };
+		SetSinglePoint(manifold, normal, point, radii - distance);
+
+		return true;
+	}
+
+	bool CollideSphereSphere(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& /*orientationA*/,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& /*orientationB*/, ContactManifold& manifold)
+	{
+		return CollideSpheres(positionA, a.radius, positionB, b.radius, vec3{ 0.0f, 1.0f, 0.0f }, manifold);
+	}
+
+	bool CollideSphereBox(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& /*orientationA*/,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		mat3 rotation{ QuaternionToRotationMatrixRow3x3(orientationB) };
+
+		//The center of the sphere in box coordinates. The rows of the rotation are the axes of the box.
+		vec3 center{ rotation * (positionA - positionB) };
+		const vec3& h{ b.halfExtents };
+
+		vec3 closest{ std::fmax(-h.x, std::fmin(center.x, h.x)), std::fmax(-h.y, std::fmin(center.y, h.y)),
+			std::fmax(-h.z, std::fmin(center.z, h.z)) };
+
+		vec3 d{ center - closest };
+		float distanceSquared{ MathEngine::DotProduct(d, d) };
+
+		if (distanceSquared > a.radius * a.radius)
+			return false;
+
+		vec3 localNormal;
+		float depth{ 0.0f };
+
+		if (distanceSquared > 1e-12f)
+		{
+			//The normal points from the sphere into the box.
+			float distance{ std::sqrt(distanceSquared) };
+			localNormal = d * (-1.0f / distance);
+			depth = a.radius - distance;
+		}
+		else
+		{
+			//The center is inside the box, push the sphere out through the nearest face.
+			float minDistance{ FLT_MAX };
+			unsigned int axis{ 0 };
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				float distance{ GetComponent(h, i) - std::fabs(GetComponent(center, i)) };
+				if (distance < minDistance)
+				{
+					minDistance = distance;
+					axis = i;
+				}
+			}
+
+			float sign{ (GetComponent(center, axis) < 0.0f) ? -1.0f : 1.0f };
+			localNormal = vec3{ (axis == 0) ? -sign : 0.0f, (axis == 1) ? -sign : 0.0f, (axis == 2) ? -sign : 0.0f };
+			closest = center - localNormal * minDistance;
+			depth = a.radius + minDistance;
+		}
+
+		vec3 normal{ localNormal * rotation };
+		vec3 boxPoint{ closest * rotation + positionB };
+		vec3 spherePoint{ positionA + normal * a.radius };
+
+		SetSinglePoint(manifold, normal, (boxPoint + spherePoint) * 0.5f, depth);
+
+		return true;
+	}
+
+	//Clips the polygon against the plane dot(n, p) <= offset. Returns the number of points in the clipped polygon.
+	static unsigned int ClipPolygon(const vec3* input, unsigned int numInput, const vec3& n, float offset, vec3* output)
+	{
+		unsigned int numOutput{ 0 };
+
+		for (unsigned int i = 0; i < numInput; ++i)
+		{
+			const vec3& p{ input[i] };
+			const vec3& q{ input[(i + 1) % numInput] };
+			float dp{ MathEngine::DotProduct(n, p) - offset };
+			float dq{ MathEngine::DotProduct(n, q) - offset };
+
+			if (dp <= 0.0f)
+				output[numOutput++] = p;
+
+			if ((dp < 0.0f && dq > 0.0f) || (dp > 0.0f && dq < 0.0f))
+				output[numOutput++] = p + (q - p) * (dp / (dp - dq));
+		}
+
+		return numOutput;
+	}
+
+	//Keeps at most MAX_MANIFOLD_POINTS points: the deepest, the one farthest from it, and the two that add the most area.
+	static void ReduceManifold(vec3* points, float* depths, unsigned int numPoints, const vec3& normal, ContactManifold& manifold)
+	{
+		if (numPoints <= MAX_MANIFOLD_POINTS)
+		{
+			for (unsigned int i = 0; i < numPoints; ++i)
+			{
+				manifold.points[i] = points[i];
+				manifold.depths[i] = depths[i];
+			}
+
+			manifold.numPoints = numPoints;
+			return;
+		}
+
+		unsigned int chosen[MAX_MANIFOLD_POINTS]{};
+
+		for (unsigned int i = 1; i < numPoints; ++i)
+		{
+			if (depths[i] > depths[chosen[0]])
+				chosen[0] = i;
+		}
+
+		float best{ -1.0f };
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			vec3 d{ points[i] - points[chosen[0]] };
+			float distanceSquared{ MathEngine::DotProduct(d, d) };
+			if (distanceSquared > best)
+			{
+				best = distanceSquared;
+				chosen[1] = i;
+			}
+		}
+
+		//The third point makes the largest triangle with the first two, the fourth the largest triangle on the other side.
+		best = -1.0f;
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			float area{ MathEngine::DotProduct(MathEngine::CrossProduct(points[chosen[0]] - points[i], points[chosen[1]] - points[i]), normal) };
+			if (area > best)
+			{
+				best = area;
+				chosen[2] = i;
+			}
+		}
+
+		best = -1.0f;
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			float area{ -MathEngine::DotProduct(MathEngine::CrossProduct(points[chosen[0]] - points[i], points[chosen[1]] - points[i]), normal) };
+			if (area > best)
+			{
+				best = area;
+				chosen[3] = i;
+			}
+		}
+
+		for (unsigned int i = 0; i < MAX_MANIFOLD_POINTS; ++i)
+		{
+			manifold.points[i] = points[chosen[i]];
+			manifold.depths[i] = depths[chosen[i]];
+		}
+
+		manifold.numPoints = MAX_MANIFOLD_POINTS;
+	}
+
+	bool CollideBoxBox(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		mat3 rotationA{ QuaternionToRotationMatrixRow3x3(orientationA) };
+		mat3 rotationB{ QuaternionToRotationMatrixRow3x3(orientationB) };
+
+		vec3 axesA[3]{ rotationA.GetRow(0), rotationA.GetRow(1), rotationA.GetRow(2) };
+		vec3 axesB[3]{ rotationB.GetRow(0), rotationB.GetRow(1), rotationB.GetRow(2) };
+		float hA[3]{ a.halfExtents.x, a.halfExtents.y, a.halfExtents.z };
+		float hB[3]{ b.halfExtents.x, b.halfExtents.y, b.halfExtents.z };
+
+		vec3 t{ positionB - positionA };
+
+		//The small epsilon keeps the edge axes of nearly parallel edges from giving false separations.
+		float r[3][3];
+		float absR[3][3];
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				r[i][j] = MathEngine::DotProduct(axesA[i], axesB[j]);
+				absR[i][j] = std::fabs(r[i][j]) + 1e-6f;
+			}
+		}
+
+		//The faces of A.
+		float faceSeparationA{ -FLT_MAX };
+		unsigned int faceA{ 0 };
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			float distance{ std::fabs(MathEngine::DotProduct(t, axesA[i])) };
+			float separation{ distance - (hA[i] + hB[0] * absR[i][0] + hB[1] * absR[i][1] + hB[2] * absR[i][2]) };
+			if (separation > 0.0f)
+				return false;
+
+			if (separation > faceSeparationA)
+			{
+				faceSeparationA = separation;
+				faceA = i;
+			}
+		}
+
+		//The faces of B.
+		float faceSeparationB{ -FLT_MAX };
+		unsigned int faceB{ 0 };
+		for (unsigned int j = 0; j < 3; ++j)
+		{
+			float distance{ std::fabs(MathEngine::DotProduct(t, axesB[j])) };
+			float separation{ distance - (hA[0] * absR[0][j] + hA[1] * absR[1][j] + hA[2] * absR[2][j] + hB[j]) };
+			if (separation > 0.0f)
+				return false;
+
+			if (separation > faceSeparationB)
+			{
+				faceSeparationB = separation;
+				faceB = j;
+			}
+		}
+
+		//The cross products of the edges.
+		float edgeSeparation{ -FLT_MAX };
+		unsigned int edgeA{ 0 };
+		unsigned int edgeB{ 0 };
+		vec3 edgeAxis;
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				vec3 axis{ MathEngine::CrossProduct(axesA[i], axesB[j]) };
+				float length{ MathEngine::Length(axis) };
+				if (length < 1e-5f)
+					continue;
+
+				axis = axis * (1.0f / length);
+
+				float radiusA{ 0.0f };
+				float radiusB{ 0.0f };
+				for (unsigned int k = 0; k < 3; ++k)
+				{
+					radiusA += hA[k] * std::fabs(MathEngine::DotProduct(axesA[k], axis));
+					radiusB += hB[k] * std::fabs(MathEngine::DotProduct(axesB[k], axis));
+				}
+
+				float separation{ std::fabs(MathEngine::DotProduct(t, axis)) - (radiusA + radiusB) };
+				if (separation > 0.0f)
+					return false;
+
+				if (separation > edgeSeparation)
+				{
+					edgeSeparation = separation;
+					edgeA = i;
+					edgeB = j;
+					edgeAxis = axis;
+				}
+			}
+		}
+
+		//Prefer the faces of A, then the faces of B, then the edges, unless the later axis is clearly better.
+		//Switching between axes with almost the same separation from one step to the next makes stacks jitter.
+		const float relativeTolerance{ 0.95f };
+		const float absoluteTolerance{ 0.01f * std::fmin(std::fmin(hA[0], hA[1]), std::fmin(hA[2], std::fmin(hB[0], std::fmin(hB[1], hB[2])))) };
+
+		bool referenceIsA{ true };
+		float faceSeparation{ faceSeparationA };
+		if (faceSeparationB > relativeTolerance * faceSeparationA + absoluteTolerance)
+		{
+			referenceIsA = false;
+			faceSeparation = faceSeparationB;
+		}
+
+		if (edgeSeparation > relativeTolerance * faceSeparation + absoluteTolerance)
+		{
+			//The normal points from A to B.
+			vec3 normal{ (MathEngine::DotProduct(t, edgeAxis) < 0.0f) ? -edgeAxis : edgeAxis };
+
+			//The edge of A farthest along the normal and the edge of B farthest against it.
+			vec3 centerA{ positionA };
+			vec3 centerB{ positionB };
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				if (k != edgeA)
+					centerA += axesA[k] * ((MathEngine::DotProduct(axesA[k], normal) > 0.0f) ? hA[k] : -hA[k]);
+
+				if (k != edgeB)
+					centerB += axesB[k] * ((MathEngine::DotProduct(axesB[k], normal) < 0.0f) ? hB[k] : -hB[k]);
+			}
+
+			vec3 closestA;
+			vec3 closestB;
+			ClosestPointsBetweenSegments(centerA - axesA[edgeA] * hA[edgeA], centerA + axesA[edgeA] * hA[edgeA],
+				centerB - axesB[edgeB] * hB[edgeB], centerB + axesB[edgeB] * hB[edgeB], closestA, closestB);
+
+			SetSinglePoint(manifold, normal, (closestA + closestB) * 0.5f, -edgeSeparation);
+
+			return true;
+		}
+
+		const vec3* referenceAxes{ referenceIsA ? axesA : axesB };
+		const vec3* incidentAxes{ referenceIsA ? axesB : axesA };
+		const float* referenceHalf{ referenceIsA ? hA : hB };
+		const float* incidentHalf{ referenceIsA ? hB : hA };
+		unsigned int referenceAxis{ referenceIsA ? faceA : faceB };
+		vec3 referencePosition{ referenceIsA ? positionA : positionB };
+		vec3 incidentPosition{ referenceIsA ? positionB : positionA };
+
+		//The normal of the reference face points towards the incident box.
+		vec3 referenceNormal{ referenceAxes[referenceAxis] };
+		if (MathEngine::DotProduct(incidentPosition - referencePosition, referenceNormal) < 0.0f)
+			referenceNormal = -referenceNormal;
+
+		//The incident face is the face of the other box most opposite to the reference normal.
+		unsigned int incidentAxis{ 0 };
+		float maxDot{ -1.0f };
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			float d{ std::fabs(MathEngine::DotProduct(incidentAxes[k], referenceNormal)) };
+			if (d > maxDot)
+			{
+				maxDot = d;
+				incidentAxis = k;
+			}
+		}
+
+		vec3 incidentNormal{ incidentAxes[incidentAxis] };
+		if (MathEngine::DotProduct(incidentNormal, referenceNormal) > 0.0f)
+			incidentNormal = -incidentNormal;
+
+		unsigned int u{ (incidentAxis + 1) % 3 };
+		unsigned int v{ (incidentAxis + 2) % 3 };
+		vec3 incidentCenter{ incidentPosition + incidentNormal * incidentHalf[incidentAxis] };
+		vec3 du{ incidentAxes[u] * incidentHalf[u] };
+		vec3 dv{ incidentAxes[v] * incidentHalf[v] };
+
+		//8 points is the most a quad clipped by 4 planes can have.
+		vec3 polygon[8]{ incidentCenter + du + dv, incidentCenter - du + dv, incidentCenter - du - dv, incidentCenter + du - dv };
+		vec3 clipped[8];
+		unsigned int numPoints{ 4 };
+
+		unsigned int side1{ (referenceAxis + 1) % 3 };
+		unsigned int side2{ (referenceAxis + 2) % 3 };
+		vec3 sides[2]{ referenceAxes[side1], referenceAxes[side2] };
+		float sideHalf[2]{ referenceHalf[side1], referenceHalf[side2] };
+
+		for (unsigned int i = 0; i < 2 && numPoints > 0; ++i)
+		{
+			float center{ MathEngine::DotProduct(sides[i], referencePosition) };
+
+			numPoints = ClipPolygon(polygon, numPoints, sides[i], center + sideHalf[i], clipped);
+			numPoints = ClipPolygon(clipped, numPoints, -sides[i], -center + sideHalf[i], polygon);
+		}
+
+		//Keep the points below the reference face.
+		float faceOffset{ MathEngine::DotProduct(referenceNormal, referencePosition) + referenceHalf[referenceAxis] };
+		vec3 points[8];
+		float depths[8];
+		unsigned int numContacts{ 0 };
+
+		for (unsigned int i = 0; i < numPoints; ++i)
+		{
+			float separation{ MathEngine::DotProduct(referenceNormal, polygon[i]) - faceOffset };
+			if (separation <= 0.0f)
+			{
+				points[numContacts] = polygon[i] - referenceNormal * (0.5f * separation);
+				depths[numContacts] = -separation;
+				++numContacts;
+			}
+		}
+
+		if (numContacts == 0)
+			return false;
+
+		vec3 normal{ referenceIsA ? referenceNormal : -referenceNormal };
+		manifold.normal = normal;
+		ReduceManifold(points, depths, numContacts, normal, manifold);
+
+		return true;
+	}
+
+	bool CollideSphereCapsule(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& /*orientationA*/,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		vec3 axis{ MathEngine::Rotate(orientationB, vec3{ 0.0f, b.halfHeight, 0.0f }) };
+		vec3 closest{ ClosestPointOnSegment(positionA, positionB - axis, positionB + axis) };
+
+		vec3 fallback{ (b.halfHeight > 0.0f) ? Perpendicular(MathEngine::Normalize(axis)) : vec3{ 0.0f, 1.0f, 0.0f } };
+
+		return CollideSpheres(positionA, a.radius, closest, b.radius, fallback, manifold);
+	}
+
+	bool CollideCapsuleCapsule(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		vec3 axisA{ MathEngine::Rotate(orientationA, vec3{ 0.0f, a.halfHeight, 0.0f }) };
+		vec3 axisB{ MathEngine::Rotate(orientationB, vec3{ 0.0f, b.halfHeight, 0.0f }) };
+		vec3 pA{ positionA - axisA };
+		vec3 qA{ positionA + axisA };
+		vec3 pB{ positionB - axisB };
+		vec3 qB{ positionB + axisB };
+
+		vec3 closestA;
+		vec3 closestB;
+		ClosestPointsBetweenSegments(pA, qA, pB, qB, closestA, closestB);
+
+		vec3 fallback{ (a.halfHeight > 0.0f) ? Perpendicular(MathEngine::Normalize(axisA)) : vec3{ 0.0f, 1.0f, 0.0f } };
+		if (!CollideSpheres(closestA, a.radius, closestB, b.radius, fallback, manifold))
+			return false;
+
+		//If the segments are parallel, add the other end of the part of the segments that overlaps.
+		float lengthA{ MathEngine::DotProduct(axisA, axisA) };
+		float lengthB{ MathEngine::DotProduct(axisB, axisB) };
+		vec3 cross{ MathEngine::CrossProduct(axisA, axisB) };
+
+		if (lengthA > FLT_MIN && lengthB > FLT_MIN && MathEngine::DotProduct(cross, cross) < 1e-6f * lengthA * lengthB)
+		{
+			//The ends of B projected onto A, as parameters from -1 to 1 along A.
+			float s1{ MathEngine::DotProduct(pB - positionA, axisA) / lengthA };
+			float s2{ MathEngine::DotProduct(qB - positionA, axisA) / lengthA };
+			float sMin{ std::fmax(-1.0f, std::fmin(s1, s2)) };
+			float sMax{ std::fmin(1.0f, std::fmax(s1, s2)) };
+
+			if (sMax - sMin > 1e-3f)
+			{
+				const vec3& normal{ manifold.normal };
+				float radii{ a.radius + b.radius };
+
+				for (unsigned int i = 0; i < 2; ++i)
+				{
+					vec3 pointA{ positionA + axisA * ((i == 0) ? sMin : sMax) };
+					vec3 pointB{ ClosestPointOnSegment(pointA, pB, qB) };
+					float depth{ radii - MathEngine::DotProduct(pointB - pointA, normal) };
+
+					manifold.points[i] = ((pointA + normal * a.radius) + (pointB - normal * b.radius)) * 0.5f;
+					manifold.depths[i] = depth;
+				}
+
+				manifold.numPoints = 2;
+			}
+		}
+
+		return true;
+	}
+
+	bool CollideSphereCylinder(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& /*orientationA*/,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		mat3 rotation{ QuaternionToRotationMatrixRow3x3(orientationB) };
+		vec3 center{ rotation * (positionA - positionB) };
+
+		float radial{ std::sqrt(center.x * center.x + center.z * center.z) };
+		vec3 closest{ center };
+		vec3 localNormal;
+		float depth{ 0.0f };
+
+		if (std::fabs(center.y) <= b.halfHeight && radial <= b.radius)
+		{
+			//The center is inside the cylinder, push the sphere out through the side or the cap that is closest.
+			float sideDistance{ b.radius - radial };
+			float capDistance{ b.halfHeight - std::fabs(center.y) };
+
+			if (sideDistance < capDistance && radial > 1e-6f)
+			{
+				localNormal = vec3{ -center.x / radial, 0.0f, -center.z / radial };
+				closest = center - localNormal * sideDistance;
+				depth = a.radius + sideDistance;
+			}
+			else
+			{
+				localNormal = vec3{ 0.0f, (center.y < 0.0f) ? 1.0f : -1.0f, 0.0f };
+				closest = center - localNormal * capDistance;
+				depth = a.radius + capDistance;
+			}
+		}
+		else
+		{
+			if (radial > b.radius)
+			{
+				closest.x = center.x * (b.radius / radial);
+				closest.z = center.z * (b.radius / radial);
+			}
+
+			closest.y = std::fmax(-b.halfHeight, std::fmin(center.y, b.halfHeight));
+
+			vec3 d{ center - closest };
+			float distanceSquared{ MathEngine::DotProduct(d, d) };
+			if (distanceSquared > a.radius * a.radius)
+				return false;
+
+			float distance{ std::sqrt(distanceSquared) };
+			localNormal = d * (-1.0f / distance);
+			depth = a.radius - distance;
+		}
+
+		vec3 normal{ localNormal * rotation };
+		vec3 cylinderPoint{ closest * rotation + positionB };
+		vec3 spherePoint{ positionA + normal * a.radius };
+
+		SetSinglePoint(manifold, normal, (cylinderPoint + spherePoint) * 0.5f, depth);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------------------------------------
+	//GJK and EPA
+
+	static float GetMargin(const CollisionShape& shape)
+	{
+		return (shape.type == COLLISION_SPHERE || shape.type == COLLISION_CAPSULE) ? shape.radius : 0.0f;
+	}
+
+	//Returns the point of the shape farthest in the direction, both in body coordinates.
+	static vec3 LocalSupport(const CollisionShape& shape, const vec3& d, bool core)
+	{
+		switch (shape.type)
+		{
+		case COLLISION_SPHERE:
+		case COLLISION_CAPSULE:
+		{
+			vec3 support{ 0.0f, (shape.type == COLLISION_CAPSULE) ? ((d.y >= 0.0f) ? shape.halfHeight : -shape.halfHeight) : 0.0f, 0.0f };
+			if (!core)
+			{
+				float length{ MathEngine::Length(d) };
+				if (length > FLT_MIN)
+					support += d * (shape.radius / length);
+			}
+
+			return support;
+		}
+
+		case COLLISION_BOX:
+			return vec3{ (d.x >= 0.0f) ? shape.halfExtents.x : -shape.halfExtents.x, (d.y >= 0.0f) ? shape.halfExtents.y : -shape.halfExtents.y,
+				(d.z >= 0.0f) ? shape.halfExtents.z : -shape.halfExtents.z };
+
+		case COLLISION_CYLINDER:
+		{
+			float radial{ std::sqrt(d.x * d.x + d.z * d.z) };
+			float y{ (d.y >= 0.0f) ? shape.halfHeight : -shape.halfHeight };
+
+			if (radial > FLT_MIN)
+				return vec3{ d.x * (shape.radius / radial), y, d.z * (shape.radius / radial) };
+
+			return vec3{ 0.0f, y, 0.0f };
+		}
+
+		default:
+			return (shape.hull != nullptr && !shape.hull->vertices.empty()) ? GetSupportPoint(*shape.hull, d) : vec3{};
+		}
+	}
+
+	static vec3 Support(const ShapeProxy& proxy, const vec3& direction)
+	{
+		return LocalSupport(*proxy.shape, proxy.rotation * direction, proxy.core) * proxy.rotation + proxy.position;
+	}
+
+	static SupportPoint Support(const ShapeProxy& a, const ShapeProxy& b, const vec3& direction)
+	{
+		SupportPoint point;
+		point.a = Support(a, direction);
+		point.b = Support(b, -direction);
+		point.w = point.a - point.b;
+
+		return point;
+	}
+
+	//Replaces the simplex with the vertices of its feature closest to the origin and returns the closest point.
+	//The weights are the barycentric coordinates of the closest point for the vertices that are left.
+	static vec3 SolveSegment(SupportPoint* simplex, float* weights, unsigned int& size)
+	{
+		const vec3& a{ simplex[0].w };
+		const vec3& b{ simplex[1].w };
+		vec3 ab{ b - a };
+
+		float t{ -MathEngine::DotProduct(a, ab) };
+		if (t <= 0.0f)
+		{
+			size = 1;
+			weights[0] = 1.0f;
+			return a;
+		}
+
+		float denominator{ MathEngine::DotProduct(ab, ab) };
+		if (t >= denominator)
+		{
+			simplex[0] = simplex[1];
+			size = 1;
+			weights[0] = 1.0f;
+			return b;
+		}
+
+		t /= denominator;
+		weights[0] = 1.0f - t;
+		weights[1] = t;
+
+		return a + ab * t;
+	}
+
+	static vec3 SolveTriangle(SupportPoint* simplex, float* weights, unsigned int& size)
+	{
+		const vec3 a{ simplex[0].w };
+		const vec3 b{ simplex[1].w };
+		const vec3 c{ simplex[2].w };
+
+		vec3 ab{ b - a };
+		vec3 ac{ c - a };
+		vec3 ap{ -a };
+
+		float d1{ MathEngine::DotProduct(ab, ap) };
+		float d2{ MathEngine::DotProduct(ac, ap) };
+		if (d1 <= 0.0f && d2 <= 0.0f)
+		{
+			size = 1;
+			weights[0] = 1.0f;
+			return a;
+		}
+
+		vec3 bp{ -b };
+		float d3{ MathEngine::DotProduct(ab, bp) };
+		float d4{ MathEngine::DotProduct(ac, bp) };
+		if (d3 >= 0.0f && d4 <= d3)
+		{
+			simplex[0] = simplex[1];
+			size = 1;
+			weights[0] = 1.0f;
+			return b;
+		}
+
+		float vc{ d1 * d4 - d3 * d2 };
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+		{
+			float t{ d1 / (d1 - d3) };
+			size = 2;
+			weights[0] = 1.0f - t;
+			weights[1] = t;
+			return a + ab * t;
+		}
+
+		vec3 cp{ -c };
+		float d5{ MathEngine::DotProduct(ab, cp) };
+		float d6{ MathEngine::DotProduct(ac, cp) };
+		if (d6 >= 0.0f && d5 <= d6)
+		{
+			simplex[0] = simplex[2];
+			size = 1;
+			weights[0] = 1.0f;
+			return c;
+		}
+
+		float vb{ d5 * d2 - d1 * d6 };
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+		{
+			float t{ d2 / (d2 - d6) };
+			simplex[1] = simplex[2];
+			size = 2;
+			weights[0] = 1.0f - t;
+			weights[1] = t;
+			return a + ac * t;
+		}
+
+		float va{ d3 * d6 - d5 * d4 };
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+		{
+			float t{ (d4 - d3) / ((d4 - d3) + (d5 - d6)) };
+			simplex[0] = simplex[1];
+			simplex[1] = simplex[2];
+			size = 2;
+			weights[0] = 1.0f - t;
+			weights[1] = t;
+			return b + (c - b) * t;
+		}
+
+		float denominator{ 1.0f / (va + vb + vc) };
+		weights[1] = vb * denominator;
+		weights[2] = vc * denominator;
+		weights[0] = 1.0f - weights[1] - weights[2];
+
+		return a + ab * weights[1] + ac * weights[2];
+	}
+
+	//Returns true if the origin is inside the tetrahedron. Otherwise reduces the simplex to the closest face, edge or vertex.
+	static bool SolveTetrahedron(SupportPoint* simplex, float* weights, unsigned int& size, vec3& closest)
+	{
+		static const unsigned int faces[4][4]{ { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 } };
+
+		float bestDistance{ FLT_MAX };
+		SupportPoint bestSimplex[3];
+		float bestWeights[3]{};
+		unsigned int bestSize{ 0 };
+		bool outside{ false };
+
+		for (const auto& i : faces)
+		{
+			const vec3& a{ simplex[i[0]].w };
+			vec3 normal{ MathEngine::CrossProduct(simplex[i[1]].w - a, simplex[i[2]].w - a) };
+
+			//The origin is outside this face if it is on the other side from the fourth vertex.
+			//If the fourth vertex is almost on the plane of the face the sides say nothing, so the face is checked anyway.
+			float originSide{ -MathEngine::DotProduct(normal, a) };
+			float vertexSide{ MathEngine::DotProduct(normal, simplex[i[3]].w - a) };
+			bool flat{ std::fabs(vertexSide) <= 1e-5f * MathEngine::Length(normal) };
+			if (!flat && originSide * vertexSide >= 0.0f)
+				continue;
+
+			outside = true;
+
+			SupportPoint face[3]{ simplex[i[0]], simplex[i[1]], simplex[i[2]] };
+			float faceWeights[3]{};
+			unsigned int faceSize{ 3 };
+			vec3 point{ SolveTriangle(face, faceWeights, faceSize) };
+
+			float distance{ MathEngine::DotProduct(point, point) };
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestSize = faceSize;
+				closest = point;
+				for (unsigned int j = 0; j < faceSize; ++j)
+				{
+					bestSimplex[j] = face[j];
+					bestWeights[j] = faceWeights[j];
+				}
+			}
+		}
+
+		if (!outside)
+			return true;
+
+		size = bestSize;
+		for (unsigned int j = 0; j < bestSize; ++j)
+		{
+			simplex[j] = bestSimplex[j];
+			weights[j] = bestWeights[j];
+		}
+
+		return false;
+	}
+
+	//Runs GJK on the two shapes. Returns true if they intersect, in which case the simplex contains the origin or touches it.
+	//Otherwise stores the closest points of the shapes in closestA and closestB.
+	static bool RunGJK(const ShapeProxy& a, const ShapeProxy& b, SupportPoint* simplex, unsigned int& size, vec3& closestA, vec3& closestB)
+	{
+		float weights[4]{ 1.0f, 0.0f, 0.0f, 0.0f };
+
+		vec3 direction{ b.position - a.position };
+		if (MathEngine::DotProduct(direction, direction) < 1e-12f)
+			direction = vec3{ 1.0f, 0.0f, 0.0f };
+
+		simplex[0] = Support(a, b, -direction);
+		size = 1;
+
+		vec3 v{ simplex[0].w };
+		float distance{ MathEngine::DotProduct(v, v) };
+
+		for (unsigned int iteration = 0; iteration < MAX_GJK_ITERATIONS; ++iteration)
+		{
+			if (distance < 1e-10f)
+				return true;
+
+			SupportPoint point{ Support(a, b, -v) };
+
+			//Stop when the new point does not get meaningfully closer to the origin than the current closest point.
+			if (distance - MathEngine::DotProduct(v, point.w) <= 1e-6f * distance)
+				break;
+
+			//A point the simplex already has cannot get closer either, and would make the simplex degenerate.
+			bool duplicate{ false };
+			for (unsigned int i = 0; i < size; ++i)
+			{
+				vec3 d{ point.w - simplex[i].w };
+				if (MathEngine::DotProduct(d, d) < 1e-10f)
+					duplicate = true;
+			}
+
+			if (duplicate)
+				break;
+
+			//Keep the simplex so it can be put back if the new one is not closer.
+			SupportPoint previousSimplex[4];
+			float previousWeights[4];
+			unsigned int previousSize{ size };
+			for (unsigned int i = 0; i < size; ++i)
+			{
+				previousSimplex[i] = simplex[i];
+				previousWeights[i] = weights[i];
+			}
+
+			simplex[size++] = point;
+
+			vec3 closest;
+			if (size == 2)
+			{
+				closest = SolveSegment(simplex, weights, size);
+			}
+			else if (size == 3)
+			{
+				closest = SolveTriangle(simplex, weights, size);
+			}
+			else if (SolveTetrahedron(simplex, weights, size, closest))
+			{
+				return true;
+			}
+
+			float newDistance{ MathEngine::DotProduct(closest, closest) };
+			if (newDistance >= distance)
+			{
+				size = previousSize;
+				for (unsigned int i = 0; i < size; ++i)
+				{
+					simplex[i] = previousSimplex[i];
+					weights[i] = previousWeights[i];
+				}
+
+				break;
+			}
+
+			v = closest;
+			distance = newDistance;
+		}
+
+		closestA = vec3{};
+		closestB = vec3{};
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			closestA += simplex[i].a * weights[i];
+			closestB += simplex[i].b * weights[i];
+		}
+
+		return distance < 1e-10f;
+	}
+
+	//Grows the simplex GJK ended with into a tetrahedron around the origin. Returns false if the shapes are flat.
+	static bool CompleteTetrahedron(const ShapeProxy& a, const ShapeProxy& b, SupportPoint* simplex, unsigned int& size)
+	{
+		static const vec3 axes[6]{ { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+
+		if (size == 1)
+		{
+			for (const auto& i : axes)
+			{
+				SupportPoint point{ Support(a, b, i) };
+				vec3 d{ point.w - simplex[0].w };
+				if (MathEngine::DotProduct(d, d) > 1e-10f)
+				{
+					simplex[size++] = point;
+					break;
+				}
+			}
+		}
+
+		if (size == 2)
+		{
+			vec3 line{ MathEngine::Normalize(simplex[1].w - simplex[0].w) };
+			vec3 u{ Perpendicular(line) };
+			vec3 v{ MathEngine::CrossProduct(line, u) };
+
+			//Try directions around the line until one gives a point off the line.
+			for (unsigned int i = 0; i < 6; ++i)
+			{
+				float angle{ i * (6.2831853f / 6.0f) };
+				SupportPoint point{ Support(a, b, u * std::cos(angle) + v * std::sin(angle)) };
+				if (MathEngine::Length(MathEngine::CrossProduct(point.w - simplex[0].w, line)) > 1e-5f)
+				{
+					simplex[size++] = point;
+					break;
+				}
+			}
+		}
+
+		if (size == 3)
+		{
+			vec3 normal{ MathEngine::CrossProduct(simplex[1].w - simplex[0].w, simplex[2].w - simplex[0].w) };
+			SupportPoint point{ Support(a, b, normal) };
+			if (std::fabs(MathEngine::DotProduct(point.w - simplex[0].w, normal)) < 1e-10f)
+				point = Support(a, b, -normal);
+
+			simplex[size++] = point;
+		}
+
+		if (size < 4)
+			return false;
+
+		vec3 e1{ simplex[1].w - simplex[0].w };
+		vec3 e2{ simplex[2].w - simplex[0].w };
+		vec3 e3{ simplex[3].w - simplex[0].w };
+
+		return std::fabs(MathEngine::DotProduct(MathEngine::CrossProduct(e1, e2), e3)) > 1e-12f;
+	}
+
+	struct EPAFace
+	{
+		unsigned int v[3];
+		vec3 normal;
+		float distance;
+		bool alive;
+	};
+
+	static bool MakeEPAFace(const SupportPoint* vertices, unsigned int v0, unsigned int v1, unsigned int v2, EPAFace& face)
+	{
+		face.v[0] = v0;
+		face.v[1] = v1;
+		face.v[2] = v2;
+		face.alive = true;
+
+		vec3 normal{ MathEngine::CrossProduct(vertices[v1].w - vertices[v0].w, vertices[v2].w - vertices[v0].w) };
+		float length{ MathEngine::Length(normal) };
+		if (length < 1e-12f)
+		{
+			face.normal = vec3{};
+			face.distance = FLT_MAX;
+			return false;
+		}
+
+		face.normal = normal * (1.0f / length);
+		face.distance = MathEngine::DotProduct(face.normal, vertices[v0].w);
+
+		return true;
+	}
+
+	//Expands the polytope from the tetrahedron until it finds the face of the Minkowski difference closest to the origin.
+	static bool RunEPA(const ShapeProxy& a, const ShapeProxy& b, const SupportPoint* tetrahedron, ContactManifold& manifold)
+	{
+		SupportPoint vertices[MAX_EPA_VERTICES];
+		EPAFace faces[MAX_EPA_FACES];
+		unsigned int numVertices{ 4 };
+		unsigned int numFaces{ 0 };
+
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			vertices[i] = tetrahedron[i];
+		}
+
+		//The faces below wind the same way around every edge. Swap two vertices if that makes them face inwards,
+		//so the faces of the tetrahedron all face outwards.
+		vec3 faceNormal{ MathEngine::CrossProduct(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w) };
+		if (MathEngine::DotProduct(faceNormal, vertices[3].w - vertices[0].w) > 0.0f)
+		{
+			SupportPoint temp{ vertices[1] };
+			vertices[1] = vertices[2];
+			vertices[2] = temp;
+		}
+
+		static const unsigned int tetrahedronFaces[4][3]{ { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+		for (const auto& i : tetrahedronFaces)
+		{
+			MakeEPAFace(vertices, i[0], i[1], i[2], faces[numFaces++]);
+		}
+
+		EPAFace* closest{ nullptr };
+
+		for (unsigned int iteration = 0; iteration < MAX_EPA_ITERATIONS; ++iteration)
+		{
+			closest = nullptr;
+			for (unsigned int i = 0; i < numFaces; ++i)
+			{
+				if (faces[i].alive && (closest == nullptr || faces[i].distance < closest->distance))
+					closest = &faces[i];
+			}
+
+			if (closest == nullptr || closest->distance == FLT_MAX)
+				return false;
+
+			SupportPoint point{ Support(a, b, closest->normal) };
+			float growth{ MathEngine::DotProduct(point.w, closest->normal) - closest->distance };
+			if (growth < 1e-4f * std::fmax(1.0f, closest->distance) || numVertices == MAX_EPA_VERTICES)
+				break;
+
+			unsigned int newVertex{ numVertices };
+			vertices[numVertices++] = point;
+
+			//Remove the faces the new point can see and remember the edges around the hole they leave.
+			unsigned int horizon[3 * MAX_EPA_FACES][2];
+			unsigned int numHorizon{ 0 };
+
+			for (unsigned int i = 0; i < numFaces; ++i)
+			{
+				EPAFace& face{ faces[i] };
+				if (!face.alive || MathEngine::DotProduct(face.normal, point.w) - face.distance <= 1e-6f)
+					continue;
+
+				face.alive = false;
+				for (unsigned int j = 0; j < 3; ++j)
+				{
+					unsigned int from{ face.v[j] };
+					unsigned int to{ face.v[(j + 1) % 3] };
+
+					//An edge shared by two removed faces appears once in each direction, so it is not on the horizon.
+					bool shared{ false };
+					for (unsigned int k = 0; k < numHorizon; ++k)
+					{
+						if (horizon[k][0] == to && horizon[k][1] == from)
+						{
+							horizon[k][0] = horizon[numHorizon - 1][0];
+							horizon[k][1] = horizon[numHorizon - 1][1];
+							--numHorizon;
+							shared = true;
+							break;
+						}
+					}
+
+					if (!shared)
+					{
+						horizon[numHorizon][0] = from;
+						horizon[numHorizon][1] = to;
+						++numHorizon;
+					}
+				}
+			}
+
+			//Compact the faces so the new ones fit.
+			unsigned int numAlive{ 0 };
+			for (unsigned int i = 0; i < numFaces; ++i)
+			{
+				if (faces[i].alive)
+					faces[numAlive++] = faces[i];
+			}
+			numFaces = numAlive;
+
+			if (numFaces + numHorizon > MAX_EPA_FACES)
+				break;
+
+			for (unsigned int i = 0; i < numHorizon; ++i)
+			{
+				MakeEPAFace(vertices, horizon[i][0], horizon[i][1], newVertex, faces[numFaces++]);
+			}
+		}
+
+		closest = nullptr;
+		for (unsigned int i = 0; i < numFaces; ++i)
+		{
+			if (faces[i].alive && (closest == nullptr || faces[i].distance < closest->distance))
+				closest = &faces[i];
+		}
+
+		if (closest == nullptr || closest->distance == FLT_MAX)
+			return false;
+
+		//The barycentric coordinates of the projection of the origin onto the face give the points on A and B.
+		const SupportPoint& p0{ vertices[closest->v[0]] };
+		const SupportPoint& p1{ vertices[closest->v[1]] };
+		const SupportPoint& p2{ vertices[closest->v[2]] };
+		vec3 projection{ closest->normal * closest->distance };
+
+		vec3 n{ MathEngine::CrossProduct(p1.w - p0.w, p2.w - p0.w) };
+		float area{ MathEngine::DotProduct(n, n) };
+		float w1{ MathEngine::DotProduct(MathEngine::CrossProduct(projection - p0.w, p2.w - p0.w), n) / area };
+		float w2{ MathEngine::DotProduct(MathEngine::CrossProduct(p1.w - p0.w, projection - p0.w), n) / area };
+		float w0{ 1.0f - w1 - w2 };
+
+		vec3 pointA{ p0.a * w0 + p1.a * w1 + p2.a * w2 };
+		vec3 pointB{ p0.b * w0 + p1.b * w1 + p2.b * w2 };
+
+		//The face normal points out of A - B, moving B along it separates the shapes.
+		SetSinglePoint(manifold, closest->normal, (pointA + pointB) * 0.5f, closest->distance);
+
+		return true;
+	}
+
+	bool CollideGJK(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		ShapeProxy proxyA{ &a, positionA, QuaternionToRotationMatrixRow3x3(orientationA), true };
+		ShapeProxy proxyB{ &b, positionB, QuaternionToRotationMatrixRow3x3(orientationB), true };
+
+		float marginA{ GetMargin(a) };
+		float marginB{ GetMargin(b) };
+
+		SupportPoint simplex[4];
+		unsigned int size{ 0 };
+		vec3 closestA;
+		vec3 closestB;
+
+		if (!RunGJK(proxyA, proxyB, simplex, size, closestA, closestB))
+		{
+			//The cores are apart, so the shapes touch only if the gap is smaller than the margins.
+			if (marginA + marginB <= 0.0f)
+				return false;
+
+			vec3 fallback{ MathEngine::Normalize(positionB - positionA) };
+			return CollideSpheres(closestA, marginA, closestB, marginB, fallback, manifold);
+		}
+
+		//The cores overlap, run GJK again on the full shapes to start EPA from.
+		if (marginA + marginB > 0.0f)
+		{
+			proxyA.core = false;
+			proxyB.core = false;
+
+			if (!RunGJK(proxyA, proxyB, simplex, size, closestA, closestB))
+				return false;
+		}
+
+		if (!CompleteTetrahedron(proxyA, proxyB, simplex, size))
+			return false;
+
+		return RunEPA(proxyA, proxyB, simplex, manifold);
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------------------------------------
+
+	//Calls the function with A and B swapped and flips the normal, so each pair only needs a function for one order.
+	template<CollideFunction function>
+	static bool CollideSwapped(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		if (!function(b, positionB, orientationB, a, positionA, orientationA, manifold))
+			return false;
+
+		manifold.normal = -manifold.normal;
+
+		return true;
+	}
+
+	//The functions for each pair of shape types, indexed by the type of A and then the type of B.
+	static const CollideFunction collideFunctions[NUM_COLLISION_SHAPES][NUM_COLLISION_SHAPES]
+	{
+		//COLLISION_SPHERE
+		{ CollideSphereSphere, CollideSphereBox, CollideSphereCapsule, CollideSphereCylinder, CollideGJK },
+
+		//COLLISION_BOX
+		{ CollideSwapped<CollideSphereBox>, CollideBoxBox, CollideGJK, CollideGJK, CollideGJK },
+
+		//COLLISION_CAPSULE
+		{ CollideSwapped<CollideSphereCapsule>, CollideGJK, CollideCapsuleCapsule, CollideGJK, CollideGJK },
+
+		//COLLISION_CYLINDER
+		{ CollideSwapped<CollideSphereCylinder>, CollideGJK, CollideGJK, CollideGJK, CollideGJK },
+
+		//COLLISION_CONVEX
+		{ CollideGJK, CollideGJK, CollideGJK, CollideGJK, CollideGJK }
+	};
+
+	CollideFunction GetCollideFunction(CollisionShapeType a, CollisionShapeType b)
+	{
+		if (a >= NUM_COLLISION_SHAPES || b >= NUM_COLLISION_SHAPES)
+			return nullptr;
+
+		return collideFunctions[a][b];
+	}
+
+	bool Collide(const CollisionShape& a, const vec3& positionA, const MathEngine::Quaternion& orientationA,
+		const CollisionShape& b, const vec3& positionB, const MathEngine::Quaternion& orientationB, ContactManifold& manifold)
+	{
+		CollideFunction function{ GetCollideFunction(a.type, b.type) };
+		if (function == nullptr)
+			return false;
+
+		return function(a, positionA, orientationA, b, positionB, orientationB, manifold);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#include "ParticleSystem.h"
+#include "ForceFunctions.h"
+#include <xmmintrin.h>
+#include <cmath>
+
+namespace PhysicsEngine
+{
+	bool IntegrateParticles(ParticleArrays& particles, unsigned int first, unsigned int count, const vec3& gravity,
+		float k1, float k2, float inverseMass, float dt)
+	{
+		unsigned int i{ first };
+		unsigned int end{ first + count };
+
+		if (end > particles.numParticles)
+			end = particles.numParticles;
+
+		float* positionX{ particles.positionX.data() };
+		float* positionY{ particles.positionY.data() };
+		float* positionZ{ particles.positionZ.data() };
+		float* velocityX{ particles.velocityX.data() };
+		float* velocityY{ particles.velocityY.data() };
+		float* velocityZ{ particles.velocityZ.data() };
+		float* lifetime{ particles.lifetime.data() };
+
+		//Drag is F = -v(k1 + k2|v|), so the drag acceleration is -v(k1 + k2|v|) / m.
+		//Scaling the coefficients by dt / m gives the change in velocity directly.
+		float c1{ k1 * inverseMass * dt };
+		float c2{ k2 * inverseMass * dt };
+
+		__m128 gx{ _mm_set1_ps(gravity.x * dt) };
+		__m128 gy{ _mm_set1_ps(gravity.y * dt) };
+		__m128 gz{ _mm_set1_ps(gravity.z * dt) };
+		__m128 sc1{ _mm_set1_ps(c1) };
+		__m128 sc2{ _mm_set1_ps(c2) };
+		__m128 sdt{ _mm_set1_ps(dt) };
+		__m128 zero{ _mm_setzero_ps() };
+		__m128 dead{ _mm_setzero_ps() };
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 vx{ _mm_loadu_ps(velocityX + i) };
+			__m128 vy{ _mm_loadu_ps(velocityY + i) };
+			__m128 vz{ _mm_loadu_ps(velocityZ + i) };
+
+			__m128 speed{ _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz))) };
+			__m128 k{ _mm_add_ps(sc1, _mm_mul_ps(sc2, speed)) };
+
+			//v = v + a * dt
+			vx = _mm_add_ps(_mm_sub_ps(vx, _mm_mul_ps(vx, k)), gx);
+			vy = _mm_add_ps(_mm_sub_ps(vy, _mm_mul_ps(vy, k)), gy);
+			vz = _mm_add_ps(_mm_sub_ps(vz, _mm_mul_ps(vz, k)), gz);
+
+			_mm_storeu_ps(velocityX + i, vx);
+			_mm_storeu_ps(velocityY + i, vy);
+			_mm_storeu_ps(velocityZ + i, vz);
+
+			//x = x + v * dt
+			_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, sdt)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, sdt)));
+			_mm_storeu_ps(positionZ + i, _mm_add_ps(_mm_loadu_ps(positionZ + i), _mm_mul_ps(vz, sdt)));
+
+			__m128 life{ _mm_sub_ps(_mm_loadu_ps(lifetime + i), sdt) };
+			_mm_storeu_ps(lifetime + i, life);
+
+			dead = _mm_or_ps(dead, _mm_cmple_ps(life, zero));
+		}
+
+		bool anyDead{ _mm_movemask_ps(dead) != 0 };
+
+		//remaining particles
+		for (; i < end; ++i)
+		{
+			vec3 v{ velocityX[i], velocityY[i], velocityZ[i] };
+			float k{ c1 + c2 * MathEngine::Length(v) };
+
+			velocityX[i] += -v.x * k + gravity.x * dt;
+			velocityY[i] += -v.y * k + gravity.y * dt;
+			velocityZ[i] += -v.z * k + gravity.z * dt;
+
+			positionX[i] += velocityX[i] * dt;
+			positionY[i] += velocityY[i] * dt;
+			positionZ[i] += velocityZ[i] * dt;
+
+			lifetime[i] -= dt;
+
+			if (lifetime[i] <= 0.0f)
+				anyDead = true;
+		}
+
+		return anyDead;
+	}
+
+	void RemoveDeadParticles(ParticleArrays& particles)
+	{
+		unsigned int i{ 0 };
+		unsigned int numParticles{ particles.numParticles };
+
+		const float* lifetime{ particles.lifetime.data() };
+
+		while (i < numParticles)
+		{
+			if (lifetime[i] > 0.0f)
+			{
+				++i;
+				continue;
+			}
+
+			//Move the last alive particle into the slot of the dead particle.
+			//The particle that got moved has not been checked yet, so i is not incremented.
+			--numParticles;
+
+			particles.positionX[i] = particles.positionX[numParticles];
+			particles.positionY[i] = particles.positionY[numParticles];
+			particles.positionZ[i] = particles.positionZ[numParticles];
+
+			particles.velocityX[i] = particles.velocityX[numParticles];
+			particles.velocityY[i] = particles.velocityY[numParticles];
+			particles.velocityZ[i] = particles.velocityZ[numParticles];
+
+			particles.lifetime[i] = particles.lifetime[numParticles];
+
+			particles.colorR[i] = particles.colorR[numParticles];
+			particles.colorG[i] = particles.colorG[numParticles];
+			particles.colorB[i] = particles.colorB[numParticles];
+			particles.colorA[i] = particles.colorA[numParticles];
+		}
+
+		particles.numParticles = numParticles;
+	}
+
+	ParticleSystem::ParticleSystem() : mK1{ 0.0f }, mK2{ 0.0f }, mInverseMass{ 1.0f }, mParticleSize{ 1.0f },
+		mMaxParticles{ 0 }, mRandomState{ 0x12345678 }
+	{}
+
+	ParticleSystem::ParticleSystem(unsigned int maxParticles) : ParticleSystem()
+	{
+		InitializeParticleSystem(maxParticles);
+	}
+
+	void ParticleSystem::InitializeParticleSystem(unsigned int maxParticles)
+	{
+		mMaxParticles = maxParticles;
+
+		std::vector<float>* arrays[]{ &mParticles.positionX, &mParticles.positionY, &mParticles.positionZ,
+			&mParticles.velocityX, &mParticles.velocityY, &mParticles.velocityZ,
+			&mParticles.lifetime,
+			&mParticles.colorR, &mParticles.colorG, &mParticles.colorB, &mParticles.colorA };
+
+		for (auto& i : arrays)
+		{
+			i->assign(maxParticles, 0.0f);
+		}
+
+		mParticles.numParticles = 0;
+
+		mInstances.resize(maxParticles);
+	}
+
+	unsigned int ParticleSystem::AddEmitter(const ParticleEmitter& emitter)
+	{
+		mEmitters.push_back(emitter);
+		mEmissionAccumulators.push_back(0.0f);
+
+		return (unsigned int)mEmitters.size() - 1;
+	}
+
+	ParticleEmitter& ParticleSystem::GetEmitter(unsigned int index)
+	{
+		return mEmitters.at(index);
+	}
+
+	unsigned int ParticleSystem::GetNumberOfEmitters() const
+	{
+		return (unsigned int)mEmitters.size();
+	}
+
+	void ParticleSystem::SetGravity(float gravityAcceleration, const vec3& direction)
+	{
+		//The gravitational force on a particle with a mass of 1 is its gravity acceleration vector.
+		mGravity = GravitationalForce(1.0f, gravityAcceleration, direction);
+	}
+
+	void ParticleSystem::SetDrag(float k1, float k2)
+	{
+		mK1 = k1;
+		mK2 = k2;
+	}
+
+	void ParticleSystem::SetParticleMass(float mass)
+	{
+		mInverseMass = (mass > 0.0f) ? 1.0f / mass : 1.0f;
+	}
+
+	void ParticleSystem::SetParticleSize(float size)
+	{
+		mParticleSize = size;
+	}
+
+	void ParticleSystem::Emit(unsigned int emitterIndex, unsigned int count)
+	{
+		const ParticleEmitter& emitter{ mEmitters.at(emitterIndex) };
+
+		unsigned int available{ mMaxParticles - mParticles.numParticles };
+		if (count > available)
+			count = available;
+
+		//orthonormal basis around the emission direction
+		vec3 direction{ MathEngine::Normalize(emitter.direction) };
+		vec3 helper{ (std::abs(direction.x) < 0.9f) ? vec3{ 1.0f, 0.0f, 0.0f } : vec3{ 0.0f, 1.0f, 0.0f } };
+		vec3 u{ MathEngine::Normalize(MathEngine::CrossProduct(helper, direction)) };
+		vec3 w{ MathEngine::CrossProduct(direction, u) };
+
+		float minCos{ std::cos(emitter.spreadAngle * PI / 180.0f) };
+
+		for (unsigned int n = 0; n < count; ++n)
+		{
+			unsigned int i{ mParticles.numParticles++ };
+
+			//uniform direction inside the cone
+			float cosTheta{ RandomFloat(minCos, 1.0f) };
+			float sinTheta{ std::sqrt(1.0f - cosTheta * cosTheta) };
+			float phi{ RandomFloat(0.0f, PI2) };
+
+			vec3 velocity{ (direction * cosTheta + (u * std::cos(phi) + w * std::sin(phi)) * sinTheta) *
+				RandomFloat(emitter.minSpeed, emitter.maxSpeed) };
+
+			mParticles.positionX[i] = emitter.position.x;
+			mParticles.positionY[i] = emitter.position.y;
+			mParticles.positionZ[i] = emitter.position.z;
+
+			mParticles.velocityX[i] = velocity.x;
+			mParticles.velocityY[i] = velocity.y;
+			mParticles.velocityZ[i] = velocity.z;
+
+			mParticles.lifetime[i] = RandomFloat(emitter.minLifetime, emitter.maxLifetime);
+
+			mParticles.colorR[i] = emitter.color.x;
+			mParticles.colorG[i] = emitter.color.y;
+			mParticles.colorB[i] = emitter.color.z;
+			mParticles.colorA[i] = emitter.color.w;
+		}
+	}
+
+	void ParticleSystem::Update(float dt)
+	{
+		//Only scan for dead particles when the integration found at least one.
+		if (IntegrateParticles(mParticles, 0, mParticles.numParticles, mGravity, mK1, mK2, mInverseMass, dt))
+			RemoveDeadParticles(mParticles);
+
+		unsigned int numEmitters{ (unsigned int)mEmitters.size() };
+		for (unsigned int i = 0; i < numEmitters; ++i)
+		{
+			//Keep the fractional part so low emission rates still emit over several updates.
+			mEmissionAccumulators[i] += mEmitters[i].emissionRate * dt;
+
+			unsigned int count{ (unsigned int)mEmissionAccumulators[i] };
+			mEmissionAccumulators[i] -= (float)count;
+
+			Emit(i, count);
+		}
+	}
+
+	void ParticleSystem::Clear()
+	{
+		mParticles.numParticles = 0;
+	}
+
+	unsigned int ParticleSystem::GetNumberOfParticles() const
+	{
+		return mParticles.numParticles;
+	}
+
+	unsigned int ParticleSystem::GetMaxParticles() const
+	{
+		return mMaxParticles;
+	}
+
+	const ParticleArrays& ParticleSystem::GetParticles() const
+	{
+		return mParticles;
+	}
+
+	const std::vector<ParticleInstance>& ParticleSystem::GetInstances()
+	{
+		unsigned int numParticles{ mParticles.numParticles };
+
+		unsigned int i{ 0 };
+		float* instances{ (float*)mInstances.data() };
+
+		//Transpose 4 particles at a time from SoA to the instance layout.
+		//Each instance is 8 floats, position and size followed by the color.
+		__m128 size{ _mm_set1_ps(mParticleSize) };
+
+		for (; i + 4 <= numParticles; i += 4)
+		{
+			__m128 x{ _mm_loadu_ps(mParticles.positionX.data() + i) };
+			__m128 y{ _mm_loadu_ps(mParticles.positionY.data() + i) };
+			__m128 z{ _mm_loadu_ps(mParticles.positionZ.data() + i) };
+			__m128 s{ size };
+			_MM_TRANSPOSE4_PS(x, y, z, s);
+
+			__m128 r{ _mm_loadu_ps(mParticles.colorR.data() + i) };
+			__m128 g{ _mm_loadu_ps(mParticles.colorG.data() + i) };
+			__m128 b{ _mm_loadu_ps(mParticles.colorB.data() + i) };
+			__m128 a{ _mm_loadu_ps(mParticles.colorA.data() + i) };
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			float* instance{ instances + i * 8 };
+			_mm_storeu_ps(instance, x);
+			_mm_storeu_ps(instance + 4, r);
+			_mm_storeu_ps(instance + 8, y);
+			_mm_storeu_ps(instance + 12, g);
+			_mm_storeu_ps(instance + 16, z);
+			_mm_storeu_ps(instance + 20, b);
+			_mm_storeu_ps(instance + 24, s);
+			_mm_storeu_ps(instance + 28, a);
+		}
+
+		//remaining particles
+		for (; i < numParticles; ++i)
+		{
+			mInstances[i].position.x = mParticles.positionX[i];
+			mInstances[i].position.y = mParticles.positionY[i];
+			mInstances[i].position.z = mParticles.positionZ[i];
+			mInstances[i].size = mParticleSize;
+			mInstances[i].color.x = mParticles.colorR[i];
+			mInstances[i].color.y = mParticles.colorG[i];
+			mInstances[i].color.z = mParticles.colorB[i];
+			mInstances[i].color.w = mParticles.colorA[i];
+		}
+
+		return mInstances;
+	}
+
+	float ParticleSystem::RandomFloat(float min, float max)
+	{
+		//xorshift32
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+
+		return min + (max - min) * ((mRandomState >> 8) * (1.0f / 16777216.0f));
+	}
+}
\ No newline at end of file
@@ -228,4 +228,42 @@ namespace PhysicsEngine
 		bodyInertia(2, 1) = bodyInertia(1, 2);
 		bodyInertia(2, 2) = (float)(worldInertia(2, 2) - mass * (cm.x * cm.x + cm.y * cm.y));//Izz - m(cm.x^2 + cm.y^2)
 	}
+
+	void ComputeMassProperties(const std::vector<ShapesEngine::Triangle>& triangles, MassProperties& massProperties)
+	{
+		mat3 bodyInertia;
+		ComputeMassProperties(triangles, massProperties.mass, massProperties.centerOfMass, bodyInertia);
+
+		//I = trace(C)I - C and trace(I) = 2trace(C), so C = (trace(I) / 2)I - I
+		float halfTrace{ 0.5f * (bodyInertia(0, 0) + bodyInertia(1, 1) + bodyInertia(2, 2)) };
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				massProperties.covariance(i, j) = ((i == j) ? halfTrace : 0.0f) - bodyInertia(i, j);
+			}
+		}
+	}
+
+	void ScaleMassProperties(const MassProperties& massProperties, const mat3& scale, double& mass, vec3& cm, mat3& bodyInertia)
+	{
+		double determinant{ MathEngine::Determinant(scale) };
+		if (determinant < 0.0)
+			determinant = -determinant;
+
+		mass = massProperties.mass * determinant;
+		cm = massProperties.centerOfMass * scale;
+
+		mat3 covariance{ (float)determinant * (MathEngine::Transpose(scale) * massProperties.covariance * scale) };
+		float trace{ covariance(0, 0) + covariance(1, 1) + covariance(2, 2) };
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				bodyInertia(i, j) = ((i == j) ? trace : 0.0f) - covariance(i, j);
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "PrimitiveMassProperties.h"
+
+namespace PhysicsEngine
+{
+	void ComputeMassProperties(PrimitiveType type, MassProperties& massProperties)
+	{
+		const double pi{ 3.14159265358979323846 };
+
+		//The covariance of each primitive is diagonal, C = diag(Cxx, Cyy, Czz), where Cxx is the integral of (x - cm.x)^2 over the volume.
+		double mass{ 0.0 };
+		double cmY{ 0.0 };
+		double cxx{ 0.0 };
+		double cyy{ 0.0 };
+
+		switch (type)
+		{
+		case PRIMITIVE_BOX:
+			//V = 1, Cxx = Cyy = Czz = V / 12
+			mass = 1.0;
+			cxx = mass / 12.0;
+			cyy = cxx;
+			break;
+
+		case PRIMITIVE_CONE:
+			//V = pi / 3, the center of mass is a quarter of the height above the base.
+			//Cxx = Czz = 3Vr^2 / 20, Cyy = 3Vh^2 / 80
+			mass = pi / 3.0;
+			cmY = -0.25;
+			cxx = 3.0 * mass / 20.0;
+			cyy = 3.0 * mass / 80.0;
+			break;
+
+		case PRIMITIVE_CYLINDER:
+			//V = pi, Cxx = Czz = Vr^2 / 4, Cyy = Vh^2 / 12
+			mass = pi;
+			cxx = mass / 4.0;
+			cyy = mass / 12.0;
+			break;
+
+		case PRIMITIVE_SPHERE:
+			//V = 4pi / 3, Cxx = Cyy = Czz = Vr^2 / 5
+			mass = 4.0 * pi / 3.0;
+			cxx = mass / 5.0;
+			cyy = cxx;
+			break;
+
+		case PRIMITIVE_PYRAMID:
+			//V = 1 / 3, the center of mass is a quarter of the height above the base.
+			//Cxx = Czz = Va^2 / 20 for a base with sides a, Cyy = 3Vh^2 / 80 like the cone.
+			mass = 1.0 / 3.0;
+			cmY = -0.25;
+			cxx = mass / 20.0;
+			cyy = 3.0 * mass / 80.0;
+			break;
+
+		default:
+			break;
+		}
+
+		massProperties.mass = mass;
+		massProperties.centerOfMass = vec3{ 0.0f, (float)cmY, 0.0f };
+		massProperties.covariance = mat3();
+		massProperties.covariance(0, 0) = (float)cxx;
+		massProperties.covariance(1, 1) = (float)cyy;
+		massProperties.covariance(2, 2) = (float)cxx;
+	}
+
+	void ComputeCapsuleMassProperties(float radius, float halfHeight, MassProperties& massProperties)
+	{
+		const double pi{ 3.14159265358979323846 };
+
+		double r{ radius };
+		double h{ 2.0 * halfHeight };
+		double hh{ halfHeight };
+
+		//The cylinder in the middle and the two caps, which together make a sphere.
+		double cylinderVolume{ pi * r * r * h };
+		double sphereVolume{ 4.0 * pi * r * r * r / 3.0 };
+
+		//Cxx = Czz = Vc r^2 / 4 + Vs r^2 / 5
+		//Cyy = Vc h^2 / 12 + Vs (r^2 / 5 + 3 hh r / 4 + hh^2), each cap is a half sphere whose flat side is hh from the center.
+		double cxx{ cylinderVolume * r * r / 4.0 + sphereVolume * r * r / 5.0 };
+		double cyy{ cylinderVolume * h * h / 12.0 + sphereVolume * (r * r / 5.0 + 3.0 * hh * r / 4.0 + hh * hh) };
+
+		massProperties.mass = cylinderVolume + sphereVolume;
+		massProperties.centerOfMass = vec3{ 0.0f, 0.0f, 0.0f };
+		massProperties.covariance = mat3();
+		massProperties.covariance(0, 0) = (float)cxx;
+		massProperties.covariance(1, 1) = (float)cyy;
+		massProperties.covariance(2, 2) = (float)cxx;
+	}
+}
\ No newline at end of file
@@ -39,6 +39,38 @@ namespace PhysicsEngine
 		mNetTorque = vec3{ 0.0f, 0.0f, 0.0f };
 	}
 
+	void RigidBody::InitializeRigidBody(float massDensity, const MathEngine::Quaternion& initialOrientation,
+		const MassProperties& massProperties, const mat3& scale)
+	{
+		if (massDensity <= 0.0f)
+		{
+			mMass = 0.0f;
+			mInverseMass = 0.0f;
+
+			SetOrientation(initialOrientation);
+		}
+		else
+		{
+			double mass{ 0.0 };
+			vec3 cm;
+			mat3 bodyInertiaTensor;
+
+			ScaleMassProperties(massProperties, scale, mass, cm, bodyInertiaTensor);
+
+			SetMass((float)(mass * massDensity));
+
+			mCenterOfMass = cm;
+
+			SetOrientation(initialOrientation);
+			SetBodyInertiaTensor(massDensity * bodyInertiaTensor);
+		}
+
+		SetLinearMomentum(vec3{ 0.0f, 0.0f, 0.0f });
+		SetAngularMomentum(vec3{ 0.0f, 0.0f, 0.0f });
+		mNetForce = vec3{ 0.0f, 0.0f, 0.0f };
+		mNetTorque = vec3{ 0.0f, 0.0f, 0.0f };
+	}
+
 	float RigidBody::GetMass() const
 	{
 		return mMass;
@@ -145,9 +177,24 @@ namespace PhysicsEngine
 		mInverseWorldCMInertiaTensor = Inverse(mWorldCMInertiaTensor);
 	}
 
+	void RigidBody::SetInverseBodyInertiaTensor(const MathEngine::Matrix3x3& inverseBodyInertia)
+	{
+		mInverseBodyInertiaTensor = inverseBodyInertia;
+		mBodyInertiaTensor = Inverse(mInverseBodyInertiaTensor);
+
+		MathEngine::Matrix3x3 rOrientation(QuaternionToRotationMatrixRow3x3(mOrientation));
+		mWorldCMInertiaTensor = rOrientation * mBodyInertiaTensor * Transpose(rOrientation);
+		mInverseWorldCMInertiaTensor = Inverse(mWorldCMInertiaTensor);
+	}
+
 	void RigidBody::SetOrientation(const MathEngine::Quaternion& orientation)
 	{
-		mOrientation = Normalize(orientation);
+		SetUnitOrientation(Normalize(orientation));
+	}
+
+	void RigidBody::SetUnitOrientation(const MathEngine::Quaternion& orientation)
+	{
+		mOrientation = orientation;
 
 		if (mInverseMass > 0)
 		{
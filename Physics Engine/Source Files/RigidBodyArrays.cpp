@@ -0,0 +1,288 @@
+#include "RigidBodyArrays.h"
+
+//Keep the compiler from fusing multiplies and adds into FMA instructions, so every build integrates the bodies the same way.
+#if defined(_MSC_VER)
+#pragma fp_contract (off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+namespace PhysicsEngine
+{
+	//Calls the specified function on every array of the RigidBodyArrays object.
+	template<typename Function>
+	static void ForEachArray(RigidBodyArrays& bodies, Function function)
+	{
+		std::vector<float>* arrays[]{ &bodies.mass, &bodies.inverseMass,
+			&bodies.centerOfMassX, &bodies.centerOfMassY, &bodies.centerOfMassZ,
+			&bodies.orientationW, &bodies.orientationX, &bodies.orientationY, &bodies.orientationZ,
+			&bodies.linearVelocityX, &bodies.linearVelocityY, &bodies.linearVelocityZ,
+			&bodies.linearMomentumX, &bodies.linearMomentumY, &bodies.linearMomentumZ,
+			&bodies.angularVelocityX, &bodies.angularVelocityY, &bodies.angularVelocityZ,
+			&bodies.angularMomentumX, &bodies.angularMomentumY, &bodies.angularMomentumZ,
+			&bodies.inverseBodyInertiaXX, &bodies.inverseBodyInertiaYY, &bodies.inverseBodyInertiaZZ,
+			&bodies.inverseBodyInertiaXY, &bodies.inverseBodyInertiaXZ, &bodies.inverseBodyInertiaYZ,
+			&bodies.netForceX, &bodies.netForceY, &bodies.netForceZ,
+			&bodies.netTorqueX, &bodies.netTorqueY, &bodies.netTorqueZ };
+
+		for (auto& i : arrays)
+		{
+			function(*i);
+		}
+	}
+
+	unsigned int GetNumberOfBodies(const RigidBodyArrays& bodies)
+	{
+		return (unsigned int)bodies.mass.size();
+	}
+
+	void ReserveBodies(RigidBodyArrays& bodies, unsigned int numBodies)
+	{
+		ForEachArray(bodies, [numBodies](std::vector<float>& array) { array.reserve(numBodies); });
+	}
+
+	void ClearBodies(RigidBodyArrays& bodies)
+	{
+		ForEachArray(bodies, [](std::vector<float>& array) { array.clear(); });
+	}
+
+	unsigned int AddRigidBody(RigidBodyArrays& bodies, const RigidBody& body)
+	{
+		unsigned int index{ GetNumberOfBodies(bodies) };
+
+		ForEachArray(bodies, [](std::vector<float>& array) { array.push_back(0.0f); });
+
+		LoadRigidBody(bodies, index, body);
+
+		return index;
+	}
+
+	void LoadRigidBody(RigidBodyArrays& bodies, unsigned int index, const RigidBody& body)
+	{
+		bodies.mass[index] = body.GetMass();
+		bodies.inverseMass[index] = body.GetInverseMass();
+
+		const vec3& centerOfMass{ body.GetCenterOfMass() };
+		bodies.centerOfMassX[index] = centerOfMass.x;
+		bodies.centerOfMassY[index] = centerOfMass.y;
+		bodies.centerOfMassZ[index] = centerOfMass.z;
+
+		const MathEngine::Quaternion& orientation{ body.GetOrientation() };
+		bodies.orientationW[index] = orientation.scalar;
+		bodies.orientationX[index] = orientation.vector.x;
+		bodies.orientationY[index] = orientation.vector.y;
+		bodies.orientationZ[index] = orientation.vector.z;
+
+		const vec3& linearVelocity{ body.GetLinearVelocity() };
+		bodies.linearVelocityX[index] = linearVelocity.x;
+		bodies.linearVelocityY[index] = linearVelocity.y;
+		bodies.linearVelocityZ[index] = linearVelocity.z;
+
+		const vec3& linearMomentum{ body.GetLinearMomentum() };
+		bodies.linearMomentumX[index] = linearMomentum.x;
+		bodies.linearMomentumY[index] = linearMomentum.y;
+		bodies.linearMomentumZ[index] = linearMomentum.z;
+
+		const vec3& angularVelocity{ body.GetAngularVelocity() };
+		bodies.angularVelocityX[index] = angularVelocity.x;
+		bodies.angularVelocityY[index] = angularVelocity.y;
+		bodies.angularVelocityZ[index] = angularVelocity.z;
+
+		const vec3& angularMomentum{ body.GetAngularMomentum() };
+		bodies.angularMomentumX[index] = angularMomentum.x;
+		bodies.angularMomentumY[index] = angularMomentum.y;
+		bodies.angularMomentumZ[index] = angularMomentum.z;
+
+		const mat3& inverseBodyInertia{ body.GetInverseBodyInertiaTensor() };
+		bodies.inverseBodyInertiaXX[index] = inverseBodyInertia(0, 0);
+		bodies.inverseBodyInertiaYY[index] = inverseBodyInertia(1, 1);
+		bodies.inverseBodyInertiaZZ[index] = inverseBodyInertia(2, 2);
+		bodies.inverseBodyInertiaXY[index] = inverseBodyInertia(0, 1);
+		bodies.inverseBodyInertiaXZ[index] = inverseBodyInertia(0, 2);
+		bodies.inverseBodyInertiaYZ[index] = inverseBodyInertia(1, 2);
+
+		bodies.netForceX[index] = 0.0f;
+		bodies.netForceY[index] = 0.0f;
+		bodies.netForceZ[index] = 0.0f;
+
+		bodies.netTorqueX[index] = 0.0f;
+		bodies.netTorqueY[index] = 0.0f;
+		bodies.netTorqueZ[index] = 0.0f;
+	}
+
+	void StoreRigidBody(const RigidBodyArrays& bodies, unsigned int index, RigidBody& body)
+	{
+		body.SetCenterOfMass(vec3{ bodies.centerOfMassX[index], bodies.centerOfMassY[index], bodies.centerOfMassZ[index] });
+
+		//The orientation has to be set first since the angular velocity is computed from the world inertia tensor.
+		//It was normalized when it was stored, normalizing it again could change it.
+		body.SetUnitOrientation(MathEngine::Quaternion{ bodies.orientationW[index],
+			vec3{ bodies.orientationX[index], bodies.orientationY[index], bodies.orientationZ[index] } });
+
+		body.SetLinearMomentum(vec3{ bodies.linearMomentumX[index], bodies.linearMomentumY[index], bodies.linearMomentumZ[index] });
+		body.SetAngularMomentum(vec3{ bodies.angularMomentumX[index], bodies.angularMomentumY[index], bodies.angularMomentumZ[index] });
+	}
+
+	void RestoreRigidBody(const RigidBodyArrays& bodies, unsigned int index, RigidBody& body)
+	{
+		body.SetMass(bodies.mass[index]);
+
+		//Set the orientation before the inertia tensor so the world inertia tensor is computed with the restored orientation.
+		body.SetUnitOrientation(MathEngine::Quaternion{ bodies.orientationW[index],
+			vec3{ bodies.orientationX[index], bodies.orientationY[index], bodies.orientationZ[index] } });
+
+		float xy{ bodies.inverseBodyInertiaXY[index] };
+		float xz{ bodies.inverseBodyInertiaXZ[index] };
+		float yz{ bodies.inverseBodyInertiaYZ[index] };
+		mat3 inverseBodyInertia(vec3{ bodies.inverseBodyInertiaXX[index], xy, xz },
+			vec3{ xy, bodies.inverseBodyInertiaYY[index], yz },
+			vec3{ xz, yz, bodies.inverseBodyInertiaZZ[index] });
+
+		//The inverse tensor is set as it is, so the restored body integrates exactly like the stored one.
+		if (bodies.inverseMass[index] > 0.0f)
+			body.SetInverseBodyInertiaTensor(inverseBodyInertia);
+
+		StoreRigidBody(bodies, index, body);
+	}
+
+	vec3 GetCenterOfMass(const RigidBodyArrays& bodies, unsigned int index)
+	{
+		return vec3{ bodies.centerOfMassX[index], bodies.centerOfMassY[index], bodies.centerOfMassZ[index] };
+	}
+
+	MathEngine::Quaternion GetOrientation(const RigidBodyArrays& bodies, unsigned int index)
+	{
+		return MathEngine::Quaternion{ bodies.orientationW[index],
+			vec3{ bodies.orientationX[index], bodies.orientationY[index], bodies.orientationZ[index] } };
+	}
+
+	void AddTorque(RigidBodyArrays& bodies, unsigned int index, const vec3& torque)
+	{
+		bodies.netTorqueX[index] += torque.x;
+		bodies.netTorqueY[index] += torque.y;
+		bodies.netTorqueZ[index] += torque.z;
+	}
+
+	vec3 GetNetForce(const RigidBodyArrays& bodies, unsigned int index)
+	{
+		return vec3{ bodies.netForceX[index], bodies.netForceY[index], bodies.netForceZ[index] };
+	}
+
+	vec3 GetNetTorque(const RigidBodyArrays& bodies, unsigned int index)
+	{
+		return vec3{ bodies.netTorqueX[index], bodies.netTorqueY[index], bodies.netTorqueZ[index] };
+	}
+
+	void ResetForcesAndTorques(RigidBodyArrays& bodies, const BodyRange& range)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		unsigned int end{ range.first + range.count };
+		if (end > numBodies)
+			end = numBodies;
+
+		for (unsigned int i = range.first; i < end; ++i)
+		{
+			bodies.netForceX[i] = 0.0f;
+			bodies.netForceY[i] = 0.0f;
+			bodies.netForceZ[i] = 0.0f;
+
+			bodies.netTorqueX[i] = 0.0f;
+			bodies.netTorqueY[i] = 0.0f;
+			bodies.netTorqueZ[i] = 0.0f;
+		}
+	}
+
+	void ResetForcesAndTorques(RigidBodyArrays& bodies)
+	{
+		ResetForcesAndTorques(bodies, BodyRange{ 0, GetNumberOfBodies(bodies) });
+	}
+
+	void ShiftOrigin(RigidBodyArrays& bodies, const vec3& shift)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		for (unsigned int i = 0; i < numBodies; ++i)
+		{
+			bodies.centerOfMassX[i] -= shift.x;
+			bodies.centerOfMassY[i] -= shift.y;
+			bodies.centerOfMassZ[i] -= shift.z;
+		}
+	}
+
+	void IntegrateRigidBodies(RigidBodyArrays& bodies, const BodyRange& range, float dt)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		unsigned int end{ range.first + range.count };
+		if (end > numBodies)
+			end = numBodies;
+
+		for (unsigned int i = range.first; i < end; ++i)
+		{
+			//If inverse mass equals to 0 that means the rigid body has infinite mass and cannot be moved.
+			if (bodies.inverseMass[i] <= 0.0f)
+				continue;
+
+			vec3 linearMomentum{ bodies.linearMomentumX[i], bodies.linearMomentumY[i], bodies.linearMomentumZ[i] };
+			linearMomentum += vec3{ bodies.netForceX[i], bodies.netForceY[i], bodies.netForceZ[i] } * dt;
+
+			vec3 linearVelocity{ linearMomentum * bodies.inverseMass[i] };
+
+			vec3 centerOfMass{ bodies.centerOfMassX[i], bodies.centerOfMassY[i], bodies.centerOfMassZ[i] };
+			centerOfMass += linearVelocity * dt;
+
+
+			vec3 angularMomentum{ bodies.angularMomentumX[i], bodies.angularMomentumY[i], bodies.angularMomentumZ[i] };
+			angularMomentum += vec3{ bodies.netTorqueX[i], bodies.netTorqueY[i], bodies.netTorqueZ[i] } * dt;
+
+			MathEngine::Quaternion orientation{ bodies.orientationW[i],
+				vec3{ bodies.orientationX[i], bodies.orientationY[i], bodies.orientationZ[i] } };
+
+			float xy{ bodies.inverseBodyInertiaXY[i] };
+			float xz{ bodies.inverseBodyInertiaXZ[i] };
+			float yz{ bodies.inverseBodyInertiaYZ[i] };
+			mat3 inverseBodyInertia(vec3{ bodies.inverseBodyInertiaXX[i], xy, xz },
+				vec3{ xy, bodies.inverseBodyInertiaYY[i], yz },
+				vec3{ xz, yz, bodies.inverseBodyInertiaZZ[i] });
+
+			mat3 rOrientation(QuaternionToRotationMatrixRow3x3(orientation));
+			mat3 inverseWorldInertiaTensor{ rOrientation * inverseBodyInertia * Transpose(rOrientation) };
+
+			vec3 angularVelocity{ angularMomentum * inverseWorldInertiaTensor };
+
+			MathEngine::Quaternion dqdt{ MathEngine::Quaternion{ 0.0f, angularVelocity } * orientation * 0.5f };
+
+			orientation += dqdt * dt;
+
+			orientation = Normalize(orientation);
+
+			bodies.linearMomentumX[i] = linearMomentum.x;
+			bodies.linearMomentumY[i] = linearMomentum.y;
+			bodies.linearMomentumZ[i] = linearMomentum.z;
+
+			bodies.linearVelocityX[i] = linearVelocity.x;
+			bodies.linearVelocityY[i] = linearVelocity.y;
+			bodies.linearVelocityZ[i] = linearVelocity.z;
+
+			bodies.centerOfMassX[i] = centerOfMass.x;
+			bodies.centerOfMassY[i] = centerOfMass.y;
+			bodies.centerOfMassZ[i] = centerOfMass.z;
+
+			bodies.angularMomentumX[i] = angularMomentum.x;
+			bodies.angularMomentumY[i] = angularMomentum.y;
+			bodies.angularMomentumZ[i] = angularMomentum.z;
+
+			bodies.angularVelocityX[i] = angularVelocity.x;
+			bodies.angularVelocityY[i] = angularVelocity.y;
+			bodies.angularVelocityZ[i] = angularVelocity.z;
+
+			bodies.orientationW[i] = orientation.scalar;
+			bodies.orientationX[i] = orientation.vector.x;
+			bodies.orientationY[i] = orientation.vector.y;
+			bodies.orientationZ[i] = orientation.vector.z;
+		}
+	}
+
+	void IntegrateRigidBodies(RigidBodyArrays& bodies, float dt)
+	{
+		IntegrateRigidBodies(bodies, BodyRange{ 0, GetNumberOfBodies(bodies) }, dt);
+	}
+}
\ No newline at end of file
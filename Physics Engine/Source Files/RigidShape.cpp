@@ -1,4 +1,9 @@
 #include "RigidShape.h"
+#include "Box.h"
+#include "Cone.h"
+#include "Cylinder.h"
+#include "Pyramid.h"
+#include "Sphere.h"
 
 namespace PhysicsEngine
 {
@@ -12,6 +17,19 @@ namespace PhysicsEngine
 		InitializeRigidShape(massDensity, triangles, std::move(shape), std::move(boundingVolume));
 	}
 
+	RigidShape::RigidShape(float massDensity, const MassProperties& massProperties,
+		std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+		std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume)
+	{
+		InitializeRigidShape(massDensity, massProperties, std::move(shape), std::move(boundingVolume));
+	}
+
+	RigidShape::RigidShape(float massDensity, std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+		std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume)
+	{
+		InitializeRigidShape(massDensity, std::move(shape), std::move(boundingVolume));
+	}
+
 	void RigidShape::InitializeRigidShape(float massDensity, const std::vector<ShapesEngine::Triangle>& triangles,
 		std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
 		std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume)
@@ -32,9 +50,42 @@ namespace PhysicsEngine
 		mRigidBody.SetCenterOfMass(mShape->GetPosition() + mOffset);
 	}
 
+	void RigidShape::InitializeRigidShape(float massDensity, const MassProperties& massProperties,
+		std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+		std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume)
+	{
+		mShape = std::move(shape);
+		mBoundingVolume = std::move(boundingVolume);
+		mBoundingVolume->SetPosition(mShape->GetPosition());
+
+		mRigidBody.InitializeRigidBody(massDensity, mShape->GetOrientation(), massProperties, MathEngine::Scale(mShape->GetDimensions()));
+
+		//The offset is the center of mass world location at t = 0, see the function above.
+		mOffset = mRigidBody.GetCenterOfMass();
+		mRigidBody.SetCenterOfMass(mShape->GetPosition() + mOffset);
+	}
+
+	void RigidShape::InitializeRigidShape(float massDensity, std::unique_ptr<ShapesEngine::ThreeDimensionalShapeAbstract> shape,
+		std::unique_ptr<PhysicsEngine::BoundingVolumeAbstract> boundingVolume)
+	{
+		MassProperties massProperties;
+		PrimitiveType type{ GetPrimitiveType(*shape) };
+
+		ComputeMassProperties(type, massProperties);
+		if (type == PRIMITIVE_NONE)
+			massDensity = 0.0f;
+
+		InitializeRigidShape(massDensity, massProperties, std::move(shape), std::move(boundingVolume));
+	}
+
 	//-------------------------------------------------------------------------------------------------------------------------------------------------------
 	//Rigid Body Delegates
 
+	const RigidBody& RigidShape::GetRigidBody() const
+	{
+		return mRigidBody;
+	}
+
 	float RigidShape::GetMass() const
 	{
 		return mRigidBody.GetMass();
@@ -249,6 +300,26 @@ namespace PhysicsEngine
 		currentRigidShape.Integrate(netForce, netTorque, simulationTime);
 	}
 
+	PrimitiveType GetPrimitiveType(const ShapesEngine::ThreeDimensionalShapeAbstract& shape)
+	{
+		if (dynamic_cast<const ShapesEngine::Box*>(&shape))
+			return PRIMITIVE_BOX;
+
+		if (dynamic_cast<const ShapesEngine::Cone*>(&shape))
+			return PRIMITIVE_CONE;
+
+		if (dynamic_cast<const ShapesEngine::Cylinder*>(&shape))
+			return PRIMITIVE_CYLINDER;
+
+		if (dynamic_cast<const ShapesEngine::Sphere*>(&shape))
+			return PRIMITIVE_SPHERE;
+
+		if (dynamic_cast<const ShapesEngine::Pyramid*>(&shape))
+			return PRIMITIVE_PYRAMID;
+
+		return PRIMITIVE_NONE;
+	}
+
 	void Interpolate(const RigidShape& r1, const RigidShape& r2, RigidShape& r3, float t)
 	{
 		r3.SetCenterOfMass(MathEngine::Lerp(r1.GetCenterOfMass(), r2.GetCenterOfMass(), t));
@@ -0,0 +1,196 @@
+#include "RollbackWorld.h"
+
+//Keep the compiler from fusing multiplies and adds into FMA instructions, so every build steps the world the same way.
+#if defined(_MSC_VER)
+#pragma fp_contract (off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+namespace PhysicsEngine
+{
+	//Marks a ring buffer slot that does not belong to any step.
+	static const unsigned long long NO_STEP{ 0xffffffffffffffffull };
+
+	//Orders inputs by body, and inputs for the same body by their force and torque, so a set of inputs always has the same order.
+	static bool InputLess(const BodyInput& a, const BodyInput& b)
+	{
+		if (a.body != b.body)
+			return a.body < b.body;
+
+		float valuesA[6]{ a.force.x, a.force.y, a.force.z, a.torque.x, a.torque.y, a.torque.z };
+		float valuesB[6]{ b.force.x, b.force.y, b.force.z, b.torque.x, b.torque.y, b.torque.z };
+
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			if (valuesA[i] != valuesB[i])
+				return valuesA[i] < valuesB[i];
+		}
+
+		return false;
+	}
+
+	RollbackWorld::RollbackWorld() : mTimeStep{ 1.0f / 60.0f }, mCurrentStep{ 0 }, mMaxInputsPerStep{ 0 }, mOldestStep{ 0 }
+	{
+		InitializeRollbackWorld(RigidBodyArrays{}, ForceGeneratorRegistry{}, mTimeStep, 1, 0);
+	}
+
+	void RollbackWorld::InitializeRollbackWorld(const RigidBodyArrays& bodies, const ForceGeneratorRegistry& forceGenerators, float timeStep,
+		unsigned int historySize, unsigned int maxInputsPerStep)
+	{
+		if (historySize == 0)
+			historySize = 1;
+
+		mBodies = bodies;
+		mForceGenerators = forceGenerators;
+		mTimeStep = timeStep;
+		mCurrentStep = 0;
+		mOldestStep = 0;
+		mMaxInputsPerStep = maxInputsPerStep;
+
+		//Save the bodies into every slot once so the snapshots already have their final size and saving a step does not allocate.
+		mStates.resize(historySize);
+		for (auto& i : mStates)
+		{
+			SaveWorldSnapshot(mBodies, i);
+		}
+		mStateSteps.assign(historySize, NO_STEP);
+
+		mInputs.resize(2 * (size_t)historySize);
+		for (auto& i : mInputs)
+		{
+			i.clear();
+			i.reserve(maxInputsPerStep);
+		}
+		mInputSteps.assign(2 * (size_t)historySize, NO_STEP);
+	}
+
+	const RigidBodyArrays& RollbackWorld::GetBodies() const
+	{
+		return mBodies;
+	}
+
+	unsigned long long RollbackWorld::GetCurrentStep() const
+	{
+		return mCurrentStep;
+	}
+
+	float RollbackWorld::GetTimeStep() const
+	{
+		return mTimeStep;
+	}
+
+	unsigned int RollbackWorld::GetHistorySize() const
+	{
+		return (unsigned int)mStates.size();
+	}
+
+	unsigned long long RollbackWorld::GetOldestStep() const
+	{
+		return mOldestStep;
+	}
+
+	bool RollbackWorld::SetInputs(unsigned long long step, const BodyInput* inputs, unsigned int numInputs)
+	{
+		if (step < mOldestStep || step >= mCurrentStep + mStates.size())
+			return false;
+
+		unsigned int numBodies{ GetNumberOfBodies(mBodies) };
+		for (unsigned int i = 0; i < numInputs; ++i)
+		{
+			if (inputs[i].body >= numBodies)
+				return false;
+		}
+
+		size_t slot{ step % mInputs.size() };
+		std::vector<BodyInput>& stepInputs{ mInputs[slot] };
+		stepInputs.assign(inputs, inputs + numInputs);
+		mInputSteps[slot] = step;
+
+		//The forces of the inputs are added in this order, so sort them to make the sums independent of the order they were passed in.
+		//The number of inputs per step is small, so an insertion sort is enough.
+		for (size_t i = 1; i < stepInputs.size(); ++i)
+		{
+			BodyInput input{ stepInputs[i] };
+
+			size_t j{ i };
+			for (; j > 0 && InputLess(input, stepInputs[j - 1]); --j)
+			{
+				stepInputs[j] = stepInputs[j - 1];
+			}
+
+			stepInputs[j] = input;
+		}
+
+		return true;
+	}
+
+	bool RollbackWorld::SetInputs(unsigned long long step, const std::vector<BodyInput>& inputs)
+	{
+		return SetInputs(step, inputs.data(), (unsigned int)inputs.size());
+	}
+
+	void RollbackWorld::Step()
+	{
+		size_t stateSlot{ mCurrentStep % mStates.size() };
+		SaveWorldSnapshot(mBodies, mStates[stateSlot]);
+		mStateSteps[stateSlot] = mCurrentStep;
+
+		if (mCurrentStep - mOldestStep >= mStates.size())
+			mOldestStep = mCurrentStep - mStates.size() + 1;
+
+		ResetForcesAndTorques(mBodies);
+		mForceGenerators.ApplyForceGenerators(mBodies);
+
+		size_t inputSlot{ mCurrentStep % mInputs.size() };
+		if (mInputSteps[inputSlot] == mCurrentStep)
+		{
+			for (const auto& i : mInputs[inputSlot])
+			{
+				mBodies.netForceX[i.body] += i.force.x;
+				mBodies.netForceY[i.body] += i.force.y;
+				mBodies.netForceZ[i.body] += i.force.z;
+
+				mBodies.netTorqueX[i.body] += i.torque.x;
+				mBodies.netTorqueY[i.body] += i.torque.y;
+				mBodies.netTorqueZ[i.body] += i.torque.z;
+			}
+		}
+
+		IntegrateRigidBodies(mBodies, mTimeStep);
+
+		++mCurrentStep;
+	}
+
+	bool RollbackWorld::Rewind(unsigned long long step)
+	{
+		if (step == mCurrentStep)
+			return true;
+
+		if (step < mOldestStep || step > mCurrentStep)
+			return false;
+
+		size_t slot{ step % mStates.size() };
+		if (mStateSteps[slot] != step || !LoadWorldSnapshot(mStates[slot], mBodies))
+			return false;
+
+		mCurrentStep = step;
+
+		return true;
+	}
+
+	bool RollbackWorld::Resimulate(unsigned long long step)
+	{
+		unsigned long long endStep{ mCurrentStep };
+
+		if (!Rewind(step))
+			return false;
+
+		while (mCurrentStep < endStep)
+		{
+			Step();
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,1187 @@
+#include "SceneQueries.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+namespace PhysicsEngine
+{
+	//Starting and joining a thread costs about as much as this many volume tests, so a batch is only split between threads
+	//if every thread gets many times more tests than that. The small batches a game runs every frame are run on the calling thread.
+	static const unsigned long long MIN_TESTS_PER_THREAD{ 1 << 18 };
+
+	//Returns the number of threads worth using for count queries that each make numTests volume or node tests.
+	static unsigned int LimitThreads(unsigned int count, unsigned int numTests, unsigned int numThreads)
+	{
+		unsigned long long maxThreads{ (unsigned long long)count * numTests / MIN_TESTS_PER_THREAD };
+		if (maxThreads < numThreads)
+			numThreads = (maxThreads > 1) ? (unsigned int)maxThreads : 1;
+
+		return numThreads;
+	}
+
+	//Returns about how many tests a query makes in a hierarchy over numVolumes volumes, a few nodes per level and the volumes of a leaf.
+	static unsigned int GetNumberOfHierarchyTests(unsigned int numVolumes)
+	{
+		unsigned int numLevels{ 0 };
+		while (numLevels < 32 && (1ull << numLevels) < numVolumes)
+			++numLevels;
+
+		return 4 * numLevels + 4;
+	}
+
+	//Returns about how many volume and node tests each query makes in the scene.
+	static unsigned int GetNumberOfTests(const QueryScene& scene)
+	{
+		unsigned int numVolumes{ scene.numSpheres + scene.numBoxes };
+
+		return ((scene.volumeBVH != nullptr) ? GetNumberOfHierarchyTests(numVolumes) : numVolumes) +
+			((scene.triangleMesh != nullptr) ? GetNumberOfHierarchyTests(scene.numTriangles) : scene.numTriangles);
+	}
+
+	//Calls function(first, end) on chunks of [0, count) split between the specified number of threads.
+	//Chunks are multiples of the grain size so packets of queries do not get split.
+	//Use LimitThreads first, so small batches do not pay for starting threads.
+	template<typename Function>
+	static void ParallelFor(unsigned int count, unsigned int grain, unsigned int numThreads, Function function)
+	{
+		if (numThreads <= 1 || count <= grain)
+		{
+			function(0, count);
+			return;
+		}
+
+		unsigned int chunk{ (count + numThreads - 1) / numThreads };
+		chunk = ((chunk + grain - 1) / grain) * grain;
+
+		std::vector<std::thread> threads;
+		for (unsigned int first = chunk; first < count; first += chunk)
+		{
+			unsigned int end{ (first + chunk < count) ? first + chunk : count };
+			threads.emplace_back(function, first, end);
+		}
+
+		function(0, (chunk < count) ? chunk : count);
+
+		for (auto& i : threads)
+		{
+			i.join();
+		}
+	}
+
+	//Returns the corner of the AABB that has the max coordinate on the axes whose bit is set in n and the min coordinate on the others.
+	static vec3 Corner(const AABB& aabb, unsigned int n)
+	{
+		return vec3{ (n & 1) ? aabb.max.x : aabb.min.x, (n & 2) ? aabb.max.y : aabb.min.y, (n & 4) ? aabb.max.z : aabb.min.z };
+	}
+
+	//Returns true if the ray hits the capsule with the segment ab and the specified radius.
+	//The capsule is the union of the cylinder around ab and the spheres at a and b.
+	static bool IntersectRayCapsule(const Ray& ray, const vec3& a, const vec3& b, float radius, float& t)
+	{
+		vec3 n(b - a);
+		vec3 m(ray.origin - a);
+
+		float nn{ MathEngine::DotProduct(n, n) };
+		float nd{ MathEngine::DotProduct(n, ray.direction) };
+		float mn{ MathEngine::DotProduct(m, n) };
+		float md{ MathEngine::DotProduct(m, ray.direction) };
+		float mm{ MathEngine::DotProduct(m, m) };
+
+		//The ray starts inside the capsule.
+		vec3 closestPoint(a + n * ((nn > EPSILON) ? ((mn < 0.0f) ? 0.0f : ((mn > nn) ? 1.0f : mn / nn)) : 0.0f));
+		if (MathEngine::Length(ray.origin - closestPoint) <= radius)
+		{
+			t = 0.0f;
+			return true;
+		}
+
+		bool hit{ false };
+		t = ray.maxDistance;
+
+		//cylinder without the end caps
+		float aa{ nn - nd * nd };
+		if (aa > EPSILON * nn)
+		{
+			float k{ mm - radius * radius };
+			float c{ nn * k - mn * mn };
+			float bb{ nn * md - nd * mn };
+			float discriminant{ bb * bb - aa * c };
+
+			if (discriminant >= 0.0f)
+			{
+				float tc{ (-bb - std::sqrt(discriminant)) / aa };
+				float s{ mn + tc * nd };
+
+				if (tc >= 0.0f && tc <= t && s >= 0.0f && s <= nn)
+				{
+					t = tc;
+					hit = true;
+				}
+			}
+		}
+
+		//end caps
+		float ts{ 0.0f };
+		vec3 normal;
+		if (IntersectRay(ray, Sphere{ a, radius }, ts, normal) && ts <= t)
+		{
+			t = ts;
+			hit = true;
+		}
+
+		if (IntersectRay(ray, Sphere{ b, radius }, ts, normal) && ts <= t)
+		{
+			t = ts;
+			hit = true;
+		}
+
+		return hit;
+	}
+
+	//Returns the normalized vector, or the fallback if the vector is too short to normalize.
+	static vec3 NormalizeOr(const vec3& v, const vec3& fallback)
+	{
+		float length{ MathEngine::Length(v) };
+
+		return (length > EPSILON) ? v * (1.0f / length) : fallback;
+	}
+
+	bool IntersectRay(const Ray& ray, const Sphere& sphere, float& t, vec3& normal)
+	{
+		vec3 m(ray.origin - sphere.center);
+		float b{ MathEngine::DotProduct(m, ray.direction) };
+		float c{ MathEngine::DotProduct(m, m) - sphere.radius * sphere.radius };
+
+		//The ray starts outside the sphere and points away from it.
+		if (c > 0.0f && b > 0.0f)
+			return false;
+
+		float discriminant{ b * b - c };
+		if (discriminant < 0.0f)
+			return false;
+
+		t = -b - std::sqrt(discriminant);
+
+		//The ray starts inside the sphere.
+		if (t < 0.0f)
+		{
+			t = 0.0f;
+			normal = -ray.direction;
+			return true;
+		}
+
+		if (t > ray.maxDistance)
+			return false;
+
+		normal = NormalizeOr(ray.origin + ray.direction * t - sphere.center, -ray.direction);
+
+		return true;
+	}
+
+	bool IntersectRay(const Ray& ray, const AABB& aabb, float& t, vec3& normal)
+	{
+		const float* origin{ &ray.origin.x };
+		const float* direction{ &ray.direction.x };
+		const float* min{ &aabb.min.x };
+		const float* max{ &aabb.max.x };
+
+		float tMin{ 0.0f };
+		float tMax{ ray.maxDistance };
+		int axis{ -1 };
+		float sign{ 0.0f };
+
+		//Intersect the ray with the 3 slabs of the AABB.
+		for (int i = 0; i < 3; ++i)
+		{
+			if (std::abs(direction[i]) < EPSILON)
+			{
+				//The ray is parallel to the slab, so it misses if the origin is not inside the slab.
+				if (origin[i] < min[i] || origin[i] > max[i])
+					return false;
+
+				continue;
+			}
+
+			float inverse{ 1.0f / direction[i] };
+			float t1{ (min[i] - origin[i]) * inverse };
+			float t2{ (max[i] - origin[i]) * inverse };
+			float faceSign{ -1.0f };
+
+			if (t1 > t2)
+			{
+				float temp{ t1 };
+				t1 = t2;
+				t2 = temp;
+				faceSign = 1.0f;
+			}
+
+			if (t1 > tMin)
+			{
+				tMin = t1;
+				axis = i;
+				sign = faceSign;
+			}
+
+			if (t2 < tMax)
+				tMax = t2;
+
+			if (tMin > tMax)
+				return false;
+		}
+
+		t = tMin;
+
+		//The ray starts inside the AABB.
+		if (axis == -1)
+		{
+			normal = -ray.direction;
+			return true;
+		}
+
+		normal = vec3{ 0.0f, 0.0f, 0.0f };
+		(&normal.x)[axis] = sign;
+
+		return true;
+	}
+
+	bool IntersectRay(const Ray& ray, const ShapesEngine::Triangle& triangle, float& t, vec3& normal)
+	{
+		const vec3& p0{ triangle.vertexList[triangle.p0].position };
+		const vec3& p1{ triangle.vertexList[triangle.p1].position };
+		const vec3& p2{ triangle.vertexList[triangle.p2].position };
+
+		//Moller-Trumbore
+		vec3 e1(p1 - p0);
+		vec3 e2(p2 - p0);
+		vec3 p(MathEngine::CrossProduct(ray.direction, e2));
+
+		float determinant{ MathEngine::DotProduct(e1, p) };
+		if (std::abs(determinant) < EPSILON)
+			return false;
+
+		float inverse{ 1.0f / determinant };
+		vec3 s(ray.origin - p0);
+
+		float u{ MathEngine::DotProduct(s, p) * inverse };
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		vec3 q(MathEngine::CrossProduct(s, e1));
+
+		float v{ MathEngine::DotProduct(ray.direction, q) * inverse };
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		float distance{ MathEngine::DotProduct(e2, q) * inverse };
+		if (distance < 0.0f || distance > ray.maxDistance)
+			return false;
+
+		t = distance;
+
+		normal = NormalizeOr(MathEngine::CrossProduct(e1, e2), -ray.direction);
+		if (MathEngine::DotProduct(normal, ray.direction) > 0.0f)
+			normal = -normal;
+
+		return true;
+	}
+
+	bool IntersectSphereCast(const SphereCast& cast, const Sphere& sphere, float& t, vec3& normal)
+	{
+		//Moving a sphere against a sphere is the same as a ray against a sphere with the sum of the radii.
+		Ray ray{ cast.origin, cast.direction, cast.maxDistance };
+
+		return IntersectRay(ray, Sphere{ sphere.center, sphere.radius + cast.radius }, t, normal);
+	}
+
+	bool IntersectSphereCast(const SphereCast& cast, const AABB& aabb, float& t, vec3& normal)
+	{
+		Ray ray{ cast.origin, cast.direction, cast.maxDistance };
+
+		//The moving sphere hits the AABB when its center hits the AABB with rounded edges and corners made by growing the AABB by the radius.
+		//First intersect the ray with the AABB grown by the radius, then check the edge and corner regions using capsules.
+		vec3 r{ cast.radius, cast.radius, cast.radius };
+		AABB grown{ aabb.min - r, aabb.max + r };
+
+		if (!IntersectRay(ray, grown, t, normal))
+			return false;
+
+		vec3 point(ray.origin + ray.direction * t);
+
+		unsigned int below{ 0 };
+		unsigned int above{ 0 };
+
+		if (point.x < aabb.min.x) below |= 1;
+		if (point.x > aabb.max.x) above |= 1;
+		if (point.y < aabb.min.y) below |= 2;
+		if (point.y > aabb.max.y) above |= 2;
+		if (point.z < aabb.min.z) below |= 4;
+		if (point.z > aabb.max.z) above |= 4;
+
+		unsigned int mask{ below | above };
+		unsigned int numAxes{ (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) };
+
+		//face region, the hit on the grown AABB is the hit
+		if (numAxes <= 1)
+			return true;
+
+		if (numAxes == 2)
+		{
+			//edge region
+			if (!IntersectRayCapsule(ray, Corner(aabb, below ^ 7), Corner(aabb, above), cast.radius, t))
+				return false;
+		}
+		else
+		{
+			//corner region, test the capsules of the 3 edges that meet at the corner
+			vec3 corner(Corner(aabb, above));
+			bool hit{ false };
+			float closest{ ray.maxDistance };
+
+			for (unsigned int i = 1; i <= 4; i <<= 1)
+			{
+				float tEdge{ 0.0f };
+				if (IntersectRayCapsule(ray, corner, Corner(aabb, above ^ i), cast.radius, tEdge) && tEdge <= closest)
+				{
+					closest = tEdge;
+					hit = true;
+				}
+			}
+
+			if (!hit)
+				return false;
+
+			t = closest;
+		}
+
+		if (t == 0.0f)
+		{
+			normal = -cast.direction;
+			return true;
+		}
+
+		vec3 center(ray.origin + ray.direction * t);
+		vec3 closestPoint{ center.x < aabb.min.x ? aabb.min.x : (center.x > aabb.max.x ? aabb.max.x : center.x),
+			center.y < aabb.min.y ? aabb.min.y : (center.y > aabb.max.y ? aabb.max.y : center.y),
+			center.z < aabb.min.z ? aabb.min.z : (center.z > aabb.max.z ? aabb.max.z : center.z) };
+
+		normal = NormalizeOr(center - closestPoint, -cast.direction);
+
+		return true;
+	}
+
+	bool IntersectSphereCast(const SphereCast& cast, const ShapesEngine::Triangle& triangle, float& t, vec3& normal)
+	{
+		//The sphere already overlaps the triangle.
+		if (TestIntersection(Sphere{ cast.origin, cast.radius }, triangle))
+		{
+			t = 0.0f;
+			normal = -cast.direction;
+			return true;
+		}
+
+		const vec3& p0{ triangle.vertexList[triangle.p0].position };
+		const vec3& p1{ triangle.vertexList[triangle.p1].position };
+		const vec3& p2{ triangle.vertexList[triangle.p2].position };
+
+		Ray ray{ cast.origin, cast.direction, cast.maxDistance };
+
+		//The normal of the triangle facing the sphere.
+		vec3 n(MathEngine::CrossProduct(p1 - p0, p2 - p0));
+		float length{ MathEngine::Length(n) };
+		if (length < EPSILON)
+			return false;
+
+		n *= 1.0f / length;
+		float distance{ MathEngine::DotProduct(n, cast.origin - p0) };
+		if (distance < 0.0f)
+		{
+			n = -n;
+			distance = -distance;
+		}
+
+		//If the sphere first touches the plane of the triangle inside the triangle, that is the hit.
+		float speed{ MathEngine::DotProduct(n, cast.direction) };
+		if (speed < 0.0f && distance > cast.radius)
+		{
+			float tPlane{ (distance - cast.radius) / -speed };
+			vec3 contact(cast.origin + cast.direction * tPlane - n * cast.radius);
+
+			if (tPlane > cast.maxDistance)
+				return false;
+
+			//The contact point is inside the triangle if it is on the same side of all 3 edges.
+			float s0{ MathEngine::DotProduct(MathEngine::CrossProduct(p1 - p0, contact - p0), n) };
+			float s1{ MathEngine::DotProduct(MathEngine::CrossProduct(p2 - p1, contact - p1), n) };
+			float s2{ MathEngine::DotProduct(MathEngine::CrossProduct(p0 - p2, contact - p2), n) };
+
+			if ((s0 >= 0.0f && s1 >= 0.0f && s2 >= 0.0f) || (s0 <= 0.0f && s1 <= 0.0f && s2 <= 0.0f))
+			{
+				t = tPlane;
+				normal = n;
+				return true;
+			}
+		}
+
+		//Otherwise the sphere first touches an edge or a corner of the triangle.
+		const vec3* vertices[]{ &p0, &p1, &p2 };
+		bool hit{ false };
+		float closest{ cast.maxDistance };
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			float tEdge{ 0.0f };
+			if (IntersectRayCapsule(ray, *vertices[i], *vertices[(i + 1) % 3], cast.radius, tEdge) && tEdge <= closest)
+			{
+				closest = tEdge;
+				hit = true;
+			}
+		}
+
+		if (!hit)
+			return false;
+
+		t = closest;
+
+		vec3 center(cast.origin + cast.direction * t);
+		normal = NormalizeOr(center - ClosestPointOnTriangle(center, triangle), n);
+
+		return true;
+	}
+
+	vec3 ClosestPointOnTriangle(const vec3& point, const ShapesEngine::Triangle& triangle)
+	{
+		const vec3& a{ triangle.vertexList[triangle.p0].position };
+		const vec3& b{ triangle.vertexList[triangle.p1].position };
+		const vec3& c{ triangle.vertexList[triangle.p2].position };
+
+		//Find the voronoi region of the triangle the point is in.
+		vec3 ab(b - a);
+		vec3 ac(c - a);
+		vec3 ap(point - a);
+
+		float d1{ MathEngine::DotProduct(ab, ap) };
+		float d2{ MathEngine::DotProduct(ac, ap) };
+		if (d1 <= 0.0f && d2 <= 0.0f)
+			return a;
+
+		vec3 bp(point - b);
+		float d3{ MathEngine::DotProduct(ab, bp) };
+		float d4{ MathEngine::DotProduct(ac, bp) };
+		if (d3 >= 0.0f && d4 <= d3)
+			return b;
+
+		float vc{ d1 * d4 - d3 * d2 };
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+			return a + ab * (d1 / (d1 - d3));
+
+		vec3 cp(point - c);
+		float d5{ MathEngine::DotProduct(ab, cp) };
+		float d6{ MathEngine::DotProduct(ac, cp) };
+		if (d6 >= 0.0f && d5 <= d6)
+			return c;
+
+		float vb{ d5 * d2 - d1 * d6 };
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+			return a + ac * (d2 / (d2 - d6));
+
+		float va{ d3 * d6 - d5 * d4 };
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		//The point is inside the face region.
+		float denominator{ 1.0f / (va + vb + vc) };
+
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+
+	bool TestIntersection(const Sphere& sphere, const AABB& aabb)
+	{
+		//squared distance between the center of the sphere and the AABB
+		const float* center{ &sphere.center.x };
+		const float* min{ &aabb.min.x };
+		const float* max{ &aabb.max.x };
+
+		float distance{ 0.0f };
+		for (int i = 0; i < 3; ++i)
+		{
+			if (center[i] < min[i])
+				distance += (min[i] - center[i]) * (min[i] - center[i]);
+
+			if (center[i] > max[i])
+				distance += (center[i] - max[i]) * (center[i] - max[i]);
+		}
+
+		return distance <= sphere.radius * sphere.radius;
+	}
+
+	bool TestIntersection(const Sphere& sphere, const ShapesEngine::Triangle& triangle)
+	{
+		vec3 v(ClosestPointOnTriangle(sphere.center, triangle) - sphere.center);
+
+		return MathEngine::DotProduct(v, v) <= sphere.radius * sphere.radius;
+	}
+
+	bool TestIntersection(const AABB& aabb, const ShapesEngine::Triangle& triangle)
+	{
+		vec3 center((aabb.min + aabb.max) * 0.5f);
+		vec3 extents((aabb.max - aabb.min) * 0.5f);
+
+		//Move the triangle so the AABB is centered at the origin.
+		vec3 v[3]{ triangle.vertexList[triangle.p0].position - center, triangle.vertexList[triangle.p1].position - center,
+			triangle.vertexList[triangle.p2].position - center };
+
+		vec3 f[3]{ v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+		vec3 axes[3]{ vec3{ 1.0f, 0.0f, 0.0f }, vec3{ 0.0f, 1.0f, 0.0f }, vec3{ 0.0f, 0.0f, 1.0f } };
+
+		//Returns true if the axis separates the triangle and the AABB.
+		auto separated = [&v, &extents](const vec3& axis)
+			{
+				float p0{ MathEngine::DotProduct(v[0], axis) };
+				float p1{ MathEngine::DotProduct(v[1], axis) };
+				float p2{ MathEngine::DotProduct(v[2], axis) };
+
+				float r{ extents.x * std::abs(axis.x) + extents.y * std::abs(axis.y) + extents.z * std::abs(axis.z) };
+				float min{ (p0 < p1) ? ((p0 < p2) ? p0 : p2) : ((p1 < p2) ? p1 : p2) };
+				float max{ (p0 > p1) ? ((p0 > p2) ? p0 : p2) : ((p1 > p2) ? p1 : p2) };
+
+				return min > r || max < -r;
+			};
+
+		//9 axes from the cross products of the AABB axes and the triangle edges
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				if (separated(MathEngine::CrossProduct(axes[i], f[j])))
+					return false;
+			}
+		}
+
+		//3 axes of the AABB
+		for (int i = 0; i < 3; ++i)
+		{
+			if (separated(axes[i]))
+				return false;
+		}
+
+		//normal of the triangle
+		return !separated(MathEngine::CrossProduct(f[0], f[1]));
+	}
+
+	//Returns the AABB around the sphere.
+	static AABB GetBounds(const Sphere& sphere)
+	{
+		vec3 r{ sphere.radius, sphere.radius, sphere.radius };
+
+		return AABB{ sphere.center - r, sphere.center + r };
+	}
+
+	static AABB GetBounds(const AABB& aabb)
+	{
+		return aabb;
+	}
+
+	QueryVolumeBVH::QueryVolumeBVH()
+	{}
+
+	void QueryVolumeBVH::BuildQueryVolumeBVH(const Sphere* spheres, unsigned int numSpheres, const AABB* boxes, unsigned int numBoxes,
+		unsigned int numThreads)
+	{
+		std::vector<vec3> mins(numSpheres + numBoxes);
+		std::vector<vec3> maxs(numSpheres + numBoxes);
+
+		for (unsigned int i = 0; i < numSpheres; ++i)
+		{
+			AABB bounds{ GetBounds(spheres[i]) };
+			mins[i] = bounds.min;
+			maxs[i] = bounds.max;
+		}
+
+		for (unsigned int i = 0; i < numBoxes; ++i)
+		{
+			mins[numSpheres + i] = boxes[i].min;
+			maxs[numSpheres + i] = boxes[i].max;
+		}
+
+		BuildMeshBVH(mins, maxs, mNodes, mVolumes, numThreads);
+	}
+
+	const std::vector<MeshBVHNode>& QueryVolumeBVH::GetNodes() const
+	{
+		return mNodes;
+	}
+
+	const std::vector<unsigned int>& QueryVolumeBVH::GetVolumes() const
+	{
+		return mVolumes;
+	}
+
+	//Calls leaf(first, count) for each leaf of the hierarchy the query reaches. reach(node, distance) returns true if the query reaches
+	//the box of the node and stores how far along the query it does, so the nearer child is visited first and its hits can cut off the other.
+	template<typename Reach, typename Leaf>
+	static void Trace(const std::vector<MeshBVHNode>& nodes, Reach reach, Leaf leaf)
+	{
+		if (nodes.empty())
+			return;
+
+		unsigned int stack[MAX_MESH_BVH_DEPTH];
+		unsigned int stackSize{ 0 };
+		float distance{ 0.0f };
+
+		if (reach(nodes[0], distance))
+			stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const MeshBVHNode& node{ nodes[stack[--stackSize]] };
+
+			if (node.count > 0)
+			{
+				leaf(node.leftOrFirst, node.count);
+				continue;
+			}
+
+			unsigned int nearChild{ node.leftOrFirst };
+			unsigned int farChild{ node.leftOrFirst + 1 };
+			float nearDistance{ 0.0f };
+			float farDistance{ 0.0f };
+			bool nearHit{ reach(nodes[nearChild], nearDistance) };
+			bool farHit{ reach(nodes[farChild], farDistance) };
+
+			if (nearHit && farHit && farDistance < nearDistance)
+				std::swap(nearChild, farChild);
+
+			//The depth limit of BuildMeshBVH keeps the stack from filling up.
+			if (farHit)
+				stack[stackSize++] = farChild;
+
+			if (nearHit)
+				stack[stackSize++] = nearChild;
+		}
+	}
+
+	//Returns a where the mask is set and b where it is not.
+	static __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	//A packet of 4 rays with one ray per lane, and the inverse directions for the slab tests.
+	struct RayPacket
+	{
+		__m128 ox, oy, oz;
+		__m128 dx, dy, dz;
+		__m128 ix, iy, iz;
+	};
+
+	//The closest distance of each ray of a packet and the id of the volume it hit there, or -1.
+	struct PacketHit
+	{
+		__m128 closest;
+		__m128 id;
+	};
+
+	static void IntersectPacket(const RayPacket& packet, const Sphere& sphere, int id, PacketHit& hit)
+	{
+		__m128 zero{ _mm_setzero_ps() };
+
+		__m128 mx{ _mm_sub_ps(packet.ox, _mm_set1_ps(sphere.center.x)) };
+		__m128 my{ _mm_sub_ps(packet.oy, _mm_set1_ps(sphere.center.y)) };
+		__m128 mz{ _mm_sub_ps(packet.oz, _mm_set1_ps(sphere.center.z)) };
+
+		__m128 b{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, packet.dx), _mm_mul_ps(my, packet.dy)), _mm_mul_ps(mz, packet.dz)) };
+		__m128 c{ _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), _mm_mul_ps(mz, mz)),
+			_mm_set1_ps(sphere.radius * sphere.radius)) };
+
+		__m128 discriminant{ _mm_sub_ps(_mm_mul_ps(b, b), c) };
+		__m128 root{ _mm_sqrt_ps(_mm_max_ps(discriminant, zero)) };
+		__m128 tNear{ _mm_max_ps(_mm_sub_ps(_mm_sub_ps(zero, b), root), zero) };
+		__m128 tFar{ _mm_add_ps(_mm_sub_ps(zero, b), root) };
+
+		__m128 mask{ _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(discriminant, zero), _mm_cmpge_ps(tFar, zero)), _mm_cmple_ps(tNear, hit.closest)) };
+
+		hit.closest = Select(mask, tNear, hit.closest);
+		hit.id = Select(mask, _mm_castsi128_ps(_mm_set1_epi32(id)), hit.id);
+	}
+
+	//Returns the distance each ray enters the box from min to max at, and sets the lanes of the mask whose rays enter it before their closest hit.
+	static __m128 IntersectPacket(const RayPacket& packet, const float* min, const float* max, __m128 closest, __m128& mask)
+	{
+		__m128 t1x{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min[0]), packet.ox), packet.ix) };
+		__m128 t2x{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max[0]), packet.ox), packet.ix) };
+		__m128 t1y{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min[1]), packet.oy), packet.iy) };
+		__m128 t2y{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max[1]), packet.oy), packet.iy) };
+		__m128 t1z{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min[2]), packet.oz), packet.iz) };
+		__m128 t2z{ _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max[2]), packet.oz), packet.iz) };
+
+		__m128 tNear{ _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_max_ps(_mm_min_ps(t1z, t2z), _mm_setzero_ps())) };
+		__m128 tFar{ _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_min_ps(_mm_max_ps(t1z, t2z), closest)) };
+
+		mask = _mm_cmple_ps(tNear, tFar);
+
+		return tNear;
+	}
+
+	static void IntersectPacket(const RayPacket& packet, const AABB& aabb, int id, PacketHit& hit)
+	{
+		__m128 mask;
+		__m128 tNear{ IntersectPacket(packet, &aabb.min.x, &aabb.max.x, hit.closest, mask) };
+
+		hit.closest = Select(mask, tNear, hit.closest);
+		hit.id = Select(mask, _mm_castsi128_ps(_mm_set1_epi32(id)), hit.id);
+	}
+
+	//Moller-Trumbore
+	static void IntersectPacket(const RayPacket& packet, const vec3& p0, const vec3& p1, const vec3& p2, int id, PacketHit& hit)
+	{
+		__m128 zero{ _mm_setzero_ps() };
+		__m128 one{ _mm_set1_ps(1.0f) };
+
+		vec3 e1(p1 - p0);
+		vec3 e2(p2 - p0);
+
+		__m128 e1x{ _mm_set1_ps(e1.x) };
+		__m128 e1y{ _mm_set1_ps(e1.y) };
+		__m128 e1z{ _mm_set1_ps(e1.z) };
+		__m128 e2x{ _mm_set1_ps(e2.x) };
+		__m128 e2y{ _mm_set1_ps(e2.y) };
+		__m128 e2z{ _mm_set1_ps(e2.z) };
+
+		//p = d x e2
+		__m128 px{ _mm_sub_ps(_mm_mul_ps(packet.dy, e2z), _mm_mul_ps(packet.dz, e2y)) };
+		__m128 py{ _mm_sub_ps(_mm_mul_ps(packet.dz, e2x), _mm_mul_ps(packet.dx, e2z)) };
+		__m128 pz{ _mm_sub_ps(_mm_mul_ps(packet.dx, e2y), _mm_mul_ps(packet.dy, e2x)) };
+
+		__m128 determinant{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz)) };
+		__m128 inverse{ _mm_div_ps(one, determinant) };
+
+		//s = o - p0
+		__m128 sx{ _mm_sub_ps(packet.ox, _mm_set1_ps(p0.x)) };
+		__m128 sy{ _mm_sub_ps(packet.oy, _mm_set1_ps(p0.y)) };
+		__m128 sz{ _mm_sub_ps(packet.oz, _mm_set1_ps(p0.z)) };
+
+		__m128 u{ _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverse) };
+
+		//q = s x e1
+		__m128 qx{ _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y)) };
+		__m128 qy{ _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z)) };
+		__m128 qz{ _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x)) };
+
+		__m128 v{ _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(packet.dx, qx), _mm_mul_ps(packet.dy, qy)), _mm_mul_ps(packet.dz, qz)), inverse) };
+		__m128 t{ _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse) };
+
+		__m128 mask{ _mm_cmpge_ps(_mm_and_ps(determinant, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))), _mm_set1_ps(EPSILON)) };
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, hit.closest)));
+
+		hit.closest = Select(mask, t, hit.closest);
+		hit.id = Select(mask, _mm_castsi128_ps(_mm_set1_epi32(id)), hit.id);
+	}
+
+	//Returns true if any ray of the packet reaches the box of the node before its closest hit, and the nearest distance one of them enters it at.
+	static bool IntersectPacket(const RayPacket& packet, const MeshBVHNode& node, __m128 closest, float& distance)
+	{
+		__m128 mask;
+		__m128 tNear{ IntersectPacket(packet, node.min, node.max, closest, mask) };
+
+		if (_mm_movemask_ps(mask) == 0)
+			return false;
+
+		__m128 t{ Select(mask, tNear, _mm_set1_ps(FLT_MAX)) };
+		t = _mm_min_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+		t = _mm_min_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2)));
+		distance = _mm_cvtss_f32(t);
+
+		return true;
+	}
+
+	//Traces a packet of up to 4 rays through the scene.
+	//Each node and volume is loaded once and tested against all the rays of the packet. The closest distance and the id of the closest volume
+	//are tracked per ray, where the id is the index of the volume after the spheres, boxes and triangles are put one after the other.
+	//The normal of the closest hit is computed at the end with the exact test of that volume.
+	static void CastRayPacket(const QueryScene& scene, const Ray* rays, unsigned int numRays, QueryHit* hits)
+	{
+		alignas(16) float origin[3][4];
+		alignas(16) float direction[3][4];
+		alignas(16) float maxDistance[4];
+
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			//Unused lanes get a negative max distance so they never hit anything.
+			const Ray& ray{ rays[(i < numRays) ? i : 0] };
+			origin[0][i] = ray.origin.x;
+			origin[1][i] = ray.origin.y;
+			origin[2][i] = ray.origin.z;
+			direction[0][i] = ray.direction.x;
+			direction[1][i] = ray.direction.y;
+			direction[2][i] = ray.direction.z;
+			maxDistance[i] = (i < numRays) ? ray.maxDistance : -1.0f;
+		}
+
+		//The inverse directions are computed once per packet.
+		RayPacket packet;
+		packet.ox = _mm_load_ps(origin[0]);
+		packet.oy = _mm_load_ps(origin[1]);
+		packet.oz = _mm_load_ps(origin[2]);
+		packet.dx = _mm_load_ps(direction[0]);
+		packet.dy = _mm_load_ps(direction[1]);
+		packet.dz = _mm_load_ps(direction[2]);
+		packet.ix = _mm_div_ps(_mm_set1_ps(1.0f), packet.dx);
+		packet.iy = _mm_div_ps(_mm_set1_ps(1.0f), packet.dy);
+		packet.iz = _mm_div_ps(_mm_set1_ps(1.0f), packet.dz);
+
+		PacketHit hit{ _mm_load_ps(maxDistance), _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+
+		auto reach = [&packet, &hit](const MeshBVHNode& node, float& distance)
+			{
+				return IntersectPacket(packet, node, hit.closest, distance);
+			};
+
+		//spheres and boxes, which the QueryVolumeBVH numbers the same way as the ids
+		if (scene.volumeBVH != nullptr)
+		{
+			const std::vector<unsigned int>& volumes{ scene.volumeBVH->GetVolumes() };
+
+			Trace(scene.volumeBVH->GetNodes(), reach, [&scene, &packet, &hit, &volumes](unsigned int first, unsigned int count)
+				{
+					for (unsigned int i = first; i < first + count; ++i)
+					{
+						unsigned int volume{ volumes[i] };
+						if (volume < scene.numSpheres)
+							IntersectPacket(packet, scene.spheres[volume], (int)volume, hit);
+						else
+							IntersectPacket(packet, scene.boxes[volume - scene.numSpheres], (int)volume, hit);
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int i = 0; i < scene.numSpheres; ++i)
+			{
+				IntersectPacket(packet, scene.spheres[i], (int)i, hit);
+			}
+
+			for (unsigned int i = 0; i < scene.numBoxes; ++i)
+			{
+				IntersectPacket(packet, scene.boxes[i], (int)(scene.numSpheres + i), hit);
+			}
+		}
+
+		unsigned int base{ scene.numSpheres + scene.numBoxes };
+
+		//triangles
+		if (scene.triangleMesh != nullptr)
+		{
+			const std::vector<vec3>& vertices{ scene.triangleMesh->GetVertices() };
+			const std::vector<unsigned int>& indices{ scene.triangleMesh->GetIndices() };
+			const std::vector<unsigned int>& triangleIds{ scene.triangleMesh->GetTriangleIds() };
+
+			Trace(scene.triangleMesh->GetNodes(), reach, [&packet, &hit, &vertices, &indices, &triangleIds, base](unsigned int first, unsigned int count)
+				{
+					for (unsigned int i = first; i < first + count; ++i)
+					{
+						IntersectPacket(packet, vertices[indices[3 * i]], vertices[indices[3 * i + 1]], vertices[indices[3 * i + 2]],
+							(int)(base + triangleIds[i]), hit);
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int i = 0; i < scene.numTriangles; ++i)
+			{
+				const ShapesEngine::Triangle& triangle{ scene.triangles[i] };
+				IntersectPacket(packet, triangle.vertexList[triangle.p0].position, triangle.vertexList[triangle.p1].position,
+					triangle.vertexList[triangle.p2].position, (int)(base + i), hit);
+			}
+		}
+
+		alignas(16) float distances[4];
+		alignas(16) int ids[4];
+		_mm_store_ps(distances, hit.closest);
+		_mm_store_si128((__m128i*)ids, _mm_castps_si128(hit.id));
+
+		for (unsigned int i = 0; i < numRays; ++i)
+		{
+			QueryHit& queryHit{ hits[i] };
+			queryHit = QueryHit{};
+
+			if (ids[i] < 0)
+				continue;
+
+			unsigned int index{ (unsigned int)ids[i] };
+			float t{ 0.0f };
+			bool found{ false };
+
+			if (index < scene.numSpheres)
+			{
+				queryHit.type = QUERY_SPHERE;
+				found = IntersectRay(rays[i], scene.spheres[index], t, queryHit.normal);
+			}
+			else if (index < scene.numSpheres + scene.numBoxes)
+			{
+				index -= scene.numSpheres;
+				queryHit.type = QUERY_AABB;
+				found = IntersectRay(rays[i], scene.boxes[index], t, queryHit.normal);
+			}
+			else
+			{
+				index -= scene.numSpheres + scene.numBoxes;
+				queryHit.type = QUERY_TRIANGLE;
+				found = IntersectRay(rays[i], scene.triangles[index], t, queryHit.normal);
+			}
+
+			//The packet test and the exact test can only disagree for rays that graze the volume.
+			if (!found)
+				queryHit.normal = -rays[i].direction;
+
+			queryHit.index = index;
+			queryHit.distance = distances[i];
+			queryHit.point = rays[i].origin + rays[i].direction * distances[i];
+		}
+	}
+
+	void CastRays(const QueryScene& scene, const Ray* rays, unsigned int numRays, QueryHit* hits, unsigned int numThreads)
+	{
+		numThreads = LimitThreads(numRays, GetNumberOfTests(scene), numThreads);
+
+		ParallelFor(numRays, 4, numThreads, [&scene, rays, hits](unsigned int first, unsigned int end)
+			{
+				for (unsigned int i = first; i < end; i += 4)
+				{
+					CastRayPacket(scene, rays + i, (end - i < 4) ? end - i : 4, hits + i);
+				}
+			});
+	}
+
+	//Keeps the hit of a sphere cast with a volume if it is the closest so far. On a tie the volume that comes first in the scene is kept,
+	//so the hit does not depend on the order the volumes are tested in.
+	template<typename Volume>
+	static void CastSphere(const SphereCast& cast, const Volume& volume, QueryVolumeType type, unsigned int index, QueryHit& hit)
+	{
+		float t{ 0.0f };
+		vec3 normal;
+
+		if (!IntersectSphereCast(cast, volume, t, normal))
+			return;
+
+		if (hit.type == QUERY_NONE || t < hit.distance || (t == hit.distance && (type < hit.type || (type == hit.type && index < hit.index))))
+		{
+			hit.type = type;
+			hit.index = index;
+			hit.distance = t;
+			hit.normal = normal;
+		}
+	}
+
+	//Finds the closest hit of the sphere cast with the volumes of the scene.
+	static void CastSphere(const QueryScene& scene, const SphereCast& cast, QueryHit& hit)
+	{
+		//The moving sphere can only reach the volumes of a node if its center reaches the box of the node grown by the radius.
+		vec3 r{ cast.radius, cast.radius, cast.radius };
+		auto reach = [&cast, &hit, &r](const MeshBVHNode& node, float& distance)
+			{
+				Ray ray{ cast.origin, cast.direction, (hit.type == QUERY_NONE) ? cast.maxDistance : hit.distance };
+				AABB grown{ vec3{ node.min[0], node.min[1], node.min[2] } - r, vec3{ node.max[0], node.max[1], node.max[2] } + r };
+				vec3 normal;
+
+				return IntersectRay(ray, grown, distance, normal);
+			};
+
+		if (scene.volumeBVH != nullptr)
+		{
+			const std::vector<unsigned int>& volumes{ scene.volumeBVH->GetVolumes() };
+
+			Trace(scene.volumeBVH->GetNodes(), reach, [&scene, &cast, &hit, &volumes](unsigned int first, unsigned int count)
+				{
+					for (unsigned int i = first; i < first + count; ++i)
+					{
+						unsigned int volume{ volumes[i] };
+						if (volume < scene.numSpheres)
+							CastSphere(cast, scene.spheres[volume], QUERY_SPHERE, volume, hit);
+						else
+							CastSphere(cast, scene.boxes[volume - scene.numSpheres], QUERY_AABB, volume - scene.numSpheres, hit);
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int i = 0; i < scene.numSpheres; ++i)
+			{
+				CastSphere(cast, scene.spheres[i], QUERY_SPHERE, i, hit);
+			}
+
+			for (unsigned int i = 0; i < scene.numBoxes; ++i)
+			{
+				CastSphere(cast, scene.boxes[i], QUERY_AABB, i, hit);
+			}
+		}
+
+		if (scene.triangleMesh != nullptr)
+		{
+			const std::vector<unsigned int>& triangleIds{ scene.triangleMesh->GetTriangleIds() };
+
+			Trace(scene.triangleMesh->GetNodes(), reach, [&scene, &cast, &hit, &triangleIds](unsigned int first, unsigned int count)
+				{
+					for (unsigned int i = first; i < first + count; ++i)
+					{
+						CastSphere(cast, scene.triangles[triangleIds[i]], QUERY_TRIANGLE, triangleIds[i], hit);
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int i = 0; i < scene.numTriangles; ++i)
+			{
+				CastSphere(cast, scene.triangles[i], QUERY_TRIANGLE, i, hit);
+			}
+		}
+	}
+
+	void CastSpheres(const QueryScene& scene, const SphereCast* casts, unsigned int numCasts, QueryHit* hits, unsigned int numThreads)
+	{
+		numThreads = LimitThreads(numCasts, GetNumberOfTests(scene), numThreads);
+
+		ParallelFor(numCasts, 1, numThreads, [&scene, casts, hits](unsigned int first, unsigned int end)
+			{
+				for (unsigned int i = first; i < end; ++i)
+				{
+					QueryHit& hit{ hits[i] };
+					hit = QueryHit{};
+
+					CastSphere(scene, casts[i], hit);
+
+					//point of contact on the volume
+					if (hit.type != QUERY_NONE)
+						hit.point = casts[i].origin + casts[i].direction * hit.distance - hit.normal * casts[i].radius;
+				}
+			});
+	}
+
+	//Appends the overlaps of the query with the volumes of the scene to hits, sorted by the type and index of the volume.
+	template<typename Query>
+	static void OverlapQuery(const QueryScene& scene, const Query& query, unsigned int queryIndex, std::vector<OverlapHit>& hits)
+	{
+		size_t first{ hits.size() };
+
+		AABB bounds{ GetBounds(query) };
+		auto reach = [&bounds](const MeshBVHNode& node, float& distance)
+			{
+				distance = 0.0f;
+
+				return node.min[0] <= bounds.max.x && node.max[0] >= bounds.min.x &&
+					node.min[1] <= bounds.max.y && node.max[1] >= bounds.min.y &&
+					node.min[2] <= bounds.max.z && node.max[2] >= bounds.min.z;
+			};
+
+		if (scene.volumeBVH != nullptr)
+		{
+			const std::vector<unsigned int>& volumes{ scene.volumeBVH->GetVolumes() };
+
+			Trace(scene.volumeBVH->GetNodes(), reach, [&scene, &query, queryIndex, &hits, &volumes](unsigned int leafFirst, unsigned int count)
+				{
+					for (unsigned int i = leafFirst; i < leafFirst + count; ++i)
+					{
+						unsigned int volume{ volumes[i] };
+						if (volume < scene.numSpheres)
+						{
+							if (TestIntersection(scene.spheres[volume], query))
+								hits.push_back(OverlapHit{ queryIndex, QUERY_SPHERE, volume });
+						}
+						else if (TestIntersection(query, scene.boxes[volume - scene.numSpheres]))
+						{
+							hits.push_back(OverlapHit{ queryIndex, QUERY_AABB, volume - scene.numSpheres });
+						}
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int j = 0; j < scene.numSpheres; ++j)
+			{
+				if (TestIntersection(scene.spheres[j], query))
+					hits.push_back(OverlapHit{ queryIndex, QUERY_SPHERE, j });
+			}
+
+			for (unsigned int j = 0; j < scene.numBoxes; ++j)
+			{
+				if (TestIntersection(query, scene.boxes[j]))
+					hits.push_back(OverlapHit{ queryIndex, QUERY_AABB, j });
+			}
+		}
+
+		if (scene.triangleMesh != nullptr)
+		{
+			const std::vector<unsigned int>& triangleIds{ scene.triangleMesh->GetTriangleIds() };
+
+			Trace(scene.triangleMesh->GetNodes(), reach, [&scene, &query, queryIndex, &hits, &triangleIds](unsigned int leafFirst, unsigned int count)
+				{
+					for (unsigned int i = leafFirst; i < leafFirst + count; ++i)
+					{
+						if (TestIntersection(query, scene.triangles[triangleIds[i]]))
+							hits.push_back(OverlapHit{ queryIndex, QUERY_TRIANGLE, triangleIds[i] });
+					}
+				});
+		}
+		else
+		{
+			for (unsigned int j = 0; j < scene.numTriangles; ++j)
+			{
+				if (TestIntersection(query, scene.triangles[j]))
+					hits.push_back(OverlapHit{ queryIndex, QUERY_TRIANGLE, j });
+			}
+		}
+
+		//The hierarchies find the volumes in the order of their leaves.
+		if (scene.volumeBVH != nullptr || scene.triangleMesh != nullptr)
+		{
+			std::sort(hits.begin() + first, hits.end(), [](const OverlapHit& a, const OverlapHit& b)
+				{
+					return a.type < b.type || (a.type == b.type && a.index < b.index);
+				});
+		}
+	}
+
+	//Finds the overlaps of each query with the volumes of the scene and appends them to hits in the order of the queries.
+	template<typename Query>
+	static void Overlap(const QueryScene& scene, const Query* queries, unsigned int numQueries, std::vector<OverlapHit>& hits,
+		unsigned int numThreads)
+	{
+		hits.clear();
+		numThreads = LimitThreads(numQueries, GetNumberOfTests(scene), numThreads);
+
+		//Each chunk of queries writes to its own vector, the vectors are then joined in order.
+		unsigned int numChunks{ (numThreads > 1) ? numThreads : 1 };
+		std::vector<std::vector<OverlapHit>> chunkHits(numChunks);
+		unsigned int chunkSize{ (numQueries + numChunks - 1) / numChunks };
+
+		ParallelFor(numQueries, (chunkSize > 0) ? chunkSize : 1, numThreads, [&scene, queries, &chunkHits, chunkSize](unsigned int first, unsigned int end)
+			{
+				std::vector<OverlapHit>& result{ chunkHits[(chunkSize > 0) ? first / chunkSize : 0] };
+
+				for (unsigned int i = first; i < end; ++i)
+				{
+					OverlapQuery(scene, queries[i], i, result);
+				}
+			});
+
+		for (const auto& i : chunkHits)
+		{
+			hits.insert(hits.end(), i.begin(), i.end());
+		}
+	}
+
+	void OverlapSpheres(const QueryScene& scene, const Sphere* queries, unsigned int numQueries, std::vector<OverlapHit>& hits,
+		unsigned int numThreads)
+	{
+		Overlap(scene, queries, numQueries, hits, numThreads);
+	}
+
+	void OverlapAABBs(const QueryScene& scene, const AABB* queries, unsigned int numQueries, std::vector<OverlapHit>& hits,
+		unsigned int numThreads)
+	{
+		Overlap(scene, queries, numQueries, hits, numThreads);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "ShapeAssets.h"
+#include <utility>
+
+namespace PhysicsEngine
+{
+	ShapeAssetLibrary::ShapeAssetLibrary()
+	{}
+
+	ShapeAssetLibrary::ShapeAssetLibrary(ShapeAssetLibrary&& library) noexcept :
+		mShapes{ std::move(library.mShapes) }, mVertexList{ std::move(library.mVertexList) }, mIndexList{ std::move(library.mIndexList) }
+	{
+		PointTrianglesAtVertices();
+		library.Clear();
+	}
+
+	ShapeAssetLibrary& ShapeAssetLibrary::operator=(ShapeAssetLibrary&& library) noexcept
+	{
+		if (this != &library)
+		{
+			mShapes = std::move(library.mShapes);
+			mVertexList = std::move(library.mVertexList);
+			mIndexList = std::move(library.mIndexList);
+			PointTrianglesAtVertices();
+			library.Clear();
+		}
+
+		return *this;
+	}
+
+	ShapeHandle ShapeAssetLibrary::AddShape(const std::vector<ShapesEngine::Vertex>& vertices,
+		const std::vector<ShapesEngine::Triangle>& triangles, PrimitiveType primitive)
+	{
+		mShapes.emplace_back();
+
+		//Moving the assets when mShapes grows keeps the vertex arrays where they are, so only the new asset
+		//needs its triangles pointed at its own vertices.
+		ShapeAsset& shape{ mShapes.back() };
+		shape.vertices = vertices;
+		shape.triangles = triangles;
+		for (auto& i : shape.triangles)
+		{
+			i.vertexList = shape.vertices.data();
+		}
+
+		ComputeAABB(shape.localBox, shape.vertices);
+		ComputeMinimumSphere(shape.localSphere, shape.vertices);
+		ComputeConvexHull(shape.vertices, shape.hull, MAX_HULL_VERTICES);
+
+		if (primitive == PRIMITIVE_NONE)
+			ComputeMassProperties(shape.triangles, shape.massProperties);
+		else
+			ComputeMassProperties(primitive, shape.massProperties);
+
+		shape.indexCount = (unsigned int)shape.triangles.size() * 3;
+		shape.locationOfFirstIndex = (unsigned int)mIndexList.size();
+		shape.indexOfFirstVertex = (int)mVertexList.size();
+
+		mVertexList.insert(mVertexList.end(), shape.vertices.begin(), shape.vertices.end());
+
+		for (const auto& i : shape.triangles)
+		{
+			mIndexList.push_back(i.p0);
+			mIndexList.push_back(i.p1);
+			mIndexList.push_back(i.p2);
+		}
+
+		return (ShapeHandle)mShapes.size() - 1;
+	}
+
+	const ShapeAsset& ShapeAssetLibrary::GetShape(ShapeHandle handle) const
+	{
+		return mShapes.at(handle);
+	}
+
+	unsigned int ShapeAssetLibrary::GetNumberOfShapes() const
+	{
+		return (unsigned int)mShapes.size();
+	}
+
+	const std::vector<ShapesEngine::Vertex>& ShapeAssetLibrary::GetVertexList() const
+	{
+		return mVertexList;
+	}
+
+	const std::vector<unsigned int>& ShapeAssetLibrary::GetIndexList() const
+	{
+		return mIndexList;
+	}
+
+	void ShapeAssetLibrary::Clear()
+	{
+		mShapes.clear();
+		mVertexList.clear();
+		mIndexList.clear();
+	}
+
+	void ShapeAssetLibrary::PointTrianglesAtVertices()
+	{
+		for (auto& i : mShapes)
+		{
+			for (auto& j : i.triangles)
+			{
+				j.vertexList = i.vertices.data();
+			}
+		}
+	}
+
+	mat4 ComputeModelMatrix(const ShapeInstance& instance)
+	{
+		return MathEngine::Scale4x4(instance.scale.x, instance.scale.y, instance.scale.z) *
+			MathEngine::QuaternionToRotationMatrixRow4x4(instance.orientation) * MathEngine::Translate(instance.position);
+	}
+
+	mat4 ComputeLocalModelMatrix(const ShapeAsset& shape, const vec3& scale)
+	{
+		return MathEngine::Scale4x4(scale.x, scale.y, scale.z) * MathEngine::Translate(-(shape.massProperties.centerOfMass * MathEngine::Scale(scale)));
+	}
+
+	void ComputeModelMatrices(const ShapeInstance* instances, unsigned int numInstances, mat4* models)
+	{
+		for (unsigned int i = 0; i < numInstances; ++i)
+		{
+			models[i] = ComputeModelMatrix(instances[i]);
+		}
+	}
+
+	void ComputeWorldAABB(AABB& worldAABB, const ShapeAsset& shape, const ShapeInstance& instance)
+	{
+		TransformAABB(worldAABB, shape.localBox, ComputeModelMatrix(instance));
+	}
+
+	void ComputeWorldSphere(Sphere& worldSphere, const ShapeAsset& shape, const ShapeInstance& instance)
+	{
+		TransformSphere(worldSphere, shape.localSphere, ComputeModelMatrix(instance));
+	}
+
+	void InitializeRigidBody(RigidBody& rigidBody, float massDensity, const ShapeAsset& shape, const ShapeInstance& instance)
+	{
+		rigidBody.InitializeRigidBody(massDensity, instance.orientation, shape.massProperties, MathEngine::Scale(instance.scale));
+
+		//The rigid body stores the center of mass of the scaled shape in local space, rotate it and move it to the position of the instance.
+		vec3 offset{ rigidBody.GetCenterOfMass() * MathEngine::QuaternionToRotationMatrixRow3x3(instance.orientation) };
+		rigidBody.SetCenterOfMass(instance.position + offset);
+	}
+
+	void UpdateShapeInstance(ShapeInstance& instance, const ShapeAsset& shape, const RigidBody& rigidBody)
+	{
+		UpdateShapeInstance(instance, shape, rigidBody.GetCenterOfMass(), rigidBody.GetOrientation());
+	}
+
+	void UpdateShapeInstance(ShapeInstance& instance, const ShapeAsset& shape, const vec3& centerOfMass,
+		const MathEngine::Quaternion& orientation)
+	{
+		vec3 localCenterOfMass{ shape.massProperties.centerOfMass * MathEngine::Scale(instance.scale) };
+
+		instance.orientation = orientation;
+		instance.position = centerOfMass - localCenterOfMass * MathEngine::QuaternionToRotationMatrixRow3x3(instance.orientation);
+	}
+}
\ No newline at end of file
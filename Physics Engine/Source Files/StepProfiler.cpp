@@ -0,0 +1,283 @@
+#include "StepProfiler.h"
+#include <atomic>
+
+#if defined(PHYSICS_ENGINE_COUNT_ALLOCATIONS)
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> gAllocationCount{ 0 };
+
+void* operator new(std::size_t size)
+{
+	gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* p{ std::malloc(size ? size : 1) };
+	if (p == nullptr)
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+#endif
+
+namespace PhysicsEngine
+{
+	const char* GetStepPhaseName(StepPhase phase)
+	{
+		static const char* names[NUM_STEP_PHASES]{ "forces", "integration", "bounding volumes", "broadphase", "narrowphase", "solve" };
+
+		if (phase < 0 || phase >= NUM_STEP_PHASES)
+			return "";
+
+		return names[phase];
+	}
+
+	unsigned long long GetAllocationCount()
+	{
+#if defined(PHYSICS_ENGINE_COUNT_ALLOCATIONS)
+		return gAllocationCount.load(std::memory_order_relaxed);
+#else
+		return 0;
+#endif
+	}
+
+	StepProfiler::StepProfiler() : mNextStep{ 0 }, mNumSteps{ 0 }, mStepCount{ 0 }, mAllocationsAtStepStart{ 0 }
+	{
+		InitializeStepProfiler(120);
+	}
+
+	StepProfiler::StepProfiler(unsigned int historySize) : mNextStep{ 0 }, mNumSteps{ 0 }, mStepCount{ 0 }, mAllocationsAtStepStart{ 0 }
+	{
+		InitializeStepProfiler(historySize);
+	}
+
+	void StepProfiler::InitializeStepProfiler(unsigned int historySize)
+	{
+		if (historySize == 0)
+			historySize = 1;
+
+		mHistory.resize(historySize);
+		Clear();
+	}
+
+	void StepProfiler::BeginStep()
+	{
+		mCurrentStep = StepStats{};
+		mCurrentStep.step = mStepCount;
+
+		mAllocationsAtStepStart = GetAllocationCount();
+		mStepStart = std::chrono::steady_clock::now();
+	}
+
+	void StepProfiler::EndStep()
+	{
+		std::chrono::duration<double, std::milli> total{ std::chrono::steady_clock::now() - mStepStart };
+		mCurrentStep.totalMilliseconds = total.count();
+		mCurrentStep.numAllocations = GetAllocationCount() - mAllocationsAtStepStart;
+
+		//mHistory is a ring buffer, mNextStep is where the next step goes.
+		mHistory[mNextStep] = mCurrentStep;
+		mNextStep = (mNextStep + 1) % (unsigned int)mHistory.size();
+
+		if (mNumSteps < mHistory.size())
+			++mNumSteps;
+
+		++mStepCount;
+	}
+
+	void StepProfiler::BeginPhase(StepPhase phase)
+	{
+		mPhaseStart[phase] = std::chrono::steady_clock::now();
+	}
+
+	void StepProfiler::EndPhase(StepPhase phase)
+	{
+		std::chrono::duration<double, std::milli> time{ std::chrono::steady_clock::now() - mPhaseStart[phase] };
+		mCurrentStep.phaseMilliseconds[phase] += time.count();
+	}
+
+	void StepProfiler::SetBodyCounts(unsigned int numBodies, unsigned int numAwakeBodies)
+	{
+		mCurrentStep.numBodies = numBodies;
+		mCurrentStep.numAwakeBodies = numAwakeBodies;
+	}
+
+	void StepProfiler::AddPairs(unsigned int numPairs)
+	{
+		mCurrentStep.numPairs += numPairs;
+	}
+
+	void StepProfiler::AddContacts(unsigned int numContacts)
+	{
+		mCurrentStep.numContacts += numContacts;
+	}
+
+	void StepProfiler::AddConstraintBatches(unsigned int numBatches)
+	{
+		mCurrentStep.numConstraintBatches += numBatches;
+	}
+
+	unsigned int StepProfiler::GetNumberOfSteps() const
+	{
+		return mNumSteps;
+	}
+
+	const StepStats& StepProfiler::GetStep(unsigned int index) const
+	{
+		unsigned int size{ (unsigned int)mHistory.size() };
+
+		return mHistory[(mNextStep + size - 1 - index % size) % size];
+	}
+
+	void StepProfiler::GetLastSteps(unsigned int count, std::vector<StepStats>& steps) const
+	{
+		if (count > mNumSteps)
+			count = mNumSteps;
+
+		steps.clear();
+		steps.reserve(count);
+
+		for (unsigned int i = count; i > 0; --i)
+		{
+			steps.push_back(GetStep(i - 1));
+		}
+	}
+
+	StepStats StepProfiler::GetAverage() const
+	{
+		StepStats average;
+		average.step = mNumSteps;
+
+		if (mNumSteps == 0)
+			return average;
+
+		//Sum the counts in doubles so large counts over many steps do not overflow.
+		double numBodies{ 0.0 };
+		double numAwakeBodies{ 0.0 };
+		double numPairs{ 0.0 };
+		double numContacts{ 0.0 };
+		double numConstraintBatches{ 0.0 };
+		double numAllocations{ 0.0 };
+
+		for (unsigned int i = 0; i < mNumSteps; ++i)
+		{
+			const StepStats& step{ GetStep(i) };
+
+			for (unsigned int j = 0; j < NUM_STEP_PHASES; ++j)
+			{
+				average.phaseMilliseconds[j] += step.phaseMilliseconds[j];
+			}
+			average.totalMilliseconds += step.totalMilliseconds;
+
+			numBodies += step.numBodies;
+			numAwakeBodies += step.numAwakeBodies;
+			numPairs += step.numPairs;
+			numContacts += step.numContacts;
+			numConstraintBatches += step.numConstraintBatches;
+			numAllocations += (double)step.numAllocations;
+		}
+
+		for (unsigned int j = 0; j < NUM_STEP_PHASES; ++j)
+		{
+			average.phaseMilliseconds[j] /= mNumSteps;
+		}
+		average.totalMilliseconds /= mNumSteps;
+
+		average.numBodies = (unsigned int)(numBodies / mNumSteps + 0.5);
+		average.numAwakeBodies = (unsigned int)(numAwakeBodies / mNumSteps + 0.5);
+		average.numPairs = (unsigned int)(numPairs / mNumSteps + 0.5);
+		average.numContacts = (unsigned int)(numContacts / mNumSteps + 0.5);
+		average.numConstraintBatches = (unsigned int)(numConstraintBatches / mNumSteps + 0.5);
+		average.numAllocations = (unsigned long long)(numAllocations / mNumSteps + 0.5);
+
+		return average;
+	}
+
+	void StepProfiler::Clear()
+	{
+		mNextStep = 0;
+		mNumSteps = 0;
+		mStepCount = 0;
+		mCurrentStep = StepStats{};
+	}
+
+	void StepProfiler::WriteCSV(std::ostream& stream) const
+	{
+		stream << "step";
+		for (unsigned int j = 0; j < NUM_STEP_PHASES; ++j)
+		{
+			stream << "," << GetStepPhaseName((StepPhase)j) << " ms";
+		}
+		stream << ",total ms,bodies,awake bodies,pairs,contacts,constraint batches,allocations\n";
+
+		for (unsigned int i = mNumSteps; i > 0; --i)
+		{
+			const StepStats& step{ GetStep(i - 1) };
+
+			stream << step.step;
+			for (unsigned int j = 0; j < NUM_STEP_PHASES; ++j)
+			{
+				stream << "," << step.phaseMilliseconds[j];
+			}
+			stream << "," << step.totalMilliseconds << "," << step.numBodies << "," << step.numAwakeBodies << "," << step.numPairs <<
+				"," << step.numContacts << "," << step.numConstraintBatches << "," << step.numAllocations << "\n";
+		}
+	}
+
+	void StepProfiler::WriteJSON(std::ostream& stream) const
+	{
+		stream << "[";
+
+		for (unsigned int i = mNumSteps; i > 0; --i)
+		{
+			const StepStats& step{ GetStep(i - 1) };
+
+			stream << (i == mNumSteps ? "\n" : ",\n") << "  {\"step\": " << step.step << ", \"phases\": {";
+			for (unsigned int j = 0; j < NUM_STEP_PHASES; ++j)
+			{
+				stream << (j == 0 ? "" : ", ") << "\"" << GetStepPhaseName((StepPhase)j) << "\": " << step.phaseMilliseconds[j];
+			}
+			stream << "}, \"total\": " << step.totalMilliseconds << ", \"bodies\": " << step.numBodies << ", \"awakeBodies\": " <<
+				step.numAwakeBodies << ", \"pairs\": " << step.numPairs << ", \"contacts\": " << step.numContacts << ", \"constraintBatches\": " <<
+				step.numConstraintBatches << ", \"allocations\": " << step.numAllocations << "}";
+		}
+
+		stream << (mNumSteps == 0 ? "]\n" : "\n]\n");
+	}
+
+	ProfileScope::ProfileScope(StepProfiler* profiler, StepPhase phase) : mProfiler{ profiler }, mPhase{ phase }
+	{
+		if (mProfiler != nullptr)
+			mProfiler->BeginPhase(mPhase);
+	}
+
+	ProfileScope::~ProfileScope()
+	{
+		if (mProfiler != nullptr)
+			mProfiler->EndPhase(mPhase);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,1160 @@
+#include "TriangleMeshCollider.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+
+namespace PhysicsEngine
+{
+	static_assert(sizeof(MeshBVHNode) == 32, "MeshBVHNode has to be 32 bytes");
+
+	//The build stops splitting at this many triangles, and splits larger nodes only if the SAH says splitting is cheaper
+	//up to MAX_SAH_LEAF_TRIANGLES.
+	static const unsigned int MAX_LEAF_TRIANGLES{ 4 };
+	static const unsigned int MAX_SAH_LEAF_TRIANGLES{ 16 };
+	static const unsigned int NUM_SAH_BINS{ 16 };
+
+	//Nodes with fewer triangles than this are built on the thread that reached them.
+	static const unsigned int MIN_PARALLEL_TRIANGLES{ 8192 };
+
+	//The size of the traversal stacks. A traversal never has more nodes on its stack than the depth of the deepest leaf plus one,
+	//so the build and Load keep every node less than MAX_TRAVERSAL_DEPTH levels below the root.
+	static const unsigned int MAX_TRAVERSAL_DEPTH{ MAX_MESH_BVH_DEPTH };
+
+	//Below this depth the build splits every node in half instead of using the SAH. Halving 32 more times reaches a leaf
+	//for any number of triangles, so the depth stays under MAX_TRAVERSAL_DEPTH.
+	static const unsigned int MAX_SAH_DEPTH{ MAX_TRAVERSAL_DEPTH - 33 };
+
+	const unsigned int MESH_COLLIDER_VERSION{ 1 };
+
+	//The start of a saved collider. The magic number is the characters "PETM".
+	//The vertices, indices, triangle ids and nodes follow the header one after the other.
+	struct MeshColliderHeader
+	{
+		unsigned int magic{ 0x4d544550 };
+		unsigned int version{ MESH_COLLIDER_VERSION };
+		unsigned int numVertices{ 0 };
+		unsigned int numTriangles{ 0 };
+		unsigned int numNodes{ 0 };
+	};
+
+	struct MeshBuilder
+	{
+		const vec3* triangleMin{ nullptr };
+		const vec3* triangleMax{ nullptr };
+		std::vector<vec3> centroids;
+
+		//The triangles in the order of the leaves.
+		std::vector<unsigned int> order;
+
+		MeshBVHNode* nodes{ nullptr };
+		std::atomic<unsigned int> numNodes{ 0 };
+	};
+
+	static float GetComponent(const vec3& v, unsigned int i)
+	{
+		return (i == 0) ? v.x : ((i == 1) ? v.y : v.z);
+	}
+
+	static vec3 Min(const vec3& a, const vec3& b)
+	{
+		return vec3{ std::fmin(a.x, b.x), std::fmin(a.y, b.y), std::fmin(a.z, b.z) };
+	}
+
+	static vec3 Max(const vec3& a, const vec3& b)
+	{
+		return vec3{ std::fmax(a.x, b.x), std::fmax(a.y, b.y), std::fmax(a.z, b.z) };
+	}
+
+	//Half the surface area of the box, which is all the SAH needs.
+	static float HalfArea(const vec3& min, const vec3& max)
+	{
+		vec3 d{ max - min };
+
+		return d.x * d.y + d.y * d.z + d.z * d.x;
+	}
+
+	static void SetBounds(MeshBVHNode& node, const vec3& min, const vec3& max)
+	{
+		node.min[0] = min.x;
+		node.min[1] = min.y;
+		node.min[2] = min.z;
+		node.max[0] = max.x;
+		node.max[1] = max.y;
+		node.max[2] = max.z;
+	}
+
+	static bool Overlaps(const MeshBVHNode& node, const vec3& min, const vec3& max)
+	{
+		return node.min[0] <= max.x && node.max[0] >= min.x &&
+			node.min[1] <= max.y && node.max[1] >= min.y &&
+			node.min[2] <= max.z && node.max[2] >= min.z;
+	}
+
+	//Builds the node over the triangles order[first] to order[first + count - 1], and its children. The root has a depth of 0.
+	static void BuildNode(MeshBuilder& builder, unsigned int nodeIndex, unsigned int first, unsigned int count, unsigned int depth,
+		unsigned int numThreads)
+	{
+		MeshBVHNode& node{ builder.nodes[nodeIndex] };
+		unsigned int end{ first + count };
+
+		vec3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+		vec3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		vec3 centroidMin{ FLT_MAX, FLT_MAX, FLT_MAX };
+		vec3 centroidMax{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (unsigned int i = first; i < end; ++i)
+		{
+			unsigned int triangle{ builder.order[i] };
+			min = Min(min, builder.triangleMin[triangle]);
+			max = Max(max, builder.triangleMax[triangle]);
+			centroidMin = Min(centroidMin, builder.centroids[triangle]);
+			centroidMax = Max(centroidMax, builder.centroids[triangle]);
+		}
+
+		SetBounds(node, min, max);
+
+		if (count <= MAX_LEAF_TRIANGLES)
+		{
+			node.leftOrFirst = first;
+			node.count = count;
+			return;
+		}
+
+		//Binned SAH: sort the centroids into bins along each axis and find the split between bins with the lowest cost.
+		unsigned int bestAxis{ 3 };
+		unsigned int bestSplit{ 0 };
+		float bestCost{ FLT_MAX };
+
+		for (unsigned int axis = 0; axis < 3 && depth < MAX_SAH_DEPTH; ++axis)
+		{
+			float axisMin{ GetComponent(centroidMin, axis) };
+			float extent{ GetComponent(centroidMax, axis) - axisMin };
+			if (extent <= 0.0f)
+				continue;
+
+			unsigned int binCounts[NUM_SAH_BINS]{};
+			vec3 binMin[NUM_SAH_BINS];
+			vec3 binMax[NUM_SAH_BINS];
+			for (unsigned int i = 0; i < NUM_SAH_BINS; ++i)
+			{
+				binMin[i] = vec3{ FLT_MAX, FLT_MAX, FLT_MAX };
+				binMax[i] = vec3{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			}
+
+			float scale{ NUM_SAH_BINS / extent };
+			for (unsigned int i = first; i < end; ++i)
+			{
+				unsigned int triangle{ builder.order[i] };
+				unsigned int bin{ (unsigned int)((GetComponent(builder.centroids[triangle], axis) - axisMin) * scale) };
+				if (bin >= NUM_SAH_BINS)
+					bin = NUM_SAH_BINS - 1;
+
+				++binCounts[bin];
+				binMin[bin] = Min(binMin[bin], builder.triangleMin[triangle]);
+				binMax[bin] = Max(binMax[bin], builder.triangleMax[triangle]);
+			}
+
+			//the areas and counts of everything left of each split
+			float leftArea[NUM_SAH_BINS - 1];
+			unsigned int leftCount[NUM_SAH_BINS - 1];
+			vec3 sweepMin{ FLT_MAX, FLT_MAX, FLT_MAX };
+			vec3 sweepMax{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			unsigned int sweepCount{ 0 };
+			for (unsigned int i = 0; i < NUM_SAH_BINS - 1; ++i)
+			{
+				sweepCount += binCounts[i];
+				if (binCounts[i] > 0)
+				{
+					sweepMin = Min(sweepMin, binMin[i]);
+					sweepMax = Max(sweepMax, binMax[i]);
+				}
+
+				leftCount[i] = sweepCount;
+				leftArea[i] = (sweepCount > 0) ? HalfArea(sweepMin, sweepMax) : 0.0f;
+			}
+
+			sweepMin = vec3{ FLT_MAX, FLT_MAX, FLT_MAX };
+			sweepMax = vec3{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			sweepCount = 0;
+			for (unsigned int i = NUM_SAH_BINS - 1; i > 0; --i)
+			{
+				sweepCount += binCounts[i];
+				if (binCounts[i] > 0)
+				{
+					sweepMin = Min(sweepMin, binMin[i]);
+					sweepMax = Max(sweepMax, binMax[i]);
+				}
+
+				if (leftCount[i - 1] == 0 || sweepCount == 0)
+					continue;
+
+				float cost{ leftCount[i - 1] * leftArea[i - 1] + sweepCount * HalfArea(sweepMin, sweepMax) };
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = i;
+				}
+			}
+		}
+
+		unsigned int middle{ first + count / 2 };
+
+		if (bestAxis != 3)
+		{
+			if (count <= MAX_SAH_LEAF_TRIANGLES && bestCost >= count * HalfArea(min, max))
+			{
+				node.leftOrFirst = first;
+				node.count = count;
+				return;
+			}
+
+			float axisMin{ GetComponent(centroidMin, bestAxis) };
+			float scale{ NUM_SAH_BINS / (GetComponent(centroidMax, bestAxis) - axisMin) };
+
+			auto split{ std::partition(builder.order.begin() + first, builder.order.begin() + end,
+				[&builder, bestAxis, bestSplit, axisMin, scale](unsigned int triangle)
+				{
+					unsigned int bin{ (unsigned int)((GetComponent(builder.centroids[triangle], bestAxis) - axisMin) * scale) };
+					return ((bin >= NUM_SAH_BINS) ? NUM_SAH_BINS - 1 : bin) < bestSplit;
+				}) };
+
+			middle = (unsigned int)(split - builder.order.begin());
+		}
+
+		//All the centroids are at the same point, a split came out empty or the node is too deep, so split the triangles in half.
+		if (middle == first || middle == end)
+			middle = first + count / 2;
+
+		unsigned int left{ builder.numNodes.fetch_add(2) };
+		node.leftOrFirst = left;
+		node.count = 0;
+
+		if (numThreads > 1 && count >= MIN_PARALLEL_TRIANGLES)
+		{
+			std::future<void> leftBuild{ std::async(std::launch::async, BuildNode, std::ref(builder), left, first, middle - first, depth + 1,
+				numThreads / 2) };
+			BuildNode(builder, left + 1, middle, end - middle, depth + 1, numThreads - numThreads / 2);
+			leftBuild.get();
+		}
+		else
+		{
+			BuildNode(builder, left, first, middle - first, depth + 1, 1);
+			BuildNode(builder, left + 1, middle, end - middle, depth + 1, 1);
+		}
+	}
+
+	//Calls function(first, count) for each leaf whose bounds overlap the box.
+	template<typename Function>
+	static void ForEachLeaf(const std::vector<MeshBVHNode>& nodes, const vec3& min, const vec3& max, Function function)
+	{
+		if (nodes.empty())
+			return;
+
+		unsigned int stack[MAX_TRAVERSAL_DEPTH];
+		unsigned int stackSize{ 0 };
+		stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const MeshBVHNode& node{ nodes[stack[--stackSize]] };
+			if (!Overlaps(node, min, max))
+				continue;
+
+			if (node.count > 0)
+			{
+				function(node.leftOrFirst, node.count);
+			}
+			else
+			{
+				//The depth limit of the build and Load keeps the stack from filling up.
+				stack[stackSize++] = node.leftOrFirst + 1;
+				stack[stackSize++] = node.leftOrFirst;
+			}
+		}
+	}
+
+	//Returns the distance along the ray to the box of the node, or FLT_MAX if the ray misses it within maxDistance.
+	static float IntersectRayNode(const MeshBVHNode& node, const vec3& origin, const vec3& inverseDirection, float maxDistance)
+	{
+		float tx1{ (node.min[0] - origin.x) * inverseDirection.x };
+		float tx2{ (node.max[0] - origin.x) * inverseDirection.x };
+		float ty1{ (node.min[1] - origin.y) * inverseDirection.y };
+		float ty2{ (node.max[1] - origin.y) * inverseDirection.y };
+		float tz1{ (node.min[2] - origin.z) * inverseDirection.z };
+		float tz2{ (node.max[2] - origin.z) * inverseDirection.z };
+
+		//fmin and fmax ignore the NaNs of rays parallel to a slab that start on its plane.
+		float tEnter{ std::fmax(std::fmax(std::fmin(tx1, tx2), std::fmin(ty1, ty2)), std::fmax(std::fmin(tz1, tz2), 0.0f)) };
+		float tExit{ std::fmin(std::fmin(std::fmax(tx1, tx2), std::fmax(ty1, ty2)), std::fmin(std::fmax(tz1, tz2), maxDistance)) };
+
+		return (tEnter <= tExit) ? tEnter : FLT_MAX;
+	}
+
+	//Moller-Trumbore. Returns true and the distance if the ray hits the triangle between 0 and maxDistance.
+	static bool IntersectRayTriangle(const vec3& origin, const vec3& direction, float maxDistance,
+		const vec3& p0, const vec3& p1, const vec3& p2, float& t)
+	{
+		vec3 e1(p1 - p0);
+		vec3 e2(p2 - p0);
+		vec3 p(MathEngine::CrossProduct(direction, e2));
+
+		float determinant{ MathEngine::DotProduct(e1, p) };
+		if (std::fabs(determinant) < FLT_MIN)
+			return false;
+
+		float inverse{ 1.0f / determinant };
+		vec3 s(origin - p0);
+
+		float u{ MathEngine::DotProduct(s, p) * inverse };
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		vec3 q(MathEngine::CrossProduct(s, e1));
+
+		float v{ MathEngine::DotProduct(direction, q) * inverse };
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		float distance{ MathEngine::DotProduct(e2, q) * inverse };
+		if (distance < 0.0f || distance > maxDistance)
+			return false;
+
+		t = distance;
+
+		return true;
+	}
+
+	static vec3 ClosestPointOnTriangle(const vec3& point, const vec3& a, const vec3& b, const vec3& c)
+	{
+		//Find the voronoi region of the triangle the point is in.
+		vec3 ab(b - a);
+		vec3 ac(c - a);
+		vec3 ap(point - a);
+
+		float d1{ MathEngine::DotProduct(ab, ap) };
+		float d2{ MathEngine::DotProduct(ac, ap) };
+		if (d1 <= 0.0f && d2 <= 0.0f)
+			return a;
+
+		vec3 bp(point - b);
+		float d3{ MathEngine::DotProduct(ab, bp) };
+		float d4{ MathEngine::DotProduct(ac, bp) };
+		if (d3 >= 0.0f && d4 <= d3)
+			return b;
+
+		float vc{ d1 * d4 - d3 * d2 };
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+			return a + ab * (d1 / (d1 - d3));
+
+		vec3 cp(point - c);
+		float d5{ MathEngine::DotProduct(ab, cp) };
+		float d6{ MathEngine::DotProduct(ac, cp) };
+		if (d6 >= 0.0f && d5 <= d6)
+			return c;
+
+		float vb{ d5 * d2 - d1 * d6 };
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+			return a + ac * (d2 / (d2 - d6));
+
+		float va{ d3 * d6 - d5 * d4 };
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		//The point is inside the face region.
+		float denominator{ 1.0f / (va + vb + vc) };
+
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+
+	//Returns the point on segment p1-q1 closest to segment p2-q2.
+	static vec3 ClosestPointBetweenSegments(const vec3& p1, const vec3& q1, const vec3& p2, const vec3& q2)
+	{
+		vec3 d1(q1 - p1);
+		vec3 d2(q2 - p2);
+		vec3 r(p1 - p2);
+
+		float a{ MathEngine::DotProduct(d1, d1) };
+		float e{ MathEngine::DotProduct(d2, d2) };
+		float f{ MathEngine::DotProduct(d2, r) };
+		float c{ MathEngine::DotProduct(d1, r) };
+		float b{ MathEngine::DotProduct(d1, d2) };
+		float denominator{ a * e - b * b };
+
+		float s{ (denominator > FLT_MIN) ? std::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f };
+		float t{ (e > FLT_MIN) ? (b * s + f) / e : 0.0f };
+
+		if (t < 0.0f)
+			s = (a > FLT_MIN) ? std::clamp(-c / a, 0.0f, 1.0f) : 0.0f;
+		else if (t > 1.0f)
+			s = (a > FLT_MIN) ? std::clamp((b - c) / a, 0.0f, 1.0f) : 0.0f;
+
+		return p1 + d1 * s;
+	}
+
+	//Returns true if the arcs p1-p2 and q1-q2 on the unit sphere cross. Both arcs have to be shorter than half a circle.
+	static bool ArcsCross(const vec3& p1, const vec3& p2, const vec3& q1, const vec3& q2)
+	{
+		vec3 pNormal{ MathEngine::CrossProduct(p1, p2) };
+		vec3 qNormal{ MathEngine::CrossProduct(q1, q2) };
+
+		if (MathEngine::DotProduct(q1, pNormal) * MathEngine::DotProduct(q2, pNormal) >= 0.0f)
+			return false;
+
+		if (MathEngine::DotProduct(p1, qNormal) * MathEngine::DotProduct(p2, qNormal) >= 0.0f)
+			return false;
+
+		//The great circles cross at x and -x. Each arc contains one of them, they have to contain the same one.
+		vec3 x{ MathEngine::CrossProduct(pNormal, qNormal) };
+
+		return MathEngine::DotProduct(x, p1 + p2) * MathEngine::DotProduct(x, q1 + q2) > 0.0f;
+	}
+
+	//The convex hull in world coordinates, transformed once per CollideConvex call.
+	struct WorldHull
+	{
+		std::vector<vec3> vertices;
+		std::vector<vec3> faceNormals;
+		std::vector<float> faceDistances;
+
+		//Each edge once, with the normals of the faces on either side.
+		std::vector<unsigned int> edgeStarts;
+		std::vector<unsigned int> edgeEnds;
+		std::vector<unsigned int> edgeFacesA;
+		std::vector<unsigned int> edgeFacesB;
+
+		vec3 center;
+	};
+
+	//Returns the smallest distance of the hull vertices along the axis and the index of the vertex it belongs to.
+	static float ProjectMin(const WorldHull& hull, const vec3& axis, unsigned int& vertex)
+	{
+		float min{ FLT_MAX };
+
+		for (unsigned int i = 0; i < (unsigned int)hull.vertices.size(); ++i)
+		{
+			float distance{ MathEngine::DotProduct(hull.vertices[i], axis) };
+			if (distance < min)
+			{
+				min = distance;
+				vertex = i;
+			}
+		}
+
+		return min;
+	}
+
+	//Tests the hull against one triangle and adds the contacts if they intersect.
+	static void CollideConvexTriangle(const WorldHull& hull, const vec3& a, const vec3& b, const vec3& c, unsigned int triangle,
+		std::vector<MeshContact>& contacts)
+	{
+		vec3 normal{ MathEngine::CrossProduct(b - a, c - a) };
+		float length{ MathEngine::Length(normal) };
+		if (length < FLT_MIN)
+			return;
+
+		normal = normal * (1.0f / length);
+		const vec3* triangleVertices[3]{ &a, &b, &c };
+
+		//The separation along the best axis so far. The axis is the contact normal, pointing from the triangle to the hull.
+		enum AxisType { TRIANGLE_FACE, HULL_FACE, EDGES };
+		AxisType bestType{ TRIANGLE_FACE };
+		float bestSeparation{ -FLT_MAX };
+		vec3 bestAxis;
+		unsigned int bestFeature{ 0 };
+		unsigned int bestHullVertex{ 0 };
+		vec3 bestEdgePoint;
+
+		//The faces of the triangle, both sides.
+		for (unsigned int side = 0; side < 2; ++side)
+		{
+			vec3 axis{ (side == 0) ? normal : -normal };
+			unsigned int vertex{ 0 };
+			float separation{ ProjectMin(hull, axis, vertex) - MathEngine::DotProduct(axis, a) };
+
+			if (separation > 0.0f)
+				return;
+
+			if (separation > bestSeparation)
+			{
+				bestSeparation = separation;
+				bestAxis = axis;
+				bestType = TRIANGLE_FACE;
+				bestHullVertex = vertex;
+			}
+		}
+
+		//The faces of the hull. The triangle is separated if all its vertices are above a face.
+		const float faceBias{ 0.001f };
+		for (unsigned int i = 0; i < (unsigned int)hull.faceNormals.size(); ++i)
+		{
+			const vec3& n{ hull.faceNormals[i] };
+			float separation{ std::fmin(std::fmin(MathEngine::DotProduct(n, a), MathEngine::DotProduct(n, b)), MathEngine::DotProduct(n, c)) -
+				hull.faceDistances[i] };
+
+			if (separation > 0.0f)
+				return;
+
+			//Prefer the triangle face when they are about as good, it gives the most stable contacts.
+			if (separation > bestSeparation + faceBias)
+			{
+				bestSeparation = separation;
+				bestAxis = -n;
+				bestType = HULL_FACE;
+				bestFeature = i;
+			}
+		}
+
+		//The edge pairs that make a face of the Minkowski difference, found by crossing their arcs on the Gauss map.
+		//The arc of a triangle edge goes from -normal to normal through the opposite of the outward normal of the edge,
+		//split in two so each part is shorter than half a circle.
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const vec3& p2{ *triangleVertices[i] };
+			const vec3& q2{ *triangleVertices[(i + 1) % 3] };
+			vec3 triangleEdge{ q2 - p2 };
+			vec3 outward{ MathEngine::Normalize(MathEngine::CrossProduct(triangleEdge, normal)) };
+
+			for (unsigned int j = 0; j < (unsigned int)hull.edgeStarts.size(); ++j)
+			{
+				const vec3& faceA{ hull.faceNormals[hull.edgeFacesA[j]] };
+				const vec3& faceB{ hull.faceNormals[hull.edgeFacesB[j]] };
+
+				if (!ArcsCross(faceA, faceB, -normal, -outward) && !ArcsCross(faceA, faceB, -outward, normal))
+					continue;
+
+				const vec3& p1{ hull.vertices[hull.edgeStarts[j]] };
+				const vec3& q1{ hull.vertices[hull.edgeEnds[j]] };
+
+				vec3 axis{ MathEngine::CrossProduct(q1 - p1, triangleEdge) };
+				float axisLength{ MathEngine::Length(axis) };
+				if (axisLength < 1e-6f)
+					continue;
+
+				axis = axis * (1.0f / axisLength);
+				if (MathEngine::DotProduct(axis, p1 - hull.center) < 0.0f)
+					axis = -axis;
+
+				float separation{ MathEngine::DotProduct(axis, p2 - p1) };
+				if (separation > 0.0f)
+					return;
+
+				if (separation > bestSeparation + faceBias)
+				{
+					bestSeparation = separation;
+					bestAxis = -axis;
+					bestType = EDGES;
+					bestEdgePoint = ClosestPointBetweenSegments(p1, q1, p2, q2);
+				}
+			}
+		}
+
+		size_t firstContact{ contacts.size() };
+
+		if (bestType == TRIANGLE_FACE)
+		{
+			//The vertices of the hull below the triangle, inside its edges.
+			float planeDistance{ MathEngine::DotProduct(bestAxis, a) };
+
+			for (const auto& i : hull.vertices)
+			{
+				float depth{ planeDistance - MathEngine::DotProduct(bestAxis, i) };
+				if (depth <= 0.0f)
+					continue;
+
+				bool inside{ true };
+				for (unsigned int j = 0; j < 3 && inside; ++j)
+				{
+					const vec3& v{ *triangleVertices[j] };
+					vec3 inward{ MathEngine::CrossProduct(normal, *triangleVertices[(j + 1) % 3] - v) };
+					inside = MathEngine::DotProduct(inward, i - v) >= 0.0f;
+				}
+
+				if (inside)
+					contacts.push_back(MeshContact{ triangle, i, bestAxis, depth });
+			}
+
+			if (contacts.size() == firstContact)
+				contacts.push_back(MeshContact{ triangle, hull.vertices[bestHullVertex], bestAxis, -bestSeparation });
+		}
+		else if (bestType == HULL_FACE)
+		{
+			//The vertices of the triangle inside the hull, moved out to the face of the hull.
+			const vec3& n{ hull.faceNormals[bestFeature] };
+			float maxDepth{ -FLT_MAX };
+			vec3 deepestPoint;
+
+			for (auto i : triangleVertices)
+			{
+				float depth{ hull.faceDistances[bestFeature] - MathEngine::DotProduct(n, *i) };
+				vec3 point{ *i + n * depth };
+
+				if (depth > maxDepth)
+				{
+					maxDepth = depth;
+					deepestPoint = point;
+				}
+
+				bool inside{ true };
+				for (unsigned int j = 0; j < (unsigned int)hull.faceNormals.size() && inside; ++j)
+				{
+					inside = MathEngine::DotProduct(hull.faceNormals[j], *i) <= hull.faceDistances[j];
+				}
+
+				if (inside && depth > 0.0f)
+					contacts.push_back(MeshContact{ triangle, point, bestAxis, depth });
+			}
+
+			if (contacts.size() == firstContact)
+				contacts.push_back(MeshContact{ triangle, deepestPoint, bestAxis, -bestSeparation });
+		}
+		else
+		{
+			contacts.push_back(MeshContact{ triangle, bestEdgePoint, bestAxis, -bestSeparation });
+		}
+	}
+
+	TriangleMeshCollider::TriangleMeshCollider()
+	{}
+
+	void TriangleMeshCollider::InitializeTriangleMeshCollider(const std::vector<vec3>& vertices, const std::vector<unsigned int>& indices,
+		unsigned int numThreads)
+	{
+		mVertices = vertices;
+		mIndices.assign(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+
+		BuildHierarchy(numThreads);
+	}
+
+	void TriangleMeshCollider::InitializeTriangleMeshCollider(const std::vector<ShapesEngine::Vertex>& vertices,
+		const std::vector<unsigned int>& indices, unsigned int numThreads)
+	{
+		std::vector<vec3> positions(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			positions[i] = vertices[i].position;
+		}
+
+		InitializeTriangleMeshCollider(positions, indices, numThreads);
+	}
+
+	void TriangleMeshCollider::InitializeTriangleMeshCollider(const std::vector<ShapesEngine::Triangle>& triangles, unsigned int numThreads)
+	{
+		//The triangles of a mesh share one vertex list, so copy the list once. Otherwise every triangle gets its own 3 vertices.
+		bool sharedList{ true };
+		unsigned int numVertices{ 0 };
+		for (const auto& i : triangles)
+		{
+			sharedList = sharedList && i.vertexList == triangles[0].vertexList;
+			numVertices = std::max(numVertices, std::max(i.p0, std::max(i.p1, i.p2)) + 1);
+		}
+
+		std::vector<vec3> positions;
+		std::vector<unsigned int> indices;
+		indices.reserve(triangles.size() * 3);
+
+		if (sharedList && !triangles.empty())
+		{
+			positions.resize(numVertices);
+			for (unsigned int i = 0; i < numVertices; ++i)
+			{
+				positions[i] = triangles[0].vertexList[i].position;
+			}
+
+			for (const auto& i : triangles)
+			{
+				indices.push_back(i.p0);
+				indices.push_back(i.p1);
+				indices.push_back(i.p2);
+			}
+		}
+		else
+		{
+			for (const auto& i : triangles)
+			{
+				indices.push_back((unsigned int)positions.size());
+				positions.push_back(i.vertexList[i.p0].position);
+				indices.push_back((unsigned int)positions.size());
+				positions.push_back(i.vertexList[i.p1].position);
+				indices.push_back((unsigned int)positions.size());
+				positions.push_back(i.vertexList[i.p2].position);
+			}
+		}
+
+		InitializeTriangleMeshCollider(positions, indices, numThreads);
+	}
+
+	void BuildMeshBVH(const std::vector<vec3>& mins, const std::vector<vec3>& maxs, std::vector<MeshBVHNode>& nodes,
+		std::vector<unsigned int>& order, unsigned int numThreads)
+	{
+		unsigned int numBoxes{ (unsigned int)mins.size() };
+
+		nodes.clear();
+		order.clear();
+
+		if (numBoxes == 0)
+			return;
+
+		if (numThreads == 0)
+			numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		MeshBuilder builder;
+		builder.triangleMin = mins.data();
+		builder.triangleMax = maxs.data();
+		builder.centroids.resize(numBoxes);
+		builder.order.resize(numBoxes);
+
+		for (unsigned int i = 0; i < numBoxes; ++i)
+		{
+			builder.centroids[i] = (mins[i] + maxs[i]) * 0.5f;
+			builder.order[i] = i;
+		}
+
+		//A tree with leaves of at least one box has at most 2n - 1 nodes. The children are allocated in pairs with an atomic counter,
+		//so the threads fill the nodes without locking and the used nodes end up packed at the front.
+		nodes.resize(2 * (size_t)numBoxes);
+		builder.nodes = nodes.data();
+		builder.numNodes = 1;
+
+		BuildNode(builder, 0, 0, numBoxes, 0, numThreads);
+
+		nodes.resize(builder.numNodes);
+
+		if (numThreads > 1)
+		{
+			//The threads take node pairs in whatever order they get to them. Lay the nodes out again in the order a single thread
+			//would have used, so the hierarchy is the same no matter how many threads built it.
+			std::vector<MeshBVHNode> ordered(nodes.size());
+			ordered[0] = nodes[0];
+			unsigned int numNodes{ 1 };
+
+			std::vector<unsigned int> stack{ 0 };
+			while (!stack.empty())
+			{
+				unsigned int node{ stack.back() };
+				stack.pop_back();
+
+				if (ordered[node].count > 0)
+					continue;
+
+				unsigned int oldLeft{ ordered[node].leftOrFirst };
+				ordered[numNodes] = nodes[oldLeft];
+				ordered[numNodes + 1] = nodes[oldLeft + 1];
+				ordered[node].leftOrFirst = numNodes;
+
+				stack.push_back(numNodes + 1);
+				stack.push_back(numNodes);
+				numNodes += 2;
+			}
+
+			nodes.swap(ordered);
+		}
+
+		nodes.shrink_to_fit();
+		order.swap(builder.order);
+	}
+
+	void TriangleMeshCollider::BuildHierarchy(unsigned int numThreads)
+	{
+		unsigned int numTriangles{ (unsigned int)mIndices.size() / 3 };
+
+		std::vector<vec3> triangleMin(numTriangles);
+		std::vector<vec3> triangleMax(numTriangles);
+
+		for (unsigned int i = 0; i < numTriangles; ++i)
+		{
+			const vec3& a{ mVertices[mIndices[3 * i]] };
+			const vec3& b{ mVertices[mIndices[3 * i + 1]] };
+			const vec3& c{ mVertices[mIndices[3 * i + 2]] };
+
+			triangleMin[i] = Min(a, Min(b, c));
+			triangleMax[i] = Max(a, Max(b, c));
+		}
+
+		std::vector<unsigned int> order;
+		BuildMeshBVH(triangleMin, triangleMax, mNodes, order, numThreads);
+
+		//Store the triangles in the order of the leaves so each leaf is a contiguous range.
+		std::vector<unsigned int> indices(mIndices.size());
+		for (unsigned int i = 0; i < numTriangles; ++i)
+		{
+			unsigned int triangle{ order[i] };
+			indices[3 * i] = mIndices[3 * triangle];
+			indices[3 * i + 1] = mIndices[3 * triangle + 1];
+			indices[3 * i + 2] = mIndices[3 * triangle + 2];
+		}
+
+		mIndices.swap(indices);
+		mTriangleIds.swap(order);
+	}
+
+	unsigned int TriangleMeshCollider::GetNumberOfTriangles() const
+	{
+		return (unsigned int)mTriangleIds.size();
+	}
+
+	const std::vector<MeshBVHNode>& TriangleMeshCollider::GetNodes() const
+	{
+		return mNodes;
+	}
+
+	const std::vector<vec3>& TriangleMeshCollider::GetVertices() const
+	{
+		return mVertices;
+	}
+
+	const std::vector<unsigned int>& TriangleMeshCollider::GetIndices() const
+	{
+		return mIndices;
+	}
+
+	const std::vector<unsigned int>& TriangleMeshCollider::GetTriangleIds() const
+	{
+		return mTriangleIds;
+	}
+
+	void TriangleMeshCollider::FindTriangles(const vec3& min, const vec3& max, std::vector<unsigned int>& triangles) const
+	{
+		triangles.clear();
+
+		ForEachLeaf(mNodes, min, max, [this, &min, &max, &triangles](unsigned int first, unsigned int count)
+			{
+				for (unsigned int i = first; i < first + count; ++i)
+				{
+					const vec3& a{ mVertices[mIndices[3 * i]] };
+					const vec3& b{ mVertices[mIndices[3 * i + 1]] };
+					const vec3& c{ mVertices[mIndices[3 * i + 2]] };
+
+					vec3 triangleMin{ Min(a, Min(b, c)) };
+					vec3 triangleMax{ Max(a, Max(b, c)) };
+
+					if (triangleMin.x <= max.x && triangleMax.x >= min.x && triangleMin.y <= max.y && triangleMax.y >= min.y &&
+						triangleMin.z <= max.z && triangleMax.z >= min.z)
+						triangles.push_back(mTriangleIds[i]);
+				}
+			});
+	}
+
+	bool TriangleMeshCollider::CastRay(const vec3& origin, const vec3& direction, float maxDistance, MeshRayHit& hit) const
+	{
+		if (mNodes.empty())
+			return false;
+
+		vec3 inverseDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+		float closest{ maxDistance };
+		unsigned int closestTriangle{ 0xffffffff };
+
+		unsigned int stack[MAX_TRAVERSAL_DEPTH];
+		unsigned int stackSize{ 0 };
+
+		if (IntersectRayNode(mNodes[0], origin, inverseDirection, closest) != FLT_MAX)
+			stack[stackSize++] = 0;
+
+		while (stackSize > 0)
+		{
+			const MeshBVHNode& node{ mNodes[stack[--stackSize]] };
+
+			if (node.count > 0)
+			{
+				for (unsigned int i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i)
+				{
+					float t{ 0.0f };
+					if (IntersectRayTriangle(origin, direction, closest, mVertices[mIndices[3 * i]], mVertices[mIndices[3 * i + 1]],
+						mVertices[mIndices[3 * i + 2]], t))
+					{
+						closest = t;
+						closestTriangle = i;
+					}
+				}
+
+				continue;
+			}
+
+			//Visit the nearer child first so farther nodes can be skipped once a hit is found.
+			unsigned int left{ node.leftOrFirst };
+			float leftDistance{ IntersectRayNode(mNodes[left], origin, inverseDirection, closest) };
+			float rightDistance{ IntersectRayNode(mNodes[left + 1], origin, inverseDirection, closest) };
+
+			unsigned int nearChild{ left };
+			unsigned int farChild{ left + 1 };
+			if (rightDistance < leftDistance)
+			{
+				std::swap(leftDistance, rightDistance);
+				std::swap(nearChild, farChild);
+			}
+
+			if (rightDistance != FLT_MAX)
+				stack[stackSize++] = farChild;
+
+			if (leftDistance != FLT_MAX)
+				stack[stackSize++] = nearChild;
+		}
+
+		if (closestTriangle == 0xffffffff)
+			return false;
+
+		const vec3& p0{ mVertices[mIndices[3 * closestTriangle]] };
+		vec3 normal{ MathEngine::CrossProduct(mVertices[mIndices[3 * closestTriangle + 1]] - p0, mVertices[mIndices[3 * closestTriangle + 2]] - p0) };
+		normal = MathEngine::Normalize(normal);
+		if (MathEngine::DotProduct(normal, direction) > 0.0f)
+			normal = -normal;
+
+		hit.triangle = mTriangleIds[closestTriangle];
+		hit.distance = closest;
+		hit.point = origin + direction * closest;
+		hit.normal = normal;
+
+		return true;
+	}
+
+	void TriangleMeshCollider::CollideSphere(const vec3& center, float radius, std::vector<MeshContact>& contacts) const
+	{
+		vec3 extent{ radius, radius, radius };
+
+		ForEachLeaf(mNodes, center - extent, center + extent, [this, &center, radius, &contacts](unsigned int first, unsigned int count)
+			{
+				for (unsigned int i = first; i < first + count; ++i)
+				{
+					const vec3& a{ mVertices[mIndices[3 * i]] };
+					const vec3& b{ mVertices[mIndices[3 * i + 1]] };
+					const vec3& c{ mVertices[mIndices[3 * i + 2]] };
+
+					vec3 closestPoint{ ClosestPointOnTriangle(center, a, b, c) };
+					vec3 d{ center - closestPoint };
+					float distanceSquared{ MathEngine::DotProduct(d, d) };
+
+					if (distanceSquared >= radius * radius)
+						continue;
+
+					float distance{ std::sqrt(distanceSquared) };
+					vec3 normal;
+
+					if (distance > 1e-6f)
+					{
+						normal = d * (1.0f / distance);
+					}
+					else
+					{
+						//The center is on the triangle, push it out along the triangle normal.
+						normal = MathEngine::Normalize(MathEngine::CrossProduct(b - a, c - a));
+					}
+
+					contacts.push_back(MeshContact{ mTriangleIds[i], center - normal * radius, normal, radius - distance });
+				}
+			});
+	}
+
+	void TriangleMeshCollider::CollideConvex(const ConvexHull& hull, const vec3& position, const MathEngine::Quaternion& orientation,
+		std::vector<MeshContact>& contacts) const
+	{
+		if (mNodes.empty() || hull.vertices.empty())
+			return;
+
+		mat3 rotation(QuaternionToRotationMatrixRow3x3(orientation));
+
+		WorldHull worldHull;
+		worldHull.vertices.resize(hull.vertices.size());
+
+		vec3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+		vec3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		vec3 sum;
+		for (size_t i = 0; i < hull.vertices.size(); ++i)
+		{
+			worldHull.vertices[i] = hull.vertices[i] * rotation + position;
+			min = Min(min, worldHull.vertices[i]);
+			max = Max(max, worldHull.vertices[i]);
+			sum += worldHull.vertices[i];
+		}
+		worldHull.center = sum * (1.0f / hull.vertices.size());
+
+		worldHull.faceNormals.resize(hull.faceNormals.size());
+		worldHull.faceDistances.resize(hull.faceNormals.size());
+		for (size_t i = 0; i < hull.faceNormals.size(); ++i)
+		{
+			worldHull.faceNormals[i] = hull.faceNormals[i] * rotation;
+			worldHull.faceDistances[i] = hull.faceDistances[i] + MathEngine::DotProduct(worldHull.faceNormals[i], position);
+		}
+
+		//Each edge appears in the neighbor lists of both its vertices, keep the direction from the lower to the higher index.
+		for (unsigned int u = 0; u < (unsigned int)hull.vertices.size(); ++u)
+		{
+			for (unsigned int k = hull.neighborOffsets[u]; k < hull.neighborOffsets[u + 1]; ++k)
+			{
+				unsigned int v{ hull.neighbors[k] };
+				if (v < u)
+					continue;
+
+				for (unsigned int l = hull.neighborOffsets[v]; l < hull.neighborOffsets[v + 1]; ++l)
+				{
+					if (hull.neighbors[l] == u)
+					{
+						worldHull.edgeStarts.push_back(u);
+						worldHull.edgeEnds.push_back(v);
+						worldHull.edgeFacesA.push_back(hull.edgeFaces[k]);
+						worldHull.edgeFacesB.push_back(hull.edgeFaces[l]);
+						break;
+					}
+				}
+			}
+		}
+
+		ForEachLeaf(mNodes, min, max, [this, &worldHull, &contacts](unsigned int first, unsigned int count)
+			{
+				for (unsigned int i = first; i < first + count; ++i)
+				{
+					CollideConvexTriangle(worldHull, mVertices[mIndices[3 * i]], mVertices[mIndices[3 * i + 1]], mVertices[mIndices[3 * i + 2]],
+						mTriangleIds[i], contacts);
+				}
+			});
+	}
+
+	void TriangleMeshCollider::Save(std::vector<unsigned char>& data) const
+	{
+		MeshColliderHeader header;
+		header.numVertices = (unsigned int)mVertices.size();
+		header.numTriangles = (unsigned int)mTriangleIds.size();
+		header.numNodes = (unsigned int)mNodes.size();
+
+		size_t vertexBytes{ mVertices.size() * sizeof(vec3) };
+		size_t indexBytes{ mIndices.size() * sizeof(unsigned int) };
+		size_t idBytes{ mTriangleIds.size() * sizeof(unsigned int) };
+		size_t nodeBytes{ mNodes.size() * sizeof(MeshBVHNode) };
+
+		data.resize(sizeof(header) + vertexBytes + indexBytes + idBytes + nodeBytes);
+
+		unsigned char* p{ data.data() };
+		std::memcpy(p, &header, sizeof(header));
+		p += sizeof(header);
+
+		if (vertexBytes > 0)
+			std::memcpy(p, mVertices.data(), vertexBytes);
+		p += vertexBytes;
+
+		if (indexBytes > 0)
+			std::memcpy(p, mIndices.data(), indexBytes);
+		p += indexBytes;
+
+		if (idBytes > 0)
+			std::memcpy(p, mTriangleIds.data(), idBytes);
+		p += idBytes;
+
+		if (nodeBytes > 0)
+			std::memcpy(p, mNodes.data(), nodeBytes);
+	}
+
+	bool TriangleMeshCollider::Load(const unsigned char* data, size_t size)
+	{
+		if (data == nullptr || size < sizeof(MeshColliderHeader))
+			return false;
+
+		MeshColliderHeader header;
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != MeshColliderHeader{}.magic || header.version == 0 || header.version > MESH_COLLIDER_VERSION)
+			return false;
+
+		size_t vertexBytes{ (size_t)header.numVertices * sizeof(vec3) };
+		size_t indexBytes{ (size_t)header.numTriangles * 3 * sizeof(unsigned int) };
+		size_t idBytes{ (size_t)header.numTriangles * sizeof(unsigned int) };
+		size_t nodeBytes{ (size_t)header.numNodes * sizeof(MeshBVHNode) };
+
+		if (size - sizeof(header) < vertexBytes + indexBytes + idBytes + nodeBytes)
+			return false;
+
+		if ((header.numTriangles == 0) != (header.numNodes == 0) || header.numNodes > 2 * (size_t)header.numTriangles)
+			return false;
+
+		std::vector<vec3> vertices(header.numVertices);
+		std::vector<unsigned int> indices((size_t)header.numTriangles * 3);
+		std::vector<unsigned int> triangleIds(header.numTriangles);
+		std::vector<MeshBVHNode> nodes(header.numNodes);
+
+		const unsigned char* p{ data + sizeof(header) };
+		if (vertexBytes > 0)
+			std::memcpy(vertices.data(), p, vertexBytes);
+		p += vertexBytes;
+
+		if (indexBytes > 0)
+			std::memcpy(indices.data(), p, indexBytes);
+		p += indexBytes;
+
+		if (idBytes > 0)
+			std::memcpy(triangleIds.data(), p, idBytes);
+		p += idBytes;
+
+		if (nodeBytes > 0)
+			std::memcpy(nodes.data(), p, nodeBytes);
+
+		//Check every index so a damaged file cannot make the queries read out of bounds.
+		for (auto i : indices)
+		{
+			if (i >= header.numVertices)
+				return false;
+		}
+
+		//The build always puts the children after their parent, so a child index that is not greater than the index of its parent
+		//means the file is damaged and could have a cycle. Knowing the parents come first, the depths are found in one pass.
+		std::vector<unsigned int> depths(header.numNodes, 0);
+		for (unsigned int i = 0; i < header.numNodes; ++i)
+		{
+			const MeshBVHNode& node{ nodes[i] };
+			if (node.count > 0)
+			{
+				if (node.leftOrFirst > header.numTriangles || node.count > header.numTriangles - node.leftOrFirst)
+					return false;
+			}
+			else
+			{
+				if (node.leftOrFirst <= i || node.leftOrFirst + 1 >= header.numNodes || depths[i] + 1 >= MAX_TRAVERSAL_DEPTH)
+					return false;
+
+				depths[node.leftOrFirst] = std::max(depths[node.leftOrFirst], depths[i] + 1);
+				depths[node.leftOrFirst + 1] = std::max(depths[node.leftOrFirst + 1], depths[i] + 1);
+			}
+		}
+
+		mVertices.swap(vertices);
+		mIndices.swap(indices);
+		mTriangleIds.swap(triangleIds);
+		mNodes.swap(nodes);
+
+		return true;
+	}
+
+	bool TriangleMeshCollider::SaveToFile(const std::string& filename) const
+	{
+		std::vector<unsigned char> data;
+		Save(data);
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file)
+			return false;
+
+		file.write((const char*)data.data(), (std::streamsize)data.size());
+
+		return (bool)file;
+	}
+
+	bool TriangleMeshCollider::LoadFromFile(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+
+		std::streamsize size{ file.tellg() };
+		if (size <= 0)
+			return false;
+
+		std::vector<unsigned char> data((size_t)size);
+		file.seekg(0);
+		if (!file.read((char*)data.data(), size))
+			return false;
+
+		return Load(data.data(), data.size());
+	}
+}
\ No newline at end of file
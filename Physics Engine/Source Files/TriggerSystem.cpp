@@ -0,0 +1,261 @@
+#include "TriggerSystem.h"
+
+namespace PhysicsEngine
+{
+	//The key of an empty slot. No trigger and body can both have the index 0xffffffff.
+	static const unsigned long long EMPTY_KEY{ 0xffffffffffffffff };
+
+	//The smallest number of slots in the pair cache. The table grows before it is half full.
+	static const unsigned int MIN_TABLE_SIZE{ 64 };
+
+	static unsigned int HashKey(unsigned long long key, unsigned int tableSize)
+	{
+		//Fibonacci hashing, the high bits of the product are mixed from all the bits of the key.
+		return (unsigned int)((key * 0x9e3779b97f4a7c15ull) >> 32) & (tableSize - 1);
+	}
+
+	TriggerSystem::TriggerSystem() : mUpdate{ 0 }
+	{}
+
+	unsigned int TriggerSystem::AddTrigger(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation,
+		unsigned int mask, bool reportStay)
+	{
+		unsigned int trigger{ (unsigned int)mTriggerVolumes.size() };
+
+		//A trigger only pairs with bodies, so it does not see the trigger layer.
+		CollisionFilter filter{ TRIGGER_COLLISION_LAYER, mask & ~TRIGGER_COLLISION_LAYER, 0 };
+
+		vec3 min;
+		vec3 max;
+		ComputeShapeBounds(shape, position, orientation, min, max);
+
+		mTriggerVolumes.push_back(mBroadphase.AddBody(min, max, filter));
+		mVolumes.push_back(Volume{ shape, position, orientation, trigger, true });
+		mReportStay.push_back(reportStay);
+
+		return trigger;
+	}
+
+	unsigned int TriggerSystem::AddBody(const CollisionShape& shape, const vec3& position, const MathEngine::Quaternion& orientation,
+		unsigned int layer)
+	{
+		unsigned int body{ (unsigned int)mBodyVolumes.size() };
+
+		//A body only pairs with triggers, so bodies are never tested against each other.
+		CollisionFilter filter{ layer & ~TRIGGER_COLLISION_LAYER, TRIGGER_COLLISION_LAYER, 0 };
+
+		vec3 min;
+		vec3 max;
+		ComputeShapeBounds(shape, position, orientation, min, max);
+
+		mBodyVolumes.push_back(mBroadphase.AddBody(min, max, filter));
+		mVolumes.push_back(Volume{ shape, position, orientation, body, false });
+
+		return body;
+	}
+
+	void TriggerSystem::Clear()
+	{
+		mBroadphase.ClearBodies();
+		mVolumes.clear();
+		mTriggerVolumes.clear();
+		mBodyVolumes.clear();
+		mReportStay.clear();
+
+		mOverlaps.clear();
+		mTableKeys.clear();
+		mTableOverlaps.clear();
+
+		mEvents.clear();
+	}
+
+	unsigned int TriggerSystem::GetNumberOfTriggers() const
+	{
+		return (unsigned int)mTriggerVolumes.size();
+	}
+
+	unsigned int TriggerSystem::GetNumberOfBodies() const
+	{
+		return (unsigned int)mBodyVolumes.size();
+	}
+
+	void TriggerSystem::SetTriggerPose(unsigned int trigger, const vec3& position, const MathEngine::Quaternion& orientation)
+	{
+		Volume& volume{ mVolumes[mTriggerVolumes[trigger]] };
+		volume.position = position;
+		volume.orientation = orientation;
+		UpdateBounds(mTriggerVolumes[trigger]);
+	}
+
+	void TriggerSystem::SetBodyPose(unsigned int body, const vec3& position, const MathEngine::Quaternion& orientation)
+	{
+		Volume& volume{ mVolumes[mBodyVolumes[body]] };
+		volume.position = position;
+		volume.orientation = orientation;
+		UpdateBounds(mBodyVolumes[body]);
+	}
+
+	void TriggerSystem::ShiftOrigin(const vec3& shift)
+	{
+		for (auto& i : mVolumes)
+		{
+			i.position -= shift;
+		}
+
+		mBroadphase.ShiftOrigin(shift);
+	}
+
+	void TriggerSystem::UpdateBounds(unsigned int volume)
+	{
+		vec3 min;
+		vec3 max;
+		ComputeShapeBounds(mVolumes[volume].shape, mVolumes[volume].position, mVolumes[volume].orientation, min, max);
+		mBroadphase.SetBounds(volume, min, max);
+	}
+
+	unsigned long long TriggerSystem::MakeKey(unsigned int trigger, unsigned int body)
+	{
+		return ((unsigned long long)trigger << 32) | body;
+	}
+
+	unsigned int TriggerSystem::FindSlot(unsigned long long key) const
+	{
+		unsigned int tableSize{ (unsigned int)mTableKeys.size() };
+		unsigned int slot{ HashKey(key, tableSize) };
+		while (mTableKeys[slot] != key && mTableKeys[slot] != EMPTY_KEY)
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		return slot;
+	}
+
+	void TriggerSystem::GrowTable()
+	{
+		unsigned int tableSize{ (mTableKeys.empty()) ? MIN_TABLE_SIZE : 2 * (unsigned int)mTableKeys.size() };
+		mTableKeys.assign(tableSize, EMPTY_KEY);
+		mTableOverlaps.resize(tableSize);
+
+		for (unsigned int i = 0; i < (unsigned int)mOverlaps.size(); ++i)
+		{
+			unsigned int slot{ FindSlot(mOverlaps[i].key) };
+			mTableKeys[slot] = mOverlaps[i].key;
+			mTableOverlaps[slot] = i;
+		}
+	}
+
+	void TriggerSystem::InsertOverlap(unsigned long long key)
+	{
+		if (2 * (mOverlaps.size() + 1) > mTableKeys.size())
+			GrowTable();
+
+		unsigned int slot{ FindSlot(key) };
+		mTableKeys[slot] = key;
+		mTableOverlaps[slot] = (unsigned int)mOverlaps.size();
+		mOverlaps.push_back(Overlap{ key, mUpdate });
+	}
+
+	void TriggerSystem::RemoveOverlap(unsigned int overlap)
+	{
+		unsigned int tableSize{ (unsigned int)mTableKeys.size() };
+		unsigned int slot{ FindSlot(mOverlaps[overlap].key) };
+
+		//Shift the keys after the removed one back, so every key can still be reached from its home slot without tombstones.
+		unsigned int next{ slot };
+		while (true)
+		{
+			next = (next + 1) & (tableSize - 1);
+			if (mTableKeys[next] == EMPTY_KEY)
+				break;
+
+			unsigned int home{ HashKey(mTableKeys[next], tableSize) };
+			bool homeBetween{ (slot <= next) ? (slot < home && home <= next) : (slot < home || home <= next) };
+			if (homeBetween)
+				continue;
+
+			mTableKeys[slot] = mTableKeys[next];
+			mTableOverlaps[slot] = mTableOverlaps[next];
+			slot = next;
+		}
+
+		mTableKeys[slot] = EMPTY_KEY;
+
+		//Move the last overlap into the hole.
+		unsigned int last{ (unsigned int)mOverlaps.size() - 1 };
+		if (overlap != last)
+		{
+			mOverlaps[overlap] = mOverlaps[last];
+			mTableOverlaps[FindSlot(mOverlaps[overlap].key)] = overlap;
+		}
+
+		mOverlaps.pop_back();
+	}
+
+	void TriggerSystem::Update()
+	{
+		++mUpdate;
+		mEvents.clear();
+
+		mBroadphase.FindPairs();
+
+		for (const auto& i : mBroadphase.GetPairs())
+		{
+			//The filters only let a trigger pair with a body.
+			const Volume& a{ mVolumes[i.bodyA] };
+			const Volume& b{ mVolumes[i.bodyB] };
+			const Volume& trigger{ a.isTrigger ? a : b };
+			const Volume& body{ a.isTrigger ? b : a };
+
+			ContactManifold manifold;
+			if (!Collide(trigger.shape, trigger.position, trigger.orientation, body.shape, body.position, body.orientation, manifold))
+				continue;
+
+			unsigned long long key{ MakeKey(trigger.index, body.index) };
+			unsigned int slot{ (mTableKeys.empty()) ? 0 : FindSlot(key) };
+
+			if (mTableKeys.empty() || mTableKeys[slot] == EMPTY_KEY)
+			{
+				InsertOverlap(key);
+				mEvents.push_back(TriggerEvent{ TRIGGER_ENTER, trigger.index, body.index });
+				continue;
+			}
+
+			mOverlaps[mTableOverlaps[slot]].update = mUpdate;
+			if (mReportStay[trigger.index])
+				mEvents.push_back(TriggerEvent{ TRIGGER_STAY, trigger.index, body.index });
+		}
+
+		//The overlaps that were not found this update have ended.
+		unsigned int i{ 0 };
+		while (i < (unsigned int)mOverlaps.size())
+		{
+			if (mOverlaps[i].update == mUpdate)
+			{
+				++i;
+				continue;
+			}
+
+			unsigned long long key{ mOverlaps[i].key };
+			mEvents.push_back(TriggerEvent{ TRIGGER_EXIT, (unsigned int)(key >> 32), (unsigned int)(key & 0xffffffff) });
+			RemoveOverlap(i);
+		}
+	}
+
+	const std::vector<TriggerEvent>& TriggerSystem::GetEvents() const
+	{
+		return mEvents;
+	}
+
+	unsigned int TriggerSystem::GetNumberOfOverlaps() const
+	{
+		return (unsigned int)mOverlaps.size();
+	}
+
+	bool TriggerSystem::IsOverlapping(unsigned int trigger, unsigned int body) const
+	{
+		if (mTableKeys.empty())
+			return false;
+
+		return mTableKeys[FindSlot(MakeKey(trigger, body))] != EMPTY_KEY;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "WorldBatch.h"
+#include <xmmintrin.h>
+#include <thread>
+
+namespace PhysicsEngine
+{
+	//The number of worlds a thread takes through all the steps at once. 64 worlds of 5 bodies is about 42 KB of body packets.
+	static const unsigned int WORLD_TILE_SIZE{ 64 };
+
+	//Threads get a multiple of this many worlds so two threads never write to the same packet.
+	static const unsigned int WORLD_THREAD_ALIGNMENT{ 16 };
+
+	void ClearSamples(WorldBatchSamples& samples)
+	{
+		samples.numSamples = 0;
+		samples.centerOfMassX.clear();
+		samples.centerOfMassY.clear();
+		samples.centerOfMassZ.clear();
+	}
+
+	WorldBatch::WorldBatch() : mNumWorlds{ 0 }, mBodiesPerWorld{ 0 }, mNumSteps{ 0 }
+	{}
+
+	WorldBatch::WorldBatch(unsigned int numWorlds, unsigned int bodiesPerWorld) : mNumWorlds{ 0 }, mBodiesPerWorld{ 0 }, mNumSteps{ 0 }
+	{
+		InitializeWorldBatch(numWorlds, bodiesPerWorld);
+	}
+
+	void WorldBatch::InitializeWorldBatch(unsigned int numWorlds, unsigned int bodiesPerWorld)
+	{
+		mNumWorlds = numWorlds;
+		mBodiesPerWorld = bodiesPerWorld;
+		mNumSteps = 0;
+
+		//The last packet of each body is filled up with worlds that have no mass, so every packet is stepped the same way.
+		unsigned int paddedWorlds{ (numWorlds + BODY_PACKET_WIDTH - 1) / BODY_PACKET_WIDTH * BODY_PACKET_WIDTH };
+		unsigned int numBodies{ paddedWorlds * bodiesPerWorld };
+		ResizeBodies(mBodies, 0);
+		ResizeBodies(mBodies, numBodies);
+
+		RigidBody body;
+		for (unsigned int i = 0; i < numWorlds; ++i)
+		{
+			for (unsigned int j = 0; j < bodiesPerWorld; ++j)
+			{
+				LoadRigidBody(mBodies, GetBodyIndex(i, j), body);
+			}
+		}
+
+		mForceOffsetX.assign(numBodies, 0.0f);
+		mForceOffsetY.assign(numBodies, 0.0f);
+		mForceOffsetZ.assign(numBodies, 0.0f);
+
+		mGravityX.assign(paddedWorlds, 0.0f);
+		mGravityY.assign(paddedWorlds, 0.0f);
+		mGravityZ.assign(paddedWorlds, 0.0f);
+		mDragK1.assign(paddedWorlds, 0.0f);
+		mDragK2.assign(paddedWorlds, 0.0f);
+	}
+
+	unsigned int WorldBatch::GetNumberOfWorlds() const
+	{
+		return mNumWorlds;
+	}
+
+	unsigned int WorldBatch::GetBodiesPerWorld() const
+	{
+		return mBodiesPerWorld;
+	}
+
+	unsigned long long WorldBatch::GetNumberOfSteps() const
+	{
+		return mNumSteps;
+	}
+
+	unsigned int WorldBatch::GetBodyIndex(unsigned int world, unsigned int body) const
+	{
+		return ((world / BODY_PACKET_WIDTH) * mBodiesPerWorld + body) * BODY_PACKET_WIDTH + world % BODY_PACKET_WIDTH;
+	}
+
+	const BodyPacketArrays& WorldBatch::GetBodies() const
+	{
+		return mBodies;
+	}
+
+	void WorldBatch::SetBody(unsigned int world, unsigned int body, const RigidBody& rigidBody)
+	{
+		LoadRigidBody(mBodies, GetBodyIndex(world, body), rigidBody);
+	}
+
+	void WorldBatch::StoreBody(unsigned int world, unsigned int body, RigidBody& rigidBody) const
+	{
+		StoreRigidBody(mBodies, GetBodyIndex(world, body), rigidBody);
+	}
+
+	vec3 WorldBatch::GetCenterOfMass(unsigned int world, unsigned int body) const
+	{
+		unsigned int index{ GetBodyIndex(world, body) };
+		const BodyPacket& packet{ mBodies.packets[index / BODY_PACKET_WIDTH] };
+		unsigned int lane{ index % BODY_PACKET_WIDTH };
+
+		return vec3{ packet.centerOfMassX[lane], packet.centerOfMassY[lane], packet.centerOfMassZ[lane] };
+	}
+
+	void WorldBatch::SetGravity(unsigned int world, const vec3& acceleration)
+	{
+		mGravityX[world] = acceleration.x;
+		mGravityY[world] = acceleration.y;
+		mGravityZ[world] = acceleration.z;
+	}
+
+	void WorldBatch::SetDrag(unsigned int world, float k1, float k2)
+	{
+		mDragK1[world] = k1;
+		mDragK2[world] = k2;
+	}
+
+	void WorldBatch::SetForceOffset(unsigned int world, unsigned int body, const vec3& offset)
+	{
+		unsigned int index{ GetBodyIndex(world, body) };
+		mForceOffsetX[index] = offset.x;
+		mForceOffsetY[index] = offset.y;
+		mForceOffsetZ[index] = offset.z;
+	}
+
+	void WorldBatch::StepTile(unsigned int firstWorld, unsigned int numWorlds, unsigned int numSteps, float dt, WorldBatchSamples* samples,
+		unsigned int firstSample)
+	{
+		//The tile starts at the first world of a packet and takes every packet it touches.
+		unsigned int firstGroup{ firstWorld / BODY_PACKET_WIDTH };
+		unsigned int lastGroup{ (firstWorld + numWorlds + BODY_PACKET_WIDTH - 1) / BODY_PACKET_WIDTH };
+
+		for (unsigned int step = 0; step < numSteps; ++step)
+		{
+			for (unsigned int group = firstGroup; group < lastGroup; ++group)
+			{
+				const float* gravityX{ mGravityX.data() + group * BODY_PACKET_WIDTH };
+				const float* gravityY{ mGravityY.data() + group * BODY_PACKET_WIDTH };
+				const float* gravityZ{ mGravityZ.data() + group * BODY_PACKET_WIDTH };
+				const float* dragK1{ mDragK1.data() + group * BODY_PACKET_WIDTH };
+				const float* dragK2{ mDragK2.data() + group * BODY_PACKET_WIDTH };
+
+				for (unsigned int body = 0; body < mBodiesPerWorld; ++body)
+				{
+					unsigned int index{ group * mBodiesPerWorld + body };
+					BodyPacket& packet{ mBodies.packets[index] };
+					const float* offsetX{ mForceOffsetX.data() + index * BODY_PACKET_WIDTH };
+					const float* offsetY{ mForceOffsetY.data() + index * BODY_PACKET_WIDTH };
+					const float* offsetZ{ mForceOffsetZ.data() + index * BODY_PACKET_WIDTH };
+
+					//F = mg - v(k1 + k2|v|), the gravity and drag generators added in the same order, 4 worlds at a time.
+					for (unsigned int i = 0; i < BODY_PACKET_WIDTH; i += 4)
+					{
+						__m128 m{ _mm_load_ps(packet.mass + i) };
+						__m128 vx{ _mm_load_ps(packet.linearVelocityX + i) };
+						__m128 vy{ _mm_load_ps(packet.linearVelocityY + i) };
+						__m128 vz{ _mm_load_ps(packet.linearVelocityZ + i) };
+
+						__m128 speed{ _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz))) };
+						__m128 k{ _mm_add_ps(_mm_loadu_ps(dragK1 + i), _mm_mul_ps(_mm_loadu_ps(dragK2 + i), speed)) };
+
+						__m128 fx{ _mm_sub_ps(_mm_mul_ps(m, _mm_loadu_ps(gravityX + i)), _mm_mul_ps(vx, k)) };
+						__m128 fy{ _mm_sub_ps(_mm_mul_ps(m, _mm_loadu_ps(gravityY + i)), _mm_mul_ps(vy, k)) };
+						__m128 fz{ _mm_sub_ps(_mm_mul_ps(m, _mm_loadu_ps(gravityZ + i)), _mm_mul_ps(vz, k)) };
+
+						__m128 ox{ _mm_loadu_ps(offsetX + i) };
+						__m128 oy{ _mm_loadu_ps(offsetY + i) };
+						__m128 oz{ _mm_loadu_ps(offsetZ + i) };
+
+						_mm_store_ps(packet.netForceX + i, fx);
+						_mm_store_ps(packet.netForceY + i, fy);
+						_mm_store_ps(packet.netForceZ + i, fz);
+
+						//offset x force
+						_mm_store_ps(packet.netTorqueX + i, _mm_sub_ps(_mm_mul_ps(oy, fz), _mm_mul_ps(oz, fy)));
+						_mm_store_ps(packet.netTorqueY + i, _mm_sub_ps(_mm_mul_ps(oz, fx), _mm_mul_ps(ox, fz)));
+						_mm_store_ps(packet.netTorqueZ + i, _mm_sub_ps(_mm_mul_ps(ox, fy), _mm_mul_ps(oy, fx)));
+					}
+
+					//The packet is integrated while its forces are still in the cache.
+					Integrate(packet, dt);
+				}
+			}
+
+			if (samples == nullptr || samples->interval == 0)
+				continue;
+
+			unsigned long long stepNumber{ mNumSteps + step + 1 };
+			if (stepNumber % samples->interval != 0)
+				continue;
+
+			unsigned int sample{ firstSample + (unsigned int)(stepNumber / samples->interval - mNumSteps / samples->interval) - 1 };
+			for (unsigned int body = 0; body < mBodiesPerWorld; ++body)
+			{
+				unsigned int to{ (sample * mBodiesPerWorld + body) * mNumWorlds };
+				for (unsigned int i = firstWorld; i < firstWorld + numWorlds; ++i)
+				{
+					unsigned int from{ GetBodyIndex(i, body) };
+					const BodyPacket& packet{ mBodies.packets[from / BODY_PACKET_WIDTH] };
+					unsigned int lane{ from % BODY_PACKET_WIDTH };
+
+					samples->centerOfMassX[to + i] = packet.centerOfMassX[lane];
+					samples->centerOfMassY[to + i] = packet.centerOfMassY[lane];
+					samples->centerOfMassZ[to + i] = packet.centerOfMassZ[lane];
+				}
+			}
+		}
+	}
+
+	void WorldBatch::StepThread(unsigned int firstWorld, unsigned int numWorlds, unsigned int numSteps, float dt, WorldBatchSamples* samples,
+		unsigned int firstSample)
+	{
+		for (unsigned int i = 0; i < numWorlds; i += WORLD_TILE_SIZE)
+		{
+			unsigned int count{ (numWorlds - i < WORLD_TILE_SIZE) ? numWorlds - i : WORLD_TILE_SIZE };
+			StepTile(firstWorld + i, count, numSteps, dt, samples, firstSample);
+		}
+	}
+
+	void WorldBatch::StepWorlds(unsigned int numSteps, float dt, unsigned int numThreads, WorldBatchSamples* samples)
+	{
+		if (numSteps == 0 || mNumWorlds == 0)
+			return;
+
+		unsigned int firstSample{ 0 };
+		if (samples != nullptr && samples->interval > 0)
+		{
+			unsigned int numNewSamples{ (unsigned int)((mNumSteps + numSteps) / samples->interval - mNumSteps / samples->interval) };
+			firstSample = samples->numSamples;
+			samples->numSamples += numNewSamples;
+
+			size_t size{ (size_t)samples->numSamples * mBodiesPerWorld * mNumWorlds };
+			samples->centerOfMassX.resize(size);
+			samples->centerOfMassY.resize(size);
+			samples->centerOfMassZ.resize(size);
+		}
+
+		if (numThreads == 0)
+			numThreads = std::thread::hardware_concurrency();
+
+		unsigned int numGroups{ (mNumWorlds + WORLD_THREAD_ALIGNMENT - 1) / WORLD_THREAD_ALIGNMENT };
+		if (numThreads > numGroups)
+			numThreads = numGroups;
+
+		if (numThreads <= 1)
+		{
+			StepThread(0, mNumWorlds, numSteps, dt, samples, firstSample);
+			mNumSteps += numSteps;
+			return;
+		}
+
+		//Each thread gets the same number of groups of worlds, give or take one.
+		std::vector<std::thread> threads;
+		unsigned int firstGroup{ 0 };
+		for (unsigned int i = 0; i < numThreads; ++i)
+		{
+			unsigned int groups{ numGroups / numThreads + ((i < numGroups % numThreads) ? 1 : 0) };
+			unsigned int firstWorld{ firstGroup * WORLD_THREAD_ALIGNMENT };
+			unsigned int lastWorld{ (firstGroup + groups) * WORLD_THREAD_ALIGNMENT };
+			if (lastWorld > mNumWorlds)
+				lastWorld = mNumWorlds;
+
+			firstGroup += groups;
+
+			if (i + 1 < numThreads)
+				threads.emplace_back(&WorldBatch::StepThread, this, firstWorld, lastWorld - firstWorld, numSteps, dt, samples, firstSample);
+			else
+				StepThread(firstWorld, lastWorld - firstWorld, numSteps, dt, samples, firstSample);
+		}
+
+		for (auto& i : threads)
+		{
+			i.join();
+		}
+
+		mNumSteps += numSteps;
+	}
+}
\ No newline at end of file
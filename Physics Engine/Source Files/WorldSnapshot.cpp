@@ -0,0 +1,146 @@
+#include "WorldSnapshot.h"
+#include <cstring>
+
+namespace PhysicsEngine
+{
+	//The arrays of a RigidBodyArrays object in the order they are stored in a snapshot.
+	//New arrays can only be added to the end, otherwise WORLD_SNAPSHOT_VERSION has to be increased.
+	static std::vector<float> RigidBodyArrays::* const bodyArrays[]{ &RigidBodyArrays::mass, &RigidBodyArrays::inverseMass,
+		&RigidBodyArrays::centerOfMassX, &RigidBodyArrays::centerOfMassY, &RigidBodyArrays::centerOfMassZ,
+		&RigidBodyArrays::orientationW, &RigidBodyArrays::orientationX, &RigidBodyArrays::orientationY, &RigidBodyArrays::orientationZ,
+		&RigidBodyArrays::linearVelocityX, &RigidBodyArrays::linearVelocityY, &RigidBodyArrays::linearVelocityZ,
+		&RigidBodyArrays::linearMomentumX, &RigidBodyArrays::linearMomentumY, &RigidBodyArrays::linearMomentumZ,
+		&RigidBodyArrays::angularVelocityX, &RigidBodyArrays::angularVelocityY, &RigidBodyArrays::angularVelocityZ,
+		&RigidBodyArrays::angularMomentumX, &RigidBodyArrays::angularMomentumY, &RigidBodyArrays::angularMomentumZ,
+		&RigidBodyArrays::inverseBodyInertiaXX, &RigidBodyArrays::inverseBodyInertiaYY, &RigidBodyArrays::inverseBodyInertiaZZ,
+		&RigidBodyArrays::inverseBodyInertiaXY, &RigidBodyArrays::inverseBodyInertiaXZ, &RigidBodyArrays::inverseBodyInertiaYZ,
+		&RigidBodyArrays::netForceX, &RigidBodyArrays::netForceY, &RigidBodyArrays::netForceZ,
+		&RigidBodyArrays::netTorqueX, &RigidBodyArrays::netTorqueY, &RigidBodyArrays::netTorqueZ };
+
+	static const unsigned int NUM_BODY_ARRAYS{ sizeof(bodyArrays) / sizeof(bodyArrays[0]) };
+
+	void SaveWorldSnapshot(const RigidBodyArrays& bodies, std::vector<unsigned char>& snapshot)
+	{
+		unsigned int numBodies{ GetNumberOfBodies(bodies) };
+		size_t arrayBytes{ numBodies * sizeof(float) };
+
+		WorldSnapshotHeader header;
+		header.numBodies = numBodies;
+		header.numSections = 1;
+
+		WorldSnapshotSection section;
+		section.type = SNAPSHOT_BODIES;
+		section.byteSize = (unsigned int)(sizeof(unsigned int) + NUM_BODY_ARRAYS * arrayBytes);
+
+		snapshot.resize(sizeof(header) + sizeof(section) + section.byteSize);
+
+		unsigned char* p{ snapshot.data() };
+		std::memcpy(p, &header, sizeof(header));
+		p += sizeof(header);
+
+		std::memcpy(p, &section, sizeof(section));
+		p += sizeof(section);
+
+		std::memcpy(p, &NUM_BODY_ARRAYS, sizeof(unsigned int));
+		p += sizeof(unsigned int);
+
+		for (auto i : bodyArrays)
+		{
+			if (numBodies > 0)
+				std::memcpy(p, (bodies.*i).data(), arrayBytes);
+			p += arrayBytes;
+		}
+	}
+
+	bool LoadWorldSnapshot(const unsigned char* snapshot, size_t size, RigidBodyArrays& bodies)
+	{
+		if (snapshot == nullptr || size < sizeof(WorldSnapshotHeader))
+			return false;
+
+		WorldSnapshotHeader header;
+		std::memcpy(&header, snapshot, sizeof(header));
+
+		if (header.magic != WorldSnapshotHeader{}.magic || header.version == 0 || header.version > WORLD_SNAPSHOT_VERSION)
+			return false;
+
+		size_t arrayBytes{ header.numBodies * sizeof(float) };
+
+		//Find the bodies section and check that every section fits before changing the bodies.
+		const unsigned char* bodiesData{ nullptr };
+		unsigned int numArrays{ 0 };
+
+		size_t offset{ sizeof(header) };
+		for (unsigned int i = 0; i < header.numSections; ++i)
+		{
+			if (size - offset < sizeof(WorldSnapshotSection))
+				return false;
+
+			WorldSnapshotSection section;
+			std::memcpy(&section, snapshot + offset, sizeof(section));
+			offset += sizeof(section);
+
+			if (size - offset < section.byteSize)
+				return false;
+
+			if (section.type == SNAPSHOT_BODIES)
+			{
+				if (section.byteSize < sizeof(unsigned int))
+					return false;
+
+				std::memcpy(&numArrays, snapshot + offset, sizeof(unsigned int));
+
+				if (arrayBytes > 0 && (section.byteSize - sizeof(unsigned int)) / arrayBytes < numArrays)
+					return false;
+
+				bodiesData = snapshot + offset + sizeof(unsigned int);
+			}
+
+			offset += section.byteSize;
+		}
+
+		if (bodiesData == nullptr)
+			return false;
+
+		for (unsigned int i = 0; i < NUM_BODY_ARRAYS; ++i)
+		{
+			std::vector<float>& array{ bodies.*bodyArrays[i] };
+			array.resize(header.numBodies);
+
+			if (header.numBodies == 0)
+				continue;
+
+			if (i < numArrays)
+				std::memcpy(array.data(), bodiesData + i * arrayBytes, arrayBytes);
+			else
+				std::memset(array.data(), 0, arrayBytes);
+		}
+
+		return true;
+	}
+
+	bool LoadWorldSnapshot(const std::vector<unsigned char>& snapshot, RigidBodyArrays& bodies)
+	{
+		return LoadWorldSnapshot(snapshot.data(), snapshot.size(), bodies);
+	}
+
+	unsigned long long HashWorldState(const RigidBodyArrays& bodies)
+	{
+		//64-bit FNV-1a over the bytes of every array.
+		unsigned long long hash{ 14695981039346656037ull };
+
+		for (auto i : bodyArrays)
+		{
+			const std::vector<float>& array{ bodies.*i };
+			const unsigned char* p{ (const unsigned char*)array.data() };
+			size_t numBytes{ array.size() * sizeof(float) };
+
+			for (size_t j = 0; j < numBytes; ++j)
+			{
+				hash ^= p[j];
+				hash *= 1099511628211ull;
+			}
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
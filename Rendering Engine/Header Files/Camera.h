@@ -58,6 +58,13 @@ namespace RenderingEngine
 	*/
 	void UpdateViewMatrix(Camera& camera);
 
+	/**@brief Rebuilds the view transformation matrix as if the camera was at the origin, so it only rotates.
+	*
+	*  Use this instead of UpdateViewMatrix when the model matrices are already relative to the camera position,
+	*  like the transforms from PhysicsEngine::FloatingOrigin. Then large camera positions never reach the GPU.
+	*/
+	void UpdateCameraRelativeViewMatrix(Camera& camera);
+
 	/**@brief Moves the camera left along the camera's x-axis.
 	*/
 	void Left(Camera& camera, float dt);
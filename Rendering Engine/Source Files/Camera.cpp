@@ -37,6 +37,17 @@ namespace RenderingEngine
 			-MathEngine::DotProduct(camera.position, camera.z), 1.0f });
 	}
 
+	void UpdateCameraRelativeViewMatrix(Camera& camera)
+	{
+		MathEngine::Orthonormalize(camera.x, camera.y, camera.z);
+
+		//same as UpdateViewMatrix with the camera position at the origin
+		camera.viewMatrix.SetRow(0, vec4{ camera.x.x, camera.y.x, camera.z.x, 0.0f });
+		camera.viewMatrix.SetRow(1, vec4{ camera.x.y, camera.y.y, camera.z.y, 0.0f });
+		camera.viewMatrix.SetRow(2, vec4{ camera.x.z, camera.y.z, camera.z.z, 0.0f });
+		camera.viewMatrix.SetRow(3, vec4{ 0.0f, 0.0f, 0.0f, 1.0f });
+	}
+
 	//compute the linear velocity vector using the linear speed and the x direction.
 	//move along the camera's negative x-axis
 	void Left(Camera& camera, float dt)